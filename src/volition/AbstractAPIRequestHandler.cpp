@@ -24,6 +24,20 @@ AbstractAPIRequestHandler::~AbstractAPIRequestHandler () {
 // overrides
 //================================================================//
 
+//----------------------------------------------------------------//
+bool AbstractAPIRequestHandler::AbstractAPIRequestHandler_getCachedResponse ( string uri, HTTPStatus& status, string& body ) const {
+    UNUSED ( uri );
+    UNUSED ( status );
+    UNUSED ( body );
+    return false;
+}
+
+//----------------------------------------------------------------//
+HTTP::Method AbstractAPIRequestHandler::AbstractAPIRequestHandler_getStreamedHTTPMethods () const {
+
+    return HTTP::UNKNOWN;
+}
+
 //----------------------------------------------------------------//
 HTTP::Method AbstractAPIRequestHandler::AbstractAPIRequestHandler_getSupportedHTTPMethods () const {
     return HTTP::ALL;
@@ -76,6 +90,22 @@ HTTPStatus AbstractAPIRequestHandler::AbstractAPIRequestHandler_handleRequest (
     return Poco::Net::HTTPResponse::HTTP_METHOD_NOT_ALLOWED;
 }
 
+//----------------------------------------------------------------//
+HTTPStatus AbstractAPIRequestHandler::AbstractAPIRequestHandler_handleStreamedRequest ( HTTP::Method method, const JSONTokenizer& jsonIn, Poco::JSON::Object& jsonOut ) const {
+    UNUSED ( method );
+    UNUSED ( jsonIn );
+    UNUSED ( jsonOut );
+
+    return Poco::Net::HTTPResponse::HTTP_METHOD_NOT_ALLOWED;
+}
+
+//----------------------------------------------------------------//
+void AbstractAPIRequestHandler::AbstractAPIRequestHandler_setCachedResponse ( string uri, HTTPStatus status, const string& body ) const {
+    UNUSED ( uri );
+    UNUSED ( status );
+    UNUSED ( body );
+}
+
 //----------------------------------------------------------------//
 void AbstractAPIRequestHandler::AbstractRequestHandler_handleRequest ( const Routing::PathMatch& match, Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response ) const {
     UNUSED ( match );
@@ -104,38 +134,67 @@ void AbstractAPIRequestHandler::AbstractRequestHandler_handleRequest ( const Rou
             return;
         }
 
-        Poco::JSON::Object::Ptr jsonIn  = NULL;
-        Poco::JSON::Object::Ptr jsonOut = new Poco::JSON::Object ();
+        string uri = request.getURI ();
+        HTTPStatus status;
+        string body;
         
-        if ( method & ( HTTP::POST | HTTP::PUT | HTTP::PATCH )) {
+        // only GET responses are eligible for caching; the handler decides if it is cacheable.
+        bool cached = ( method == HTTP::GET ) && this->AbstractAPIRequestHandler_getCachedResponse ( uri, status, body );
         
-            Poco::JSON::Parser parser;
-            Poco::Dynamic::Var result = parser.parse ( request.stream ());
-            jsonIn = result.extract < Poco::JSON::Object::Ptr >();
+        if ( !cached ) {
         
-            if ( !jsonIn ) {
-                response.setStatus ( Poco::Net::HTTPResponse::HTTP_BAD_REQUEST );
-                response.send ();
-                return;
+            Poco::JSON::Object::Ptr jsonOut = new Poco::JSON::Object ();
+            
+            if ( method & this->AbstractAPIRequestHandler_getStreamedHTTPMethods ()) {
+            
+                // read the body as-is; the handler deserializes straight from the tokens.
+                JSONTokenizer jsonIn;
+                jsonIn.tokenize ( string ( istreambuf_iterator < char >( request.stream ()), istreambuf_iterator < char >()));
+                status = this->AbstractAPIRequestHandler_handleStreamedRequest ( method, jsonIn, *jsonOut );
+            }
+            else {
+            
+                Poco::JSON::Object::Ptr jsonIn  = NULL;
+            
+                if ( method & ( HTTP::POST | HTTP::PUT | HTTP::PATCH )) {
+                
+                    Poco::JSON::Parser parser;
+                    Poco::Dynamic::Var result = parser.parse ( request.stream ());
+                    jsonIn = result.extract < Poco::JSON::Object::Ptr >();
+                
+                    if ( !jsonIn ) {
+                        response.setStatus ( Poco::Net::HTTPResponse::HTTP_BAD_REQUEST );
+                        response.send ();
+                        return;
+                    }
+                }
+                else {
+                    jsonIn = new Poco::JSON::Object ();
+                }
+                status = this->AbstractAPIRequestHandler_handleRequest ( method, *jsonIn, *jsonOut );
+            }
+            
+            stringstream bodyStream;
+            jsonOut->stringify ( bodyStream, 4, -1 );
+            body = bodyStream.str ();
+            
+            if ( method == HTTP::GET ) {
+                this->AbstractAPIRequestHandler_setCachedResponse ( uri, status, body );
             }
         }
-        else {
-            jsonIn = new Poco::JSON::Object ();
-        }
-
-        HTTPStatus status = this->AbstractAPIRequestHandler_handleRequest ( method, *jsonIn, *jsonOut );
+        
         response.setStatus ( status );
         response.setContentType ( "application/json" );
         
         ostream& out = response.send ();
-        jsonOut->stringify ( out, 4, -1 );
+        out.write ( body.data (), ( streamsize )body.size ());
         out.flush ();
         
         chrono::high_resolution_clock::time_point t1 = chrono::high_resolution_clock::now ();
         chrono::milliseconds span = chrono::duration_cast < chrono::milliseconds >( t1 - t0 );
 
         // TODO: the cast to int here is slightly gross, but is a quick fix for a build warning on some platforms (where u64 is defined as a long instead of a long long).
-        LGN_LOG ( VOL_FILTER_HTTP, INFO, "%p: %dms %s RESPONSE %s", ( void* )this, ( int )span.count (), request.getMethod ().c_str (), request.getURI ().c_str ());
+        LGN_LOG ( VOL_FILTER_HTTP, INFO, "%p: %dms %s RESPONSE%s %s", ( void* )this, ( int )span.count (), request.getMethod ().c_str (), cached ? " (CACHED)" : "", request.getURI ().c_str ());
     }
     catch ( const Poco::Exception& exc ) {
         LGN_LOG ( VOL_FILTER_HTTP, INFO, "%p: EXCEPTION in %s %s", ( void* )this, request.getMethod ().c_str (), request.getURI ().c_str ());
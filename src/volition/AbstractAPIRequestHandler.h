@@ -6,6 +6,7 @@
 
 #include <volition/AbstractRequestHandler.h>
 #include <volition/HTTP.h>
+#include <volition/serialization/JSONTokenizer.h>
 
 namespace Volition {
 
@@ -14,6 +15,13 @@ namespace Volition {
         return mask;                                                                        \
     }
 
+// request bodies for these methods are tokenized and passed to
+// AbstractAPIRequestHandler_handleStreamedRequest instead of being parsed into a Poco::JSON tree.
+#define STREAMED_HTTP_METHODS(mask)                                                         \
+    HTTP::Method AbstractAPIRequestHandler_getStreamedHTTPMethods () const override {       \
+        return mask;                                                                        \
+    }
+
 //================================================================//
 // AbstractAPIRequestHandler
 //================================================================//
@@ -27,6 +35,8 @@ protected:
     void                    AbstractRequestHandler_handleRequest                    ( const Routing::PathMatch& match, Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response ) const override;
 
     //----------------------------------------------------------------//
+    virtual bool            AbstractAPIRequestHandler_getCachedResponse             ( string uri, HTTPStatus& status, string& body ) const;
+    virtual HTTP::Method    AbstractAPIRequestHandler_getStreamedHTTPMethods        () const;
     virtual HTTP::Method    AbstractAPIRequestHandler_getSupportedHTTPMethods       () const;
     virtual HTTPStatus      AbstractAPIRequestHandler_handleDelete                  () const;
     virtual HTTPStatus      AbstractAPIRequestHandler_handleGet                     ( Poco::JSON::Object& jsonOut ) const;
@@ -34,6 +44,8 @@ protected:
     virtual HTTPStatus      AbstractAPIRequestHandler_handlePost                    ( const Poco::JSON::Object& jsonIn, Poco::JSON::Object& jsonOut ) const;
     virtual HTTPStatus      AbstractAPIRequestHandler_handlePut                     ( const Poco::JSON::Object& jsonIn, Poco::JSON::Object& jsonOut ) const;
     virtual HTTPStatus      AbstractAPIRequestHandler_handleRequest                 ( HTTP::Method method, const Poco::JSON::Object& jsonIn, Poco::JSON::Object& jsonOut ) const;
+    virtual HTTPStatus      AbstractAPIRequestHandler_handleStreamedRequest         ( HTTP::Method method, const JSONTokenizer& jsonIn, Poco::JSON::Object& jsonOut ) const;
+    virtual void            AbstractAPIRequestHandler_setCachedResponse             ( string uri, HTTPStatus status, const string& body ) const;
 
 public:
 
@@ -0,0 +1,54 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_ABSTRACTBLOCKSTORE_H
+#define VOLITION_ABSTRACTBLOCKSTORE_H
+
+#include <volition/common.h>
+#include <volition/Block.h>
+
+namespace Volition {
+
+//================================================================//
+// AbstractBlockStore
+//================================================================//
+// Content-addressed storage for full blocks, keyed by the hex digest of the
+// block's header. Blocks are immutable, so writing the same block twice is a
+// no-op; the ledger and the block tree both keep only the hash and share one
+// copy of the body. Implementations must be safe to call from any thread.
+class AbstractBlockStore {
+protected:
+
+    //----------------------------------------------------------------//
+    virtual shared_ptr < const Block >      AbstractBlockStore_getBlock         ( string hash ) const = 0;
+    virtual bool                            AbstractBlockStore_hasBlock         ( string hash ) const = 0;
+    virtual void                            AbstractBlockStore_putBlock         ( const Block& block ) = 0;
+
+public:
+
+    //----------------------------------------------------------------//
+    AbstractBlockStore () {
+    }
+
+    //----------------------------------------------------------------//
+    virtual ~AbstractBlockStore () {
+    }
+
+    //----------------------------------------------------------------//
+    shared_ptr < const Block > getBlock ( string hash ) const {
+        return this->AbstractBlockStore_getBlock ( hash );
+    }
+
+    //----------------------------------------------------------------//
+    bool hasBlock ( string hash ) const {
+        return this->AbstractBlockStore_hasBlock ( hash );
+    }
+
+    //----------------------------------------------------------------//
+    void putBlock ( const Block& block ) {
+        this->AbstractBlockStore_putBlock ( block );
+    }
+};
+
+} // namespace Volition
+#endif
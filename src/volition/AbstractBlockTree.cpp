@@ -3,6 +3,7 @@
 
 #include <volition/Block.h>
 #include <volition/AbstractBlockTree.h>
+#include <volition/Metrics.h>
 
 namespace Volition {
 
@@ -19,8 +20,14 @@ size_t BlockTreeSegment::getFullLength () const {
 //----------------------------------------------------------------//
 size_t BlockTreeSegment::getRewriteDefeatCount () const {
 
-    time_t window = this->mHead->getRewriteWindow (); // TODO: account for different rewrite windows in segment
-    return ( size_t )floor ( difftime ( this->mTop->getTime (), this->mHead->getTime ()) / window ) + 1;
+    return BlockTreeSegment::getRewriteDefeatCount ( *this->mHead, *this->mTop );
+}
+
+//----------------------------------------------------------------//
+size_t BlockTreeSegment::getRewriteDefeatCount ( const HasBlockHeaderFields& head, const HasBlockHeaderFields& top ) {
+
+    time_t window = head.getRewriteWindow (); // TODO: account for different rewrite windows in segment
+    return ( size_t )floor ( difftime ( top.getTime (), head.getTime ()) / window ) + 1;
 }
 
 //----------------------------------------------------------------//
@@ -93,9 +100,7 @@ kBlockTreeAppendResult AbstractBlockTree::checkAppend ( const BlockHeader& heade
 
     if ( acceptedRelease < header.getRelease ()) return INCOMPATIBLE;
 
-    string hash = header.getDigest ().toHex ();
-
-    BlockTreeCursor cursor = this->findCursorForHash ( hash );
+    BlockTreeCursor cursor = this->findCursorForHash ( header.getDigest ());
     if ( cursor.hasHeader ()) return ALREADY_EXISTS;
 
     BlockTreeCursor prevCursor = this->findCursorForHash ( header.getPrevDigest ());
@@ -108,57 +113,128 @@ kBlockTreeAppendResult AbstractBlockTree::checkAppend ( const BlockHeader& heade
     return APPEND_OK;
 }
 
+//----------------------------------------------------------------//
+void AbstractBlockTree::clearCompareCache () {
+
+    this->mCompareCache.clear ();
+    this->mParentCache.clear ();
+}
+
 //----------------------------------------------------------------//
 int AbstractBlockTree::compare ( const BlockTreeCursor& cursor0, const BlockTreeCursor& cursor1 ) const {
 
     LGN_LOG_SCOPE ( VOL_FILTER_CONSENSUS, INFO, __PRETTY_FUNCTION__ );
 
-    BlockTreeFork fork;
-    this->findFork ( fork, cursor0, cursor1 );
+    assert ( cursor0.mTree && ( cursor0.mTree == cursor1.mTree ));
+    assert ( cursor0.mHeader && cursor1.mHeader );
 
-    if ( fork.mStatus == BlockTreeFork::SAME ) return 0;
-    if ( fork.mStatus == BlockTreeFork::LEFT_DOMINANT_SUBSET ) return -1;
-    if ( fork.mStatus == BlockTreeFork::RIGHT_DOMINANT_SUBSET ) return 1;
+    // not symmetric (see the rewrite defeat checks), so key on the ordered pair.
+    CompareCacheKey key ( cursor0.getDigest (), cursor1.getDigest ());
 
-    size_t fullLength0  = fork.mSeg0.getFullLength ();
-    size_t fullLength1  = fork.mSeg1.getFullLength ();
-    size_t segLength    = fork.getSegLength (); // length of the comparison segment
-    
-    // if the segment is shorter, it must have enough blocks to "defeat" the longer chain (as a function of time)
-    if (( segLength < fullLength0 ) && ( segLength < fork.mSeg0.getRewriteDefeatCount ())) return -1;
-    if (( segLength < fullLength1 ) && ( segLength < fork.mSeg1.getRewriteDefeatCount ())) return 1;
+    map < CompareCacheKey, int >::const_iterator cacheIt = this->mCompareCache.find ( key );
+    if ( cacheIt != this->mCompareCache.cend ()) return cacheIt->second;
+
+    int result = this->compareBranches ( cursor0.mHeader, cursor1.mHeader );
+
+    if ( this->mCompareCache.size () >= MAX_COMPARE_CACHE_SIZE ) {
+        this->mCompareCache.clear ();
+    }
+    this->mCompareCache [ key ] = result;
+    return result;
+}
+
+//----------------------------------------------------------------//
+int AbstractBlockTree::compareBranches ( shared_ptr < const BlockHeader > header0, shared_ptr < const BlockHeader > header1 ) const {
+
+    // same walk as findFork (), but over headers and memoized parent links instead of cursors.
+
+    if ( header0->equals ( *header1 )) return 0;
+
+    shared_ptr < const BlockHeader > top0 = header0;
+    shared_ptr < const BlockHeader > top1 = header1;
+
+    size_t height0 = top0->getHeight ();
+    size_t height1 = top1->getHeight ();
+    size_t height = height0 < height1 ? height0 : height1;
+
+    while ( height < header0->getHeight ()) {
+        shared_ptr < const BlockHeader > parent = this->getParentHeader ( *header0 );
+        if ( !parent ) break;
+        header0 = parent;
+    }
+
+    while ( height < header1->getHeight ()) {
+        shared_ptr < const BlockHeader > parent = this->getParentHeader ( *header1 );
+        if ( !parent ) break;
+        header1 = parent;
+    }
+
+    // one branch is a subset of the other.
+    if ( header0->equals ( *header1 )) {
+        return ( height0 < height1 ) ? 1 : -1;
+    }
+
+    // walk both branches back to the common root; each vector runs from the tail
+    // (the shared height) down to the head (the block just above the root).
+    vector < shared_ptr < const BlockHeader >> seg0;
+    vector < shared_ptr < const BlockHeader >> seg1;
+
+    while ( header0 && header1 && !header0->equals ( *header1 )) {
+
+        seg0.push_back ( header0 );
+        seg1.push_back ( header1 );
 
-    BlockTreeSegment::Iterator cursorIt0 = fork.mSeg0.mTail;
-    BlockTreeSegment::Iterator cursorIt1 = fork.mSeg1.mTail;
+        header0 = this->getParentHeader ( *header0 );
+        header1 = this->getParentHeader ( *header1 );
+    }
+
+    assert ( header0 && header1 );
+    assert ( seg0.size () == seg1.size ());
+    if ( !( header0 && header1 )) return 0;
+
+    const BlockHeader& head0 = *seg0.back ();
+    const BlockHeader& head1 = *seg1.back ();
+
+    size_t fullLength0  = ( top0->getHeight () - head0.getHeight ()) + 1;
+    size_t fullLength1  = ( top1->getHeight () - head1.getHeight ()) + 1;
+    size_t segLength    = seg0.size (); // length of the comparison segment
+
+    // if the segment is shorter, it must have enough blocks to "defeat" the longer chain (as a function of time)
+    if (( segLength < fullLength0 ) && ( segLength < BlockTreeSegment::getRewriteDefeatCount ( head0, *top0 ))) return -1;
+    if (( segLength < fullLength1 ) && ( segLength < BlockTreeSegment::getRewriteDefeatCount ( head1, *top1 ))) return 1;
 
     int tieBreaker = 0;
     int score = 0;
 
     for ( size_t i = 0; i < segLength; ++i ) {
-    
-        const BlockTreeCursor& cusor0 = *cursorIt0;
-        const BlockTreeCursor& cusor1 = *cursorIt1;
-        
-        assert ( cusor0.getDigest ());
-        assert ( cusor1.getDigest ());
-        assert ( cusor0.getDigest () != cusor1.getDigest ());
-        
-        tieBreaker = BlockHeader::compare ( *cursorIt0->mHeader, *cursorIt1->mHeader );
+
+        assert ( seg0 [ i ]->getDigest () != seg1 [ i ]->getDigest ());
+
+        tieBreaker = BlockHeader::compare ( *seg0 [ i ], *seg1 [ i ]);
         score += tieBreaker;
-        
-        --cursorIt0;
-        --cursorIt1;
     }
-    
+
     return score == 0 ? tieBreaker : ( score < 0 ? -1 : 1 );
 }
 
 //----------------------------------------------------------------//
-BlockTreeCursor AbstractBlockTree::findCursorForHash ( string hash ) const {
+BlockTreeCursor AbstractBlockTree::findCursorForHash ( const Digest& hash ) const {
+
+    return this->AbstractBlockTree_findCursorForHash ( Digest256 ( hash ));
+}
+
+//----------------------------------------------------------------//
+BlockTreeCursor AbstractBlockTree::findCursorForHash ( const Digest256& hash ) const {
 
     return this->AbstractBlockTree_findCursorForHash ( hash );
 }
 
+//----------------------------------------------------------------//
+BlockTreeCursor AbstractBlockTree::findCursorForHash ( string hash ) const {
+
+    return this->AbstractBlockTree_findCursorForHash ( Digest256::fromHex ( hash ));
+}
+
 //----------------------------------------------------------------//
 BlockTreeCursor AbstractBlockTree::findCursorForTag ( const BlockTreeTag& tag ) const {
 
@@ -173,7 +249,7 @@ BlockTreeCursor AbstractBlockTree::findCursorForTag ( const BlockTreeTag& tag )
 //----------------------------------------------------------------//
 void AbstractBlockTree::findFork ( BlockTreeFork& fork, BlockTreeCursor cursor0, BlockTreeCursor cursor1 ) const {
 
-    LGN_LOG_SCOPE ( VOL_FILTER_CONSENSUS, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_SPAN ( "volition_block_tree_find_fork_seconds", "Wall time of AbstractBlockTree::findFork." );
 
     assert ( cursor0.mTree && ( cursor0.mTree == cursor1.mTree ));
     
@@ -260,11 +336,33 @@ shared_ptr < const Block > AbstractBlockTree::getBlock ( const BlockTreeCursor&
 BlockTreeCursor AbstractBlockTree::getParent ( const BlockTreeCursor& cursor ) const {
 
     if ( cursor.getHeight () > 0 ) {
-        return this->findCursorForHash ( cursor.getPrevDigest ().toHex ());
+        return this->findCursorForHash ( cursor.getPrevDigest ());
     }
     return BlockTreeCursor ();
 }
 
+//----------------------------------------------------------------//
+shared_ptr < const BlockHeader > AbstractBlockTree::getParentHeader ( const BlockHeader& header ) const {
+
+    if ( header.isGenesis ()) return NULL;
+
+    Digest256 digest ( header.getDigest ());
+
+    ParentCache::const_iterator parentIt = this->mParentCache.find ( digest );
+    if ( parentIt != this->mParentCache.cend ()) return parentIt->second;
+
+    shared_ptr < const BlockHeader > parent = this->findCursorForHash ( header.getPrevDigest ()).mHeader;
+
+    // only cache links we have actually resolved; the parent may show up later.
+    if ( parent ) {
+        if ( this->mParentCache.size () >= MAX_PARENT_CACHE_SIZE ) {
+            this->mParentCache.clear ();
+        }
+        this->mParentCache [ digest ] = parent;
+    }
+    return parent;
+}
+
 //----------------------------------------------------------------//
 BlockTreeCursor AbstractBlockTree::makeProvisional ( shared_ptr < const BlockHeader > header ) {
 
@@ -11,6 +11,7 @@
 #include <volition/BlockTreeCursor.h>
 #include <volition/BlockTreeEnums.h>
 #include <volition/BlockTreeTag.h>
+#include <volition/Digest256.h>
 
 namespace Volition {
 
@@ -32,6 +33,7 @@ public:
     //----------------------------------------------------------------//
     size_t          getFullLength           () const;
     size_t          getRewriteDefeatCount   () const;
+    static size_t   getRewriteDefeatCount   ( const HasBlockHeaderFields& head, const HasBlockHeaderFields& top );
     Iterator        pushFront               ( const BlockTreeCursor& cursor );
 };
 
@@ -68,14 +70,28 @@ protected:
     friend class BlockTreeTag;
     friend class DebugBlockTree;
 
+    static const size_t MAX_COMPARE_CACHE_SIZE      = 16384;
+    static const size_t MAX_PARENT_CACHE_SIZE       = 16384;
+
+    typedef pair < Digest256, Digest256 >                                                   CompareCacheKey;
+    typedef unordered_map < Digest256, shared_ptr < const BlockHeader >, Digest256::Hash >  ParentCache;
+
+    // branch comparison only looks at headers, and headers are immutable and
+    // addressed by digest; compare results and parent links may be memoized
+    // for as long as the tree lives.
+    mutable map < CompareCacheKey, int >    mCompareCache;
+    mutable ParentCache                     mParentCache;
+
     //----------------------------------------------------------------//
     BlockTreeCursor             affirm                  ( BlockTreeTag& tag, shared_ptr < const BlockHeader > header, shared_ptr < const Block > block, bool isProvisional = false );
+    int                         compareBranches         ( shared_ptr < const BlockHeader > header0, shared_ptr < const BlockHeader > header1 ) const;
     void                        findFork                ( BlockTreeFork& fork, BlockTreeCursor cursor0, BlockTreeCursor cursor1 ) const;
+    shared_ptr < const BlockHeader > getParentHeader     ( const BlockHeader& header ) const;
     BlockTreeCursor             makeCursor              ( shared_ptr < const BlockHeader > header, kBlockTreeBranchStatus branchStatus, kBlockTreeSearchStatus searchStatus ) const;
 
     //----------------------------------------------------------------//
     virtual BlockTreeCursor             AbstractBlockTree_affirm                    ( BlockTreeTag& tag, shared_ptr < const BlockHeader > header, shared_ptr < const Block > block, bool isProvisional ) = 0;
-    virtual BlockTreeCursor             AbstractBlockTree_findCursorForHash         ( string hash ) const = 0;
+    virtual BlockTreeCursor             AbstractBlockTree_findCursorForHash         ( const Digest256& hash ) const = 0;
     virtual BlockTreeCursor             AbstractBlockTree_findCursorForTagName      ( string tagName ) const = 0;
     virtual shared_ptr < const Block >  AbstractBlockTree_getBlock                  ( const BlockTreeCursor& cursor ) const = 0;
     virtual void                        AbstractBlockTree_setBranchStatus           ( const BlockTreeCursor& cursor, kBlockTreeBranchStatus status ) = 0;
@@ -94,7 +110,10 @@ public:
                                 AbstractBlockTree       ();
     virtual                     ~AbstractBlockTree      ();
     kBlockTreeAppendResult      checkAppend             ( const BlockHeader& header, u64 acceptedRelease ) const;
+    void                        clearCompareCache       ();
     int                         compare                 ( const BlockTreeCursor& cursor0, const BlockTreeCursor& cursor1 ) const;
+    BlockTreeCursor             findCursorForHash       ( const Digest& hash ) const;
+    BlockTreeCursor             findCursorForHash       ( const Digest256& hash ) const;
     BlockTreeCursor             findCursorForHash       ( string hash ) const;
     BlockTreeCursor             findCursorForTag        ( const BlockTreeTag& tag ) const;
     BlockTreeCursor             findRoot                ( const BlockTreeCursor& cursor0, const BlockTreeCursor& cursor1 ) const;
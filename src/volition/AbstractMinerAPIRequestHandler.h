@@ -8,10 +8,16 @@
 #include <volition/HTTP.h>
 #include <volition/Ledger.h>
 #include <volition/Miner.h>
+#include <volition/MinerAPIResponseCache.h>
 #include <volition/MinerLocks.h>
 
 namespace Volition {
 
+#define CACHEABLE_RESPONSE                                                                  \
+    bool AbstractMinerAPIRequestHandler_isCacheable () const override {                     \
+        return true;                                                                        \
+    }
+
 class Ledger;
 class Miner;
 
@@ -24,15 +30,65 @@ protected:
 
     friend class MinerAPIFactory;
     
-    shared_ptr < Miner >    mMiner;
+    shared_ptr < Miner >                    mMiner;
+    shared_ptr < MinerAPIResponseCache >    mResponseCache;
+    mutable string                          mResponseEpoch;
     
     //----------------------------------------------------------------//
     virtual HTTPStatus      AbstractMinerAPIRequestHandler_handleRequest        ( HTTP::Method method, shared_ptr < Miner > miner, const Poco::JSON::Object& jsonIn, Poco::JSON::Object& jsonOut ) const = 0;
     
+    //----------------------------------------------------------------//
+    // override along with STREAMED_HTTP_METHODS.
+    virtual HTTPStatus AbstractMinerAPIRequestHandler_handleStreamedRequest ( HTTP::Method method, shared_ptr < Miner > miner, const JSONTokenizer& jsonIn, Poco::JSON::Object& jsonOut ) const {
+        UNUSED ( method );
+        UNUSED ( miner );
+        UNUSED ( jsonIn );
+        UNUSED ( jsonOut );
+        return Poco::Net::HTTPResponse::HTTP_METHOD_NOT_ALLOWED;
+    }
+    
+    //----------------------------------------------------------------//
+    // override (via CACHEABLE_RESPONSE) only for handlers whose GET response is fully determined
+    // by the URI and the miner's response epoch.
+    virtual bool AbstractMinerAPIRequestHandler_isCacheable () const {
+        return false;
+    }
+    
+    //----------------------------------------------------------------//
+    bool AbstractAPIRequestHandler_getCachedResponse ( string uri, HTTPStatus& status, string& body ) const override {
+    
+        if ( !( this->mMiner && this->mResponseCache && this->AbstractMinerAPIRequestHandler_isCacheable ())) return false;
+        
+        // remember the epoch we looked up under; the response is only cached if it is unchanged once computed.
+        this->mResponseEpoch = this->mMiner->getResponseEpoch ();
+        
+        int cachedStatus;
+        if ( this->mResponseCache->get ( this->mResponseEpoch, uri, cachedStatus, body )) {
+            status = ( HTTPStatus )cachedStatus;
+            return true;
+        }
+        return false;
+    }
+    
     //----------------------------------------------------------------//
     HTTPStatus AbstractAPIRequestHandler_handleRequest ( HTTP::Method method, const Poco::JSON::Object& jsonIn, Poco::JSON::Object& jsonOut ) const override {
         return this->AbstractMinerAPIRequestHandler_handleRequest ( method, this->mMiner, jsonIn, jsonOut );
     }
+    
+    //----------------------------------------------------------------//
+    HTTPStatus AbstractAPIRequestHandler_handleStreamedRequest ( HTTP::Method method, const JSONTokenizer& jsonIn, Poco::JSON::Object& jsonOut ) const override {
+        return this->AbstractMinerAPIRequestHandler_handleStreamedRequest ( method, this->mMiner, jsonIn, jsonOut );
+    }
+    
+    //----------------------------------------------------------------//
+    void AbstractAPIRequestHandler_setCachedResponse ( string uri, HTTPStatus status, const string& body ) const override {
+    
+        if ( !( this->mMiner && this->mResponseCache && this->AbstractMinerAPIRequestHandler_isCacheable ())) return;
+        if ( !(( status == Poco::Net::HTTPResponse::HTTP_OK ) || ( status == Poco::Net::HTTPResponse::HTTP_NOT_FOUND ))) return;
+        if ( this->mMiner->getResponseEpoch () != this->mResponseEpoch ) return;
+        
+        this->mResponseCache->set ( this->mResponseEpoch, uri, ( int )status, body );
+    }
 
 public:
 
@@ -45,9 +101,10 @@ public:
     }
     
      //----------------------------------------------------------------//
-    void initialize ( shared_ptr < Miner > miner ) {
+    void initialize ( shared_ptr < Miner > miner, shared_ptr < MinerAPIResponseCache > responseCache = NULL ) {
     
         this->mMiner = miner;
+        this->mResponseCache = responseCache;
     }
 };
 
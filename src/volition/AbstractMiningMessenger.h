@@ -7,6 +7,7 @@
 #include <volition/common.h>
 #include <volition/Block.h>
 #include <volition/Digest.h>
+#include <volition/LedgerSnapshot.h>
 
 namespace Volition {
 
@@ -22,6 +23,8 @@ public:
         REQUEST_EXTEND_NETWORK,
         REQUEST_HEADERS,
         REQUEST_MINER_INFO,
+        REQUEST_SNAPSHOT_CHUNK,
+        REQUEST_SNAPSHOT_MANIFEST,
     };
 
     Type                                mRequestType;
@@ -30,13 +33,15 @@ public:
     Digest                              mBlockDigest;
     size_t                              mHeight;
     u64                                 mAcceptedRelease;
+    size_t                              mChunkIndex;
     
     string                              mDebug;
     
     //----------------------------------------------------------------//
     MiningMessengerRequest () :
         mRequestType ( UNKNOWN ),
-        mHeight ( 0 ) {
+        mHeight ( 0 ),
+        mChunkIndex ( 0 ) {
     }
     
     //----------------------------------------------------------------//
@@ -44,7 +49,8 @@ public:
         mRequestType ( requestType ),
         mMinerURL ( minerURL ),
         mHeight ( 0 ),
-        mAcceptedRelease ( 0 ) {
+        mAcceptedRelease ( 0 ),
+        mChunkIndex ( 0 ) {
     }
 };
 
@@ -70,6 +76,9 @@ public:
     shared_ptr < const Block >                  mBlock;
     list < shared_ptr < const BlockHeader >>    mHeaders;
     set < string >                              mMinerURLs;
+    
+    shared_ptr < const LedgerSnapshotManifest > mSnapshotManifest;
+    string                                      mSnapshotChunk;
 };
 
 //================================================================//
@@ -223,6 +232,42 @@ public:
         this->enqueueResponse ( response );
     }
 
+    //----------------------------------------------------------------//
+    void enqueueSnapshotChunkRequest ( string minerURL, u64 height, size_t chunkIndex ) {
+        
+        MiningMessengerRequest request ( minerURL, MiningMessengerRequest::REQUEST_SNAPSHOT_CHUNK );
+        request.mHeight             = height;
+        request.mChunkIndex         = chunkIndex;
+        this->enqueueRequest ( request );
+    }
+    
+    //----------------------------------------------------------------//
+    void enqueueSnapshotChunkResponse ( const MiningMessengerRequest& request, string chunk ) {
+    
+        MiningMessengerResponse response;
+        response.mStatus            = MiningMessengerResponse::STATUS_OK;
+        response.mRequest           = request;
+        response.mSnapshotChunk     = chunk;
+        this->enqueueResponse ( response );
+    }
+    
+    //----------------------------------------------------------------//
+    void enqueueSnapshotManifestRequest ( string minerURL ) {
+        
+        MiningMessengerRequest request ( minerURL, MiningMessengerRequest::REQUEST_SNAPSHOT_MANIFEST );
+        this->enqueueRequest ( request );
+    }
+    
+    //----------------------------------------------------------------//
+    void enqueueSnapshotManifestResponse ( const MiningMessengerRequest& request, shared_ptr < const LedgerSnapshotManifest > manifest ) {
+    
+        MiningMessengerResponse response;
+        response.mStatus            = MiningMessengerResponse::STATUS_OK;
+        response.mRequest           = request;
+        response.mSnapshotManifest  = manifest;
+        this->enqueueResponse ( response );
+    }
+
     //----------------------------------------------------------------//
     bool isFull ( MiningMessengerRequest::Type requestType ) const {
     
@@ -29,6 +29,17 @@ TransactionResult AbstractTransactionBody::genesis ( AbstractLedger& ledger ) {
     return this->AbstractTransactionBody_genesis ( ledger );
 }
 
+//----------------------------------------------------------------//
+TransactionAccessSet AbstractTransactionBody::getAccessSet () const {
+
+    TransactionAccessSet accessSet;
+    if ( this->mMaker ) {
+        accessSet.mAccounts.insert ( this->mMaker->getAccountName ());
+    }
+    this->AbstractTransactionBody_getAccessSet ( accessSet );
+    return accessSet;
+}
+
 //----------------------------------------------------------------//
 TransactionDetailsPtr AbstractTransactionBody::getDetails ( const AbstractLedger& ledger ) const {
     return this->AbstractTransactionBody_getDetails ( ledger );
@@ -83,6 +94,13 @@ TransactionResult AbstractTransactionBody::AbstractTransactionBody_genesis ( Abs
     return "Missing transaction maker.";
 }
 
+//----------------------------------------------------------------//
+void AbstractTransactionBody::AbstractTransactionBody_getAccessSet ( TransactionAccessSet& accessSet ) const {
+
+    // bodies that don't declare their writes conflict with everything.
+    accessSet.mGlobal = true;
+}
+
 //----------------------------------------------------------------//
 TransactionDetailsPtr AbstractTransactionBody::AbstractTransactionBody_getDetails ( const AbstractLedger& ledger ) const {
     UNUSED ( ledger );
@@ -10,6 +10,7 @@
 #include <volition/Ledger.h>
 #include <volition/Miner.h>
 #include <volition/serialization/Serialization.h>
+#include <volition/TransactionAccessSet.h>
 #include <volition/TransactionContext.h>
 #include <volition/TransactionMaker.h>
 #include <volition/TransactionResult.h>
@@ -61,6 +62,7 @@ protected:
     //----------------------------------------------------------------//
     virtual TransactionResult       AbstractTransactionBody_apply           ( TransactionContext& context ) const = 0;
     virtual TransactionResult       AbstractTransactionBody_genesis         ( AbstractLedger& ledger ) const;
+    virtual void                    AbstractTransactionBody_getAccessSet    ( TransactionAccessSet& accessSet ) const;
     virtual TransactionDetailsPtr   AbstractTransactionBody_getDetails      ( const AbstractLedger& ledger ) const;
     virtual u64                     AbstractTransactionBody_getVOL          ( const TransactionContext& context ) const;
     virtual u64                     AbstractTransactionBody_maturity        () const = 0;
@@ -88,6 +90,7 @@ public:
                                 ~AbstractTransactionBody                ();
     TransactionResult           apply                                   ( TransactionContext& context ) const;
     TransactionResult           genesis                                 ( AbstractLedger& ledger );
+    TransactionAccessSet        getAccessSet                            () const;
     TransactionDetailsPtr       getDetails                              ( const AbstractLedger& ledger ) const;
     const TransactionMaker*     getMaker                                () const;
     u64                         getVOL                                  ( const TransactionContext& context ) const;
@@ -0,0 +1,153 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <volition/AccountInventory.h>
+#include <volition/Metrics.h>
+
+namespace Volition {
+
+//================================================================//
+// AccountInventory
+//================================================================//
+
+//----------------------------------------------------------------//
+AccountInventory::AccountInventory ( AccountODBM& accountODBM ) :
+    mAccountODBM ( accountODBM ) {
+
+    this->mCommittedSize = accountODBM.mAssetCount.get ( 0 );
+    this->mSize = this->mCommittedSize;
+}
+
+//----------------------------------------------------------------//
+AccountInventory::~AccountInventory () {
+}
+
+//----------------------------------------------------------------//
+AccountInventory::Page& AccountInventory::affirmPage ( size_t pageID ) {
+
+    map < size_t, Page >::iterator pageIt = this->mPages.find ( pageID );
+    if ( pageIt != this->mPages.end ()) return pageIt->second;
+
+    VOL_METRIC_COUNT_LABELED ( "volition_inventory_pages_total", "Inventory pages read from or written to the ledger.", "op=\"load\"", 1 );
+
+    Page& page = this->mPages [ pageID ];
+    size_t base = pageID * PAGE_SIZE;
+
+    LedgerObjectFieldODBM < Page > pageField = this->mAccountODBM.getInventoryPageField ( pageID );
+    if ( pageField.exists ()) {
+        pageField.get ( page );
+    }
+    else {
+        size_t top = ( base + PAGE_SIZE ) < this->mCommittedSize ? ( base + PAGE_SIZE ) : this->mCommittedSize;
+        for ( size_t i = base; i < top; ++i ) {
+            page.push_back ( this->mAccountODBM.getInventoryField ( i ).get ());
+        }
+    }
+
+    // slots past the end of the inventory may hold stale indices (the inventory shrank since the page was
+    // written); drop them so that the page's size always matches the slots in use.
+    size_t inUse = this->mSize > base ? this->mSize - base : 0;
+    if ( inUse > PAGE_SIZE ) {
+        inUse = PAGE_SIZE;
+    }
+    assert ( page.size () >= inUse );
+    page.resize ( inUse );
+
+    return page;
+}
+
+//----------------------------------------------------------------//
+void AccountInventory::clear () {
+
+    // nothing to write: the slots are past the end now, so they'll be trimmed when their page is next loaded.
+    this->mSize = 0;
+    this->mPages.clear ();
+    this->mDirty.clear ();
+}
+
+//----------------------------------------------------------------//
+void AccountInventory::commit () {
+
+    set < size_t >::const_iterator dirtyIt = this->mDirty.cbegin ();
+    for ( ; dirtyIt != this->mDirty.cend (); ++dirtyIt ) {
+        this->mAccountODBM.getInventoryPageField ( *dirtyIt ).set ( this->mPages [ *dirtyIt ]);
+    }
+    VOL_METRIC_COUNT_LABELED ( "volition_inventory_pages_total", "Inventory pages read from or written to the ledger.", "op=\"store\"", this->mDirty.size ());
+    this->mDirty.clear ();
+
+    if ( this->mSize != this->mCommittedSize ) {
+        this->mAccountODBM.mAssetCount.set ( this->mSize );
+        this->mCommittedSize = this->mSize;
+    }
+}
+
+//----------------------------------------------------------------//
+AssetID::Index AccountInventory::get ( size_t position ) {
+
+    assert ( position < this->mSize );
+    return this->affirmPage ( position / PAGE_SIZE )[ position % PAGE_SIZE ];
+}
+
+//----------------------------------------------------------------//
+void AccountInventory::getRange ( size_t base, size_t top, vector < AssetID::Index >& assetIDs ) {
+
+    if ( top > this->mSize ) {
+        top = this->mSize;
+    }
+    if ( base >= top ) return;
+
+    assetIDs.reserve ( assetIDs.size () + ( top - base ));
+
+    for ( size_t position = base; position < top; ) {
+
+        const Page& page = this->affirmPage ( position / PAGE_SIZE );
+
+        size_t pageBase = position - ( position % PAGE_SIZE );
+        size_t pageTop = ( pageBase + page.size ()) < top ? ( pageBase + page.size ()) : top;
+
+        assetIDs.insert ( assetIDs.end (), page.cbegin () + ( long )( position - pageBase ), page.cbegin () + ( long )( pageTop - pageBase ));
+        position = pageTop;
+    }
+}
+
+//----------------------------------------------------------------//
+size_t AccountInventory::push ( AssetID::Index assetID ) {
+
+    size_t position = this->mSize;
+    size_t pageID = position / PAGE_SIZE;
+
+    Page& page = this->affirmPage ( pageID );
+    assert ( page.size () == ( position % PAGE_SIZE ));
+
+    page.push_back ( assetID );
+    this->mDirty.insert ( pageID );
+    this->mSize++;
+
+    return position;
+}
+
+//----------------------------------------------------------------//
+AssetID::Index AccountInventory::remove ( size_t position ) {
+
+    // fill the vacated slot by swapping in the tail; returns the asset that moved, if any.
+    assert ( position < this->mSize );
+
+    size_t tail = this->mSize - 1;
+    size_t tailPageID = tail / PAGE_SIZE;
+
+    Page& tailPage = this->affirmPage ( tailPageID );
+    AssetID::Index tailAssetID = tailPage.back ();
+    tailPage.pop_back ();
+    this->mDirty.insert ( tailPageID );
+    this->mSize--;
+
+    if ( position == tail ) return AssetID::NULL_INDEX;
+
+    size_t pageID = position / PAGE_SIZE;
+    this->affirmPage ( pageID )[ position % PAGE_SIZE ] = tailAssetID;
+    this->mDirty.insert ( pageID );
+
+    return tailAssetID;
+}
+
+} // namespace Volition
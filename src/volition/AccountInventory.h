@@ -0,0 +1,58 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_ACCOUNTINVENTORY_H
+#define VOLITION_ACCOUNTINVENTORY_H
+
+#include <volition/common.h>
+#include <volition/AccountODBM.h>
+#include <volition/AssetID.h>
+
+namespace Volition {
+
+//================================================================//
+// AccountInventory
+//================================================================//
+// An account's inventory: the list of asset indices it owns, in position
+// order. Stored as fixed-size pages (one ledger key per PAGE_SIZE slots)
+// rather than one key per slot, so reading or rewriting n slots touches
+// about n / PAGE_SIZE keys and each write to the versioned store copies a
+// whole page. Pages are loaded on first touch and buffered; nothing is
+// written until commit (), which stores each modified page once along
+// with the new asset count. Pages missing from older ledgers are filled in
+// from the legacy per-slot keys.
+class AccountInventory {
+public:
+
+    static const size_t PAGE_SIZE = 256;
+
+    typedef SerializableVector < AssetID::Index > Page;
+
+private:
+
+    AccountODBM&                mAccountODBM;
+    size_t                      mCommittedSize;
+    size_t                      mSize;
+    map < size_t, Page >        mPages;
+    set < size_t >              mDirty;
+
+    //----------------------------------------------------------------//
+    Page&                       affirmPage                  ( size_t pageID );
+
+public:
+
+    GET ( size_t,               Size,                       mSize )
+
+    //----------------------------------------------------------------//
+                                AccountInventory            ( AccountODBM& accountODBM );
+                                ~AccountInventory           ();
+    void                        clear                       ();
+    void                        commit                      ();
+    AssetID::Index              get                         ( size_t position );
+    void                        getRange                    ( size_t base, size_t top, vector < AssetID::Index >& assetIDs );
+    size_t                      push                        ( AssetID::Index assetID );
+    AssetID::Index              remove                      ( size_t position );
+};
+
+} // namespace Volition
+#endif
@@ -48,11 +48,21 @@ private:
         return LedgerKey ([ = ]() { return Format::write ( "account.%d", index ); });
     }
 
+    //----------------------------------------------------------------//
+    static LedgerKey keyFor_inventoryCheckpoint ( AccountID::Index index, u64 checkpoint ) {
+        return Format::write ( "account.%d.inventoryCheckpoint.%d", index, checkpoint );
+    }
+
     //----------------------------------------------------------------//
     static LedgerKey keyFor_inventoryField ( AccountID::Index index, size_t position ) {
         return Format::write ( "account.%d.assets.%d", index, position );
     }
 
+    //----------------------------------------------------------------//
+    static LedgerKey keyFor_inventoryPage ( AccountID::Index index, size_t page ) {
+        return Format::write ( "account.%d.inventoryPage.%d", index, page );
+    }
+
     //----------------------------------------------------------------//
     static LedgerKey keyFor_inventoryLogEntry ( AccountID::Index index, u64 inventoryNonce ) {
         return Format::write ( "account.%d.inventoryLog.%d", index, inventoryNonce );
@@ -164,11 +174,25 @@ public:
     }
     
     //----------------------------------------------------------------//
+    // union of the inventory log entries in one checkpoint interval; see InventoryDelta.
+    LedgerObjectFieldODBM < InventoryLogEntry > getInventoryCheckpointField ( u64 checkpoint ) {
+    
+        return LedgerObjectFieldODBM < InventoryLogEntry >( this->mLedger, keyFor_inventoryCheckpoint ( this->mAccountID, checkpoint ));
+    }
+    
+    //----------------------------------------------------------------//
+    // legacy (one key per slot) inventory layout; only read to fill in pages that were never written.
     LedgerFieldODBM < AssetID::Index > getInventoryField ( size_t position ) {
     
         return LedgerFieldODBM < AssetID::Index >( this->mLedger, keyFor_inventoryField ( this->mAccountID, position ), AssetID::NULL_INDEX );
     }
     
+    //----------------------------------------------------------------//
+    LedgerObjectFieldODBM < SerializableVector < AssetID::Index >> getInventoryPageField ( size_t page ) {
+    
+        return LedgerObjectFieldODBM < SerializableVector < AssetID::Index >>( this->mLedger, keyFor_inventoryPage ( this->mAccountID, page ));
+    }
+    
     //----------------------------------------------------------------//
     LedgerObjectFieldODBM < InventoryLogEntry > getInventoryLogEntryField ( u64 inventoryNonce ) {
     
@@ -44,6 +44,13 @@ public:
         return AssetFieldValue ();
     }
     
+    //----------------------------------------------------------------//
+    const AssetFieldValue* getFieldOrNull ( const string& name ) const {
+    
+        Fields::const_iterator fieldIt = this->mFields.find ( name );
+        return ( fieldIt != this->mFields.cend ()) ? &fieldIt->second : NULL;
+    }
+    
     //----------------------------------------------------------------//
     void AbstractSerializable_serializeFrom ( const AbstractSerializerFrom& serializer ) override {
         
@@ -18,12 +18,11 @@ bool AssetMethod::checkInvocation ( const map < string, shared_ptr < const Asset
     
         string paramName = assetArgIt->first;
         const AssetMethodParamDesc& arg = assetArgIt->second;
-        shared_ptr < const AbstractSquap > qualifier = arg.mQualifier;
         
         map < string, shared_ptr < const Asset >>::const_iterator assetParamIt = assetParams.find ( paramName );
         if ( assetParamIt == assetParams.end () || !assetParamIt->second ) return false;
 
-        if ( qualifier && !qualifier->evaluate ( SquapEvaluationContext ( assetParamIt->second ))) return false;
+        if ( !arg.qualifies ( assetParamIt->second )) return false;
     }
 
     ConstArgs::const_iterator constArgIt = this->mConstArgs.cbegin ();
@@ -31,21 +30,26 @@ bool AssetMethod::checkInvocation ( const map < string, shared_ptr < const Asset
     
         string paramName = constArgIt->first;
         const ConstMethodParamDesc& arg = constArgIt->second;
-        shared_ptr < const AbstractSquap > qualifier = arg.mQualifier;
             
         map < string, AssetFieldValue >::const_iterator constParamIt = constParams.find ( paramName );
         if ( constParamIt == constParams.end ()) return false;
         
-        if ( qualifier && !qualifier->evaluate ( SquapEvaluationContext ( constParamIt->second ))) return false;
+        if ( !arg.qualifies ( constParamIt->second )) return false;
     }
 
     if ( this->mConstraints.size () > 0 ) {
     
         SquapEvaluationContext context ( assetParams, constParams );
+        bool isCompiled = ( this->mConstraintPrograms.size () == this->mConstraints.size ());
     
-        Constraints::const_iterator constraintIt = this->mConstraints.cbegin ();
-        for ( ; constraintIt != this->mConstraints.cend (); ++constraintIt ) {
-            shared_ptr < const AbstractSquap > qualifier = *constraintIt;
+        for ( size_t i = 0; i < this->mConstraints.size (); ++i ) {
+        
+            if ( isCompiled && this->mConstraintPrograms [ i ]) {
+                if ( !this->mConstraintPrograms [ i ].evaluate ( context )) return false;
+                continue;
+            }
+        
+            shared_ptr < const AbstractSquap > qualifier = this->mConstraints [ i ];
             assert ( qualifier );
             if ( !qualifier->evaluate ( context )) return false;
         }
@@ -53,4 +57,24 @@ bool AssetMethod::checkInvocation ( const map < string, shared_ptr < const Asset
     return true;
 }
 
+//----------------------------------------------------------------//
+void AssetMethod::compile () {
+
+    this->mConstraintPrograms.clear ();
+    this->mConstraintPrograms.resize ( this->mConstraints.size ());
+    
+    for ( size_t i = 0; i < this->mConstraints.size (); ++i ) {
+        this->mConstraintPrograms [ i ].compile ( this->mConstraints [ i ].get ());
+    }
+}
+
+//----------------------------------------------------------------//
+bool AssetMethod::qualifyAssetArg ( string paramName, shared_ptr < const Asset > asset ) const {
+
+    AssetArgs::const_iterator assetArgIt = this->mAssetArgs.find ( paramName );
+    if ( assetArgIt == this->mAssetArgs.cend ()) return false;
+    
+    return assetArgIt->second.qualifies ( asset );
+}
+
 } // namespace Volition
@@ -8,6 +8,7 @@
 #include <volition/AssetFieldValue.h>
 #include <volition/serialization/Serialization.h>
 #include <volition/SquapFactory.h>
+#include <volition/SquapProgram.h>
 
 namespace Volition {
 
@@ -20,12 +21,23 @@ public:
 
     SerializableSharedPtr < AbstractSquap, SquapFactory >   mQualifier;
     bool                                                    mIsSubject;
+    SquapProgram                                            mProgram;       // compiled mQualifier
+    
+    //----------------------------------------------------------------//
+    bool qualifies ( shared_ptr < const Asset > asset ) const {
+        
+        if ( !asset ) return false;
+        if ( this->mProgram ) return ( bool )this->mProgram.evaluate ( *asset );
+        return this->mQualifier ? ( bool )this->mQualifier->evaluate ( SquapEvaluationContext ( asset )) : true;
+    }
     
     //----------------------------------------------------------------//
     void AbstractSerializable_serializeFrom ( const AbstractSerializerFrom& serializer ) override {
         
         serializer.serialize ( "qualifier",     this->mQualifier );
         serializer.serialize ( "isSubject",     this->mIsSubject );
+        
+        this->mProgram.compile ( this->mQualifier.get ());
     }
     
     //----------------------------------------------------------------//
@@ -46,6 +58,14 @@ public:
     SerializableSharedPtr < AbstractSquap, SquapFactory >   mQualifier;
     AssetFieldValue                                         mDefaultValue;
     SerializableOpaque                                      mInputScheme;
+    SquapProgram                                            mProgram;       // compiled mQualifier
+    
+    //----------------------------------------------------------------//
+    bool qualifies ( const AssetFieldValue& value ) const {
+        
+        if ( this->mProgram ) return ( bool )this->mProgram.evaluate ( value );
+        return this->mQualifier ? ( bool )this->mQualifier->evaluate ( SquapEvaluationContext ( value )) : true;
+    }
     
     //----------------------------------------------------------------//
     void AbstractSerializable_serializeFrom ( const AbstractSerializerFrom& serializer ) override {
@@ -53,6 +73,8 @@ public:
         serializer.serialize ( "qualifier",     this->mQualifier );
         serializer.serialize ( "defaultValue",  this->mDefaultValue );
         serializer.serialize ( "inputScheme",   this->mInputScheme );
+        
+        this->mProgram.compile ( this->mQualifier.get ());
     }
     
     //----------------------------------------------------------------//
@@ -87,8 +109,13 @@ public:
     // the standalone Lua script to run.
     string          mLua;
     
+    // mConstraints, compiled when the method is loaded.
+    vector < SquapProgram >     mConstraintPrograms;
+    
     //----------------------------------------------------------------//
     bool            checkInvocation             ( const map < string, shared_ptr < const Asset >>& assetParams, const map < string, AssetFieldValue >& constParams ) const;
+    void            compile                     ();
+    bool            qualifyAssetArg             ( string paramName, shared_ptr < const Asset > asset ) const;
 
     //----------------------------------------------------------------//
     void AbstractSerializable_serializeFrom ( const AbstractSerializerFrom& serializer ) override {
@@ -101,6 +128,8 @@ public:
         serializer.serialize ( "constArgs",         this->mConstArgs );
         serializer.serialize ( "constraints",       this->mConstraints );
         serializer.serialize ( "lua",               this->mLua );
+        
+        this->compile ();
     }
     
     //----------------------------------------------------------------//
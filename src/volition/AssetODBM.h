@@ -8,6 +8,7 @@
 #include <volition/Account.h>
 #include <volition/AccountODBM.h>
 #include <volition/Asset.h>
+#include <volition/AssetReadCache.h>
 #include <volition/Ledger.h>
 #include <volition/LedgerFieldODBM.h>
 #include <volition/LedgerKey.h>
@@ -87,20 +88,25 @@ public:
     //----------------------------------------------------------------//
     shared_ptr < const Asset > getAsset ( bool sparse = false ) {
 
+        AssetReadCache cache ( this->mLedger.getConst ());
+        return this->getAsset ( cache, sparse );
+    }
+    
+    //----------------------------------------------------------------//
+    shared_ptr < const Asset > getAsset ( AssetReadCache& cache, bool sparse = false ) {
+
+        // only a never-awarded asset lacks the key; a revoked one keeps it (as NULL_INDEX) and comes back ownerless.
         if ( !this->mOwner.exists ()) return NULL;
 
-        const Schema& schema = this->mLedger.getConst ().getSchema ();
+        string assetType = this->mType.get ();
 
-        const AssetDefinition* assetDefinition = schema.getDefinitionOrNull ( this->mType.get ());
+        const AssetDefinition* assetDefinition = cache.getDefinitionOrNull ( assetType );
         if ( !assetDefinition ) return NULL;
         
-        AccountID ownerAccountIndex = this->mOwner.get ();
-        AccountODBM ownerODBM ( this->mLedger, ownerAccountIndex );
-        
         shared_ptr < Asset > asset = make_shared < Asset >();
-        asset->mType            = this->mType.get ();
+        asset->mType            = assetType;
         asset->mAssetID         = this->mAssetID;
-        asset->mOwner           = ownerODBM.mName.get ();
+        asset->mOwner           = cache.getAccountName ( this->mOwner.get ());
         asset->mInventoryNonce  = this->mInventoryNonce.get ( 0 );
         asset->mOfferID         = this->mOffer.get ();
         
@@ -109,7 +115,7 @@ public:
         for ( ; fieldIt != assetDefinition->mFields.cend (); ++fieldIt ) {
         
             string fieldName = fieldIt->first;
-            AssetFieldValue value = this->getFieldValue ( fieldName, *assetDefinition, sparse );
+            AssetFieldValue value = this->getFieldValue ( fieldName, fieldIt->second, sparse );
             
             if ( value.isValid ()) {
                 asset->mFields [ fieldName ] = value;
@@ -121,7 +127,12 @@ public:
     //----------------------------------------------------------------//
     AssetFieldValue getFieldValue ( string fieldName, const AssetDefinition& assetDefinition, bool sparse = false ) {
 
-        const AssetFieldDefinition& fieldDefinition = assetDefinition.getField ( fieldName );
+        return this->getFieldValue ( fieldName, assetDefinition.getField ( fieldName ), sparse );
+    }
+    
+    //----------------------------------------------------------------//
+    AssetFieldValue getFieldValue ( string fieldName, const AssetFieldDefinition& fieldDefinition, bool sparse = false ) {
+
         if ( !fieldDefinition.isValid ()) return AssetFieldValue ();
         if ( !fieldDefinition.mMutable ) return fieldDefinition;
         
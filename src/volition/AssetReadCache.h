@@ -0,0 +1,77 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_ASSETREADCACHE_H
+#define VOLITION_ASSETREADCACHE_H
+
+#include <volition/common.h>
+#include <volition/Account.h>
+#include <volition/AccountODBM.h>
+#include <volition/Ledger.h>
+#include <volition/Schema.h>
+
+namespace Volition {
+
+//================================================================//
+// AssetReadCache
+//================================================================//
+// Memoizes the parts of asset materialization that repeat from asset to
+// asset: the schema (and its definitions) and owner account names. Only
+// valid for a single read against a ledger that doesn't change underneath
+// it; build one per request (or per inventory walk) and throw it away.
+class AssetReadCache {
+private:
+
+    const AbstractLedger&                       mLedger;
+    const Schema*                               mSchema;
+    map < string, const AssetDefinition* >      mDefinitions;
+    map < AccountID::Index, string >            mAccountNames;
+
+public:
+
+    //----------------------------------------------------------------//
+    AssetReadCache ( const AbstractLedger& ledger ) :
+        mLedger ( ledger ),
+        mSchema ( NULL ) {
+    }
+
+    //----------------------------------------------------------------//
+    string getAccountName ( AccountID::Index accountID ) {
+
+        map < AccountID::Index, string >::const_iterator nameIt = this->mAccountNames.find ( accountID );
+        if ( nameIt != this->mAccountNames.cend ()) return nameIt->second;
+
+        string name = AccountODBM ( this->mLedger, accountID ).mName.get ();
+        this->mAccountNames [ accountID ] = name;
+        return name;
+    }
+
+    //----------------------------------------------------------------//
+    const AssetDefinition* getDefinitionOrNull ( string assetType ) {
+
+        map < string, const AssetDefinition* >::const_iterator definitionIt = this->mDefinitions.find ( assetType );
+        if ( definitionIt != this->mDefinitions.cend ()) return definitionIt->second;
+
+        const AssetDefinition* definition = this->getSchema ().getDefinitionOrNull ( assetType );
+        this->mDefinitions [ assetType ] = definition;
+        return definition;
+    }
+
+    //----------------------------------------------------------------//
+    const Schema& getSchema () {
+
+        if ( !this->mSchema ) {
+            this->mSchema = &this->mLedger.getSchema ();
+        }
+        return *this->mSchema;
+    }
+
+    //----------------------------------------------------------------//
+    void setAccountName ( AccountID::Index accountID, string name ) {
+
+        this->mAccountNames [ accountID ] = name;
+    }
+};
+
+} // namespace Volition
+#endif
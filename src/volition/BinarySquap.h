@@ -27,7 +27,13 @@ public:
         AssetFieldValue lval = this->mLeft->evaluate ( context );
         AssetFieldValue rval = this->mRight->evaluate ( context );
         
-        switch ( this->mOpCode ) {
+        return BinarySquap::apply ( this->mOpCode, lval, rval );
+    }
+    
+    //----------------------------------------------------------------//
+    static AssetFieldValue apply ( OpCode opCode, const AssetFieldValue& lval, const AssetFieldValue& rval ) {
+        
+        switch ( opCode ) {
         
             case AND:
                 return AssetFieldValue::booleanAnd ( lval, rval );
@@ -1,14 +1,20 @@
 // Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
 // http://cryptogogue.com
 
+#include <volition/AbstractBlockStore.h>
 #include <volition/Block.h>
 #include <volition/BlockODBM.h>
 #include <volition/CryptoKey.h>
+#include <volition/DeferredBlock.h>
 #include <volition/Format.h>
 #include <volition/Ledger.h>
+#include <volition/LedgerWriteOverlay.h>
+#include <volition/Metrics.h>
 #include <volition/MonetaryPolicy.h>
+#include <volition/ThePoseCache.h>
 #include <volition/TheTransactionBodyFactory.h>
 #include <volition/Transaction.h>
+#include <volition/TransactionBatchVerifier.h>
 
 namespace Volition {
 
@@ -58,6 +64,7 @@ void Block::affirmHash () {
 LedgerResult Block::apply ( AbstractLedger& ledger, VerificationPolicy policy ) const {
     
     LGN_LOG_SCOPE ( VOL_FILTER_BLOCK, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_SPAN ( "volition_block_apply_seconds", "Wall time to verify and apply a block." );
 
     if ( ledger.getVersion () != this->mHeight ) return "Apply block: height/version mismatch.";
     
@@ -69,6 +76,7 @@ LedgerResult Block::apply ( AbstractLedger& ledger, VerificationPolicy policy )
     if ( !verifyResult ) return verifyResult;
 
     ledger.setRelease ( this->getRelease ());
+    ledger.affirmOpenOfferIndex ();
     ledger.expireOffers ( this->mTime );
 
     // some transactions need to be applied later.
@@ -82,6 +90,13 @@ LedgerResult Block::apply ( AbstractLedger& ledger, VerificationPolicy policy )
     // if a block is removed or added from the list, flag it.
     // if it's been flagged, record it in the ledger at the end.
 
+    // the unfinished list is consensus state, and is kept exactly as it always has been: a block
+    // is scheduled once, at its latest maturity (so only the transactions maturing there are
+    // ever applied), and whenever the list changes, entries that aren't due yet are dropped.
+    // the transactions themselves are copied out (under keyFor_deferred) when the block is
+    // applied, so a due block doesn't have to be loaded and parsed again. a copy is cleared
+    // as soon as its entry leaves the list, whether it was applied or dropped.
+
     // apply the entropy up front.
     this->applyEntropy ( ledger );
 
@@ -96,11 +111,8 @@ LedgerResult Block::apply ( AbstractLedger& ledger, VerificationPolicy policy )
         
         if ( unfinishedBlock.mMaturity == this->mHeight ) {
             
-            shared_ptr < const Block > block = ledger.getBlock ( unfinishedBlock.mBlockID );
-            assert ( block );
-            
             size_t nextMaturity;
-            LedgerResult transactionsResult = block->applyTransactions ( ledger, policy, nextMaturity );
+            LedgerResult transactionsResult = Block::applyUnfinished ( ledger, policy, unfinishedBlock, nextMaturity );
             if ( !transactionsResult ) return transactionsResult;
             
             if ( nextMaturity > this->mHeight ) {
@@ -130,9 +142,21 @@ LedgerResult Block::apply ( AbstractLedger& ledger, VerificationPolicy policy )
     
     // check pending block list, and apply if changed.
     if ( unfinishedChanged ) {
+    
+        // entries that weren't due are dropped, and so are their copies.
+        for ( unfinishedBlockIt = unfinished.mBlocks.cbegin (); unfinishedBlockIt != unfinished.mBlocks.cend (); ++unfinishedBlockIt ) {
+            if ( unfinishedBlockIt->mMaturity != this->mHeight ) {
+                ledger.clearDeferred ( unfinishedBlockIt->mMaturity );
+            }
+        }
         ledger.setUnfinished ( nextUnfinished );
     }
     
+    // copied out last, so clearing a dropped entry at the same height can't take it with it.
+    if ( nextMaturity > this->mHeight ) {
+        this->deferTransactions ( ledger, nextMaturity );
+    }
+    
     BlockODBM blockODBM ( ledger, this->mHeight );
     
     string hash = this->mDigest.toHex ();
@@ -140,7 +164,11 @@ LedgerResult Block::apply ( AbstractLedger& ledger, VerificationPolicy policy )
     blockODBM.mHash.set ( this->mDigest.toHex ());
     blockODBM.mPose.set ( this->mPose.toHex ());
     blockODBM.mHeader.set ( *this );
-    blockODBM.mBlock.set ( *this );
+    
+    // with a block store, the body is written by AbstractLedger::pushBlock once the block is committed.
+    if ( !ledger.mBlockStore ) {
+        blockODBM.mBlock.set ( *this );
+    }
 
     return true;
 }
@@ -148,44 +176,57 @@ LedgerResult Block::apply ( AbstractLedger& ledger, VerificationPolicy policy )
 //----------------------------------------------------------------//
 LedgerResult Block::applyTransactions ( AbstractLedger& ledger, VerificationPolicy policy, size_t& nextMaturity ) const {
 
-    LGN_LOG_SCOPE ( VOL_FILTER_BLOCK, INFO, __PRETTY_FUNCTION__ );
-
     if ( !this->mBody ) return false;
 
-    nextMaturity = this->mHeight;
     size_t height = ledger.getVersion ();
 
     assert ( this->mHeight == height );
 
-    AccountODBM accountODBM ( ledger, this->mMinerID );
+    vector < const Transaction* > maturing;
+    nextMaturity = this->getMaturing ( height, maturing );
+    return Block::applyTransactions ( ledger, policy, this->mMinerID, this->mBody->mReward, this->getRelease (), this->mTime, maturing );
+}
+
+//----------------------------------------------------------------//
+LedgerResult Block::applyTransactions ( AbstractLedger& ledger, VerificationPolicy policy, string minerID, string reward, u64 release, time_t time, const vector < const Transaction* >& maturing ) {
+
+    VOL_METRIC_SPAN ( "volition_block_apply_transactions_seconds", "Wall time to apply a block's matured transactions and rewards." );
+
+    size_t height = ledger.getVersion ();
+
+    AccountODBM accountODBM ( ledger, minerID );
     assert ( accountODBM || ledger.isGenesis ());
 
     size_t gratuity         = 0;
     size_t profitShare      = 0;
     size_t transferTax      = 0;
 
-    if ( ledger.getVersion () >= this->mHeight ) {
-        
+    {
         LGN_LOG_SCOPE ( VOL_FILTER_BLOCK, INFO, "Apply transactions" );
         
+        // check signatures of the transactions maturing now in parallel, up front.
+        TransactionBatchVerifier verifier;
+        verifier.verify ( ledger, maturing, TransactionBatchVerifier::IN_ORDER, policy );
+        
         // apply block transactions.
-        for ( size_t i = 0; i < this->mBody->mTransactions.size (); ++i ) {
-            const Transaction& transaction = *this->mBody->mTransactions [ i ];
+        for ( size_t i = 0; i < maturing.size (); ++i ) {
+        
+            if ( !maturing [ i ]) continue;
+            const Transaction& transaction = *maturing [ i ];
             
-            size_t transactionMaturity = this->mHeight + transaction.getMaturity ();
-            if ( transactionMaturity == height ) {
+            // each transaction's repeated writes to the same keys reach the store once.
+            LedgerWriteOverlay overlay ( ledger );
             
-                TransactionResult result = transaction.apply ( ledger, height, this->getRelease (), i, this->mTime, policy );
-                if ( !result ) return Format::write ( "%s: %s", result.getUUID ().c_str (), result.getMessage ().c_str ());
-                
-                gratuity        += transaction.getGratuity ();
-                profitShare     += transaction.getProfitShare ();
-                transferTax     += transaction.getTransferTax ();
-            }
+            TransactionResult result = transaction.apply ( ledger, height, release, i, time, verifier.getPolicy ( transaction, policy ));
+            if ( !result ) return Format::write ( "%s: %s", result.getUUID ().c_str (), result.getMessage ().c_str ());
             
-            if ( nextMaturity < transactionMaturity ) {
-                nextMaturity = transactionMaturity;
-            }
+            overlay.commit ();
+            
+            VOL_METRIC_COUNT ( "volition_transactions_applied_total", "Transactions applied to the ledger (including replays on rewind).", 1 );
+            
+            gratuity        += transaction.getGratuity ();
+            profitShare     += transaction.getProfitShare ();
+            transferTax     += transaction.getTransferTax ();
         }
     }
     
@@ -195,7 +236,7 @@ LedgerResult Block::applyTransactions ( AbstractLedger& ledger, VerificationPoli
     
         {
             LGN_LOG_SCOPE ( VOL_FILTER_BLOCK, INFO, "Invoke reward script" );
-            ledger.invokeReward ( this->mMinerID, this->mBody->mReward, this->mTime );
+            ledger.invokeReward ( minerID, reward, time );
         }
         
         {
@@ -235,6 +276,43 @@ LedgerResult Block::applyTransactions ( AbstractLedger& ledger, VerificationPoli
     return true;
 }
 
+//----------------------------------------------------------------//
+LedgerResult Block::applyUnfinished ( AbstractLedger& ledger, VerificationPolicy policy, const UnfinishedBlock& unfinishedBlock, size_t& nextMaturity ) {
+
+    // a block is only ever scheduled at its latest maturity, so once it's due nothing is left.
+    nextMaturity = unfinishedBlock.mMaturity;
+
+    // the entry is consumed either way, so its copy goes now.
+    DeferredBlockList deferred = ledger.getDeferred ( unfinishedBlock.mMaturity );
+    ledger.clearDeferred ( unfinishedBlock.mMaturity );
+    
+    DeferredBlockList::Iterator deferredBlockIt = deferred.mBlocks.cbegin ();
+    for ( ; deferredBlockIt != deferred.mBlocks.cend (); ++deferredBlockIt ) {
+    
+        const DeferredBlock& deferredBlock = *deferredBlockIt;
+        if ( deferredBlock.mBlockID != unfinishedBlock.mBlockID ) continue;
+        
+        vector < const Transaction* > maturing;
+        SerializableList < DeferredTransaction >::const_iterator transactionIt = deferredBlock.mTransactions.cbegin ();
+        for ( ; transactionIt != deferredBlock.mTransactions.cend (); ++transactionIt ) {
+            if ( maturing.size () <= transactionIt->mIndex ) {
+                maturing.resize ( transactionIt->mIndex + 1, NULL );
+            }
+            maturing [ transactionIt->mIndex ] = transactionIt->mTransaction.get ();
+        }
+        return Block::applyTransactions ( ledger, policy, deferredBlock.mMinerID, deferredBlock.mReward, deferredBlock.mRelease, deferredBlock.mTime, maturing );
+    }
+
+    // scheduled before the transactions were copied out, so they have to come from the block.
+    shared_ptr < const Block > block = ledger.getBlock ( unfinishedBlock.mBlockID );
+    assert ( block );
+    if ( !block->mBody ) return false;
+
+    vector < const Transaction* > maturing;
+    nextMaturity = block->getMaturing ( ledger.getVersion (), maturing );
+    return Block::applyTransactions ( ledger, policy, block->mMinerID, block->mBody->mReward, block->getRelease (), block->mTime, maturing );
+}
+
 //----------------------------------------------------------------//
 Block::Block () :
     mBodyType ( 0 ) {
@@ -259,6 +337,55 @@ size_t Block::countTransactions () const {
     return this->mBody ? this->mBody->mTransactions.size () : 0;
 }
 
+//----------------------------------------------------------------//
+void Block::deferTransactions ( AbstractLedger& ledger, u64 maturity ) const {
+
+    if ( !this->mBody ) return;
+
+    DeferredBlock deferredBlock;
+    deferredBlock.mBlockID      = this->mHeight;
+    deferredBlock.mMinerID      = this->mMinerID;
+    deferredBlock.mReward       = this->mBody->mReward;
+    deferredBlock.mRelease      = this->getRelease ();
+    deferredBlock.mTime         = this->mTime;
+
+    for ( size_t i = 0; i < this->mBody->mTransactions.size (); ++i ) {
+        if (( this->mHeight + this->mBody->mTransactions [ i ]->getMaturity ()) == maturity ) {
+        
+            DeferredTransaction deferredTransaction;
+            deferredTransaction.mIndex          = i;
+            deferredTransaction.mTransaction    = this->mBody->mTransactions [ i ];
+            deferredBlock.mTransactions.push_back ( deferredTransaction );
+        }
+    }
+
+    // copies are cleared as their entries leave the unfinished list, and this block is the only
+    // entry scheduled at its maturity, so the list at that height holds just this one.
+    DeferredBlockList deferred;
+    deferred.mBlocks.push_back ( deferredBlock );
+    ledger.setDeferred ( maturity, deferred );
+}
+
+//----------------------------------------------------------------//
+size_t Block::getMaturing ( u64 height, vector < const Transaction* >& maturing ) const {
+
+    // only the transactions maturing at the given height; returns the block's latest maturity.
+    size_t nextMaturity = this->mHeight;
+    if ( !this->mBody || ( height < this->mHeight )) return nextMaturity;
+
+    for ( size_t i = 0; i < this->mBody->mTransactions.size (); ++i ) {
+        const Transaction& transaction = *this->mBody->mTransactions [ i ];
+        
+        size_t transactionMaturity = this->mHeight + transaction.getMaturity ();
+        maturing.push_back ( transactionMaturity == height ? &transaction : NULL );
+        
+        if ( nextMaturity < transactionMaturity ) {
+            nextMaturity = transactionMaturity;
+        }
+    }
+    return nextMaturity;
+}
+
 //----------------------------------------------------------------//
 const Transaction* Block::getTransaction ( u64 index ) const {
 
@@ -329,7 +456,7 @@ LedgerResult Block::verify ( const AbstractLedger& ledger, VerificationPolicy po
 
         if ( policy & VerificationPolicy::VERIFY_POSE ) {
             Digest digest = this->hashPose ( prevPoseHex );
-            if ( !key.verify ( this->mPose, digest )) return "Verify block: invalid POSE.";
+            if ( !ThePoseCache::get ().verify ( key, this->mPose, digest )) return "Verify block: invalid POSE.";
         }
 
         if ( policy & VerificationPolicy::VERIFY_CHARM ) {
@@ -359,7 +486,7 @@ void Block::affirmBody () {
     shared_ptr < BlockBody > body = make_shared < BlockBody >();
 
     if ( this->mBodyString.size ()) {
-        FromJSONSerializer::fromJSONString ( *body, this->mBodyString );
+        FromJSONStreamSerializer::fromJSONString ( *body, this->mBodyString );
     }
     this->mBody = body;
 }
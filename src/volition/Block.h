@@ -12,6 +12,7 @@ namespace Volition {
 
 class AbstractLedger;
 class Transaction;
+class UnfinishedBlock;
 
 //================================================================//
 // BlockBody
@@ -26,7 +27,6 @@ private:
 
     string              mReward;
 
-    // TODO: store these in a map indexed by maturity (so we don't have to traverse all transactions when handling deferred transactions)
     SerializableVector < SerializableSharedConstPtr < Transaction >> mTransactions;
     
     //----------------------------------------------------------------//
@@ -69,6 +69,10 @@ private:
     //----------------------------------------------------------------//
     void                    affirmBody                          ();
     LedgerResult            applyTransactions                   ( AbstractLedger& ledger, VerificationPolicy policy, size_t& nextMaturity ) const;
+    static LedgerResult     applyTransactions                   ( AbstractLedger& ledger, VerificationPolicy policy, string minerID, string reward, u64 release, time_t time, const vector < const Transaction* >& maturing );
+    static LedgerResult     applyUnfinished                     ( AbstractLedger& ledger, VerificationPolicy policy, const UnfinishedBlock& unfinishedBlock, size_t& nextMaturity );
+    void                    deferTransactions                   ( AbstractLedger& ledger, u64 maturity ) const;
+    size_t                  getMaturing                         ( u64 height, vector < const Transaction* >& maturing ) const;
     size_t                  getWeight                           () const;
     
     //----------------------------------------------------------------//
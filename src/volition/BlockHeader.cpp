@@ -4,6 +4,7 @@
 #include <volition/BlockHeader.h>
 #include <volition/Format.h>
 #include <volition/Ledger.h>
+#include <volition/ThePoseCache.h>
 
 namespace Volition {
 
@@ -38,7 +39,7 @@ void BlockHeader::initialize ( string minerID, u64 release, const Digest& visage
         this->mHeight       = prevBlockHeader->mHeight + 1;
         this->mPrevDigest   = prevBlockHeader->mDigest;
         
-        this->mPose         = key.sign ( this->hashPose ( prevBlockHeader->mPose.toHex ()), Digest::HASH_ALGORITHM_SHA256 );
+        this->mPose         = ThePoseCache::get ().sign ( key, this->hashPose ( prevBlockHeader->mPose.toHex ()), Digest::HASH_ALGORITHM_SHA256 );
         this->mCharm        = prevBlockHeader->getNextCharm ( visage );
     }
 }
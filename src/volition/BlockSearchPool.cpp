@@ -38,6 +38,7 @@ bool BlockSearch::extendSearch ( BlockSearchPool& pool ) {
 
     // get all the miners that are active and not already in searches
     map < string, shared_ptr < RemoteMiner >> remoteMinersByName;
+    size_t busy = 0;
     set < shared_ptr < RemoteMiner >>::iterator remoteMinerIt = miner.mRemoteMiners.begin ();
     for ( ; remoteMinerIt != miner.mRemoteMiners.end (); ++remoteMinerIt ) {
     
@@ -49,6 +50,12 @@ bool BlockSearch::extendSearch ( BlockSearchPool& pool ) {
         if ( this->mCompletedMiners.find ( minerID ) != this->mCompletedMiners.end ()) continue;
         if ( this->mActiveMiners.find ( minerID ) != this->mActiveMiners.end ()) continue;
         
+        // miners with a full request window may still have the block; wait for them.
+        if ( !remoteMiner->canFetchBlock ()) {
+            busy++;
+            continue;
+        }
+        
         remoteMinersByName [ remoteMiner->getMinerID ()] = remoteMiner;
     }
 
@@ -57,16 +64,36 @@ bool BlockSearch::extendSearch ( BlockSearchPool& pool ) {
     for ( size_t i = 0; (( i < sampleSize ) && ( remoteMinersByName.size () > 0 )); ++i ) {
     
         // if the block's miner is online, make sure that miner is in the first batch of searches.
+        // otherwise, prefer the miner with the most room in its request window.
         map < string, shared_ptr < RemoteMiner >>::iterator remoteMinerByNameIt = remoteMinersByName.find ( cursor.getMinerID ());
         if ( remoteMinerByNameIt == remoteMinersByName.end ()) {
+        
             remoteMinerByNameIt = remoteMinersByName.begin ();
             advance ( remoteMinerByNameIt, ( long )( UnsecureRandom::get ().random ( 0, remoteMinersByName.size () - 1 )));
+            
+            size_t bestRoom = 0;
+            map < string, shared_ptr < RemoteMiner >>::iterator candidateIt = remoteMinerByNameIt;
+            for ( size_t j = 0; j < remoteMinersByName.size (); ++j ) {
+            
+                const RemoteMiner& candidate = *candidateIt->second;
+                size_t room = candidate.mBlockWindow - candidate.mBlocksInFlight;
+                if ( bestRoom < room ) {
+                    bestRoom = room;
+                    remoteMinerByNameIt = candidateIt;
+                }
+                if ( ++candidateIt == remoteMinersByName.end ()) {
+                    candidateIt = remoteMinersByName.begin ();
+                }
+            }
         }
         
         shared_ptr < RemoteMiner > remoteMiner = remoteMinerByNameIt->second;
         remoteMinersByName.erase ( remoteMinerByNameIt );
         
         this->mActiveMiners.insert ( remoteMiner->getMinerID ());
+        this->mRequestTimes [ remoteMiner->getMinerID ()] = chrono::high_resolution_clock::now ();
+        remoteMiner->beginBlockRequest ();
+        
         miner.mMessenger->enqueueBlockRequest (
             remoteMiner->mURL,
             cursor.getDigest (),
@@ -75,7 +102,36 @@ bool BlockSearch::extendSearch ( BlockSearchPool& pool ) {
         );
     }
     
-    return ( this->mActiveMiners.size () > 0 );
+    return (( this->mActiveMiners.size () > 0 ) || ( busy > 0 ));
+}
+
+//----------------------------------------------------------------//
+void BlockSearch::expireRequests ( BlockSearchPool& pool ) {
+
+    Miner& miner = pool.mMiner;
+    chrono::high_resolution_clock::time_point now = chrono::high_resolution_clock::now ();
+
+    // give up on miners that are taking much longer than usual; the search moves on to
+    // another miner. a late answer is still accepted (see BlockSearchPool::updateBlockSearch).
+    set < string > activeMiners = this->mActiveMiners;
+    set < string >::const_iterator activeIt = activeMiners.cbegin ();
+    for ( ; activeIt != activeMiners.cend (); ++activeIt ) {
+    
+        string minerID = *activeIt;
+        
+        map < string, shared_ptr < RemoteMiner >>::iterator remoteMinerIt = miner.mRemoteMinersByID.find ( minerID );
+        shared_ptr < RemoteMiner > remoteMiner = ( remoteMinerIt != miner.mRemoteMinersByID.end ()) ? remoteMinerIt->second : NULL;
+        
+        if ( remoteMiner ) {
+            double elapsed = chrono::duration_cast < chrono::milliseconds >( now - this->mRequestTimes [ minerID ]).count () * 0.001;
+            if ( elapsed < remoteMiner->getBlockTimeout ()) continue;
+            remoteMiner->timeoutBlockRequest ();
+        }
+        
+        this->mCompletedMiners.insert ( minerID );
+        this->mActiveMiners.erase ( minerID );
+        this->mRequestTimes.erase ( minerID );
+    }
 }
 
 //----------------------------------------------------------------//
@@ -83,7 +139,7 @@ void BlockSearch::initialize ( BlockTreeCursor cursor ) {
 
     this->mTag      = cursor.write ();
     this->mHeight   = cursor.getHeight ();
-    this->mHash     = cursor.getHash ();
+    this->mHash     = cursor.getDigest ();
 }
 
 //----------------------------------------------------------------//
@@ -100,6 +156,8 @@ bool BlockSearch::step ( BlockSearchPool& pool ) {
     
     if ( cursor.hasBlock ()) return false;
     if ( miner.mRemoteMiners.size () == 0 ) return true;
+    
+    this->expireRequests ( pool );
     if ( this->extendSearch ( pool )) return true;
     
     if ( this->mRetries < MAX_RETRIES ) {
@@ -115,9 +173,12 @@ bool BlockSearch::step ( BlockSearchPool& pool ) {
 //----------------------------------------------------------------//
 void BlockSearch::step ( string minerID ) {
 
-    assert ( this->mActiveMiners.find ( minerID ) != this->mActiveMiners.cend ());
+    // the request may already have been given up on as too slow.
+    if ( this->mActiveMiners.find ( minerID ) == this->mActiveMiners.cend ()) return;
+    
     this->mCompletedMiners.insert ( minerID );
     this->mActiveMiners.erase ( minerID );
+    this->mRequestTimes.erase ( minerID );
 }
 
 //================================================================//
@@ -146,7 +207,7 @@ void BlockSearchPool::affirmBranchSearch ( BlockTreeCursor cursor ) {
         if ( branchStatus == BRANCH_STATUS_INVALID ) continue;
         
         // see if a search is already in progress.
-        string hash = cursor.getDigest ();
+        Digest256 hash ( cursor.getDigest ());
         if ( this->mBlockSearchesByHash.find ( hash ) != this->mBlockSearchesByHash.end ()) return; // already searching (this and all parents)
 
         // create the search.
@@ -160,7 +221,10 @@ void BlockSearchPool::affirmBranchSearch ( BlockTreeCursor cursor ) {
 BlockSearchPool::BlockSearchPool ( Miner& miner, AbstractBlockTree& blockTree ) :
     mMiner ( miner ),
     mBlockTree ( blockTree ),
-    mMaxSearches ( MAX_SEARCHES ) {
+    mMaxSearches ( MAX_SEARCHES ),
+    mBlocksFound ( 0 ),
+    mBlockRate ( 0.0 ),
+    mRateT0 ( chrono::high_resolution_clock::now ()) {
 }
 
 //----------------------------------------------------------------//
@@ -180,9 +244,9 @@ size_t BlockSearchPool::countSearches () const {
 }
 
 //----------------------------------------------------------------//
-void BlockSearchPool::erase ( string hash ) {
+void BlockSearchPool::erase ( Digest256 hash ) {
 
-    map < string, BlockSearch >::iterator blockSearchIt = this->mBlockSearchesByHash.find ( hash );
+    BlockSearchesByHash::iterator blockSearchIt = this->mBlockSearchesByHash.find ( hash );
     if ( blockSearchIt != this->mBlockSearchesByHash.end ()) {
     
         BlockSearchKey key ( blockSearchIt->second );
@@ -196,12 +260,28 @@ void BlockSearchPool::erase ( string hash ) {
 //----------------------------------------------------------------//
 BlockSearch* BlockSearchPool::findBlockSearch ( const Digest& digest ) {
 
-    map < string, BlockSearch >::iterator searchIt = this->mBlockSearchesByHash.find ( digest.toHex ());
+    BlockSearchesByHash::iterator searchIt = this->mBlockSearchesByHash.find ( digest );
     if ( searchIt == this->mBlockSearchesByHash.cend ()) return NULL; // no search; bail.
     
     return &searchIt->second;
 }
 
+//----------------------------------------------------------------//
+size_t BlockSearchPool::getWindow () const {
+
+    // keep about two searches ready for every request slot the online miners offer,
+    // so a slot that frees up can be refilled on the next step.
+    size_t capacity = 0;
+    set < shared_ptr < RemoteMiner >>::const_iterator remoteMinerIt = this->mMiner.mOnlineMiners.cbegin ();
+    for ( ; remoteMinerIt != this->mMiner.mOnlineMiners.cend (); ++remoteMinerIt ) {
+        capacity += ( *remoteMinerIt )->mBlockWindow;
+    }
+    
+    size_t window = capacity * 2;
+    window = window > 0 ? window : 1;
+    return window < this->mMaxSearches ? window : this->mMaxSearches;
+}
+
 //----------------------------------------------------------------//
 void BlockSearchPool::reportBlockSearches () const {
 
@@ -213,7 +293,7 @@ void BlockSearchPool::reportBlockSearches () const {
         
         LGN_LOG ( VOL_FILTER_MINING_SEARCH_REPORT, INFO, "BLOCK SEARCH %d: %s", ( int )i, blockSearch.mTag.c_str ());
         
-        LGN_LOG ( VOL_FILTER_MINING_SEARCH_REPORT, INFO, "    HASH: %s", blockSearch.mHash.c_str ());
+        LGN_LOG ( VOL_FILTER_MINING_SEARCH_REPORT, INFO, "    HASH: %s", blockSearch.mHash.toHex ().c_str ());
         
         set < string >::const_iterator activeIt = blockSearch.mActiveMiners.begin ();
         for ( ; activeIt != blockSearch.mActiveMiners.end (); ++activeIt ) {
@@ -239,15 +319,25 @@ void BlockSearchPool::update () {
 
     LGN_LOG_SCOPE ( VOL_FILTER_CONSENSUS, INFO, __PRETTY_FUNCTION__ );
     
-    if ( this->mActiveSearches.size () < ( this->mMaxSearches / 4 )) {
-        while (( this->mActiveSearches.size () < this->mMaxSearches ) && ( this->mPendingSearches.size ())) {
+    chrono::high_resolution_clock::time_point now = chrono::high_resolution_clock::now ();
+    double elapsed = chrono::duration_cast < chrono::milliseconds >( now - this->mRateT0 ).count () * 0.001;
+    if ( elapsed >= RATE_INTERVAL ) {
+        double rate = ( double )this->mBlocksFound / elapsed;
+        this->mBlockRate = ( this->mBlockRate > 0.0 ) ? (( this->mBlockRate + rate ) * 0.5 ) : rate;
+        this->mBlocksFound = 0;
+        this->mRateT0 = now;
+    }
+    
+    // sliding window: pending searches are ordered by height, so the lowest missing blocks
+    // are always the ones in flight.
+    size_t window = this->getWindow ();
+    while (( this->mActiveSearches.size () < window ) && ( this->mPendingSearches.size ())) {
+    
+        set < BlockSearchKey >::iterator next = this->mPendingSearches.begin ();
+        BlockSearchKey key = *next;
         
-            set < BlockSearchKey >::iterator next = this->mPendingSearches.begin ();
-            BlockSearchKey key = *next;
-            
-            this->mActiveSearches.insert ( key );
-            this->mPendingSearches.erase ( next );
-        }
+        this->mActiveSearches.insert ( key );
+        this->mPendingSearches.erase ( next );
     }
     
     // step the currently active block searches
@@ -270,17 +360,30 @@ void BlockSearchPool::update () {
 }
 
 //----------------------------------------------------------------//
-void BlockSearchPool::updateBlockSearch ( string minerID, string hash, bool found ) {
+void BlockSearchPool::updateBlockSearch ( RemoteMiner& remoteMiner, const Digest256& hash, bool found ) {
+
+    string minerID = remoteMiner.getMinerID ();
+    double latency = -1.0;
 
-    map < string, BlockSearch >::iterator blockSearchIt = this->mBlockSearchesByHash.find ( hash );
+    BlockSearchesByHash::iterator blockSearchIt = this->mBlockSearchesByHash.find ( hash );
     if ( blockSearchIt != this->mBlockSearchesByHash.end ()) {
+    
+        BlockSearch& blockSearch = blockSearchIt->second;
+    
+        map < string, chrono::high_resolution_clock::time_point >::const_iterator requestTimeIt = blockSearch.mRequestTimes.find ( minerID );
+        if ( requestTimeIt != blockSearch.mRequestTimes.cend ()) {
+            latency = chrono::duration_cast < chrono::milliseconds >( chrono::high_resolution_clock::now () - requestTimeIt->second ).count () * 0.001;
+        }
+    
         if ( found ) {
+            this->mBlocksFound++;
             this->erase ( blockSearchIt->first );
         }
         else {
-            blockSearchIt->second.step ( minerID );
+            blockSearch.step ( minerID );
         }
     }
+    remoteMiner.endBlockRequest ( latency );
 }
 
 } // namespace Volition
@@ -11,6 +11,7 @@
 #include <volition/PayoutPolicy.h>
 #include <volition/TransactionFeeSchedule.h>
 #include <volition/CryptoKey.h>
+#include <volition/Digest256.h>
 #include <volition/Ledger.h>
 #include <volition/RemoteMiner.h>
 #include <volition/TransactionQueue.h>
@@ -34,7 +35,7 @@ protected:
     friend class BlockSearchPool;
     friend class BlockSearchKey;
 
-    static const size_t SAMPLE_SIZE     = 4;
+    static const size_t SAMPLE_SIZE     = 1;    // miners asked at once; slow miners are replaced, not doubled up
     static const size_t MAX_RETRIES     = 16;
 
     friend class Miner;
@@ -42,13 +43,17 @@ protected:
     bool                mActive;
 
     string              mTag;
-    string              mHash;
+    Digest256           mHash;
     u64                 mHeight;
     set < string >      mActiveMiners;
     set < string >      mCompletedMiners;
     size_t              mRetries;
 
-    chrono::high_resolution_clock::time_point   mT0;
+    chrono::high_resolution_clock::time_point                   mT0;
+    map < string, chrono::high_resolution_clock::time_point >   mRequestTimes;
+
+    //----------------------------------------------------------------//
+    void                    expireRequests                  ( BlockSearchPool& pool );
 
 public:
 
@@ -91,19 +96,27 @@ protected:
     friend class BlockSearch;
     
     static const size_t MAX_SEARCHES = 256;
+    static constexpr double RATE_INTERVAL = 5.0; // seconds between block rate samples
 
     Miner&                          mMiner;
     AbstractBlockTree&              mBlockTree;
     set < BlockSearchKey >          mActiveSearches;
-    map < string, BlockSearch >     mBlockSearchesByHash;
+    typedef unordered_map < Digest256, BlockSearch, Digest256::Hash > BlockSearchesByHash;
+
+    BlockSearchesByHash             mBlockSearchesByHash;
     set < BlockSearchKey >          mPendingSearches;
     size_t                          mMaxSearches;
+    
+    size_t                                      mBlocksFound;
+    double                                      mBlockRate;     // blocks per second, smoothed
+    chrono::high_resolution_clock::time_point   mRateT0;
 
     //----------------------------------------------------------------//
-    void                    erase                           ( string hash );
+    void                    erase                           ( Digest256 hash );
 
 public:
     
+    GET ( double,       BlockRate,      mBlockRate )
     GET_SET ( size_t,   MaxSearches,    mMaxSearches )
     
     //----------------------------------------------------------------//
@@ -113,9 +126,10 @@ public:
     size_t                  countActiveSearches             () const;
     size_t                  countSearches                   () const;
     BlockSearch*            findBlockSearch                 ( const Digest& digest );
+    size_t                  getWindow                       () const;
     void                    reportBlockSearches             () const;
     void                    update                          ();
-    void                    updateBlockSearch               ( string minerID, string hash, bool found );
+    void                    updateBlockSearch               ( RemoteMiner& remoteMiner, const Digest256& hash, bool found );
 };
 
 } // namespace Volition
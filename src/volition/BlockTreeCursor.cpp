@@ -4,6 +4,7 @@
 #include <volition/AbstractBlockTree.h>
 #include <volition/Block.h>
 #include <volition/BlockTreeCursor.h>
+#include <volition/Metrics.h>
 
 // To compare chains:
 // 1. Find the common root.
@@ -106,7 +107,7 @@ bool BlockTreeCursor::hasParent () const {
 //----------------------------------------------------------------//
 bool BlockTreeCursor::isAncestorOf ( BlockTreeCursor tail ) const {
 
-    LGN_LOG_SCOPE ( VOL_FILTER_CONSENSUS, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_COUNT ( "volition_block_tree_ancestor_checks_total", "Calls to BlockTreeCursor::isAncestorOf.", 1 );
 
     assert ( this->mHeader );
     assert ( tail.mHeader );
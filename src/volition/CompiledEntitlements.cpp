@@ -0,0 +1,74 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <volition/CompiledEntitlements.h>
+#include <algorithm>
+
+namespace Volition {
+
+//================================================================//
+// CompiledEntitlements
+//================================================================//
+
+//----------------------------------------------------------------//
+bool CompiledEntitlements::check ( string path ) const {
+
+    unordered_map < string, size_t >::const_iterator indexIt = this->mIndex.find ( path );
+    if ( indexIt != this->mIndex.cend ()) return this->mAllowed [ indexIt->second ];
+
+    const AbstractEntitlement* leaf = this->mEntitlements->resolvePath ( path );
+    return leaf ? leaf->check () : false;
+}
+
+//----------------------------------------------------------------//
+void CompiledEntitlements::compile ( string path, const AbstractEntitlement* node ) {
+
+    assert ( node );
+
+    this->mIndex [ path ] = this->mLeaves.size ();
+    this->mAllowed.push_back ( node->check ());
+    this->mLeaves.push_back ( node );
+
+    const PathEntitlement* branch = dynamic_cast < const PathEntitlement* >( node );
+    if ( !branch ) return;
+
+    PathEntitlement::Children::const_iterator childIt = branch->mChildren.cbegin ();
+    for ( ; childIt != branch->mChildren.cend (); ++childIt ) {
+        if ( !childIt->second ) continue;
+        
+        // resolvePath () splits on the delimiter, so names that are empty or contain one can't be reached.
+        const string& name = childIt->first;
+        if (( name.size () == 0 ) || ( find_if ( name.cbegin (), name.cend (), PathEntitlement::isDelimiter ) != name.cend ())) continue;
+        
+        this->compile ( path.size () ? path + "." + name : name, childIt->second.get ());
+    }
+}
+
+//----------------------------------------------------------------//
+CompiledEntitlements::CompiledEntitlements ( shared_ptr < const Entitlements > entitlements ) :
+    mEntitlements ( entitlements ) {
+
+    assert ( entitlements );
+    this->compile ( "", entitlements.get ());
+}
+
+//----------------------------------------------------------------//
+CompiledEntitlements::~CompiledEntitlements () {
+}
+
+//----------------------------------------------------------------//
+const Entitlements& CompiledEntitlements::getEntitlements () const {
+
+    return *this->mEntitlements;
+}
+
+//----------------------------------------------------------------//
+const AbstractEntitlement* CompiledEntitlements::resolvePath ( string path ) const {
+
+    unordered_map < string, size_t >::const_iterator indexIt = this->mIndex.find ( path );
+    if ( indexIt != this->mIndex.cend ()) return this->mLeaves [ indexIt->second ];
+
+    return this->mEntitlements->resolvePath ( path );
+}
+
+} // namespace Volition
@@ -0,0 +1,61 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_COMPILEDENTITLEMENTS_H
+#define VOLITION_COMPILEDENTITLEMENTS_H
+
+#include <volition/common.h>
+#include <volition/Entitlements.h>
+#include <unordered_map>
+
+namespace Volition {
+
+//================================================================//
+// CompiledEntitlements
+//================================================================//
+// A resolved (base plus restrictions) entitlements tree, flattened so that
+// checks don't walk it: every node's full dotted path maps to a slot in a
+// permission bitset (the node's unconditional check ()) and in a leaf table
+// used for numeric limit checks. Immutable once built, so one instance can
+// be shared by every transaction (and thread) that resolves to the same
+// policy. Paths that aren't in the table (odd spellings like a trailing
+// delimiter) fall back to walking the tree, so answers always match
+// PathEntitlement.
+class CompiledEntitlements {
+private:
+
+    shared_ptr < const Entitlements >               mEntitlements; // owns everything in mLeaves
+    unordered_map < string, size_t >                mIndex;
+    vector < bool >                                 mAllowed;
+    vector < const AbstractEntitlement* >           mLeaves;
+
+    //----------------------------------------------------------------//
+    void                            compile                     ( string path, const AbstractEntitlement* node );
+    const AbstractEntitlement*      resolvePath                 ( string path ) const;
+
+public:
+
+    //----------------------------------------------------------------//
+    bool                            check                       ( string path ) const;
+                                    CompiledEntitlements        ( shared_ptr < const Entitlements > entitlements );
+                                    ~CompiledEntitlements       ();
+    const Entitlements&             getEntitlements             () const;
+
+    //----------------------------------------------------------------//
+    template < typename TYPE >
+    bool check ( string path, TYPE value ) const {
+
+        const AbstractEntitlement* leaf = this->resolvePath ( path );
+        return leaf ? leaf->check ( value ) : false;
+    }
+
+    //----------------------------------------------------------------//
+    template < typename TYPE >
+    const TYPE* resolvePathAs ( string path ) const {
+
+        return dynamic_cast < const TYPE* >( this->resolvePath ( path ));
+    }
+};
+
+} // namespace Volition
+#endif
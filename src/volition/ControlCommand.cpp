@@ -74,7 +74,7 @@ void ControlCommand::AbstractSerializable_serializeFrom ( const AbstractSerializ
         serializer.serialize ( "body", this->mBodyString );
         if ( this->mBodyString.size ()) {
         
-            FromJSONSerializer::fromJSONString ( this->mBody, this->mBodyString );
+            FromJSONStreamSerializer::fromJSONString ( this->mBody, this->mBodyString );
             assert ( this->mBody );
         }
     }
@@ -0,0 +1,282 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <volition/AccountODBM.h>
+#include <volition/AssetMethod.h>
+#include <volition/AssetODBM.h>
+#include <volition/BlockODBM.h>
+#include <volition/CraftabilityIndex.h>
+#include <volition/InventoryLogEntry.h>
+#include <volition/Ledger.h>
+#include <volition/Schema.h>
+#include <volition/TheWorkerPool.h>
+
+namespace Volition {
+
+//================================================================//
+// CraftabilityIndex
+//================================================================//
+
+//----------------------------------------------------------------//
+bool CraftabilityIndex::canExtend ( const AbstractLedger& ledger, const AccountIndex& accountIndex ) {
+
+    if ( accountIndex.mSchemaHash != ledger.getSchemaHash ()) return false;
+    if ( ledger.countBlocks () < accountIndex.mHeight ) return false;
+    if ( accountIndex.mHeight == 0 ) return true;
+
+    return ( BlockODBM ( ledger, accountIndex.mHeight - 1 ).mHash.get () == accountIndex.mBlockHash );
+}
+
+//----------------------------------------------------------------//
+void CraftabilityIndex::clear () {
+
+    lock_guard < mutex > lock ( this->mMutex );
+    this->mAccounts.clear ();
+}
+
+//----------------------------------------------------------------//
+CraftabilityIndex::CraftabilityIndex ( size_t maxAccounts ) :
+    mMaxAccounts ( maxAccounts ) {
+}
+
+//----------------------------------------------------------------//
+CraftabilityIndex::~CraftabilityIndex () {
+}
+
+//----------------------------------------------------------------//
+void CraftabilityIndex::evaluate ( const Schema& schema, const vector < shared_ptr < const Asset >>& assets, AssetsByMethod& assetsByMethod ) {
+
+    size_t totalAssets = assets.size ();
+    if ( totalAssets == 0 ) return;
+
+    TheWorkerPool& pool = TheWorkerPool::get ();
+
+    size_t totalJobs = pool.countThreads () + 1;
+    size_t maxJobs = totalAssets / MIN_ASSETS_PER_JOB;
+    if ( maxJobs < totalJobs ) {
+        totalJobs = maxJobs;
+    }
+
+    if ( totalJobs <= 1 ) {
+        CraftabilityIndex::evaluateRange ( schema, assets, 0, totalAssets, assetsByMethod );
+        return;
+    }
+
+    // qualifier programs are const and self-contained, so each job can evaluate
+    // its own slice of the assets into a private result; merge once all are done.
+    vector < AssetsByMethod > partials ( totalJobs );
+
+    size_t chunkSize = ( totalAssets + totalJobs - 1 ) / totalJobs;
+    pool.parallelFor ( totalJobs, [ & ]( size_t i ) {
+
+        size_t base = i * chunkSize;
+        size_t top = ( base + chunkSize ) < totalAssets ? ( base + chunkSize ) : totalAssets;
+        if ( base < top ) {
+            CraftabilityIndex::evaluateRange ( schema, assets, base, top, partials [ i ]);
+        }
+    });
+
+    for ( size_t i = 0; i < totalJobs; ++i ) {
+
+        AssetsByMethod::const_iterator methodIt = partials [ i ].cbegin ();
+        for ( ; methodIt != partials [ i ].cend (); ++methodIt ) {
+
+            AssetsByParam::const_iterator paramIt = methodIt->second.cbegin ();
+            for ( ; paramIt != methodIt->second.cend (); ++paramIt ) {
+                assetsByMethod [ methodIt->first ][ paramIt->first ].insert ( paramIt->second.cbegin (), paramIt->second.cend ());
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------//
+void CraftabilityIndex::evaluateRange ( const Schema& schema, const vector < shared_ptr < const Asset >>& assets, size_t base, size_t top, AssetsByMethod& assetsByMethod ) {
+
+    const Schema::Methods& methods = schema.getMethods ();
+
+    for ( size_t i = base; i < top; ++i ) {
+
+        shared_ptr < const Asset > asset = assets [ i ];
+        if ( !asset ) continue;
+
+        Schema::Methods::const_iterator methodIt = methods.cbegin ();
+        for ( ; methodIt != methods.cend (); ++methodIt ) {
+
+            const AssetMethod& method = methodIt->second;
+
+            AssetMethod::AssetArgs::const_iterator assetArgIt = method.mAssetArgs.cbegin ();
+            for ( ; assetArgIt != method.mAssetArgs.cend (); ++assetArgIt ) {
+                if ( assetArgIt->second.qualifies ( asset )) {
+                    assetsByMethod [ methodIt->first ][ assetArgIt->first ].insert ( asset->mAssetID );
+                }
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------//
+bool CraftabilityIndex::getQualifiedAssets ( AbstractLedger& ledger, string accountName, string methodName, AssetsByParam& assetsByParam ) {
+
+    const AssetMethod* method = ledger.getSchema ().getMethodOrNull ( methodName );
+    if ( !method ) return false;
+
+    AccountID accountID = ledger.getAccountID ( accountName );
+    if ( accountID == AccountID::NULL_INDEX ) return false;
+
+    shared_ptr < const AccountIndex > cached;
+    {
+        lock_guard < mutex > lock ( this->mMutex );
+        map < AccountID::Index, shared_ptr < const AccountIndex >>::const_iterator accountIt = this->mAccounts.find ( accountID );
+        if ( accountIt != this->mAccounts.cend ()) {
+            cached = accountIt->second;
+        }
+    }
+
+    // sync outside the lock. the stored entry is shared with other readers, so
+    // anything that needs to change works on a copy that gets swapped in after.
+    shared_ptr < const AccountIndex > accountIndex;
+
+    if ( cached && CraftabilityIndex::canExtend ( ledger, *cached )) {
+
+        bool isCurrent = (
+            ( cached->mHeight == ledger.countBlocks ()) &&
+            ( cached->mInventoryNonce == AccountODBM ( ledger, accountID ).mInventoryNonce.get ( 0 ))
+        );
+
+        if ( isCurrent ) {
+            accountIndex = cached;
+        }
+        else {
+            shared_ptr < AccountIndex > replayed = make_shared < AccountIndex >( *cached );
+            CraftabilityIndex::replay ( ledger, accountID, *replayed );
+            accountIndex = replayed;
+        }
+    }
+    else {
+        shared_ptr < AccountIndex > rebuilt = make_shared < AccountIndex >();
+        CraftabilityIndex::rebuild ( ledger, accountID, *rebuilt );
+        accountIndex = rebuilt;
+    }
+
+    if ( accountIndex != cached ) {
+        this->store ( accountID, accountIndex );
+    }
+
+    assetsByParam.clear ();
+    const AssetsByMethod& assetsByMethod = accountIndex->mAssetsByMethod;
+    AssetsByMethod::const_iterator methodIt = assetsByMethod.find ( methodName );
+
+    AssetMethod::AssetArgs::const_iterator assetArgIt = method->mAssetArgs.cbegin ();
+    for ( ; assetArgIt != method->mAssetArgs.cend (); ++assetArgIt ) {
+
+        AssetSet& assets = assetsByParam [ assetArgIt->first ];
+        if ( methodIt == assetsByMethod.cend ()) continue;
+
+        AssetsByParam::const_iterator paramIt = methodIt->second.find ( assetArgIt->first );
+        if ( paramIt != methodIt->second.cend ()) {
+            assets = paramIt->second;
+        }
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------//
+void CraftabilityIndex::rebuild ( AbstractLedger& ledger, AccountID accountID, AccountIndex& accountIndex ) {
+
+    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+
+    accountIndex.mAssetsByMethod.clear ();
+    accountIndex.mInventoryNonce = AccountODBM ( ledger, accountID ).mInventoryNonce.get ( 0 );
+
+    SerializableList < SerializableSharedConstPtr < Asset >> inventory;
+    ledger.getInventory ( accountID, inventory );
+
+    vector < shared_ptr < const Asset >> assets;
+    assets.reserve ( inventory.size ());
+
+    SerializableList < SerializableSharedConstPtr < Asset >>::const_iterator inventoryIt = inventory.cbegin ();
+    for ( ; inventoryIt != inventory.cend (); ++inventoryIt ) {
+        assets.push_back ( *inventoryIt );
+    }
+
+    CraftabilityIndex::evaluate ( ledger.getSchema (), assets, accountIndex.mAssetsByMethod );
+
+    u64 height = ledger.countBlocks ();
+    accountIndex.mHeight        = height;
+    accountIndex.mBlockHash     = height ? BlockODBM ( ledger, height - 1 ).mHash.get () : "";
+    accountIndex.mSchemaHash    = ledger.getSchemaHash ();
+}
+
+//----------------------------------------------------------------//
+void CraftabilityIndex::replay ( AbstractLedger& ledger, AccountID accountID, AccountIndex& accountIndex ) {
+
+    AccountODBM accountODBM ( ledger, accountID );
+    u64 inventoryNonce = accountODBM.mInventoryNonce.get ( 0 );
+
+    // every asset named by a new log entry (added, removed or updated) is dropped
+    // from the index, then re-evaluated if the account still owns it.
+    SerializableSet < AssetID::Index > touched;
+    for ( u64 nonce = accountIndex.mInventoryNonce; nonce < inventoryNonce; ++nonce ) {
+
+        shared_ptr < const InventoryLogEntry > logEntry = accountODBM.getInventoryLogEntryField ( nonce ).get ();
+        if ( !logEntry ) continue;
+
+        logEntry->apply ( touched, touched );
+    }
+
+    if ( touched.size ()) {
+
+        AssetsByMethod::iterator methodIt = accountIndex.mAssetsByMethod.begin ();
+        for ( ; methodIt != accountIndex.mAssetsByMethod.end (); ++methodIt ) {
+
+            AssetsByParam::iterator paramIt = methodIt->second.begin ();
+            for ( ; paramIt != methodIt->second.end (); ++paramIt ) {
+
+                SerializableSet < AssetID::Index >::const_iterator touchedIt = touched.cbegin ();
+                for ( ; touchedIt != touched.cend (); ++touchedIt ) {
+                    paramIt->second.erase ( *touchedIt );
+                }
+            }
+        }
+
+        vector < shared_ptr < const Asset >> assets;
+        AssetReadCache cache ( ledger );
+
+        SerializableSet < AssetID::Index >::const_iterator touchedIt = touched.cbegin ();
+        for ( ; touchedIt != touched.cend (); ++touchedIt ) {
+
+            AssetODBM assetODBM ( ledger, *touchedIt );
+            if ( assetODBM.mOwner.get ( AccountID::NULL_INDEX ) != accountID ) continue;
+
+            shared_ptr < const Asset > asset = assetODBM.getAsset ( cache );
+            if ( asset ) {
+                assets.push_back ( asset );
+            }
+        }
+        CraftabilityIndex::evaluate ( ledger.getSchema (), assets, accountIndex.mAssetsByMethod );
+    }
+
+    u64 height = ledger.countBlocks ();
+    accountIndex.mInventoryNonce    = inventoryNonce;
+    accountIndex.mHeight            = height;
+    accountIndex.mBlockHash         = height ? BlockODBM ( ledger, height - 1 ).mHash.get () : "";
+}
+
+//----------------------------------------------------------------//
+void CraftabilityIndex::store ( AccountID accountID, shared_ptr < const AccountIndex > accountIndex ) {
+
+    lock_guard < mutex > lock ( this->mMutex );
+
+    map < AccountID::Index, shared_ptr < const AccountIndex >>::iterator accountIt = this->mAccounts.find ( accountID );
+
+    // don't let a query against an older ledger (or a slower concurrent sync) evict an entry that is further along.
+    if (( accountIt != this->mAccounts.end ()) && ( accountIndex->mHeight < accountIt->second->mHeight )) return;
+
+    if (( accountIt == this->mAccounts.end ()) && ( this->mAccounts.size () >= this->mMaxAccounts )) {
+        this->mAccounts.erase ( this->mAccounts.begin ());
+    }
+    this->mAccounts [ accountID ] = accountIndex;
+}
+
+} // namespace Volition
@@ -0,0 +1,74 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_CRAFTABILITYINDEX_H
+#define VOLITION_CRAFTABILITYINDEX_H
+
+#include <volition/common.h>
+#include <volition/Asset.h>
+#include <volition/AssetID.h>
+
+namespace Volition {
+
+class AbstractLedger;
+class Schema;
+
+//================================================================//
+// CraftabilityIndex
+//================================================================//
+// For each indexed account, the set of inventory assets that satisfy each
+// asset param qualifier of each schema method. Built once per account (with
+// qualifier evaluation spread across TheWorkerPool) and then kept current by
+// replaying the account's inventory log from the last nonce seen: only the
+// assets named in new log entries are dropped and re-evaluated. An entry is
+// rebuilt from scratch if the schema changes or the ledger no longer extends
+// the block it was built at (i.e. after a reorg). Entries are immutable once
+// stored; a sync works on a private copy outside the lock and swaps it in, so
+// a slow rebuild for one account doesn't hold up queries for the others.
+class CraftabilityIndex {
+public:
+
+    typedef set < AssetID::Index >              AssetSet;
+    typedef map < string, AssetSet >            AssetsByParam;
+    typedef map < string, AssetsByParam >       AssetsByMethod;
+
+    static const size_t DEFAULT_MAX_ACCOUNTS    = 1024;
+
+private:
+
+    static const size_t MIN_ASSETS_PER_JOB      = 64;
+
+    //----------------------------------------------------------------//
+    class AccountIndex {
+    public:
+
+        u64                 mHeight;            // ledger.countBlocks () when last synced
+        string              mBlockHash;         // hash of the block at mHeight - 1
+        string              mSchemaHash;
+        u64                 mInventoryNonce;    // next inventory log entry to replay
+        AssetsByMethod      mAssetsByMethod;
+    };
+
+    mutable mutex                                               mMutex;
+    size_t                                                      mMaxAccounts;
+    map < AccountID::Index, shared_ptr < const AccountIndex >>  mAccounts;
+
+    //----------------------------------------------------------------//
+    static bool         canExtend                   ( const AbstractLedger& ledger, const AccountIndex& accountIndex );
+    static void         evaluate                    ( const Schema& schema, const vector < shared_ptr < const Asset >>& assets, AssetsByMethod& assetsByMethod );
+    static void         evaluateRange               ( const Schema& schema, const vector < shared_ptr < const Asset >>& assets, size_t base, size_t top, AssetsByMethod& assetsByMethod );
+    static void         rebuild                     ( AbstractLedger& ledger, AccountID accountID, AccountIndex& accountIndex );
+    static void         replay                      ( AbstractLedger& ledger, AccountID accountID, AccountIndex& accountIndex );
+    void                store                       ( AccountID accountID, shared_ptr < const AccountIndex > accountIndex );
+
+public:
+
+    //----------------------------------------------------------------//
+    void                clear                       ();
+                        CraftabilityIndex           ( size_t maxAccounts = DEFAULT_MAX_ACCOUNTS );
+                        ~CraftabilityIndex          ();
+    bool                getQualifiedAssets          ( AbstractLedger& ledger, string accountName, string methodName, AssetsByParam& assetsByParam );
+};
+
+} // namespace Volition
+#endif
@@ -0,0 +1,72 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_DECKTABLE_H
+#define VOLITION_DECKTABLE_H
+
+#include <volition/common.h>
+#include <algorithm>
+
+namespace Volition {
+
+//================================================================//
+// DeckTable
+//================================================================//
+// A deck (or set) flattened into a cumulative count table. Drawing card N
+// of the deck is a binary search for the first entry whose cumulative count
+// exceeds N, which picks the same asset type as indexing into the fully
+// expanded deck (one string per card) would. Types keep the deck's order.
+class DeckTable {
+private:
+
+    vector < string >       mTypes;
+    vector < u64 >          mCumulative;
+
+public:
+
+    //----------------------------------------------------------------//
+    void build ( const map < string, u64 >& deck ) {
+
+        this->mTypes.clear ();
+        this->mCumulative.clear ();
+
+        u64 total = 0;
+        map < string, u64 >::const_iterator deckIt = deck.cbegin ();
+        for ( ; deckIt != deck.cend (); ++deckIt ) {
+            if ( deckIt->second == 0 ) continue;
+            total += deckIt->second;
+            this->mTypes.push_back ( deckIt->first );
+            this->mCumulative.push_back ( total );
+        }
+    }
+
+    //----------------------------------------------------------------//
+    DeckTable () {
+    }
+
+    //----------------------------------------------------------------//
+    size_t draw ( u64 card ) const {
+
+        assert ( this->getTotal ());
+        card = card % this->getTotal ();
+        return ( size_t )( upper_bound ( this->mCumulative.cbegin (), this->mCumulative.cend (), card ) - this->mCumulative.cbegin ());
+    }
+
+    //----------------------------------------------------------------//
+    u64 getTotal () const {
+        return this->mCumulative.size () ? this->mCumulative.back () : 0;
+    }
+
+    //----------------------------------------------------------------//
+    const string& getType ( size_t index ) const {
+        return this->mTypes [ index ];
+    }
+
+    //----------------------------------------------------------------//
+    size_t size () const {
+        return this->mTypes.size ();
+    }
+};
+
+} // namespace Volition
+#endif
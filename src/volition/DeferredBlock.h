@@ -0,0 +1,118 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_DEFERREDBLOCK_H
+#define VOLITION_DEFERREDBLOCK_H
+
+#include <volition/common.h>
+#include <volition/serialization/Serialization.h>
+#include <volition/Transaction.h>
+
+namespace Volition {
+
+//================================================================//
+// DeferredTransaction
+//================================================================//
+class DeferredTransaction :
+    public AbstractSerializable {
+public:
+
+    u64                                             mIndex;             // position of the transaction in its block
+    SerializableSharedConstPtr < Transaction >      mTransaction;
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeFrom ( const AbstractSerializerFrom& serializer ) override {
+
+        serializer.serialize ( "index",             this->mIndex );
+        serializer.serialize ( "transaction",       this->mTransaction );
+    }
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeTo ( AbstractSerializerTo& serializer ) const override {
+
+        serializer.serialize ( "index",             this->mIndex );
+        serializer.serialize ( "transaction",       this->mTransaction );
+    }
+
+    //----------------------------------------------------------------//
+    DeferredTransaction () :
+        mIndex ( 0 ) {
+    }
+};
+
+//================================================================//
+// DeferredBlock
+//================================================================//
+// The transactions of a block on the unfinished list that are due at its
+// scheduled height, along with what applying them needs from the block (its
+// miner, reward, release and time), so the block itself doesn't have to be
+// loaded and parsed again. The unfinished list decides what's applied; this
+// is only a copy of the transactions.
+class DeferredBlock :
+    public AbstractSerializable {
+public:
+
+    u64                                             mBlockID;           // height of the block the transactions came from
+    string                                          mMinerID;
+    string                                          mReward;
+    u64                                             mRelease;
+    SerializableTime                                mTime;
+    SerializableList < DeferredTransaction >        mTransactions;
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeFrom ( const AbstractSerializerFrom& serializer ) override {
+
+        serializer.serialize ( "blockID",           this->mBlockID );
+        serializer.serialize ( "minerID",           this->mMinerID );
+        serializer.serialize ( "reward",            this->mReward );
+        serializer.serialize ( "release",           this->mRelease );
+        serializer.serialize ( "time",              this->mTime );
+        serializer.serialize ( "transactions",      this->mTransactions );
+    }
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeTo ( AbstractSerializerTo& serializer ) const override {
+
+        serializer.serialize ( "blockID",           this->mBlockID );
+        serializer.serialize ( "minerID",           this->mMinerID );
+        serializer.serialize ( "reward",            this->mReward );
+        serializer.serialize ( "release",           this->mRelease );
+        serializer.serialize ( "time",              this->mTime );
+        serializer.serialize ( "transactions",      this->mTransactions );
+    }
+
+    //----------------------------------------------------------------//
+    DeferredBlock () :
+        mBlockID ( 0 ),
+        mRelease ( 0 ),
+        mTime ( 0 ) {
+    }
+};
+
+//================================================================//
+// DeferredBlockList
+//================================================================//
+// The copied-out transactions of the blocks scheduled at one height.
+class DeferredBlockList :
+    public AbstractSerializable {
+public:
+
+    typedef SerializableList < DeferredBlock >::const_iterator    Iterator;
+
+    SerializableList < DeferredBlock >      mBlocks;
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeFrom ( const AbstractSerializerFrom& serializer ) override {
+
+        serializer.serialize ( "blocks",      this->mBlocks );
+    }
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeTo ( AbstractSerializerTo& serializer ) const override {
+
+        serializer.serialize ( "blocks",      this->mBlocks );
+    }
+};
+
+} // namespace Volition
+#endif
@@ -0,0 +1,153 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_DIGEST256_H
+#define VOLITION_DIGEST256_H
+
+#include <volition/common.h>
+#include <volition/Digest.h>
+#include <unordered_map>
+
+namespace Volition {
+
+//================================================================//
+// Digest256
+//================================================================//
+// Fixed-size, trivially copyable 32-byte digest for use as a map key. Block
+// hashes are SHA256, so this holds them inline (no heap) and compares them
+// with memcmp. Byte order matches the order of the lowercase hex strings we
+// used to key on, so swapping one for the other does not change iteration
+// order. An all-zero digest is treated as empty. Hex is only for the wire.
+class Digest256 {
+public:
+
+    static const size_t SIZE = 32;
+
+    //----------------------------------------------------------------//
+    class Hash {
+    public:
+
+        //----------------------------------------------------------------//
+        size_t operator () ( const Digest256& digest ) const {
+
+            // input is already a cryptographic hash; any 8 bytes will do.
+            size_t hash;
+            memcpy ( &hash, digest.mBytes, sizeof ( hash ));
+            return hash;
+        }
+    };
+
+private:
+
+    u8      mBytes [ SIZE ];
+
+public:
+
+    //----------------------------------------------------------------//
+    operator bool () const {
+
+        for ( size_t i = 0; i < SIZE; ++i ) {
+            if ( this->mBytes [ i ]) return true;
+        }
+        return false;
+    }
+
+    //----------------------------------------------------------------//
+    bool operator < ( const Digest256& rhs ) const {
+        return ( memcmp ( this->mBytes, rhs.mBytes, SIZE ) < 0 );
+    }
+
+    //----------------------------------------------------------------//
+    bool operator == ( const Digest256& rhs ) const {
+        return ( memcmp ( this->mBytes, rhs.mBytes, SIZE ) == 0 );
+    }
+
+    //----------------------------------------------------------------//
+    bool operator != ( const Digest256& rhs ) const {
+        return !( *this == rhs );
+    }
+
+    //----------------------------------------------------------------//
+    static int compare ( const Digest256& digest0, const Digest256& digest1 ) {
+
+        int result = memcmp ( digest0.mBytes, digest1.mBytes, SIZE );
+        return result < 0 ? -1 : result > 0 ? 1 : 0;
+    }
+
+    //----------------------------------------------------------------//
+    const u8* data () const {
+        return this->mBytes;
+    }
+
+    //----------------------------------------------------------------//
+    Digest256 () {
+        memset ( this->mBytes, 0, SIZE );
+    }
+
+    //----------------------------------------------------------------//
+    Digest256 ( const Digest& digest ) {
+
+        assert ( digest.size () <= SIZE );
+
+        size_t size = digest.size () < SIZE ? digest.size () : SIZE;
+        memset ( this->mBytes, 0, SIZE );
+        if ( size ) {
+            memcpy ( this->mBytes, digest.data (), size );
+        }
+    }
+
+    //----------------------------------------------------------------//
+    static Digest256 fromHex ( string hex ) {
+
+        Digest256 digest;
+        if ( hex.size () != ( SIZE * 2 )) return digest;
+
+        for ( size_t i = 0; i < SIZE; ++i ) {
+
+            int hi = Digest256::fromHexChar ( hex [ i * 2 ]);
+            int lo = Digest256::fromHexChar ( hex [( i * 2 ) + 1 ]);
+
+            if (( hi < 0 ) || ( lo < 0 )) return Digest256 ();
+            digest.mBytes [ i ] = ( u8 )(( hi << 4 ) | lo );
+        }
+        return digest;
+    }
+
+    //----------------------------------------------------------------//
+    static int fromHexChar ( char c ) {
+
+        if (( '0' <= c ) && ( c <= '9' )) return c - '0';
+        if (( 'a' <= c ) && ( c <= 'f' )) return c - 'a' + 10;
+        if (( 'A' <= c ) && ( c <= 'F' )) return c - 'A' + 10;
+        return -1;
+    }
+
+    //----------------------------------------------------------------//
+    Digest toDigest () const {
+
+        Digest digest;
+        if ( *this ) {
+            digest.assign ( this->mBytes, this->mBytes + SIZE );
+        }
+        return digest;
+    }
+
+    //----------------------------------------------------------------//
+    string toHex () const {
+
+        static const char* HEX = "0123456789abcdef";
+
+        if ( !( *this )) return "";
+
+        string hex;
+        hex.resize ( SIZE * 2 );
+        for ( size_t i = 0; i < SIZE; ++i ) {
+            hex [ i * 2 ]           = HEX [ this->mBytes [ i ] >> 4 ];
+            hex [( i * 2 ) + 1 ]    = HEX [ this->mBytes [ i ] & 0x0f ];
+        }
+        return hex;
+    }
+};
+
+} // namespace Volition
+#endif
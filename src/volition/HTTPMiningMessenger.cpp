@@ -3,6 +3,7 @@
 
 #include <volition/Block.h>
 #include <volition/HTTPMiningMessenger.h>
+#include <volition/Metrics.h>
 #include <volition/UnsecureRandom.h>
 
 namespace Volition {
@@ -40,7 +41,9 @@ private:
 
     TYPE                                mUserData;
     string                              mURL;
+    bool                                mStreamed;      // keep the raw body in mBody instead of parsing mJSON
     Poco::JSON::Object::Ptr             mJSON;
+    string                              mBody;
 
     //----------------------------------------------------------------//
     void runTask () override {
@@ -64,19 +67,33 @@ private:
             
             session->setKeepAlive ( false );
             session->setTimeout ( Poco::Timespan ( 1, 0 ), Poco::Timespan ( 1, 0 ), Poco::Timespan ( 5, 0 ));
+            
+            chrono::steady_clock::time_point t0 = chrono::steady_clock::now ();
             session->sendRequest ( request );
             
             Poco::Net::HTTPResponse response;
             std::istream& jsonStream = session->receiveResponse ( response );
             
+            chrono::duration < double > rtt = chrono::steady_clock::now () - t0;
+            VOL_METRIC_OBSERVE ( "volition_peer_rtt_seconds", "Time from sending a request to a peer until its response headers arrive.", rtt.count ());
+            
             if ( response.getStatus () == Poco::Net::HTTPResponse::HTTP_OK ) {
                 
-                Poco::JSON::Parser parser;
-                Poco::Dynamic::Var result = parser.parse ( jsonStream );
-                this->mJSON = result.extract < Poco::JSON::Object::Ptr >();
+                if ( this->mStreamed ) {
+                    this->mBody.assign ( istreambuf_iterator < char >( jsonStream ), istreambuf_iterator < char >());
+                }
+                else {
+                    Poco::JSON::Parser parser;
+                    Poco::Dynamic::Var result = parser.parse ( jsonStream );
+                    this->mJSON = result.extract < Poco::JSON::Object::Ptr >();
+                }
+            }
+            else {
+                VOL_METRIC_COUNT ( "volition_peer_request_errors_total", "Peer requests that failed or did not return HTTP 200.", 1 );
             }
         }
         catch ( Poco::Exception& exc ) {
+            VOL_METRIC_COUNT ( "volition_peer_request_errors_total", "Peer requests that failed or did not return HTTP 200.", 1 );
             string msg = exc.message ();
             if ( msg.size () > 0 ) {
                 LGN_LOG ( VOL_FILTER_CONSENSUS, INFO, "%s", exc.message ().c_str ());
@@ -91,10 +108,11 @@ private:
 public:
 
     //----------------------------------------------------------------//
-    HTTPGetJSONTask ( TYPE userData, string url ) :
+    HTTPGetJSONTask ( TYPE userData, string url, bool streamed = false ) :
         Task ( "HTTP GET JSON" ),
         mUserData ( userData ),
-        mURL ( url ) {
+        mURL ( url ),
+        mStreamed ( streamed ) {
     }
     
     //----------------------------------------------------------------//
@@ -116,6 +134,32 @@ void HTTPMiningMessenger::completeRequest ( const MiningMessengerRequest& reques
     this->pumpQueues ();
 }
 
+//----------------------------------------------------------------//
+bool HTTPMiningMessenger::deserializeBlock ( const string& body, shared_ptr < Block >& block ) {
+
+    if ( body.size () == 0 ) return false;
+
+    try {
+    
+        JSONTokenizer tokenizer;
+        tokenizer.tokenize ( body );
+        
+        FromJSONStreamSerializer::fromJSON ( tokenizer, [ & ]( const AbstractSerializerFrom& serializer ) {
+            serializer.context ( "block", [ & ]( const AbstractSerializerFrom& blockSerializer ) {
+                if ( blockSerializer.getKeyType () != AbstractSerializerFrom::KEY_TYPE_STRING ) return;
+                block = make_shared < Block >();
+                block->serializeFrom ( blockSerializer );
+            });
+        });
+    }
+    catch ( Poco::Exception& exc ) {
+        LGN_LOG ( VOL_FILTER_CONSENSUS, INFO, "%s", exc.message ().c_str ());
+        block = NULL;
+        return false;
+    }
+    return true;
+}
+
 //----------------------------------------------------------------//
 void HTTPMiningMessenger::deserailizeHeaderList ( list < shared_ptr < const BlockHeader >>& responseHeaders, Poco::JSON::Array::Ptr headersJSON ) {
 
@@ -146,6 +190,10 @@ size_t HTTPMiningMessenger::getQueueIndex ( MiningMessengerRequest::Type request
         
         case MiningMessengerRequest::REQUEST_MINER_INFO:
             return INFO_QUEUE_INDEX;
+        
+        case MiningMessengerRequest::REQUEST_SNAPSHOT_CHUNK:
+        case MiningMessengerRequest::REQUEST_SNAPSHOT_MANIFEST:
+            return SNAPSHOT_QUEUE_INDEX;
 
         default:
             break;
@@ -163,6 +211,7 @@ size_t HTTPMiningMessenger::getQueueRawWeight ( size_t index ) {
         case BLOCK_QUEUE_INDEX:         return BLOCK_QUEUE_WEIGHT;
         case HEADER_QUEUE_INDEX:        return HEADER_QUEUE_WEIGHT;
         case INFO_QUEUE_INDEX:          return INFO_QUEUE_WEIGHT;
+        case SNAPSHOT_QUEUE_INDEX:      return SNAPSHOT_QUEUE_WEIGHT;
         case TOPOLOGY_QUEUE_INDEX:      return TOPOLOGY_QUEUE_WEIGHT;
 
         default: break;
@@ -195,6 +244,14 @@ string HTTPMiningMessenger::getRequestURL ( const MiningMessengerRequest& reques
             Format::write ( url, "%s/node", request.mMinerURL.c_str ());
             break;
         
+        case MiningMessengerRequest::REQUEST_SNAPSHOT_CHUNK:
+            Format::write ( url, "%s/consensus/snapshot/%llu/chunks/%llu", request.mMinerURL.c_str (), ( u64 )request.mHeight, ( u64 )request.mChunkIndex );
+            break;
+        
+        case MiningMessengerRequest::REQUEST_SNAPSHOT_MANIFEST:
+            Format::write ( url, "%s/consensus/snapshot", request.mMinerURL.c_str ());
+            break;
+        
         default:
             assert ( false );
             break;
@@ -279,24 +336,21 @@ void HTTPMiningMessenger::onTaskFinishedNotification ( Poco::TaskFinishedNotific
     const MiningMessengerRequest& request = task->mUserData;
     Poco::JSON::Object::Ptr json = task->mJSON;
     
-    if ( json ) {
+    if ( request.mRequestType == MiningMessengerRequest::REQUEST_BLOCK ) {
+    
+        // block requests are streamed (see sendRequest); the block is deserialized from the response text.
+        shared_ptr < Block > block;
+        if ( HTTPMiningMessenger::deserializeBlock ( task->mBody, block )) {
+            this->enqueueBlockResponse ( request, block );
+        }
+        else {
+            this->enqueueErrorResponse ( request );
+        }
+    }
+    else if ( json ) {
     
         switch ( request.mRequestType ) {
             
-            case MiningMessengerRequest::REQUEST_BLOCK: {
-            
-                shared_ptr < Block > block;
-                
-                Poco::JSON::Object::Ptr blockJSON = json ? json->getObject ( "block" ) : NULL;
-                if ( blockJSON ) {
-                    block = make_shared < Block >();
-                    FromJSONSerializer::fromJSON ( *block, *blockJSON );
-                }
-                this->enqueueBlockResponse ( request, block );
-                
-                break;
-            }
-            
             case MiningMessengerRequest::REQUEST_EXTEND_NETWORK: {
             
                 Poco::JSON::Array::Ptr minerListJSON = json ? json->getArray ( "miners" ) : NULL;
@@ -334,6 +388,31 @@ void HTTPMiningMessenger::onTaskFinishedNotification ( Poco::TaskFinishedNotific
                 break;
             }
             
+            case MiningMessengerRequest::REQUEST_SNAPSHOT_CHUNK: {
+            
+                if ( json->has ( "chunk" )) {
+                    this->enqueueSnapshotChunkResponse ( request, json->getValue < string >( "chunk" ));
+                }
+                else {
+                    this->enqueueErrorResponse ( request );
+                }
+                break;
+            }
+            
+            case MiningMessengerRequest::REQUEST_SNAPSHOT_MANIFEST: {
+            
+                Poco::JSON::Object::Ptr snapshotJSON = json->getObject ( "snapshot" );
+                if ( snapshotJSON ) {
+                    shared_ptr < LedgerSnapshotManifest > manifest = make_shared < LedgerSnapshotManifest >();
+                    FromJSONSerializer::fromJSON ( *manifest, *snapshotJSON );
+                    this->enqueueSnapshotManifestResponse ( request, manifest );
+                }
+                else {
+                    this->enqueueErrorResponse ( request );
+                }
+                break;
+            }
+            
             default:
                 this->enqueueErrorResponse ( request );
                 break;
@@ -389,6 +468,9 @@ void HTTPMiningMessenger::pumpQueues () {
         // all of the queues in the set have been serviced; if there are still pending requests and
         // resources available, rinse and repeat.
     }
+    
+    VOL_METRIC_GAUGE ( "volition_peer_requests_pending", "Peer requests queued and waiting for a worker thread.", this->mTotalPending );
+    VOL_METRIC_GAUGE ( "volition_peer_requests_active", "Peer requests currently in flight.", this->mTotalActive );
 }
 
 //----------------------------------------------------------------//
@@ -405,7 +487,8 @@ void HTTPMiningMessenger::sendRequest ( HTTPMiningMessengerRequestQueue& queue )
     // send the request
     MiningMessengerRequest& request = *requestIt;
     string url = this->getRequestURL ( request );
-    this->mTaskManager.start ( new HTTPGetJSONTask < MiningMessengerRequest >( request, url ));
+    bool streamed = ( request.mRequestType == MiningMessengerRequest::REQUEST_BLOCK );
+    this->mTaskManager.start ( new HTTPGetJSONTask < MiningMessengerRequest >( request, url, streamed ));
 
     // remove it from the queue and update the counts
     queue.mPending.erase ( requestIt );
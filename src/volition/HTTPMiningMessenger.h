@@ -42,6 +42,7 @@ protected:
         BLOCK_QUEUE_INDEX               = 0,
         HEADER_QUEUE_INDEX,
         INFO_QUEUE_INDEX,
+        SNAPSHOT_QUEUE_INDEX,
         TOPOLOGY_QUEUE_INDEX,
         TOTAL_QUEUES,
     };
@@ -50,6 +51,7 @@ protected:
         BLOCK_QUEUE_WEIGHT              = 8,
         HEADER_QUEUE_WEIGHT             = 6,
         INFO_QUEUE_WEIGHT               = 1,
+        SNAPSHOT_QUEUE_WEIGHT           = 4,
         TOPOLOGY_QUEUE_WEIGHT           = 1,
     };
     
@@ -67,6 +69,7 @@ protected:
 
     //----------------------------------------------------------------//
     void                completeRequest                             ( const MiningMessengerRequest& request );
+    static bool         deserializeBlock                            ( const string& body, shared_ptr < Block >& block );
     static void         deserailizeHeaderList                       ( list < shared_ptr < const BlockHeader >>& responseHeaders, Poco::JSON::Array::Ptr headersJSON );
     static size_t       getQueueIndex                               ( MiningMessengerRequest::Type requestType );
     static size_t       getQueueRawWeight                           ( size_t index );
@@ -56,13 +56,16 @@ int HasBlockHeaderFields::compare ( const HasBlockHeaderFields& block0, const Ha
 //----------------------------------------------------------------//
 int HasBlockHeaderFields::compare ( const Digest& charm0, const Digest& charm1 ) {
 
-    string hex0 = charm0.toHex ();
-    string hex1 = charm1.toHex ();
-
-//    printf ( "charm0 (%s): %s\n", block0.getMinerID ().c_str (), hex0.c_str ());
-//    printf ( "charm1 (%s): %s\n", block1.getMinerID ().c_str (), hex1.c_str ());
-        
-    int result = hex0.compare ( hex1 );
+    // byte-wise compare; same order as comparing the lowercase hex strings
+    // (shorter digest loses a tie on the common prefix), without the allocs.
+    size_t size0 = charm0.size ();
+    size_t size1 = charm1.size ();
+    size_t size = size0 < size1 ? size0 : size1;
+    
+    int result = size ? memcmp ( charm0.data (), charm1.data (), size ) : 0;
+    if ( result == 0 ) {
+        result = size0 < size1 ? -1 : size0 > size1 ? 1 : 0;
+    }
     return result < 0 ? -1 : result > 0 ? 1 : 0;
 }
 
@@ -19,24 +19,24 @@ InMemoryBlockTree::InMemoryBlockTree () :
 //----------------------------------------------------------------//
 InMemoryBlockTree::~InMemoryBlockTree () {
 
-    map < string, InMemoryBlockTreeNode* >::iterator nodeIt = this->mNodes.begin ();
+    NodesByHash::iterator nodeIt = this->mNodes.begin ();
     for ( ; nodeIt != this->mNodes.end (); ++nodeIt ) {
         nodeIt->second->mTree = NULL;
     }
 }
 
 //----------------------------------------------------------------//
-InMemoryBlockTreeNode* InMemoryBlockTree::findNodeForHash ( string hash ) {
+InMemoryBlockTreeNode* InMemoryBlockTree::findNodeForHash ( const Digest256& hash ) {
 
-    map < string, InMemoryBlockTreeNode* >::iterator nodeIt = this->mNodes.find ( hash );
+    NodesByHash::iterator nodeIt = this->mNodes.find ( hash );
     if ( nodeIt != this->mNodes.end ()) return nodeIt->second;
     return NULL;
 }
 
 //----------------------------------------------------------------//
-const InMemoryBlockTreeNode* InMemoryBlockTree::findNodeForHash ( string hash ) const {
+const InMemoryBlockTreeNode* InMemoryBlockTree::findNodeForHash ( const Digest256& hash ) const {
 
-    map < string, InMemoryBlockTreeNode* >::const_iterator nodeIt = this->mNodes.find ( hash );
+    NodesByHash::const_iterator nodeIt = this->mNodes.find ( hash );
     if ( nodeIt != this->mNodes.cend ()) return nodeIt->second;
     return NULL;
 }
@@ -83,7 +83,7 @@ void InMemoryBlockTree::logTreeRecurse ( string prefix, size_t maxDepth, const I
 BlockTreeCursor InMemoryBlockTree::AbstractBlockTree_affirm ( BlockTreeTag& tag, shared_ptr < const BlockHeader > header, shared_ptr < const Block > block, bool isProvisional ) {
 
     string tagName = tag.getName ();
-    string hash = header->getDigest ().toHex ();
+    Digest256 hash ( header->getDigest ());
     InMemoryBlockTreeNode::Ptr node = this->findNodeForHash ( hash );
 
     if ( node ) {
@@ -91,8 +91,7 @@ BlockTreeCursor InMemoryBlockTree::AbstractBlockTree_affirm ( BlockTreeTag& tag,
     }
     else {
 
-        string prevHash = header->getPrevDigest ();
-        InMemoryBlockTreeNode* prevNode = this->findNodeForHash ( prevHash );
+        InMemoryBlockTreeNode* prevNode = this->findNodeForHash ( header->getPrevDigest ());
 
         if ( !prevNode && this->mRoot ) return BlockTreeCursor ();
 
@@ -116,10 +115,10 @@ BlockTreeCursor InMemoryBlockTree::AbstractBlockTree_affirm ( BlockTreeTag& tag,
 }
 
 //----------------------------------------------------------------//
-BlockTreeCursor InMemoryBlockTree::AbstractBlockTree_findCursorForHash ( string hash ) const {
+BlockTreeCursor InMemoryBlockTree::AbstractBlockTree_findCursorForHash ( const Digest256& hash ) const {
 
-    map < string, InMemoryBlockTreeNode* >::const_iterator nodeIt = this->mNodes.find ( hash );
-    if ( nodeIt != this->mNodes.cend ()) return *nodeIt->second;
+    const InMemoryBlockTreeNode* node = this->findNodeForHash ( hash );
+    if ( node ) return *node;
     return BlockTreeCursor ();
 }
 
@@ -138,7 +137,7 @@ shared_ptr < const Block > InMemoryBlockTree::AbstractBlockTree_getBlock ( const
     assert ( cursor.getTree () == this );
     if ( !cursor.hasBlock ()) return NULL;
 
-    const InMemoryBlockTreeNode* node = this->findNodeForHash ( cursor.getHash ());
+    const InMemoryBlockTreeNode* node = this->findNodeForHash ( cursor.getDigest ());
     assert ( node && node->mBlock );
     
     return node->mBlock;
@@ -147,7 +146,7 @@ shared_ptr < const Block > InMemoryBlockTree::AbstractBlockTree_getBlock ( const
 //----------------------------------------------------------------//
 void InMemoryBlockTree::AbstractBlockTree_setBranchStatus ( const BlockTreeCursor& cursor, kBlockTreeBranchStatus status ) {
 
-    InMemoryBlockTreeNode* node = this->findNodeForHash ( cursor.getHash ());
+    InMemoryBlockTreeNode* node = this->findNodeForHash ( cursor.getDigest ());
 
     if ( node ) {
         node->setBranchStatus ( status );
@@ -162,14 +161,14 @@ void InMemoryBlockTree::AbstractBlockTree_setCacheSize ( size_t size ) {
 //----------------------------------------------------------------//
 void InMemoryBlockTree::AbstractBlockTree_setSearchStatus ( const BlockTreeCursor& cursor, kBlockTreeSearchStatus status ) {
 
-    InMemoryBlockTreeNode* node = this->findNodeForHash ( cursor.getHash ());
+    InMemoryBlockTreeNode* node = this->findNodeForHash ( cursor.getDigest ());
     node->mSearchStatus = status;
 }
 
 //----------------------------------------------------------------//
 BlockTreeCursor InMemoryBlockTree::AbstractBlockTree_tag ( BlockTreeTag& tag, const BlockTreeCursor& cursor ) {
         
-    InMemoryBlockTreeNode::Ptr node = this->findNodeForHash ( cursor.getHash ());
+    InMemoryBlockTreeNode::Ptr node = this->findNodeForHash ( cursor.getDigest ());
     assert ( node );
     this->mTags [ tag.getName ()] = node->shared_from_this ();
     
@@ -190,13 +189,13 @@ BlockTreeCursor InMemoryBlockTree::AbstractBlockTree_tag ( BlockTreeTag& tag, co
 void InMemoryBlockTree::AbstractBlockTree_update ( shared_ptr < const Block > block ) {
 
     if ( !block ) return;
-    string hash = block->getDigest ();
+    Digest256 hash ( block->getDigest ());
 
     InMemoryBlockTreeNode::Ptr node = this->findNodeForHash ( hash );
     if ( !node ) return;
     
     assert ( node->mHeader );
-    assert ( node->mHeader->getDigest ().toHex () == hash );
+    assert ( Digest256 ( node->mHeader->getDigest ()) == hash );
     
     node->mBlock = block;
     node->mSearchStatus = kBlockTreeSearchStatus::SEARCH_STATUS_HAS_BLOCK;
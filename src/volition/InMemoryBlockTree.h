@@ -10,6 +10,7 @@
 #include <volition/Block.h>
 #include <volition/BlockTreeCursor.h>
 #include <volition/BlockTreeTag.h>
+#include <volition/Digest256.h>
 
 namespace Volition {
 
@@ -24,18 +25,20 @@ private:
 
     friend class InMemoryBlockTreeNode;
 
+    typedef unordered_map < Digest256, InMemoryBlockTreeNode*, Digest256::Hash > NodesByHash;
+
     InMemoryBlockTreeNode*                                  mRoot;
-    map < string, InMemoryBlockTreeNode* >                  mNodes;
+    NodesByHash                                             mNodes;
     map < string, shared_ptr < InMemoryBlockTreeNode >>     mTags;
 
     //----------------------------------------------------------------//
-    InMemoryBlockTreeNode*          findNodeForHash                 ( string hash );
-    const InMemoryBlockTreeNode*    findNodeForHash                 ( string hash ) const;
+    InMemoryBlockTreeNode*          findNodeForHash                 ( const Digest256& hash );
+    const InMemoryBlockTreeNode*    findNodeForHash                 ( const Digest256& hash ) const;
     void                            logTreeRecurse                  ( string prefix, size_t maxDepth, const InMemoryBlockTreeNode* node, size_t depth ) const;
 
     //----------------------------------------------------------------//
     BlockTreeCursor                 AbstractBlockTree_affirm                    ( BlockTreeTag& tag, shared_ptr < const BlockHeader > header, shared_ptr < const Block > block, bool isProvisional ) override;
-    BlockTreeCursor                 AbstractBlockTree_findCursorForHash         ( string hash ) const override;
+    BlockTreeCursor                 AbstractBlockTree_findCursorForHash         ( const Digest256& hash ) const override;
     BlockTreeCursor                 AbstractBlockTree_findCursorForTagName      ( string tagName ) const override;
     shared_ptr < const Block >      AbstractBlockTree_getBlock                  ( const BlockTreeCursor& cursor ) const override;
     void                            AbstractBlockTree_setBranchStatus           ( const BlockTreeCursor& cursor, kBlockTreeBranchStatus status ) override;
@@ -0,0 +1,101 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <volition/AccountODBM.h>
+#include <volition/AssetODBM.h>
+#include <volition/AssetReadCache.h>
+#include <volition/InventoryDelta.h>
+#include <volition/Ledger.h>
+#include <volition/Metrics.h>
+
+namespace Volition {
+
+//================================================================//
+// InventoryDelta
+//================================================================//
+
+//----------------------------------------------------------------//
+void InventoryDelta::checkpoint ( AccountODBM& accountODBM, u64 inventoryNonce, const InventoryLogEntry& entry ) {
+
+    // called once the entry at inventoryNonce has been written; only the last entry of an interval completes it.
+    if ((( inventoryNonce + 1 ) % CHECKPOINT_INTERVAL ) != 0 ) return;
+
+    u64 base = inventoryNonce + 1 - CHECKPOINT_INTERVAL;
+
+    InventoryLogEntry checkpoint ( entry.mTime );
+    for ( u64 nonce = base; nonce < inventoryNonce; ++nonce ) {
+        shared_ptr < const InventoryLogEntry > logEntry = accountODBM.getInventoryLogEntryField ( nonce ).get ();
+        if ( logEntry ) {
+            logEntry->apply ( checkpoint.mAdditions, checkpoint.mDeletions );
+        }
+    }
+    entry.apply ( checkpoint.mAdditions, checkpoint.mDeletions );
+
+    accountODBM.getInventoryCheckpointField ( inventoryNonce / CHECKPOINT_INTERVAL ).set ( checkpoint );
+}
+
+//----------------------------------------------------------------//
+void InventoryDelta::expand ( const AbstractLedger& ledger, AccountID accountID, size_t base, size_t count, SerializableList < SerializableSharedConstPtr < Asset >>& assetList ) const {
+
+    // pages through the additions in index order; only assets the account still owns are expanded.
+    AssetReadCache cache ( ledger );
+
+    SerializableSet < AssetID::Index >::const_iterator additionIt = this->mAdditions.cbegin ();
+    for ( size_t i = 0; ( additionIt != this->mAdditions.cend ()) && ( i < base ); ++i ) {
+        ++additionIt;
+    }
+
+    for ( size_t i = 0; ( additionIt != this->mAdditions.cend ()) && ( i < count ); ++i, ++additionIt ) {
+
+        AssetODBM assetODBM ( ledger, *additionIt );
+        AccountID ownerID = assetODBM.mOwner.get ();
+        if ( ownerID != accountID ) continue;
+
+        shared_ptr < const Asset > asset = assetODBM.getAsset ( cache );
+        assert ( asset );
+        assetList.push_back ( asset );
+    }
+}
+
+//----------------------------------------------------------------//
+InventoryDelta::InventoryDelta () {
+}
+
+//----------------------------------------------------------------//
+InventoryDelta::~InventoryDelta () {
+}
+
+//----------------------------------------------------------------//
+void InventoryDelta::load ( AccountODBM& accountODBM, u64 from, u64 to ) {
+
+    VOL_METRIC_SPAN ( "volition_inventory_delta_seconds", "Wall time to compact a range of an account's inventory log." );
+
+    size_t checkpoints = 0;
+    size_t entries = 0;
+
+    for ( u64 nonce = from; nonce < to; ) {
+
+        if ((( nonce % CHECKPOINT_INTERVAL ) == 0 ) && (( nonce + CHECKPOINT_INTERVAL ) <= to )) {
+
+            shared_ptr < const InventoryLogEntry > checkpoint = accountODBM.getInventoryCheckpointField ( nonce / CHECKPOINT_INTERVAL ).get ();
+            if ( checkpoint ) {
+                checkpoint->apply ( this->mAdditions, this->mDeletions );
+                nonce += CHECKPOINT_INTERVAL;
+                checkpoints++;
+                continue;
+            }
+        }
+
+        shared_ptr < const InventoryLogEntry > logEntry = accountODBM.getInventoryLogEntryField ( nonce ).get ();
+        if ( logEntry ) {
+            logEntry->apply ( this->mAdditions, this->mDeletions );
+        }
+        nonce++;
+        entries++;
+    }
+
+    VOL_METRIC_COUNT_LABELED ( "volition_inventory_delta_reads_total", "Inventory log records read to compact a delta, by kind.", "kind=\"checkpoint\"", checkpoints );
+    VOL_METRIC_COUNT_LABELED ( "volition_inventory_delta_reads_total", "Inventory log records read to compact a delta, by kind.", "kind=\"entry\"", entries );
+}
+
+} // namespace Volition
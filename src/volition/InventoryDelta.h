@@ -0,0 +1,47 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_INVENTORYDELTA_H
+#define VOLITION_INVENTORYDELTA_H
+
+#include <volition/common.h>
+#include <volition/Asset.h>
+#include <volition/AssetID.h>
+#include <volition/IndexID.h>
+#include <volition/InventoryLogEntry.h>
+#include <volition/serialization/Serialization.h>
+
+namespace Volition {
+
+class AbstractLedger;
+class AccountODBM;
+
+//================================================================//
+// InventoryDelta
+//================================================================//
+// The combined additions and deletions of a range of an account's inventory
+// log, [from, to). Each time the log completes a CHECKPOINT_INTERVAL, the
+// union of that interval's entries is stored as a checkpoint. So a delta
+// over n entries reads about n / CHECKPOINT_INTERVAL checkpoints, plus
+// single entries at the unaligned ends, instead of all n entries. Intervals
+// written before checkpoints existed are replayed entry by entry. The
+// result is the same as replaying every entry: the sets are unions, and an
+// asset updated in place appears in both.
+class InventoryDelta {
+public:
+
+    static const u64 CHECKPOINT_INTERVAL = 64;
+
+    SerializableSet < AssetID::Index >      mAdditions;
+    SerializableSet < AssetID::Index >      mDeletions;
+
+    //----------------------------------------------------------------//
+    static void         checkpoint              ( AccountODBM& accountODBM, u64 inventoryNonce, const InventoryLogEntry& entry );
+    void                expand                  ( const AbstractLedger& ledger, AccountID accountID, size_t base, size_t count, SerializableList < SerializableSharedConstPtr < Asset >>& assetList ) const;
+                        InventoryDelta          ();
+                        ~InventoryDelta         ();
+    void                load                    ( AccountODBM& accountODBM, u64 from, u64 to );
+};
+
+} // namespace Volition
+#endif
@@ -45,14 +45,16 @@ void InventoryLogEntry::expand ( const AbstractLedger& ledger, string accountNam
     
     AccountID accountID = ledger.getAccountID ( accountName );
     
+    AssetReadCache cache ( ledger );
+    
     SerializableSet < AssetID::Index >::const_iterator indexIt = indexSet.cbegin ();
     for ( ; indexIt != indexSet.cend (); ++indexIt ) {
     
-        AssetID::Index assetID = *indexIt;
-        AccountID ownerID = AssetODBM ( ledger, assetID ).mOwner.get ();
+        AssetODBM assetODBM ( ledger, *indexIt );
+        AccountID ownerID = assetODBM.mOwner.get ();
     
         if ( ownerID == accountID ) {
-            shared_ptr < const Asset > asset = AssetODBM ( ledger, assetID ).getAsset ();
+            shared_ptr < const Asset > asset = assetODBM.getAsset ( cache );
             assert ( asset );
             assetList.push_back ( asset );
         }
@@ -1,6 +1,7 @@
 // Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
 // http://cryptogogue.com
 
+#include <volition/AbstractBlockStore.h>
 #include <volition/AccountODBM.h>
 #include <volition/Asset.h>
 #include <volition/AssetMethod.h>
@@ -8,10 +9,12 @@
 #include <volition/AssetODBM.h>
 #include <volition/BlockODBM.h>
 #include <volition/ContractWithDigest.h>
+#include <volition/DeferredBlock.h>
 #include <volition/Format.h>
 #include <volition/Ledger.h>
 #include <volition/LedgerFieldODBM.h>
 #include <volition/LuaContext.h>
+#include <volition/Metrics.h>
 #include <volition/MiningReward.h>
 #include <volition/MonetaryPolicy.h>
 #include <volition/PayoutPolicy.h>
@@ -26,7 +29,17 @@ namespace Volition {
 //================================================================//
 
 //----------------------------------------------------------------//
-AbstractLedger::AbstractLedger () {
+AbstractLedger::AbstractLedger () :
+    mOverlay ( NULL ) {
+}
+
+//----------------------------------------------------------------//
+AbstractLedger::AbstractLedger ( const AbstractLedger& other ) :
+    mOverlay ( NULL ),
+    mSchemaCache ( other.mSchemaCache ),
+    mBlockStore ( other.mBlockStore ) {
+    
+    // a copy starts without the original's overlay; that overlay belongs to (and unwinds with) the original.
 }
 
 //----------------------------------------------------------------//
@@ -127,6 +140,16 @@ string AbstractLedger::chooseReward ( string rewardName ) {
     return rewardName;
 }
 
+//----------------------------------------------------------------//
+void AbstractLedger::clearDeferred ( u64 height ) {
+
+    // the versioned store can't remove a key; an empty value reads back as no copy at all.
+    LedgerKey KEY_FOR_DEFERRED = keyFor_deferred ( height );
+    if ( this->getValueOrFallback < string >( KEY_FOR_DEFERRED, "" ).size ()) {
+        this->setValue < string >( KEY_FOR_DEFERRED, "" );
+    }
+}
+
 //----------------------------------------------------------------//
 void AbstractLedger::clearSchemaCache () {
 
@@ -175,7 +198,11 @@ shared_ptr < const Block > AbstractLedger::getBlock () const {
 shared_ptr < const Block > AbstractLedger::getBlock ( u64 height ) const {
 
     BlockODBM blockODBM ( *this, height );
-    return blockODBM.mBlock.get ();
+    if ( blockODBM.mBlock.exists ()) return blockODBM.mBlock.get ();
+    
+    // body was written to the block store; the ledger only has its hash.
+    if ( this->mBlockStore && blockODBM ) return this->mBlockStore->getBlock ( blockODBM.mHash.get ());
+    return NULL;
 }
 
 //----------------------------------------------------------------//
@@ -196,6 +223,13 @@ time_t AbstractLedger::getBlockDelayInSeconds () const {
     return ( time_t )this->getValue < u64 >( keyFor_blockDelay ());
 }
 
+//----------------------------------------------------------------//
+DeferredBlockList AbstractLedger::getDeferred ( u64 height ) const {
+
+    shared_ptr < DeferredBlockList > deferred = this->getObjectOrNull < DeferredBlockList >( keyFor_deferred ( height ));
+    return deferred ? *deferred : DeferredBlockList ();
+}
+
 //----------------------------------------------------------------//
 Entropy AbstractLedger::getEntropy () const {
 
@@ -296,10 +330,12 @@ const Schema& AbstractLedger::getSchema () const {
     map < string, shared_ptr < const Schema >>::const_iterator schemaIt = schemaCache.find ( schemaHash );
     if ( schemaIt != schemaCache.cend ()) {
         LGN_LOG ( VOL_FILTER_LEDGER, INFO, "Found in cache" );
+        VOL_METRIC_COUNT_LABELED ( "volition_cache_lookups_total", "Cache lookups, by cache and result.", "cache=\"schema\",result=\"hit\"", 1 );
         return *schemaIt->second;
     }
     
     LGN_LOG ( VOL_FILTER_LEDGER, INFO, "Loading schema" );
+    VOL_METRIC_COUNT_LABELED ( "volition_cache_lookups_total", "Cache lookups, by cache and result.", "cache=\"schema\",result=\"miss\"", 1 );
 
     shared_ptr < Schema > schema = make_shared < Schema >();
     schemaCache [ schemaHash ] = schema;
@@ -307,7 +343,7 @@ const Schema& AbstractLedger::getSchema () const {
     if ( schemaHash.size ()) {
         string schemaString = this->getSchemaString ();
         if ( schemaString.size () > 0 ) {
-            FromJSONSerializer::fromJSONString ( *schema, schemaString );
+            FromJSONStreamSerializer::fromJSONString ( *schema, schemaString );
         }
     }
     return *schema;
@@ -333,7 +369,7 @@ SchemaVersion AbstractLedger::getSchemaVersion () const {
     SchemaVersion schemaVersion;
     const string schemaVersionString = this->getValueOrFallback < string >( keyFor_schemaVersion (), "" );
     if ( schemaVersionString.size () > 0 ) {
-        FromJSONSerializer::fromJSONString ( schemaVersion, schemaVersionString );
+        FromJSONStreamSerializer::fromJSONString ( schemaVersion, schemaVersionString );
     }
     return schemaVersion;
 }
@@ -380,6 +416,8 @@ void AbstractLedger::init () {
 
     this->revertAndClear ( 0 );
     this->setObject < SerializableSet < string >>( keyFor_miners (), SerializableSet < string > ());
+    this->setObject < Ledger_Miner::MinerURLMap >( keyFor_minerURLs (), Ledger_Miner::MinerURLMap ());
+    this->setValue < string >( keyFor_minerRegistryStamp (), Ledger_Miner::MINER_REGISTRY_STAMP_INIT );
     this->setValue < AssetID::Index >( keyFor_globalAccountCount (), 0 );
     this->setValue < AssetID::Index >( keyFor_globalAssetCount (), 0 );
     this->setValue < string >( keyFor_schema (), "{}" );
@@ -473,6 +511,11 @@ LedgerResult AbstractLedger::pushBlock ( const Block& block, Block::Verification
         fork.pushVersion ();
         
         this->takeSnapshot ( fork );
+        
+        // only now is the block part of the ledger; a block applied to a scratch fork never reaches the store.
+        if ( this->mBlockStore ) {
+            this->mBlockStore->putBlock ( block );
+        }
     }
     return result;
 }
@@ -509,6 +552,12 @@ void AbstractLedger::serializeEntitlements ( const Account& account, AbstractSer
     });
 }
 
+//----------------------------------------------------------------//
+void AbstractLedger::setDeferred ( u64 height, const DeferredBlockList& deferred ) {
+
+    this->setObject < DeferredBlockList >( keyFor_deferred ( height ), deferred );
+}
+
 //----------------------------------------------------------------//
 void AbstractLedger::setEntitlements ( string name, const Entitlements& entitlements ) {
 
@@ -18,17 +18,20 @@
 #include <volition/Ledger_Inventory.h>
 #include <volition/Ledger_Miner.h>
 #include <volition/LedgerKey.h>
+#include <volition/LedgerWriteOverlay.h>
 #include <volition/SchemaVersion.h>
 #include <volition/serialization/Serialization.h>
 
 namespace Volition {
 
+class AbstractBlockStore;
 class AccountEntitlements;
 class AssetFieldValue;
 class AssetMethod;
 class AssetMethodInvocation;
 class Block;
 class ContractWithDigest;
+class DeferredBlockList;
 class KeyEntitlements;
 class MonetaryPolicy;
 class PayoutPolicy;
@@ -101,9 +104,13 @@ class AbstractLedger :
 protected:
 
     friend class Ledger;
+    friend class LedgerWriteOverlay;
     friend class LockedLedger;
     friend class LockedLedgerIterator;
 
+    // innermost write overlay, if any; installed and removed by LedgerWriteOverlay.
+    LedgerWriteOverlay*         mOverlay;
+
     //----------------------------------------------------------------//
     AbstractLedger&             AbstractLedgerComponent_getLedger           () override;
     const AbstractLedger&       AbstractLedgerComponent_getLedger           () const override;
@@ -114,6 +121,9 @@ public:
 
     mutable map < string, shared_ptr < const Schema >> mSchemaCache;
 
+    // if set, Block::apply writes block bodies here and the ledger keeps only the hash.
+    shared_ptr < AbstractBlockStore >                   mBlockStore;
+
     //----------------------------------------------------------------//
     static LedgerKey keyFor_accountAlias ( string accountName ) {
         assert ( accountName.size () > 0 );
@@ -135,6 +145,11 @@ public:
         return Format::write ( "blockHeightByHash.%s", hash.c_str ());
     }
 
+    //----------------------------------------------------------------//
+    static LedgerKey keyFor_deferred ( u64 height ) {
+        return Format::write ( "deferred.%d", height );
+    }
+
     //----------------------------------------------------------------//
     static LedgerKey keyFor_entitlements ( string name ) {
 
@@ -167,6 +182,16 @@ public:
         return "maxBlockWeight";
     }
 
+    //----------------------------------------------------------------//
+    static LedgerKey keyFor_minerRegistryStamp () {
+        return "minerRegistryStamp";
+    }
+
+    //----------------------------------------------------------------//
+    static LedgerKey keyFor_minerURLs () {
+        return "minerURLs";
+    }
+
     //----------------------------------------------------------------//
     static LedgerKey keyFor_miners () {
         return "miners";
@@ -240,6 +265,7 @@ public:
     }
     
     //----------------------------------------------------------------//
+    // blocks with deferred transactions, and the height each is next due.
     static LedgerKey keyFor_unfinished () {
         return "unfinished";
     }
@@ -251,11 +277,13 @@ public:
 
     //----------------------------------------------------------------//
                                         AbstractLedger                  ();
+                                        AbstractLedger                  ( const AbstractLedger& other );
                                         ~AbstractLedger                 ();
     bool                                canReward                       ( string rewardName ) const;
     bool                                checkMiners                     ( string miners ) const;
     LedgerResult                        checkSchemaMethodsAndRewards    ( const Schema& schema ) const;
     string                              chooseReward                    ( string rewardName );
+    void                                clearDeferred                   ( u64 height );
     void                                clearSchemaCache                ();
     u64                                 countBlocks                     () const;
     u64                                 countVOL                        () const;
@@ -264,6 +292,7 @@ public:
     shared_ptr < const Block >          getBlock                        ( u64 height ) const;
     shared_ptr < const Block >          getBlock                        ( string hash ) const;
     time_t                              getBlockDelayInSeconds          () const;
+    DeferredBlockList                   getDeferred                     ( u64 height ) const;
     Entropy                             getEntropy                      () const;
     string                              getEntropyString                () const;
     string                              getGenesisHash                  () const;
@@ -295,6 +324,7 @@ public:
     string                              printChain                      ( const char* pre = NULL, const char* post = NULL ) const;
     LedgerResult                        pushBlock                       ( const Block& block, Block::VerificationPolicy policy );
     void                                serializeEntitlements           ( const Account& account, AbstractSerializerTo& serializer ) const;
+    void                                setDeferred                     ( u64 height, const DeferredBlockList& deferred );
     void                                setEntitlements                 ( string name, const Entitlements& entitlements );
     void                                setEntropyString                ( string entropy );
     bool                                setIdentity                     ( string identity );
@@ -332,7 +362,11 @@ public:
     template < typename TYPE >
     void getObject ( LedgerKey key, TYPE& object ) const {
     
-        AbstractLedger::getObject < TYPE >( *this, key, object );
+        // read through this->getValueOrFallback, not the snapshot overload, so overlay writes are seen.
+        string json = this->getValueOrFallback < string >( key, "" );
+        if ( json.size () > 0 ) {
+            FromJSONStreamSerializer::fromJSONString ( object, json );
+        }
     }
 
     //----------------------------------------------------------------//
@@ -341,7 +375,7 @@ public:
     
         string json = snapshot.getValueOrFallback < string >( key, "" );
         if ( json.size () > 0 ) {
-            FromJSONSerializer::fromJSONString ( object, json );
+            FromJSONStreamSerializer::fromJSONString ( object, json );
         }
     }
 
@@ -349,7 +383,13 @@ public:
     template < typename TYPE >
     shared_ptr < TYPE > getObjectOrNull ( LedgerKey key ) const {
 
-        return AbstractLedger::getObjectOrNull < TYPE >( *this, key );
+        string json = this->getValueOrFallback < string >( key, "" );
+        if ( json.size () > 0 ) {
+            shared_ptr < TYPE > object = make_shared < TYPE >();
+            FromJSONStreamSerializer::fromJSONString ( *object, json );
+            return object;
+        }
+        return NULL;
     }
     
     //----------------------------------------------------------------//
@@ -359,12 +399,83 @@ public:
         string json = snapshot.getValueOrFallback < string >( key, "" );
         if ( json.size () > 0 ) {
             shared_ptr < TYPE > object = make_shared < TYPE >();
-            FromJSONSerializer::fromJSONString ( *object, json );
+            FromJSONStreamSerializer::fromJSONString ( *object, json );
             return object;
         }
         return NULL;
     }
     
+    //----------------------------------------------------------------//
+    // getValue, getValueOrFallback, hasKey, hasValue and setValue shadow the versioned
+    // store's: while a LedgerWriteOverlay is installed, writes go to it and reads check it first.
+    // only the forms that read or write the current version are shadowed; the rest (e.g. reads
+    // at an explicit version) are brought in unchanged, since the overlay only ever holds the
+    // current version's writes. the LedgerKey forms resolve the key and forward, so that a
+    // LedgerKey never picks a base overload by conversion.
+    using AbstractVersionedStoreTag::getValue;
+    using AbstractVersionedStoreTag::getValueOrFallback;
+    using AbstractVersionedStoreTag::hasKey;
+    using AbstractVersionedStoreTag::hasValue;
+    using AbstractVersionedStoreTag::setValue;
+
+    //----------------------------------------------------------------//
+    template < typename TYPE >
+    TYPE getValue ( LedgerKey key ) const {
+        return this->getValue < TYPE >(( string )key );
+    }
+
+    //----------------------------------------------------------------//
+    template < typename TYPE >
+    TYPE getValue ( string key ) const {
+    
+        if ( this->mOverlay ) {
+            const TYPE* value = this->mOverlay->getValue < TYPE >( key );
+            if ( value ) return *value;
+        }
+        return AbstractVersionedStoreTag::getValue < TYPE >( key );
+    }
+    
+    //----------------------------------------------------------------//
+    template < typename TYPE >
+    TYPE getValueOrFallback ( LedgerKey key, const TYPE& fallback ) const {
+        return this->getValueOrFallback < TYPE >(( string )key, fallback );
+    }
+
+    //----------------------------------------------------------------//
+    template < typename TYPE >
+    TYPE getValueOrFallback ( string key, const TYPE& fallback ) const {
+    
+        if ( this->mOverlay ) {
+            const TYPE* value = this->mOverlay->getValue < TYPE >( key );
+            if ( value ) return *value;
+        }
+        return AbstractVersionedStoreTag::getValueOrFallback < TYPE >( key, fallback );
+    }
+    
+    //----------------------------------------------------------------//
+    bool hasKey ( LedgerKey key ) const {
+        return this->hasKey (( string )key );
+    }
+
+    //----------------------------------------------------------------//
+    bool hasKey ( string key ) const {
+    
+        if ( this->mOverlay && this->mOverlay->hasValue ( key )) return true;
+        return AbstractVersionedStoreTag::hasKey ( key );
+    }
+    
+    //----------------------------------------------------------------//
+    bool hasValue ( LedgerKey key ) const {
+        return this->hasValue (( string )key );
+    }
+
+    //----------------------------------------------------------------//
+    bool hasValue ( string key ) const {
+    
+        if ( this->mOverlay && this->mOverlay->hasValue ( key )) return true;
+        return AbstractVersionedStoreTag::hasValue ( key );
+    }
+    
     //----------------------------------------------------------------//
     template < typename ENTITLEMENTS_FAMILY >
     bool isMoreRestrictivePolicy ( const Policy& policy, const Policy& restriction ) const {
@@ -414,6 +525,23 @@ public:
         string json = ToJSONSerializer::toJSONString ( object );
         this->setValue < string >( key, json );
     }
+    
+    //----------------------------------------------------------------//
+    template < typename TYPE >
+    void setValue ( LedgerKey key, const TYPE& value ) {
+        this->setValue < TYPE >(( string )key, value );
+    }
+
+    //----------------------------------------------------------------//
+    template < typename TYPE >
+    void setValue ( string key, const TYPE& value ) {
+    
+        if ( this->mOverlay ) {
+            this->mOverlay->setValue < TYPE >( key, value );
+            return;
+        }
+        AbstractVersionedStoreTag::setValue < TYPE >( key, value );
+    }
 };
 
 //================================================================//
@@ -435,6 +563,7 @@ public:
         enable_shared_from_this < Ledger > () {
         
         this->mSchemaCache = other.mSchemaCache;
+        this->mBlockStore = other.mBlockStore;
     }
     
     //----------------------------------------------------------------//
@@ -469,6 +598,7 @@ public:
     LockedLedger ( const AbstractLedger& other ) :
         VersionedStoreLock ( other ) {
         this->mSchemaCache = other.mSchemaCache;
+        this->mBlockStore = other.mBlockStore;
     }
 };
 
@@ -493,6 +623,7 @@ public:
     LockedLedgerIterator ( const AbstractLedger& other ) :
         VersionedStoreIterator ( other ) {
         this->mSchemaCache = other.mSchemaCache;
+        this->mBlockStore = other.mBlockStore;
     }
 };
 
@@ -0,0 +1,173 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <volition/Block.h>
+#include <volition/DeferredBlock.h>
+#include <volition/LedgerEventFeed.h>
+#include <volition/Metrics.h>
+#include <volition/Transaction.h>
+
+namespace Volition {
+
+//================================================================//
+// LedgerEvent
+//================================================================//
+
+//----------------------------------------------------------------//
+bool LedgerEvent::matches ( const set < string >& accounts, const set < string >& transactions ) const {
+
+    if ( this->mEveryone ) return true;
+
+    set < string >::const_iterator accountIt = accounts.cbegin ();
+    for ( ; accountIt != accounts.cend (); ++accountIt ) {
+        if ( this->mAccounts.find ( *accountIt ) != this->mAccounts.cend ()) return true;
+    }
+
+    set < string >::const_iterator transactionIt = transactions.cbegin ();
+    for ( ; transactionIt != transactions.cend (); ++transactionIt ) {
+        if ( this->mTransactions.find ( *transactionIt ) != this->mTransactions.cend ()) return true;
+    }
+    return false;
+}
+
+//================================================================//
+// LedgerEventFeed
+//================================================================//
+
+//----------------------------------------------------------------//
+void LedgerEventFeed::addTransaction ( LedgerEvent& event, const Transaction& transaction ) {
+
+    // the maker is in its own access set, along with any accounts the body declares.
+    TransactionAccessSet accessSet = transaction.getAccessSet ();
+    if ( accessSet.mGlobal || accessSet.mAllAccounts ) {
+        event.mEveryone = true;
+    }
+    event.mAccounts.insert ( accessSet.mAccounts.cbegin (), accessSet.mAccounts.cend ());
+}
+
+//----------------------------------------------------------------//
+u64 LedgerEventFeed::getNextNonce () const {
+
+    lock_guard < mutex > lock ( this->mMutex );
+    return this->mNextNonce;
+}
+
+//----------------------------------------------------------------//
+LedgerEventFeed::LedgerEventFeed () :
+    mNextNonce ( 0 ),
+    mLastHeight ( 0 ),
+    mWaiters ( 0 ),
+    mMaxWaiters ( DEFAULT_MAX_WAITERS ) {
+}
+
+//----------------------------------------------------------------//
+LedgerEventFeed::~LedgerEventFeed () {
+}
+
+//----------------------------------------------------------------//
+void LedgerEventFeed::publish ( const Block& block, const DeferredBlockList& matured, bool everyone ) {
+
+    LedgerEvent event;
+    event.mHeight       = block.getHeight ();
+    event.mHash         = block.getDigest ().toHex ();
+    event.mEveryone     = everyone;
+
+    event.mAccounts.insert ( block.getMinerID ());
+
+    for ( size_t i = 0; i < block.countTransactions (); ++i ) {
+
+        const Transaction* transaction = block.getTransaction ( i );
+        if ( !transaction ) continue;
+
+        event.mTransactions.insert ( transaction->getUUID ());
+        LedgerEventFeed::addTransaction ( event, *transaction );
+    }
+
+    // deferred transactions maturing now were recorded (and reported) with their own blocks;
+    // only the accounts they touch, and the miners they credit, are news here.
+    DeferredBlockList::Iterator deferredBlockIt = matured.mBlocks.cbegin ();
+    for ( ; deferredBlockIt != matured.mBlocks.cend (); ++deferredBlockIt ) {
+
+        event.mAccounts.insert ( deferredBlockIt->mMinerID );
+
+        SerializableList < DeferredTransaction >::const_iterator transactionIt = deferredBlockIt->mTransactions.cbegin ();
+        for ( ; transactionIt != deferredBlockIt->mTransactions.cend (); ++transactionIt ) {
+            if ( transactionIt->mTransaction ) {
+                LedgerEventFeed::addTransaction ( event, *transactionIt->mTransaction );
+            }
+        }
+    }
+
+    VOL_METRIC_COUNT_LABELED ( "volition_ledger_events_total", "Ledger change events published to subscribers, by scope.", event.mEveryone ? "scope=\"everyone\"" : "scope=\"accounts\"", 1 );
+
+    {
+        lock_guard < mutex > lock ( this->mMutex );
+
+        // a block at or below the last height replaces history; whatever the old blocks changed is unknown here.
+        if (( this->mNextNonce > 0 ) && ( event.mHeight <= this->mLastHeight )) {
+            event.mEveryone = true;
+        }
+
+        event.mNonce = this->mNextNonce++;
+        this->mLastHeight = event.mHeight;
+
+        this->mEvents.push_back ( event );
+        while ( this->mEvents.size () > MAX_EVENTS ) {
+            this->mEvents.pop_front ();
+        }
+    }
+    this->mCondition.notify_all ();
+}
+
+//----------------------------------------------------------------//
+void LedgerEventFeed::setMaxWaiters ( size_t maxWaiters ) {
+
+    lock_guard < mutex > lock ( this->mMutex );
+    this->mMaxWaiters = maxWaiters;
+}
+
+//----------------------------------------------------------------//
+LedgerEventFeed::WaitResult LedgerEventFeed::wait ( u64 since, const set < string >& accounts, const set < string >& transactions, u64 timeoutMillis, vector < LedgerEvent >& events, u64& next ) const {
+
+    chrono::steady_clock::time_point deadline = chrono::steady_clock::now () + chrono::milliseconds ( timeoutMillis );
+
+    unique_lock < mutex > lock ( this->mMutex );
+
+    if ( this->mWaiters >= this->mMaxWaiters ) {
+        next = since;
+        return WAIT_BUSY;
+    }
+    this->mWaiters++;
+
+    WaitResult result = WAIT_OK;
+
+    while ( true ) {
+
+        // the reader is asking for events that were dropped (or from before a restart); it has to resync.
+        u64 oldest = this->mEvents.size () ? this->mEvents.front ().mNonce : this->mNextNonce;
+        if (( since < oldest ) || ( since > this->mNextNonce )) {
+            since = this->mNextNonce;
+            result = WAIT_RESYNC;
+            break;
+        }
+
+        deque < LedgerEvent >::const_iterator eventIt = this->mEvents.cbegin () + ( long )( since - oldest );
+        for ( ; eventIt != this->mEvents.cend (); ++eventIt ) {
+            if ( eventIt->matches ( accounts, transactions )) {
+                events.push_back ( *eventIt );
+            }
+        }
+
+        // a reader that can't wait (or is out of time) never lets go of the lock, so it sees the feed in one piece.
+        since = this->mNextNonce;
+        if ( events.size () || ( chrono::steady_clock::now () >= deadline )) break;
+        if ( this->mCondition.wait_until ( lock, deadline ) == cv_status::timeout ) break;
+    }
+
+    this->mWaiters--;
+
+    next = since;
+    return result;
+}
+
+} // namespace Volition
@@ -0,0 +1,121 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_LEDGEREVENTFEED_H
+#define VOLITION_LEDGEREVENTFEED_H
+
+#include <volition/common.h>
+#include <volition/serialization/Serialization.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace Volition {
+
+class Block;
+class DeferredBlockList;
+class Transaction;
+
+//================================================================//
+// LedgerEvent
+//================================================================//
+// What changed when one block was pushed onto the miner's ledger: the
+// accounts touched by its transactions and by any deferred transactions
+// maturing with it (makers, declared receivers and the miners credited)
+// and the UUIDs of the transactions it recorded. If the block's effects
+// can't be narrowed down to accounts (a rewind, or a transaction whose
+// access set is global or spans all accounts) mEveryone is set and every
+// subscriber should refresh.
+class LedgerEvent :
+    public AbstractSerializable {
+public:
+
+    u64                             mNonce;         // position in the feed
+    u64                             mHeight;        // height of the block
+    string                          mHash;
+    bool                            mEveryone;
+    SerializableSet < string >      mAccounts;
+    SerializableSet < string >      mTransactions;
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeFrom ( const AbstractSerializerFrom& serializer ) override {
+
+        serializer.serialize ( "nonce",             this->mNonce );
+        serializer.serialize ( "height",            this->mHeight );
+        serializer.serialize ( "hash",              this->mHash );
+        serializer.serialize ( "everyone",          this->mEveryone );
+        serializer.serialize ( "accounts",          this->mAccounts );
+        serializer.serialize ( "transactions",      this->mTransactions );
+    }
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeTo ( AbstractSerializerTo& serializer ) const override {
+
+        serializer.serialize ( "nonce",             this->mNonce );
+        serializer.serialize ( "height",            this->mHeight );
+        serializer.serialize ( "hash",              this->mHash );
+        serializer.serialize ( "everyone",          this->mEveryone );
+        serializer.serialize ( "accounts",          this->mAccounts );
+        serializer.serialize ( "transactions",      this->mTransactions );
+    }
+
+    //----------------------------------------------------------------//
+    bool matches ( const set < string >& accounts, const set < string >& transactions ) const;
+
+    //----------------------------------------------------------------//
+    LedgerEvent () :
+        mNonce ( 0 ),
+        mHeight ( 0 ),
+        mEveryone ( false ) {
+    }
+};
+
+//================================================================//
+// LedgerEventFeed
+//================================================================//
+// A bounded, in-memory feed of LedgerEvents, published by the miner once
+// per pushed block and read by long-polling API clients. Readers never
+// touch the miner or its ledger lock: they wait on the feed's own
+// condition variable until an event they care about arrives or they time
+// out. Only the last MAX_EVENTS are kept; a reader that asks for anything
+// older is told to resync. Each blocked reader holds an HTTP server thread,
+// so at most mMaxWaiters may block at once; past that, wait () answers
+// WAIT_BUSY right away and the caller should back off.
+class LedgerEventFeed {
+public:
+
+    static const size_t MAX_EVENTS              = 1024;
+    static const size_t DEFAULT_MAX_WAITERS     = 8;
+
+    enum WaitResult {
+        WAIT_OK,            // 'events' holds whatever matched (possibly nothing, on timeout)
+        WAIT_RESYNC,        // 'since' is outside the retained window
+        WAIT_BUSY,          // too many readers already blocked; nothing was read
+    };
+
+private:
+
+    mutable mutex                   mMutex;
+    mutable condition_variable      mCondition;
+    deque < LedgerEvent >           mEvents;
+    u64                             mNextNonce;
+    u64                             mLastHeight;
+    mutable size_t                  mWaiters;
+    size_t                          mMaxWaiters;
+
+    //----------------------------------------------------------------//
+    static void     addTransaction          ( LedgerEvent& event, const Transaction& transaction );
+
+public:
+
+    //----------------------------------------------------------------//
+    u64             getNextNonce            () const;
+                    LedgerEventFeed         ();
+                    ~LedgerEventFeed        ();
+    void            publish                 ( const Block& block, const DeferredBlockList& matured, bool everyone );
+    void            setMaxWaiters           ( size_t maxWaiters );
+    WaitResult      wait                    ( u64 since, const set < string >& accounts, const set < string >& transactions, u64 timeoutMillis, vector < LedgerEvent >& events, u64& next ) const;
+};
+
+} // namespace Volition
+#endif
@@ -0,0 +1,221 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <volition/BlockODBM.h>
+#include <volition/Digest.h>
+#include <volition/Ledger.h>
+#include <volition/LedgerSnapshot.h>
+
+namespace Volition {
+
+//================================================================//
+// LedgerSnapshotManifest
+//================================================================//
+
+//----------------------------------------------------------------//
+size_t LedgerSnapshotManifest::countChunks () const {
+
+    if ( this->mAccountsPerChunk == 0 ) return 0;
+    return ( size_t )( 1 + (( this->mTotalAccounts + this->mAccountsPerChunk - 1 ) / this->mAccountsPerChunk ));
+}
+
+//----------------------------------------------------------------//
+string LedgerSnapshotManifest::getDigest () const {
+
+    return Digest ( *this ).toHex ();
+}
+
+//----------------------------------------------------------------//
+bool LedgerSnapshotManifest::isConsistent () const {
+
+    return (( this->mHeight > 0 ) && this->mBlockHash.size () && this->mAccountsPerChunk && ( this->mChunkDigests.size () == this->countChunks ()));
+}
+
+//----------------------------------------------------------------//
+LedgerSnapshotManifest::LedgerSnapshotManifest () :
+    mHeight ( 0 ),
+    mTotalAccounts ( 0 ),
+    mAccountsPerChunk ( 0 ) {
+}
+
+//----------------------------------------------------------------//
+bool LedgerSnapshotManifest::verifyChunk ( size_t chunkIndex, const string& chunk ) const {
+
+    if ( chunkIndex >= this->mChunkDigests.size ()) return false;
+    return ( Digest ( chunk ).toHex () == this->mChunkDigests [ chunkIndex ]);
+}
+
+//================================================================//
+// LedgerSnapshot
+//================================================================//
+
+//----------------------------------------------------------------//
+string LedgerSnapshot::encodeChunk ( AbstractLedger& ledger, u64 accountsPerChunk, size_t chunkIndex ) {
+
+    if ( chunkIndex == 0 ) return Ledger_Dump::encodeHeader ( ledger );
+
+    AccountID::Index totalAccounts = ledger.getValue < AccountID::Index >( Ledger::keyFor_globalAccountCount ());
+
+    u64 base = ( chunkIndex - 1 ) * accountsPerChunk;
+    u64 top = base + accountsPerChunk;
+    top = top < totalAccounts ? top : totalAccounts;
+
+    return ( base < top ) ? Ledger_Dump::encodeAccountRange ( ledger, base, top ) : "";
+}
+
+//----------------------------------------------------------------//
+string LedgerSnapshot::encodeEnd ( const LedgerSnapshotManifest& manifest ) {
+
+    return Ledger_Dump::encodeEnd ( manifest.mTotalAccounts );
+}
+
+//----------------------------------------------------------------//
+u64 LedgerSnapshot::getSnapshotHeight ( u64 totalBlocks ) {
+
+    if ( totalBlocks == 0 ) return 0;
+    return (( totalBlocks - 1 ) / SNAPSHOT_INTERVAL ) * SNAPSHOT_INTERVAL;
+}
+
+//----------------------------------------------------------------//
+shared_ptr < const LedgerSnapshotManifest > LedgerSnapshot::makeManifest ( AbstractLedger& ledger, u64 accountsPerChunk ) {
+
+    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+
+    u64 totalBlocks = ledger.countBlocks ();
+    if (( totalBlocks < 2 ) || ( accountsPerChunk == 0 )) return NULL;
+
+    shared_ptr < LedgerSnapshotManifest > manifest = make_shared < LedgerSnapshotManifest >();
+
+    manifest->mHeight               = totalBlocks - 1;
+    manifest->mBlockHash            = BlockODBM ( ledger, manifest->mHeight ).mHash.get ();
+    manifest->mGenesisHash          = BlockODBM ( ledger, 0 ).mHash.get ();
+    manifest->mTotalAccounts        = ledger.getValue < AccountID::Index >( Ledger::keyFor_globalAccountCount ());
+    manifest->mAccountsPerChunk     = accountsPerChunk;
+
+    size_t totalChunks = manifest->countChunks ();
+    manifest->mChunkDigests.reserve ( totalChunks );
+
+    for ( size_t i = 0; i < totalChunks; ++i ) {
+        manifest->mChunkDigests.push_back ( Digest ( LedgerSnapshot::encodeChunk ( ledger, accountsPerChunk, i )).toHex ());
+    }
+    return manifest;
+}
+
+//================================================================//
+// LedgerSnapshotCache
+//================================================================//
+
+//----------------------------------------------------------------//
+shared_ptr < const LedgerSnapshotManifest > LedgerSnapshotCache::build ( u64 height, string blockHash ) {
+
+    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+
+    shared_ptr < LedgerSnapshotManifest > manifest = make_shared < LedgerSnapshotManifest >();
+    
+    manifest->mHeight               = height;
+    manifest->mBlockHash            = blockHash;
+    manifest->mAccountsPerChunk     = this->mAccountsPerChunk;
+    
+    bool isCurrent = false;
+    
+    bool found = this->mReader ( height, [ & ]( AbstractLedger& ledger ) {
+        isCurrent = ( BlockODBM ( ledger, height ).mHash.get () == blockHash );
+        manifest->mGenesisHash      = BlockODBM ( ledger, 0 ).mHash.get ();
+        manifest->mTotalAccounts    = ledger.getValue < AccountID::Index >( Ledger::keyFor_globalAccountCount ());
+    });
+    if ( !( found && isCurrent )) return NULL;
+
+    size_t totalChunks = manifest->countChunks ();
+    manifest->mChunkDigests.reserve ( totalChunks );
+
+    for ( size_t i = 0; i < totalChunks; ++i ) {
+    
+        {
+            lock_guard < mutex > lock ( this->mMutex );
+            if ( this->mStop ) return NULL;
+        }
+    
+        string digest;
+        found = this->mReader ( height, [ & ]( AbstractLedger& ledger ) {
+            isCurrent = ( BlockODBM ( ledger, height ).mHash.get () == blockHash );
+            if ( isCurrent ) {
+                digest = Digest ( LedgerSnapshot::encodeChunk ( ledger, this->mAccountsPerChunk, i )).toHex ();
+            }
+        });
+        if ( !( found && isCurrent )) return NULL;
+        
+        manifest->mChunkDigests.push_back ( digest );
+    }
+    return manifest;
+}
+
+//----------------------------------------------------------------//
+shared_ptr < const LedgerSnapshotManifest > LedgerSnapshotCache::getManifest ( u64 height, string blockHash ) {
+
+    if ( height == 0 ) return NULL;
+
+    lock_guard < mutex > lock ( this->mMutex );
+
+    if ( this->mManifest && ( this->mManifest->mHeight == height ) && ( this->mManifest->mBlockHash == blockHash )) {
+        return this->mManifest;
+    }
+
+    this->mRequestedHeight = height;
+    this->mRequestedHash = blockHash;
+    
+    if ( !this->mThread.joinable ()) {
+        this->mThread = thread ([ this ]() { this->run (); });
+    }
+    this->mWake.notify_one ();
+    
+    return NULL;
+}
+
+//----------------------------------------------------------------//
+LedgerSnapshotCache::LedgerSnapshotCache ( LedgerReader reader, u64 accountsPerChunk ) :
+    mReader ( reader ),
+    mAccountsPerChunk ( accountsPerChunk ),
+    mStop ( false ),
+    mRequestedHeight ( 0 ) {
+}
+
+//----------------------------------------------------------------//
+LedgerSnapshotCache::~LedgerSnapshotCache () {
+
+    {
+        lock_guard < mutex > lock ( this->mMutex );
+        this->mStop = true;
+    }
+    this->mWake.notify_all ();
+    
+    if ( this->mThread.joinable ()) {
+        this->mThread.join ();
+    }
+}
+
+//----------------------------------------------------------------//
+void LedgerSnapshotCache::run () {
+
+    unique_lock < mutex > lock ( this->mMutex );
+
+    while ( true ) {
+    
+        this->mWake.wait ( lock, [ this ]() { return ( this->mStop || ( this->mRequestedHeight > 0 )); });
+        if ( this->mStop ) break;
+        
+        u64 height = this->mRequestedHeight;
+        string blockHash = this->mRequestedHash;
+        this->mRequestedHeight = 0;
+        
+        lock.unlock ();
+        shared_ptr < const LedgerSnapshotManifest > manifest = this->build ( height, blockHash );
+        lock.lock ();
+        
+        // a build that lost a race with a newer one is dropped; a failed one waits to be asked again.
+        if ( manifest && (( !this->mManifest ) || ( this->mManifest->mHeight <= manifest->mHeight ))) {
+            this->mManifest = manifest;
+        }
+    }
+}
+
+} // namespace Volition
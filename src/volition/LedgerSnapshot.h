@@ -0,0 +1,127 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_LEDGERSNAPSHOT_H
+#define VOLITION_LEDGERSNAPSHOT_H
+
+#include <volition/common.h>
+#include <volition/serialization/Serialization.h>
+#include <condition_variable>
+#include <thread>
+
+namespace Volition {
+
+class AbstractLedger;
+
+//================================================================//
+// LedgerSnapshotManifest
+//================================================================//
+// Describes a snapshot of the ledger taken right after the block at mHeight.
+// The snapshot itself is a ledger dump stream (see Ledger_Dump) cut into
+// chunks: chunk 0 is the dump header and chunk N (N > 0) holds the account
+// records for indices [( N - 1 ) * mAccountsPerChunk, N * mAccountsPerChunk ).
+// Each chunk is addressed by its SHA256, so chunks may be fetched from any
+// peer that agrees on the manifest.
+class LedgerSnapshotManifest :
+    public AbstractSerializable {
+public:
+
+    u64                                 mHeight;
+    string                              mBlockHash;
+    string                              mGenesisHash;
+    u64                                 mTotalAccounts;
+    u64                                 mAccountsPerChunk;
+    SerializableVector < string >       mChunkDigests;
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeFrom ( const AbstractSerializerFrom& serializer ) override {
+
+        serializer.serialize ( "height",            this->mHeight );
+        serializer.serialize ( "blockHash",         this->mBlockHash );
+        serializer.serialize ( "genesisHash",       this->mGenesisHash );
+        serializer.serialize ( "totalAccounts",     this->mTotalAccounts );
+        serializer.serialize ( "accountsPerChunk",  this->mAccountsPerChunk );
+        serializer.serialize ( "chunkDigests",      this->mChunkDigests );
+    }
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeTo ( AbstractSerializerTo& serializer ) const override {
+
+        serializer.serialize ( "height",            this->mHeight );
+        serializer.serialize ( "blockHash",         this->mBlockHash );
+        serializer.serialize ( "genesisHash",       this->mGenesisHash );
+        serializer.serialize ( "totalAccounts",     this->mTotalAccounts );
+        serializer.serialize ( "accountsPerChunk",  this->mAccountsPerChunk );
+        serializer.serialize ( "chunkDigests",      this->mChunkDigests );
+    }
+
+    //----------------------------------------------------------------//
+    size_t      countChunks                 () const;
+    string      getDigest                   () const;
+    bool        isConsistent                () const;
+                LedgerSnapshotManifest      ();
+    bool        verifyChunk                 ( size_t chunkIndex, const string& chunk ) const;
+};
+
+//================================================================//
+// LedgerSnapshot
+//================================================================//
+// Snapshots are only taken at multiples of SNAPSHOT_INTERVAL, so every peer
+// near the tip of the chain offers the same one and the manifest (which
+// requires encoding every account) is built once per interval. Building the
+// manifest walks the whole ledger; LedgerSnapshotCache keeps the latest one.
+class LedgerSnapshot {
+public:
+
+    static const u64 SNAPSHOT_INTERVAL          = 1024;
+    static const u64 ACCOUNTS_PER_CHUNK         = 256;
+
+    //----------------------------------------------------------------//
+    static string                                       encodeChunk             ( AbstractLedger& ledger, u64 accountsPerChunk, size_t chunkIndex );
+    static string                                       encodeEnd               ( const LedgerSnapshotManifest& manifest );
+    static u64                                          getSnapshotHeight       ( u64 totalBlocks );
+    static shared_ptr < const LedgerSnapshotManifest >  makeManifest            ( AbstractLedger& ledger, u64 accountsPerChunk = ACCOUNTS_PER_CHUNK );
+};
+
+//================================================================//
+// LedgerSnapshotCache
+//================================================================//
+// Builds manifests on a thread of its own, so an HTTP request never waits
+// on (or holds a ledger lock for) a walk over every account. getManifest
+// returns the manifest if it's ready and otherwise queues it and returns
+// NULL; peers ask again. The ledger is read through mReader, which takes
+// whatever lock the owner needs and is called once per chunk, so a build
+// never holds the lock for long. A build is dropped if the block at the
+// snapshot height changes under it.
+class LedgerSnapshotCache {
+public:
+
+    typedef function < bool ( u64 height, const function < void ( AbstractLedger& )>& visitor )> LedgerReader;
+
+private:
+
+    LedgerReader                                    mReader;
+    u64                                             mAccountsPerChunk;
+
+    mutable mutex                                   mMutex;
+    condition_variable                              mWake;
+    thread                                          mThread;
+    bool                                            mStop;
+    u64                                             mRequestedHeight;
+    string                                          mRequestedHash;
+    shared_ptr < const LedgerSnapshotManifest >     mManifest;
+
+    //----------------------------------------------------------------//
+    shared_ptr < const LedgerSnapshotManifest >     build                   ( u64 height, string blockHash );
+    void                                            run                     ();
+
+public:
+
+    //----------------------------------------------------------------//
+    shared_ptr < const LedgerSnapshotManifest >     getManifest             ( u64 height, string blockHash );
+                                                    LedgerSnapshotCache     ( LedgerReader reader, u64 accountsPerChunk = LedgerSnapshot::ACCOUNTS_PER_CHUNK );
+                                                    ~LedgerSnapshotCache    ();
+};
+
+} // namespace Volition
+#endif
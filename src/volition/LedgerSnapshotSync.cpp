@@ -0,0 +1,272 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <volition/AbstractBlockTree.h>
+#include <volition/LedgerSnapshotSync.h>
+
+namespace Volition {
+
+//================================================================//
+// LedgerSnapshotSync
+//================================================================//
+
+//----------------------------------------------------------------//
+void LedgerSnapshotSync::chooseManifest ( const AbstractBlockTree& blockTree, BlockTreeCursor bestBranch ) {
+
+    if ( !bestBranch.hasHeader ()) return;
+
+    // prefer the highest snapshot that enough miners agree on.
+    shared_ptr < const LedgerSnapshotManifest > best;
+    string bestDigest;
+
+    map < string, set < string >>::const_iterator digestIt = this->mURLsByDigest.cbegin ();
+    for ( ; digestIt != this->mURLsByDigest.cend (); ++digestIt ) {
+
+        if ( digestIt->second.size () < this->mQuorum ) continue;
+
+        shared_ptr < const LedgerSnapshotManifest > manifest = this->mManifestsByDigest [ digestIt->first ];
+        if ( best && ( manifest->mHeight <= best->mHeight )) continue;
+
+        // the snapshot must have been taken right after a block we already agree with.
+        BlockTreeCursor cursor = blockTree.findCursorForHash ( manifest->mBlockHash );
+        if ( !( cursor.hasHeader () && ( cursor.getHeight () == manifest->mHeight ))) continue;
+        if (( bestBranch.getHeight () < manifest->mHeight ) || !cursor.isAncestorOf ( bestBranch )) continue;
+
+        best = manifest;
+        bestDigest = digestIt->first;
+    }
+
+    if ( !best ) return;
+
+    this->mOutStream.open ( this->mFilename, ios_base::out | ios_base::binary | ios_base::trunc );
+    if ( !this->mOutStream.is_open ()) {
+        LGN_LOG ( VOL_FILTER_CONSENSUS, ERROR, "SNAPSHOT: could not open '%s' for writing", this->mFilename.c_str ());
+        this->mState = STATE_FAILED;
+        return;
+    }
+
+    this->mManifest = best;
+    this->mSources = this->mURLsByDigest [ bestDigest ];
+    this->mNextChunk = 0;
+
+    size_t totalChunks = best->countChunks ();
+    for ( size_t i = 0; i < totalChunks; ++i ) {
+        this->mMissing.insert ( i );
+    }
+
+    LGN_LOG ( VOL_FILTER_CONSENSUS, INFO, "SNAPSHOT: downloading %d chunks at height %d from %d miners", ( int )totalChunks, ( int )best->mHeight, ( int )this->mSources.size ());
+    this->mState = STATE_DOWNLOADING;
+}
+
+//----------------------------------------------------------------//
+bool LedgerSnapshotSync::isDone () const {
+
+    return (( this->mState == STATE_COMPLETE ) || ( this->mState == STATE_FAILED ));
+}
+
+//----------------------------------------------------------------//
+LedgerSnapshotSync::LedgerSnapshotSync ( string filename, size_t quorum ) :
+    mFilename ( filename ),
+    mQuorum ( quorum ? quorum : 1 ),
+    mState ( STATE_COLLECTING_MANIFESTS ),
+    mNextChunk ( 0 ) {
+}
+
+//----------------------------------------------------------------//
+LedgerSnapshotSync::~LedgerSnapshotSync () {
+}
+
+//----------------------------------------------------------------//
+void LedgerSnapshotSync::receiveChunk ( const MiningMessengerResponse& response ) {
+
+    const MiningMessengerRequest& request = response.mRequest;
+    string url = request.mMinerURL;
+    size_t chunkIndex = request.mChunkIndex;
+
+    if ( this->mInFlightByURL [ url ] > 0 ) {
+        this->mInFlightByURL [ url ]--;
+    }
+
+    // stale response from an earlier manifest or a chunk already reassigned.
+    if (( this->mState != STATE_DOWNLOADING ) || ( request.mHeight != this->mManifest->mHeight )) return;
+
+    map < size_t, string >::iterator inFlightIt = this->mInFlight.find ( chunkIndex );
+    if (( inFlightIt == this->mInFlight.end ()) || ( inFlightIt->second != url )) return;
+    this->mInFlight.erase ( inFlightIt );
+
+    if ( response.mStatus != MiningMessengerResponse::STATUS_OK ) {
+    
+        // a timeout or busy server isn't a reason to give up on a miner; ask again.
+        this->mMissing.insert ( chunkIndex );
+        if ( ++this->mFailuresByURL [ url ] >= MAX_CHUNK_FAILURES ) {
+            LGN_LOG ( VOL_FILTER_CONSENSUS, WARNING, "SNAPSHOT: dropping %s after %d failed chunk requests", url.c_str (), ( int )MAX_CHUNK_FAILURES );
+            this->mSources.erase ( url );
+        }
+        return;
+    }
+
+    if ( !this->mManifest->verifyChunk ( chunkIndex, response.mSnapshotChunk )) {
+        LGN_LOG ( VOL_FILTER_CONSENSUS, WARNING, "SNAPSHOT: bad chunk %d from %s", ( int )chunkIndex, url.c_str ());
+        this->mSources.erase ( url );
+        this->mMissing.insert ( chunkIndex );
+        return;
+    }
+
+    this->mFailuresByURL.erase ( url );
+    this->mBuffered [ chunkIndex ] = response.mSnapshotChunk;
+    this->writeChunks ();
+}
+
+//----------------------------------------------------------------//
+void LedgerSnapshotSync::receiveManifest ( const MiningMessengerResponse& response ) {
+
+    if ( this->mState != STATE_COLLECTING_MANIFESTS ) return;
+    
+    // peers build manifests in the background and answer NOT_FOUND until one is ready; ask again.
+    if ( response.mStatus != MiningMessengerResponse::STATUS_OK ) {
+        this->mAskedURLs.erase ( response.mRequest.mMinerURL );
+        return;
+    }
+
+    shared_ptr < const LedgerSnapshotManifest > manifest = response.mSnapshotManifest;
+    if ( !( manifest && manifest->isConsistent ())) return;
+
+    string digest = manifest->getDigest ();
+    if ( this->mManifestsByDigest.find ( digest ) == this->mManifestsByDigest.cend ()) {
+        this->mManifestsByDigest [ digest ] = manifest;
+    }
+    this->mURLsByDigest [ digest ].insert ( response.mRequest.mMinerURL );
+}
+
+//----------------------------------------------------------------//
+void LedgerSnapshotSync::receiveResponse ( const MiningMessengerResponse& response ) {
+
+    switch ( response.mRequest.mRequestType ) {
+
+        case MiningMessengerRequest::REQUEST_SNAPSHOT_CHUNK:
+            this->receiveChunk ( response );
+            break;
+
+        case MiningMessengerRequest::REQUEST_SNAPSHOT_MANIFEST:
+            this->receiveManifest ( response );
+            break;
+
+        default:
+            break;
+    }
+}
+
+//----------------------------------------------------------------//
+void LedgerSnapshotSync::requestChunks ( AbstractMiningMessenger& messenger, const set < string >& onlineURLs ) {
+
+    // requeue chunks held by miners that have since gone offline.
+    map < size_t, string >::iterator inFlightIt = this->mInFlight.begin ();
+    while ( inFlightIt != this->mInFlight.end ()) {
+        if ( onlineURLs.find ( inFlightIt->second ) == onlineURLs.cend ()) {
+            this->mInFlightByURL.erase ( inFlightIt->second );
+            this->mMissing.insert ( inFlightIt->first );
+            inFlightIt = this->mInFlight.erase ( inFlightIt );
+        }
+        else {
+            ++inFlightIt;
+        }
+    }
+
+    set < string >::const_iterator sourceIt = this->mSources.cbegin ();
+    for ( ; sourceIt != this->mSources.cend (); ++sourceIt ) {
+
+        string url = *sourceIt;
+        if ( onlineURLs.find ( url ) == onlineURLs.cend ()) continue;
+
+        size_t& inFlight = this->mInFlightByURL [ url ];
+        while (( inFlight < MAX_CHUNKS_PER_MINER ) && this->mMissing.size ()) {
+
+            size_t chunkIndex = *this->mMissing.cbegin ();
+            if ( chunkIndex >= ( this->mNextChunk + MAX_CHUNK_WINDOW )) return;
+
+            this->mMissing.erase ( this->mMissing.cbegin ());
+            this->mInFlight [ chunkIndex ] = url;
+            inFlight++;
+
+            messenger.enqueueSnapshotChunkRequest ( url, this->mManifest->mHeight, chunkIndex );
+        }
+    }
+}
+
+//----------------------------------------------------------------//
+void LedgerSnapshotSync::restart () {
+
+    LGN_LOG ( VOL_FILTER_CONSENSUS, WARNING, "SNAPSHOT: no miners left to serve the snapshot; starting over" );
+
+    if ( this->mOutStream.is_open ()) {
+        this->mOutStream.close ();
+    }
+
+    this->mAskedURLs.clear ();
+    this->mManifestsByDigest.clear ();
+    this->mURLsByDigest.clear ();
+    this->mManifest = NULL;
+    this->mSources.clear ();
+    this->mMissing.clear ();
+    this->mInFlight.clear ();
+    this->mInFlightByURL.clear ();
+    this->mFailuresByURL.clear ();
+    this->mBuffered.clear ();
+    this->mNextChunk = 0;
+    this->mState = STATE_COLLECTING_MANIFESTS;
+}
+
+//----------------------------------------------------------------//
+void LedgerSnapshotSync::update ( AbstractMiningMessenger& messenger, const AbstractBlockTree& blockTree, BlockTreeCursor bestBranch, const set < string >& onlineURLs ) {
+
+    switch ( this->mState ) {
+
+        case STATE_COLLECTING_MANIFESTS: {
+
+            set < string >::const_iterator urlIt = onlineURLs.cbegin ();
+            for ( ; urlIt != onlineURLs.cend (); ++urlIt ) {
+                if ( this->mAskedURLs.find ( *urlIt ) != this->mAskedURLs.cend ()) continue;
+                this->mAskedURLs.insert ( *urlIt );
+                messenger.enqueueSnapshotManifestRequest ( *urlIt );
+            }
+            this->chooseManifest ( blockTree, bestBranch );
+            break;
+        }
+
+        case STATE_DOWNLOADING: {
+
+            if ( this->mSources.size () == 0 ) {
+                this->restart ();
+                break;
+            }
+            this->requestChunks ( messenger, onlineURLs );
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+//----------------------------------------------------------------//
+void LedgerSnapshotSync::writeChunks () {
+
+    map < size_t, string >::iterator bufferedIt = this->mBuffered.find ( this->mNextChunk );
+    for ( ; bufferedIt != this->mBuffered.end (); bufferedIt = this->mBuffered.find ( this->mNextChunk )) {
+
+        this->mOutStream << bufferedIt->second;
+        this->mBuffered.erase ( bufferedIt );
+        this->mNextChunk++;
+    }
+    this->mOutStream.flush ();
+
+    if ( this->mNextChunk < this->mManifest->countChunks ()) return;
+
+    this->mOutStream << LedgerSnapshot::encodeEnd ( *this->mManifest );
+    this->mOutStream.close ();
+
+    LGN_LOG ( VOL_FILTER_CONSENSUS, INFO, "SNAPSHOT: saved snapshot at height %d to '%s'", ( int )this->mManifest->mHeight, this->mFilename.c_str ());
+    this->mState = STATE_COMPLETE;
+}
+
+} // namespace Volition
@@ -0,0 +1,88 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_LEDGERSNAPSHOTSYNC_H
+#define VOLITION_LEDGERSNAPSHOTSYNC_H
+
+#include <volition/common.h>
+#include <volition/AbstractMiningMessenger.h>
+#include <volition/Accessors.h>
+#include <volition/BlockTreeCursor.h>
+#include <volition/LedgerSnapshot.h>
+
+namespace Volition {
+
+class AbstractBlockTree;
+
+//================================================================//
+// LedgerSnapshotSync
+//================================================================//
+// Downloads a ledger snapshot from the network. A manifest is accepted once
+// mQuorum online miners have served the same one and its block hash is a
+// header on the miner's best branch. Chunks are then requested in parallel
+// from every miner that agreed, checked against the manifest's digests and
+// appended to mFilename in order; the result is a ledger dump that can be
+// restored (or turned into a genesis block) like any other. A chunk that fails
+// is asked for again; a miner is dropped after it serves a bad chunk or fails
+// MAX_CHUNK_FAILURES times running. If none are left, the sync starts over.
+// The miner never loads the file into its own ledger: a dump leaves out
+// nonces, offers and deferred transactions, and nothing ties its accounts
+// to the chain's state beyond the miners who agreed on the manifest.
+class LedgerSnapshotSync {
+public:
+
+    enum State {
+        STATE_COLLECTING_MANIFESTS,
+        STATE_DOWNLOADING,
+        STATE_COMPLETE,
+        STATE_FAILED,
+    };
+
+    static const size_t DEFAULT_QUORUM              = 3;
+    static const size_t MAX_CHUNKS_PER_MINER        = 2;
+    static const size_t MAX_CHUNK_WINDOW            = 64;   // max chunks held in memory waiting for an earlier one
+    static const size_t MAX_CHUNK_FAILURES          = 3;    // consecutive failed chunk requests before a miner is dropped
+
+private:
+
+    string                                                          mFilename;
+    size_t                                                          mQuorum;
+    State                                                           mState;
+
+    set < string >                                                  mAskedURLs;
+    map < string, shared_ptr < const LedgerSnapshotManifest >>      mManifestsByDigest;
+    map < string, set < string >>                                   mURLsByDigest;
+
+    shared_ptr < const LedgerSnapshotManifest >                     mManifest;
+    set < string >                                                  mSources;
+    set < size_t >                                                  mMissing;
+    map < size_t, string >                                          mInFlight;
+    map < string, size_t >                                          mInFlightByURL;
+    map < string, size_t >                                          mFailuresByURL;
+    map < size_t, string >                                          mBuffered;
+    size_t                                                          mNextChunk;
+    ofstream                                                        mOutStream;
+
+    //----------------------------------------------------------------//
+    void                chooseManifest              ( const AbstractBlockTree& blockTree, BlockTreeCursor bestBranch );
+    void                receiveChunk                ( const MiningMessengerResponse& response );
+    void                receiveManifest             ( const MiningMessengerResponse& response );
+    void                requestChunks               ( AbstractMiningMessenger& messenger, const set < string >& onlineURLs );
+    void                restart                     ();
+    void                writeChunks                 ();
+
+public:
+
+    GET ( State,        State,          mState )
+    GET ( string,       Filename,       mFilename )
+
+    //----------------------------------------------------------------//
+    bool                isDone                      () const;
+                        LedgerSnapshotSync          ( string filename, size_t quorum = DEFAULT_QUORUM );
+                        ~LedgerSnapshotSync         ();
+    void                receiveResponse             ( const MiningMessengerResponse& response );
+    void                update                      ( AbstractMiningMessenger& messenger, const AbstractBlockTree& blockTree, BlockTreeCursor bestBranch, const set < string >& onlineURLs );
+};
+
+} // namespace Volition
+#endif
@@ -0,0 +1,91 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <volition/Ledger.h>
+#include <volition/LedgerWriteOverlay.h>
+#include <volition/Metrics.h>
+
+namespace Volition {
+
+//================================================================//
+// LedgerWriteOverlay
+//================================================================//
+
+//----------------------------------------------------------------//
+void LedgerWriteOverlay::commit () {
+
+    size_t keys = this->mValues.size ();
+
+    VOL_METRIC_COUNT_LABELED ( "volition_ledger_overlay_writes_total", "Ledger writes buffered by transaction overlays, by outcome.", "result=\"committed\"", keys );
+    VOL_METRIC_COUNT_LABELED ( "volition_ledger_overlay_writes_total", "Ledger writes buffered by transaction overlays, by outcome.", "result=\"combined\"", this->mTotalWrites - keys );
+
+    if ( this->mParent ) {
+
+        // nested: the enclosing overlay takes the writes and decides their fate.
+        unordered_map < string, unique_ptr < AbstractValue >>::iterator valueIt = this->mValues.begin ();
+        for ( ; valueIt != this->mValues.end (); ++valueIt ) {
+            this->mParent->mValues [ valueIt->first ] = move ( valueIt->second );
+        }
+        this->mParent->mTotalWrites += keys;
+    }
+    else {
+
+        // write straight to the store; going through the ledger would land back in this overlay.
+        AbstractVersionedStoreTag& store = this->mLedger;
+
+        unordered_map < string, unique_ptr < AbstractValue >>::const_iterator valueIt = this->mValues.cbegin ();
+        for ( ; valueIt != this->mValues.cend (); ++valueIt ) {
+            valueIt->second->commit ( store, valueIt->first );
+        }
+    }
+
+    this->mValues.clear ();
+    this->mTotalWrites = 0;
+}
+
+//----------------------------------------------------------------//
+size_t LedgerWriteOverlay::countKeys () const {
+
+    return this->mValues.size ();
+}
+
+//----------------------------------------------------------------//
+void LedgerWriteOverlay::discard () {
+
+    VOL_METRIC_COUNT_LABELED ( "volition_ledger_overlay_writes_total", "Ledger writes buffered by transaction overlays, by outcome.", "result=\"discarded\"", this->mTotalWrites );
+
+    this->mValues.clear ();
+    this->mTotalWrites = 0;
+}
+
+//----------------------------------------------------------------//
+bool LedgerWriteOverlay::hasValue ( string key ) const {
+
+    for ( const LedgerWriteOverlay* overlay = this; overlay; overlay = overlay->mParent ) {
+        if ( overlay->mValues.find ( key ) != overlay->mValues.cend ()) return true;
+    }
+    return false;
+}
+
+//----------------------------------------------------------------//
+LedgerWriteOverlay::LedgerWriteOverlay ( AbstractLedger& ledger ) :
+    mLedger ( ledger ),
+    mParent ( ledger.mOverlay ),
+    mTotalWrites ( 0 ) {
+
+    ledger.mOverlay = this;
+}
+
+//----------------------------------------------------------------//
+LedgerWriteOverlay::~LedgerWriteOverlay () {
+
+    // overlays are scoped, so they come off the ledger in the order they went on.
+    assert ( this->mLedger.mOverlay == this );
+
+    if ( this->mValues.size ()) {
+        this->discard ();
+    }
+    this->mLedger.mOverlay = this->mParent;
+}
+
+} // namespace Volition
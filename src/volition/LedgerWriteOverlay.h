@@ -0,0 +1,101 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_LEDGERWRITEOVERLAY_H
+#define VOLITION_LEDGERWRITEOVERLAY_H
+
+#include <volition/common.h>
+#include <unordered_map>
+
+namespace Volition {
+
+class AbstractLedger;
+
+//================================================================//
+// LedgerWriteOverlay
+//================================================================//
+// Buffers a ledger's writes for the lifetime of the object (typically one
+// transaction). While it's installed, AbstractLedger's setValue lands here
+// instead of the versioned store, and getValue/hasValue/hasKey see these
+// writes first. Repeated writes to one key collapse into one. commit ()
+// writes what's left to the store in a single pass (or into the enclosing
+// overlay, if there is one); anything not committed is dropped when the
+// overlay goes out of scope, which costs no more than clearing a map.
+class LedgerWriteOverlay {
+private:
+
+    friend class AbstractLedger;
+
+    //================================================================//
+    // AbstractValue
+    //================================================================//
+    class AbstractValue {
+    public:
+
+        //----------------------------------------------------------------//
+        virtual         ~AbstractValue      () {}
+        virtual void    commit              ( AbstractVersionedStoreTag& store, string key ) const = 0;
+    };
+
+    //================================================================//
+    // Value
+    //================================================================//
+    template < typename TYPE >
+    class Value :
+        public AbstractValue {
+    public:
+
+        TYPE            mValue;
+
+        //----------------------------------------------------------------//
+        void commit ( AbstractVersionedStoreTag& store, string key ) const override {
+            store.template setValue < TYPE >( key, this->mValue );
+        }
+
+        //----------------------------------------------------------------//
+        Value ( const TYPE& value ) :
+            mValue ( value ) {
+        }
+    };
+
+    AbstractLedger&                                             mLedger;
+    LedgerWriteOverlay*                                         mParent;
+    unordered_map < string, unique_ptr < AbstractValue >>       mValues;
+    size_t                                                      mTotalWrites;
+
+    //----------------------------------------------------------------//
+    template < typename TYPE >
+    const TYPE* getValue ( string key ) const {
+
+        for ( const LedgerWriteOverlay* overlay = this; overlay; overlay = overlay->mParent ) {
+            unordered_map < string, unique_ptr < AbstractValue >>::const_iterator valueIt = overlay->mValues.find ( key );
+            if ( valueIt != overlay->mValues.cend ()) {
+                const Value < TYPE >* value = dynamic_cast < const Value < TYPE >* >( valueIt->second.get ());
+                assert ( value ); // same key read back as a different type
+                return value ? &value->mValue : NULL;
+            }
+        }
+        return NULL;
+    }
+
+    //----------------------------------------------------------------//
+    template < typename TYPE >
+    void setValue ( string key, const TYPE& value ) {
+
+        this->mValues [ key ] = make_unique < Value < TYPE >>( value );
+        this->mTotalWrites++;
+    }
+
+public:
+
+    //----------------------------------------------------------------//
+    void            commit                  ();
+    size_t          countKeys               () const;
+    void            discard                 ();
+    bool            hasValue                ( string key ) const;
+                    LedgerWriteOverlay      ( AbstractLedger& ledger );
+                    ~LedgerWriteOverlay     ();
+};
+
+} // namespace Volition
+#endif
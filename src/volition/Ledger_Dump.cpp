@@ -2,10 +2,16 @@
 // http://cryptogogue.com
 
 #include <volition/Block.h>
+#include <volition/BlockODBM.h>
+#include <volition/FileSys.h>
 #include <volition/Ledger.h>
 #include <volition/Ledger_Dump.h>
 #include <volition/serialization/Serialization.h>
 #include <volition/Transactions.h>
+#include <Poco/InflatingStream.h>
+#include <Poco/DeflatingStream.h>
+#include <thread>
+#include <unistd.h>
 
 namespace Volition {
 
@@ -14,14 +20,466 @@ namespace Volition {
 //================================================================//
 
 //----------------------------------------------------------------//
-void Ledger_Dump::dump ( string filename ) {
+LedgerResult Ledger_Dump::dump ( string filename, bool resume, size_t batchSize ) {
+
+    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
 
     AbstractLedger& ledger = this->getLedger ();
+    
+    if ( batchSize == 0 ) {
+        batchSize = DEFAULT_DUMP_BATCH_SIZE;
+    }
+    
+    bool compress = Ledger_Dump::isCompressed ( filename );
+    
+    // can't append to a gzip stream, so compressed dumps always start over.
+    u64 base = 0;
+    if ( resume && !compress && FileSys::exists ( filename )) {
+        bool isComplete = false;
+        LedgerResult result = Ledger_Dump::scanForResume ( ledger, filename, base, isComplete );
+        if ( !result ) return result;
+        if ( isComplete ) return true;
+    }
+    
+    ofstream fileStream ( filename, ( base > 0 ) ? ( ios_base::out | ios_base::binary | ios_base::app ) : ( ios_base::out | ios_base::binary | ios_base::trunc ));
+    if ( !fileStream.is_open ()) return Format::write ( "Could not open '%s' for writing.", filename.c_str ());
+    
+    unique_ptr < Poco::DeflatingOutputStream > deflater;
+    if ( compress ) {
+        deflater = make_unique < Poco::DeflatingOutputStream >( fileStream, Poco::DeflatingStreamBuf::STREAM_GZIP );
+    }
+    ostream& outStream = deflater ? ( ostream& )*deflater : ( ostream& )fileStream;
+    
+    if ( base == 0 ) {
+        outStream << Ledger_Dump::encodeHeader ( ledger );
+    }
+    
+    AccountID::Index totalAccounts = ledger.getValue < AccountID::Index >( Ledger::keyFor_globalAccountCount ());
+    
+    for ( AccountID::Index batchBase = base; batchBase < totalAccounts; batchBase += batchSize ) {
+    
+        AccountID::Index batchTop = (( batchBase + batchSize ) < totalAccounts ) ? ( batchBase + batchSize ) : totalAccounts;
+    
+        outStream << Ledger_Dump::encodeAccountRange ( ledger, batchBase, batchTop );
+        outStream.flush ();
+        
+        LGN_LOG ( VOL_FILTER_LEDGER, INFO, "dumped accounts %d of %d", ( int )batchTop, ( int )totalAccounts );
+    }
+    
+    outStream << Ledger_Dump::encodeEnd ( totalAccounts );
+    
+    if ( deflater ) {
+        deflater->close ();
+    }
+    fileStream.close ();
+    
+    return true;
+}
+
+//----------------------------------------------------------------//
+string Ledger_Dump::encodeAccountRange ( AbstractLedger& ledger, u64 base, u64 top ) {
+
+    // ledger reads stay on this thread; only the (much slower) encoding is spread out.
+    vector < Transactions::LoadLedgerAccount > accounts;
+    vector < u64 > indices;
+    accounts.reserve ( top - base );
+    indices.reserve ( top - base );
+    
+    for ( u64 i = base; i < top; ++i ) {
+    
+        Transactions::LoadLedgerAccount account;
+        if ( account.init ( ledger, AccountID ( i ))) {
+            accounts.push_back ( account );
+            indices.push_back ( i );
+        }
+    }
+    
+    vector < string > records;
+    Ledger_Dump::encodeAccounts ( accounts, indices, records );
+    
+    string out;
+    for ( size_t i = 0; i < records.size (); ++i ) {
+        out.append ( records [ i ]);
+        out.append ( "\n" );
+    }
+    return out;
+}
+
+//----------------------------------------------------------------//
+void Ledger_Dump::encodeAccounts ( const vector < Transactions::LoadLedgerAccount >& accounts, const vector < u64 >& indices, vector < string >& records ) {
+
+    size_t totalAccounts = accounts.size ();
+    records.resize ( totalAccounts );
+    
+    auto encode = [ & ]( size_t first, size_t stride ) {
+        for ( size_t i = first; i < totalAccounts; i += stride ) {
+        
+            Poco::JSON::Object record;
+            record.set ( "index",       indices [ i ]);
+            record.set ( "account",     ToJSONSerializer::toJSON ( accounts [ i ]));
+            
+            stringstream stream;
+            record.stringify ( stream );
+            records [ i ] = stream.str ();
+        }
+    };
+    
+    size_t totalThreads = ( size_t )thread::hardware_concurrency ();
+    if ( totalAccounts < totalThreads ) {
+        totalThreads = totalAccounts;
+    }
+    
+    if ( totalThreads <= 1 ) {
+        encode ( 0, 1 );
+        return;
+    }
+    
+    vector < thread > threads;
+    for ( size_t i = 0; i < totalThreads; ++i ) {
+        threads.emplace_back ( encode, i, totalThreads );
+    }
+    for ( size_t i = 0; i < totalThreads; ++i ) {
+        threads [ i ].join ();
+    }
+}
+
+//----------------------------------------------------------------//
+string Ledger_Dump::encodeEnd ( u64 totalAccounts ) {
+
+    Poco::JSON::Object record;
+    record.set ( "end",             true );
+    record.set ( "totalAccounts",   totalAccounts );
+    
+    stringstream stream;
+    record.stringify ( stream );
+    stream << "\n";
+    return stream.str ();
+}
+
+//----------------------------------------------------------------//
+string Ledger_Dump::encodeHeader ( AbstractLedger& ledger ) {
+
+    Transactions::LoadLedger header;
+    header.initHeader ( ledger );
+
+    Transactions::ConsensusSettings settings;
+    settings.mIdentity                  = ledger.getIdentity ();
+    settings.mMaxBlockWeight            = ledger.getMaxBlockWeight ();
+    settings.mBlockDelayInSeconds       = ledger.getBlockDelayInSeconds ();
+    settings.mRewriteWindowInSeconds    = ledger.getRewriteWindowInSeconds ();
+
+    u64 totalBlocks = ledger.countBlocks ();
+    u64 height = totalBlocks ? totalBlocks - 1 : 0;
+
+    Poco::JSON::Object record;
+    record.set ( "format",      DUMP_FORMAT );
+    record.set ( "height",      height );
+    record.set ( "blockHash",   totalBlocks ? BlockODBM ( ledger, height ).mHash.get () : "" );
+    record.set ( "settings",    ToJSONSerializer::toJSON ( settings ));
+    record.set ( "header",      ToJSONSerializer::toJSON ( header ));
+    
+    stringstream stream;
+    record.stringify ( stream );
+    stream << "\n";
+    return stream.str ();
+}
+
+//----------------------------------------------------------------//
+string Ledger_Dump::escapeString ( const string& str ) {
 
-    Transactions::LoadLedger loadLedger;
-    loadLedger.init ( ledger );
+    // the escaped body of a JSON string literal, without the quotes.
+    stringstream stream;
+    Poco::JSON::Stringifier ().stringify ( Poco::Dynamic::Var ( str ), stream );
+    string quoted = stream.str ();
+    return quoted.substr ( 1, quoted.size () - 2 );
+}
+
+//----------------------------------------------------------------//
+bool Ledger_Dump::isCompressed ( string filename ) {
+
+    static const string GZIP_EXTENSION = ".gz";
+    return (( filename.size () >= GZIP_EXTENSION.size ()) && ( filename.compare ( filename.size () - GZIP_EXTENSION.size (), GZIP_EXTENSION.size (), GZIP_EXTENSION ) == 0 ));
+}
+
+//----------------------------------------------------------------//
+bool Ledger_Dump::isDumpStream ( string filename ) {
+
+    ifstream fileStream ( filename, ios_base::in | ios_base::binary );
+    if ( !fileStream.is_open ()) return false;
+
+    unique_ptr < Poco::InflatingInputStream > inflater;
+    if ( Ledger_Dump::isCompressed ( filename )) {
+        inflater = make_unique < Poco::InflatingInputStream >( fileStream, Poco::InflatingStreamBuf::STREAM_GZIP );
+    }
+    istream& inStream = inflater ? ( istream& )*inflater : ( istream& )fileStream;
+
+    // legacy dumps are a single pretty-printed document, so their first line is just "{".
+    string line;
+    if ( !getline ( inStream, line )) return false;
+    
+    try {
+        Poco::JSON::Object::Ptr record = Poco::JSON::Parser ().parse ( line ).extract < Poco::JSON::Object::Ptr >();
+        return ( record && record->has ( "format" ) && ( record->getValue < string >( "format" ) == DUMP_FORMAT ));
+    }
+    catch ( Poco::Exception& ) {
+    }
+    return false;
+}
+
+//----------------------------------------------------------------//
+LedgerResult Ledger_Dump::readDump ( string filename, HeaderVisitor onHeader, AccountVisitor onAccount ) {
+
+    ifstream fileStream ( filename, ios_base::in | ios_base::binary );
+    if ( !fileStream.is_open ()) return Format::write ( "Could not open '%s' for reading.", filename.c_str ());
+
+    unique_ptr < Poco::InflatingInputStream > inflater;
+    if ( Ledger_Dump::isCompressed ( filename )) {
+        inflater = make_unique < Poco::InflatingInputStream >( fileStream, Poco::InflatingStreamBuf::STREAM_GZIP );
+    }
+    istream& inStream = inflater ? ( istream& )*inflater : ( istream& )fileStream;
+
+    bool hasHeader = false;
+    bool hasEnd = false;
+    u64 lineNumber = 0;
+    
+    string line;
+    while ( !hasEnd && getline ( inStream, line )) {
+        
+        lineNumber++;
+        if ( line.size () == 0 ) continue;
+        
+        // parse each record on its own; only one account's DOM is alive at a time.
+        Poco::JSON::Object::Ptr record;
+        try {
+            record = Poco::JSON::Parser ().parse ( line ).extract < Poco::JSON::Object::Ptr >();
+        }
+        catch ( Poco::Exception& ) {
+        }
+        if ( !record ) return Format::write ( "Malformed record at line %d.", ( int )lineNumber );
+        
+        if ( record->has ( "header" )) {
+        
+            if ( !( record->has ( "format" ) && ( record->getValue < string >( "format" ) == DUMP_FORMAT ))) return "Unrecognized dump format.";
+        
+            Transactions::LoadLedger header;
+            FromJSONSerializer::fromJSON ( header, *record->getObject ( "header" ));
+            
+            Transactions::ConsensusSettings settings;
+            if ( record->has ( "settings" )) {
+                FromJSONSerializer::fromJSON ( settings, *record->getObject ( "settings" ));
+            }
+            
+            LedgerResult result = onHeader ( header, settings );
+            if ( !result ) return result;
+            hasHeader = true;
+        }
+        else if ( record->has ( "account" )) {
+        
+            if ( !hasHeader ) return "Missing dump header.";
+            
+            Transactions::LoadLedgerAccount account;
+            FromJSONSerializer::fromJSON ( account, *record->getObject ( "account" ));
+            
+            LedgerResult result = onAccount ( account );
+            if ( !result ) return result;
+        }
+        else if ( record->has ( "end" )) {
+            hasEnd = true;
+        }
+    }
+    
+    if ( !hasHeader ) return "Missing dump header.";
+    if ( !hasEnd ) return "Dump is incomplete.";
+    return true;
+}
+
+//----------------------------------------------------------------//
+LedgerResult Ledger_Dump::restoreDump ( string filename ) {
+
+    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+
+    AbstractLedger& ledger = this->getLedger ();
+    Transactions::ConsensusSettings settings;
+    
+    LedgerResult result = Ledger_Dump::readDump (
+        filename,
+        [ & ]( const Transactions::LoadLedger& header, const Transactions::ConsensusSettings& headerSettings ) -> LedgerResult {
+            settings = headerSettings;
+            ledger.setSchema ( header.mSchema );
+            return true;
+        },
+        [ & ]( const Transactions::LoadLedgerAccount& account ) -> LedgerResult {
+            // accounts already in the ledger were restored by an earlier, interrupted pass.
+            if ( ledger.getAccountID ( account.mName ) != AccountID::NULL_INDEX ) return true;
+            return account.apply ( ledger );
+        }
+    );
+    if ( !result ) return result;
+    
+    return settings.apply ( ledger );
+}
+
+//----------------------------------------------------------------//
+LedgerResult Ledger_Dump::scanForResume ( AbstractLedger& ledger, string filename, u64& next, bool& isComplete ) {
+
+    next = 0;
+    isComplete = false;
+
+    size_t validBytes = 0;
+    bool hasHeader = false;
+
+    {
+        ifstream fileStream ( filename, ios_base::in | ios_base::binary );
+        
+        string line;
+        while ( getline ( fileStream, line )) {
+        
+            // a last line with no newline was cut off mid-write.
+            if ( fileStream.eof ()) break;
+        
+            Poco::JSON::Object::Ptr record;
+            try {
+                record = Poco::JSON::Parser ().parse ( line ).extract < Poco::JSON::Object::Ptr >();
+            }
+            catch ( Poco::Exception& ) {
+            }
+            if ( !record ) break;
+            
+            if ( record->has ( "header" )) {
+            
+                if ( !( record->has ( "format" ) && ( record->getValue < string >( "format" ) == DUMP_FORMAT ))) break;
+            
+                // appending to a dump taken at another block would mix two ledger states.
+                u64 totalBlocks = ledger.countBlocks ();
+                u64 height = totalBlocks ? totalBlocks - 1 : 0;
+                string blockHash = totalBlocks ? BlockODBM ( ledger, height ).mHash.get () : "";
+                
+                if ( !( record->has ( "height" ) && record->has ( "blockHash" ))) return Format::write ( "Can't resume '%s': its header doesn't say which block it was taken at.", filename.c_str ());
+                if (( record->getValue < u64 >( "height" ) != height ) || ( record->getValue < string >( "blockHash" ) != blockHash )) {
+                    return Format::write ( "Can't resume '%s': it was taken at a different block than the ledger is at now.", filename.c_str ());
+                }
+                hasHeader = true;
+            }
+            else if ( record->has ( "account" ) && record->has ( "index" )) {
+                next = record->getValue < u64 >( "index" ) + 1;
+            }
+            else if ( record->has ( "end" )) {
+                isComplete = hasHeader;
+                if ( !hasHeader ) next = 0;
+                return true;
+            }
+            validBytes += line.size () + 1;
+        }
+    }
+    
+    // without a header there is nothing to resume from; start over.
+    if ( !hasHeader ) {
+        next = 0;
+        return true;
+    }
+    
+    if ( truncate ( filename.c_str (), ( off_t )validBytes ) != 0 ) {
+        next = 0;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------//
+LedgerResult Ledger_Dump::writeGenesisBlock ( string filename, string outFilename ) {
+
+    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+
+    if ( !Ledger_Dump::isDumpStream ( filename )) {
+    
+        // legacy dumps are a single document, so they are read whole, as they always were.
+        shared_ptr < Transactions::LoadLedger > loadLedger = make_shared < Transactions::LoadLedger >();
+        FromJSONSerializer::fromJSONFile ( *loadLedger, filename );
+        
+        shared_ptr < Transaction > transaction = make_shared < Transaction >();
+        transaction->setBody ( loadLedger );
+        
+        shared_ptr < Block > block = make_shared < Block >();
+        block->pushTransaction ( transaction );
+        
+        ToJSONSerializer::toJSONFile ( *block, outFilename );
+        return true;
+    }
+
+    // the block is written around the accounts, one at a time. the LoadLedger body
+    // is a JSON string inside the transaction (and that inside the block body), so
+    // its accounts land escaped once per level. serialize the block with no
+    // accounts, find the empty list at whatever depth it ended up and write
+    // each account escaped to that depth.
+    static const string ACCOUNTS_KEY = "\"accounts\":[";
+
+    ofstream outStream;
+    string suffix;
+    size_t depth = 0;
+    size_t totalAccounts = 0;
+
+    LedgerResult result = Ledger_Dump::readDump (
+        filename,
+        [ & ]( const Transactions::LoadLedger& header, const Transactions::ConsensusSettings& settings ) -> LedgerResult {
+            UNUSED ( settings );
+            
+            shared_ptr < Transactions::LoadLedger > loadLedger = make_shared < Transactions::LoadLedger >();
+            ( Transactions::ConsensusSettings& )*loadLedger = header;
+            loadLedger->mSchema = header.mSchema;
+            
+            shared_ptr < Transaction > transaction = make_shared < Transaction >();
+            transaction->setBody ( loadLedger );
+            
+            shared_ptr < Block > block = make_shared < Block >();
+            block->pushTransaction ( transaction );
+            
+            string blockJSON = ToJSONSerializer::toJSONString ( *block, 4 );
+            
+            size_t found = 0;
+            size_t split = string::npos;
+            
+            string key = ACCOUNTS_KEY;
+            for ( size_t i = 0; i < 4; ++i, key = Ledger_Dump::escapeString ( key )) {
+                for ( size_t at = blockJSON.find ( key + "]" ); at != string::npos; at = blockJSON.find ( key + "]", at + 1 )) {
+                    split = at + key.size ();
+                    depth = i;
+                    found++;
+                }
+            }
+            if ( found != 1 ) return "Could not place the accounts in the genesis block.";
+            
+            outStream.open ( outFilename, ios_base::out | ios_base::binary | ios_base::trunc );
+            if ( !outStream.is_open ()) return Format::write ( "Could not open '%s' for writing.", outFilename.c_str ());
+            
+            outStream << blockJSON.substr ( 0, split );
+            suffix = blockJSON.substr ( split );
+            return true;
+        },
+        [ & ]( const Transactions::LoadLedgerAccount& account ) -> LedgerResult {
+        
+            string accountJSON = ToJSONSerializer::toJSONString ( account );
+            for ( size_t i = 0; i < depth; ++i ) {
+                accountJSON = Ledger_Dump::escapeString ( accountJSON );
+            }
+            
+            if ( totalAccounts++ ) {
+                outStream << ",";
+            }
+            outStream << accountJSON;
+            return true;
+        }
+    );
+    
+    if ( !result ) {
+        if ( outStream.is_open ()) {
+            outStream.close ();
+            remove ( outFilename.c_str ());
+        }
+        return result;
+    }
     
-    ToJSONSerializer::toJSONFile ( loadLedger, filename );
+    outStream << suffix;
+    outStream.close ();
+    return true;
 }
 
 } // namespace Volition
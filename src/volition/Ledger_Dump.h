@@ -16,15 +16,52 @@ class AccountODBM;
 class AssetODBM;
 class Schema;
 
+namespace Transactions {
+class ConsensusSettings;
+class LoadLedger;
+class LoadLedgerAccount;
+} // namespace Transactions
+
 //================================================================//
 // Ledger_Dump
 //================================================================//
+// Ledger dumps are streamed as one JSON record per line: a header (the
+// LoadLedger body minus its accounts, as the legacy format wrote it, plus
+// the consensus settings and the block the dump was taken at), one record
+// per account, and an end record. Only one batch of accounts is ever held in
+// memory, and each batch is encoded in parallel. Filenames ending in ".gz"
+// are gzipped. An uncompressed dump cut short can be resumed from the last
+// account written, as long as the ledger is still at the same block. The
+// encoders are public so ledger snapshots can produce the same records.
 class Ledger_Dump :
     virtual public AbstractLedgerComponent {
+public:
+
+    static constexpr const char* DUMP_FORMAT        = "volition-ledger-dump-1";
+    static const size_t DEFAULT_DUMP_BATCH_SIZE     = 256;
+
+    typedef std::function < LedgerResult ( const Transactions::LoadLedger&, const Transactions::ConsensusSettings& )>    HeaderVisitor;
+    typedef std::function < LedgerResult ( const Transactions::LoadLedgerAccount& )>                                    AccountVisitor;
+
+private:
+
+    //----------------------------------------------------------------//
+    static void                 encodeAccounts                  ( const vector < Transactions::LoadLedgerAccount >& accounts, const vector < u64 >& indices, vector < string >& records );
+    static string               escapeString                    ( const string& str );
+    static bool                 isCompressed                    ( string filename );
+    static LedgerResult         scanForResume                   ( AbstractLedger& ledger, string filename, u64& next, bool& isComplete );
+
 public:
 
     //----------------------------------------------------------------//
-    void                        dump                            ( string filename );
+    LedgerResult                dump                            ( string filename, bool resume = false, size_t batchSize = DEFAULT_DUMP_BATCH_SIZE );
+    static string               encodeAccountRange              ( AbstractLedger& ledger, u64 base, u64 top );
+    static string               encodeEnd                       ( u64 totalAccounts );
+    static string               encodeHeader                    ( AbstractLedger& ledger );
+    static bool                 isDumpStream                    ( string filename );
+    static LedgerResult         readDump                        ( string filename, HeaderVisitor onHeader, AccountVisitor onAccount );
+    LedgerResult                restoreDump                     ( string filename );
+    static LedgerResult         writeGenesisBlock               ( string filename, string outFilename );
 };
 
 } // namespace Volition
@@ -1,20 +1,25 @@
 // Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
 // http://cryptogogue.com
 
+#include <volition/AccountInventory.h>
 #include <volition/AccountODBM.h>
 #include <volition/Asset.h>
 #include <volition/AssetMethod.h>
 #include <volition/AssetMethodInvocation.h>
 #include <volition/AssetODBM.h>
+#include <volition/AssetReadCache.h>
 #include <volition/Block.h>
 #include <volition/Format.h>
+#include <volition/InventoryDelta.h>
 #include <volition/InventoryLogEntry.h>
 #include <volition/Ledger.h>
 #include <volition/Ledger_Inventory.h>
 #include <volition/LedgerFieldODBM.h>
 #include <volition/LuaContext.h>
+#include <volition/Metrics.h>
 #include <volition/OfferODBM.h>
 #include <volition/StampODBM.h>
+#include <volition/TheTransactionContextCache.h>
 #include <volition/TransactionMaker.h>
 
 namespace Volition {
@@ -23,10 +28,43 @@ namespace Volition {
 // Ledger_Inventory
 //================================================================//
 
+//----------------------------------------------------------------//
+void Ledger_Inventory::affirmOpenOfferIndex () {
+
+    AbstractLedger& ledger = this->getLedger ();
+
+    LedgerFieldODBM < bool > builtField ( ledger, OfferODBM::keyFor_openOfferByTypeBuilt (), false );
+    if ( builtField.get ()) return;
+
+    // one-time backfill for ledgers that had open offers before the by-type index existed.
+    // walks every offer ID, since the global open list may still hold closed offers.
+    u64 count = LedgerFieldODBM < u64 >( ledger, OfferODBM::keyFor_globalOfferCount ()).get ( 0 );
+    for ( u64 offerID = 0; offerID < count; ++offerID ) {
+    
+        OfferODBM offerODBM ( ledger, offerID );
+        if ( offerODBM.mSeller.get () == AccountID::NULL_INDEX ) continue;
+        if ( offerODBM.mBuyer.get () != AccountID::NULL_INDEX ) continue;
+        
+        shared_ptr < const SerializableSet < string >> indexedTypes = offerODBM.mAssetTypes.get ();
+        if ( indexedTypes && indexedTypes->size ()) continue;
+        
+        SerializableVector < AssetID::Index > assetIDs;
+        offerODBM.mAssetIdentifiers.get ( assetIDs );
+        
+        SerializableSet < string > assetTypes;
+        SerializableVector < AssetID::Index >::const_iterator assetIDIt = assetIDs.cbegin ();
+        for ( ; assetIDIt != assetIDs.cend (); ++assetIDIt ) {
+            assetTypes.insert ( AssetODBM ( ledger, *assetIDIt ).mType.get ());
+        }
+        this->indexOpenOffer ( offerODBM, assetTypes );
+    }
+    builtField.set ( true );
+}
+
 //----------------------------------------------------------------//
 LedgerResult Ledger_Inventory::awardAssets ( AccountODBM& accountODBM, u64 inventoryNonce, const list < AssetBase >& assets, InventoryLogEntry& logEntry ) {
 
-    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_COUNT_LABELED ( "volition_inventory_ops_total", "Ledger inventory operations, by method.", "op=\"awardAssets\"", 1 );
 
     size_t quantity = assets.size ();
     if ( quantity == 0 ) return true;
@@ -36,7 +74,7 @@ LedgerResult Ledger_Inventory::awardAssets ( AccountODBM& accountODBM, u64 inven
 
     LedgerKey KEY_FOR_GLOBAL_ASSET_COUNT = Ledger::keyFor_globalAssetCount ();
     size_t globalAssetCount = ledger.getValueOrFallback < u64 >( KEY_FOR_GLOBAL_ASSET_COUNT, 0 );
-    size_t accountAssetCount = accountODBM.mAssetCount.get ( 0 );
+    AccountInventory inventory ( accountODBM );
     
     list < AssetBase >::const_iterator assetIt = assets.cbegin ();
     for ( size_t i = 0; assetIt != assets.cend (); ++assetIt, ++i ) {
@@ -50,7 +88,7 @@ LedgerResult Ledger_Inventory::awardAssets ( AccountODBM& accountODBM, u64 inven
         
         assetODBM.mOwner.set ( accountODBM.mAccountID );
         assetODBM.mInventoryNonce.set ( inventoryNonce );
-        assetODBM.mPosition.set ( accountAssetCount + i );
+        assetODBM.mPosition.set ( inventory.push ( assetODBM.mAssetID ));
         assetODBM.mType.set ( assetType );
         
         Asset::Fields::const_iterator fieldIt = asset.mFields.cbegin ();
@@ -58,12 +96,11 @@ LedgerResult Ledger_Inventory::awardAssets ( AccountODBM& accountODBM, u64 inven
             assetODBM.setFieldValue ( fieldIt->first, fieldIt->second );
         }
         
-        accountODBM.getInventoryField ( assetODBM.mPosition.get ()).set ( assetODBM.mAssetID );
         logEntry.insertAddition ( assetODBM.mAssetID );
     }
     
     ledger.setValue < u64 >( KEY_FOR_GLOBAL_ASSET_COUNT, globalAssetCount + quantity );
-    accountODBM.mAssetCount.set ( accountAssetCount + quantity );
+    inventory.commit ();
 
     return true;
 }
@@ -71,7 +108,7 @@ LedgerResult Ledger_Inventory::awardAssets ( AccountODBM& accountODBM, u64 inven
 //----------------------------------------------------------------//
 LedgerResult Ledger_Inventory::awardAssets ( AccountODBM& accountODBM, u64 inventoryNonce, string assetType, size_t quantity, InventoryLogEntry& logEntry ) {
 
-    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_COUNT_LABELED ( "volition_inventory_ops_total", "Ledger inventory operations, by method.", "op=\"awardAssets\"", 1 );
 
     if ( quantity == 0 ) return true;
 
@@ -82,7 +119,7 @@ LedgerResult Ledger_Inventory::awardAssets ( AccountODBM& accountODBM, u64 inven
 
     LedgerKey KEY_FOR_GLOBAL_ASSET_COUNT = Ledger::keyFor_globalAssetCount ();
     size_t globalAssetCount = ledger.getValueOrFallback < u64 >( KEY_FOR_GLOBAL_ASSET_COUNT, 0 );
-    size_t accountAssetCount = accountODBM.mAssetCount.get ( 0 );
+    AccountInventory inventory ( accountODBM );
     
     for ( size_t i = 0; i < quantity; ++i ) {
         
@@ -90,15 +127,14 @@ LedgerResult Ledger_Inventory::awardAssets ( AccountODBM& accountODBM, u64 inven
         
         assetODBM.mOwner.set ( accountODBM.mAccountID );
         assetODBM.mInventoryNonce.set ( inventoryNonce );
-        assetODBM.mPosition.set ( accountAssetCount + i );
+        assetODBM.mPosition.set ( inventory.push ( assetODBM.mAssetID ));
         assetODBM.mType.set ( assetType );
         
-        accountODBM.getInventoryField ( assetODBM.mPosition.get ()).set ( assetODBM.mAssetID );
         logEntry.insertAddition ( assetODBM.mAssetID );
     }
     
     ledger.setValue < u64 >( KEY_FOR_GLOBAL_ASSET_COUNT, globalAssetCount + quantity );
-    accountODBM.mAssetCount.set ( accountAssetCount + quantity );
+    inventory.commit ();
 
     return true;
 }
@@ -106,7 +142,7 @@ LedgerResult Ledger_Inventory::awardAssets ( AccountODBM& accountODBM, u64 inven
 //----------------------------------------------------------------//
 LedgerResult Ledger_Inventory::awardAssets ( AccountID accountID, string assetType, size_t quantity, time_t time ) {
 
-    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_COUNT_LABELED ( "volition_inventory_ops_total", "Ledger inventory operations, by method.", "op=\"awardAssets\"", 1 );
 
     AbstractLedger& ledger = this->getLedger ();
     
@@ -125,7 +161,7 @@ LedgerResult Ledger_Inventory::awardAssets ( AccountID accountID, string assetTy
 //----------------------------------------------------------------//
 LedgerResult Ledger_Inventory::awardAssets ( AccountID accountID, const list < AssetBase >& assets, time_t time ) {
 
-    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_COUNT_LABELED ( "volition_inventory_ops_total", "Ledger inventory operations, by method.", "op=\"awardAssets\"", 1 );
 
     AbstractLedger& ledger = this->getLedger ();
     
@@ -144,7 +180,7 @@ LedgerResult Ledger_Inventory::awardAssets ( AccountID accountID, const list < A
 //----------------------------------------------------------------//
 LedgerResult Ledger_Inventory::awardAssetsAll ( AccountID accountID, size_t quantity, time_t time ) {
 
-    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_COUNT_LABELED ( "volition_inventory_ops_total", "Ledger inventory operations, by method.", "op=\"awardAssetsAll\"", 1 );
 
     AbstractLedger& ledger = this->getLedger ();
     const Schema& schema = ledger.getSchema ();
@@ -168,29 +204,19 @@ LedgerResult Ledger_Inventory::awardAssetsAll ( AccountID accountID, size_t quan
 //----------------------------------------------------------------//
 LedgerResult Ledger_Inventory::awardAssetsRandom ( AccountID accountID, string deckName, string seed, size_t quantity, time_t time ) {
 
-    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_COUNT_LABELED ( "volition_inventory_ops_total", "Ledger inventory operations, by method.", "op=\"awardAssetsRandom\"", 1 );
 
     AbstractLedger& ledger = this->getLedger ();
     const Schema& schema = ledger.getSchema ();
 
     if ( quantity == 0 ) return true;
 
-    const Schema::Deck* deck = schema.getDeck ( deckName );
-    if ( !deck ) return Format::write ( "Deck '%s' not found.", deckName.c_str ());
+    const DeckTable* deckTable = schema.getDeckTable ( deckName );
+    if ( !deckTable ) return Format::write ( "Deck '%s' not found.", deckName.c_str ());
+    if ( deckTable->getTotal () == 0 ) return Format::write ( "Deck '%s' is empty.", deckName.c_str ());
 
     AccountODBM accountODBM ( ledger, accountID );
     if ( accountODBM.mAccountID == AccountID::NULL_INDEX ) return false;
-
-    // TODO: yes, this is inefficient. optimize (and/or cache) later.
-    vector < string > expandedSetOrDeck;
-    Schema::Deck::const_iterator deckIt = deck->cbegin ();
-    for ( ; deckIt != deck->cend (); ++deckIt ) {
-        string assetType = deckIt->first;
-        size_t count = deckIt->second;
-        for ( size_t i = 0; i < count; ++i ) {
-            expandedSetOrDeck.push_back ( assetType );
-        }
-    }
     
     string entropy = ledger.getEntropyString ();
     
@@ -204,23 +230,20 @@ LedgerResult Ledger_Inventory::awardAssetsRandom ( AccountID accountID, string d
 
     Psuedorandom prng ( digestEngine.digest ());
     
-    map < string, size_t > awards;
+    // tally draws by type index; types are in deck (name) order, so the awards
+    // (and the asset IDs they get) come out in the same order as before.
+    vector < size_t > awards ( deckTable->size (), 0 );
     for ( size_t i = 0; i < quantity; ++i ) {
-        u32 index = prng.randomInt32 ();
-        string awardType = expandedSetOrDeck [ index % expandedSetOrDeck.size ()];
-        
-        if ( awards.find ( awardType ) == awards.end ()) {
-            awards [ awardType ] = 0;
-        }
-        awards [ awardType ] = awards [ awardType ] + 1;
+        u32 card = prng.randomInt32 ();
+        awards [ deckTable->draw ( card )]++;
     }
     
     InventoryLogEntry logEntry ( time );
     u64 inventoryNonce = accountODBM.mInventoryNonce.get ( 0 );
     
-    map < string, size_t >::const_iterator awardIt = awards.cbegin ();
-    for ( ; awardIt != awards.cend (); ++awardIt ) {
-        ledger.awardAssets ( accountODBM, inventoryNonce, awardIt->first, awardIt->second, logEntry );
+    for ( size_t i = 0; i < awards.size (); ++i ) {
+        if ( awards [ i ] == 0 ) continue;
+        ledger.awardAssets ( accountODBM, inventoryNonce, deckTable->getType ( i ), awards [ i ], logEntry );
     }
     ledger.updateInventory ( accountODBM.mAccountID, logEntry );
     
@@ -230,7 +253,7 @@ LedgerResult Ledger_Inventory::awardAssetsRandom ( AccountID accountID, string d
 //----------------------------------------------------------------//
 LedgerResult Ledger_Inventory::awardDeck ( AccountID accountID, string deckName, time_t time ) {
 
-    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_COUNT_LABELED ( "volition_inventory_ops_total", "Ledger inventory operations, by method.", "op=\"awardDeck\"", 1 );
 
     AbstractLedger& ledger = this->getLedger ();
     const Schema& schema = ledger.getSchema ();
@@ -248,7 +271,7 @@ LedgerResult Ledger_Inventory::awardDeck ( AccountID accountID, string deckName,
 //----------------------------------------------------------------//
 LedgerResult Ledger_Inventory::cancelOffer ( AccountID accountID, string assetIdentifier, time_t time ) {
 
-    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_COUNT_LABELED ( "volition_inventory_ops_total", "Ledger inventory operations, by method.", "op=\"cancelOffer\"", 1 );
 
     AbstractLedger& ledger = this->getLedger ();
 
@@ -272,6 +295,7 @@ LedgerResult Ledger_Inventory::cancelOffer ( AccountID accountID, string assetId
     SerializableVector < AssetID::Index > assetIDs;
     offerODBM.mAssetIdentifiers.get ( assetIDs );
     this->clearOffers ( offerODBM.mSeller.get (), AssetListAdapter ( assetIDs.data (), assetIDs.size ()), time );
+    this->unindexOpenOffer ( offerODBM.mOfferID );
 
     offerODBM.mSeller.set ( OfferID::NULL_INDEX );
 
@@ -281,7 +305,7 @@ LedgerResult Ledger_Inventory::cancelOffer ( AccountID accountID, string assetId
 //----------------------------------------------------------------//
 LedgerResult Ledger_Inventory::clearOffers ( AccountID accountID, AssetListAdapter assetList, time_t time ) {
 
-    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_COUNT_LABELED ( "volition_inventory_ops_total", "Ledger inventory operations, by method.", "op=\"clearOffers\"", 1 );
 
     AbstractLedger& ledger = this->getLedger ();
 
@@ -318,11 +342,13 @@ LedgerResult Ledger_Inventory::clearInventory ( AccountID accountID, time_t time
 
     InventoryLogEntry logEntry ( time );
 
-    size_t totalAssets = accountODBM.mAssetCount.get ( 0 );    
-    for ( size_t i = 0; i < totalAssets; ++i ) {
+    AccountInventory inventory ( accountODBM );
+    vector < AssetID::Index > assetIDs;
+    inventory.getRange ( 0, inventory.getSize (), assetIDs );
+    
+    for ( size_t i = 0; i < assetIDs.size (); ++i ) {
     
-        AssetID::Index assetIndex = accountODBM.getInventoryField ( i ).get ();
-        AssetODBM assetODBM ( ledger, assetIndex );
+        AssetODBM assetODBM ( ledger, assetIDs [ i ]);
 
         // asset has no owner or position
         assetODBM.mOwner.set ( AssetID::NULL_INDEX );
@@ -332,7 +358,8 @@ LedgerResult Ledger_Inventory::clearInventory ( AccountID accountID, time_t time
         logEntry.insertDeletion ( assetODBM.mAssetID );
     }
 
-    accountODBM.mAssetCount.set ( 0 );
+    inventory.clear ();
+    inventory.commit ();
     ledger.updateInventory ( accountODBM.mAccountID, logEntry );
 
     return true;
@@ -361,6 +388,7 @@ void Ledger_Inventory::expireOffers ( time_t time ) {
             SerializableVector < AssetID::Index > assetIDs;
             offerODBM.mAssetIdentifiers.get ( assetIDs );
             this->clearOffers ( offerODBM.mSeller.get (), AssetListAdapter ( assetIDs.data (), assetIDs.size ()), time );
+            this->unindexOpenOffer ( offerID );
             
             offerODBM.mSeller.set ( OfferID::NULL_INDEX );
         }
@@ -404,10 +432,16 @@ void Ledger_Inventory::getInventory ( AccountID accountID, SerializableList < Se
         }
     }
     
-    for ( size_t i = base; i < top; ++i ) {
+    // every asset in the inventory has the same owner, so seed the cache with it.
+    AssetReadCache cache ( ledger );
+    cache.setAccountName ( accountODBM.mAccountID, accountODBM.mName.get ());
+    
+    vector < AssetID::Index > assetIDs;
+    AccountInventory ( accountODBM ).getRange ( base, top, assetIDs );
+    
+    for ( size_t i = 0; i < assetIDs.size (); ++i ) {
     
-        AssetID::Index assetIndex = accountODBM.getInventoryField ( i ).get ();
-        shared_ptr < const Asset > asset = AssetODBM ( ledger, assetIndex ).getAsset ( sparse );
+        shared_ptr < const Asset > asset = AssetODBM ( ledger, assetIDs [ i ]).getAsset ( cache, sparse );
         assert ( asset );
         assetList.push_back ( asset );
     }
@@ -433,10 +467,43 @@ map < string, size_t > Ledger_Inventory::getInventoryHistogram ( AccountID accou
     return histogram;
 }
 
+//----------------------------------------------------------------//
+void Ledger_Inventory::getOpenOffers ( string assetType, SerializableVector < OfferID::Index >& offerIDs ) const {
+
+    const AbstractLedger& ledger = this->getLedger ();
+
+    u64 count = LedgerFieldODBM < u64 >( ledger, OfferODBM::keyFor_openOfferByTypeCount ( assetType )).get ( 0 );
+    offerIDs.reserve ( offerIDs.size () + count );
+    
+    for ( u64 i = 0; i < count; ++i ) {
+        offerIDs.push_back ( LedgerFieldODBM < u64 >( ledger, OfferODBM::keyFor_openOfferByTypeElement ( assetType, i )).get ());
+    }
+}
+
+//----------------------------------------------------------------//
+void Ledger_Inventory::indexOpenOffer ( OfferODBM& offerODBM, const SerializableSet < string >& assetTypes ) {
+
+    AbstractLedger& ledger = this->getLedger ();
+
+    // one list per asset type, appended to here and swap-removed in unindexOpenOffer.
+    // the offer remembers its position in each so removal doesn't have to search.
+    SerializableSet < string >::const_iterator typeIt = assetTypes.cbegin ();
+    for ( ; typeIt != assetTypes.cend (); ++typeIt ) {
+    
+        LedgerFieldODBM < u64 > countField ( ledger, OfferODBM::keyFor_openOfferByTypeCount ( *typeIt ));
+        u64 position = countField.get ( 0 );
+        
+        LedgerFieldODBM < u64 >( ledger, OfferODBM::keyFor_openOfferByTypeElement ( *typeIt, position )).set ( offerODBM.mOfferID );
+        offerODBM.getTypePositionField ( *typeIt ).set ( position );
+        countField.set ( position + 1 );
+    }
+    offerODBM.mAssetTypes.set ( assetTypes );
+}
+
 //----------------------------------------------------------------//
 LedgerResult Ledger_Inventory::offerAssets ( AccountID accountID, u64 minimumPrice, time_t expiration, AssetListAdapter assetList, time_t time ) {
 
-    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_COUNT_LABELED ( "volition_inventory_ops_total", "Ledger inventory operations, by method.", "op=\"offerAssets\"", 1 );
 
     if ( expiration <= time ) return "Offer already expired by record time.";
 
@@ -464,6 +531,7 @@ LedgerResult Ledger_Inventory::offerAssets ( AccountID accountID, u64 minimumPri
     
     // tag the assets and build the vector
     SerializableVector < AssetID::Index > assetIDVector;
+    SerializableSet < string > assetTypes;
     for ( size_t i = 0; i < assetList.size (); ++i ) {
         
         AssetODBM assetODBM ( ledger, assetList.getAssetIndex ( i ));
@@ -475,6 +543,7 @@ LedgerResult Ledger_Inventory::offerAssets ( AccountID accountID, u64 minimumPri
         logEntry.insertAddition ( assetODBM.mAssetID );
         
         assetIDVector.push_back ( assetODBM.mAssetID );
+        assetTypes.insert ( assetODBM.mType.get ());
     }
     
     ledger.updateInventory ( sellerODBM.mAccountID, logEntry );
@@ -488,6 +557,7 @@ LedgerResult Ledger_Inventory::offerAssets ( AccountID accountID, u64 minimumPri
     offerODBM.mMinimumPrice.set ( minimumPrice );
     offerODBM.mExpiration.set ( Format::toISO8601 ( expiration ));
     offerODBM.mAssetIdentifiers.set ( assetIDVector );
+    this->indexOpenOffer ( offerODBM, assetTypes );
     
     LedgerFieldODBM < u64 >( ledger, OfferODBM::keyFor_globalOpenOfferListElement ( offerPosition )).set ( offerID );
     
@@ -500,7 +570,7 @@ LedgerResult Ledger_Inventory::offerAssets ( AccountID accountID, u64 minimumPri
 //----------------------------------------------------------------//
 LedgerResult Ledger_Inventory::resetAssetFields ( AssetID::Index index, time_t time ) {
 
-    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_COUNT_LABELED ( "volition_inventory_ops_total", "Ledger inventory operations, by method.", "op=\"resetAssetFields\"", 1 );
 
     AbstractLedger& ledger = this->getLedger ();
 
@@ -517,7 +587,7 @@ LedgerResult Ledger_Inventory::resetAssetFields ( AssetID::Index index, time_t t
 //----------------------------------------------------------------//
 LedgerResult Ledger_Inventory::resetAssetFieldValue ( AssetID::Index index, string fieldName, time_t time ) {
 
-    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_COUNT_LABELED ( "volition_inventory_ops_total", "Ledger inventory operations, by method.", "op=\"resetAssetFieldValue\"", 1 );
 
     AbstractLedger& ledger = this->getLedger ();
     const Schema& schema = ledger.getSchema ();
@@ -562,7 +632,7 @@ LedgerResult Ledger_Inventory::resetAssetFieldValue ( AssetID::Index index, stri
 //----------------------------------------------------------------//
 LedgerResult Ledger_Inventory::revokeAsset ( AssetID::Index index, time_t time ) {
     
-    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_COUNT_LABELED ( "volition_inventory_ops_total", "Ledger inventory operations, by method.", "op=\"revokeAsset\"", 1 );
 
     AbstractLedger& ledger = this->getLedger ();
 
@@ -575,19 +645,17 @@ LedgerResult Ledger_Inventory::revokeAsset ( AssetID::Index index, time_t time )
     if ( accountID == AccountID::NULL_INDEX ) return true; // already revoked!
     AccountODBM accountODBM ( ledger, accountID );
 
-    // count the assets in the account
-    size_t accountAssetCount = accountODBM.mAssetCount.get ( 0 );
-    assert ( accountAssetCount > 0 );
+    AccountInventory inventory ( accountODBM );
+    assert ( inventory.getSize () > 0 );
 
     // fill the asset's original position by swapping in the tail
     size_t position = assetODBM.mPosition.get ();
-    if ( position < accountAssetCount ) {
-        LedgerFieldODBM < AssetID::Index > accountInventoryField = accountODBM.getInventoryField ( position );
-        LedgerFieldODBM < AssetID::Index > accountInventoryTailField = accountODBM.getInventoryField ( accountAssetCount - 1 );
-        
-        AssetODBM tailAssetODBM ( ledger, accountInventoryTailField.get ());
-        tailAssetODBM.mPosition.set ( position );
-        accountInventoryField.set ( tailAssetODBM.mAssetID );
+    if ( position < inventory.getSize ()) {
+        AssetID::Index movedAssetID = inventory.remove ( position );
+        if ( movedAssetID != AssetID::NULL_INDEX ) {
+            AssetODBM ( ledger, movedAssetID ).mPosition.set ( position );
+        }
+        inventory.commit ();
     }
     
     // asset has no owner or position
@@ -595,9 +663,6 @@ LedgerResult Ledger_Inventory::revokeAsset ( AssetID::Index index, time_t time )
     assetODBM.mInventoryNonce.set (( u64 )-1 );
     assetODBM.mPosition.set ( Asset::NULL_POSITION );
     
-    // shrink account inventory by one
-    accountODBM.mAssetCount.set ( accountAssetCount - 1 );
-    
     InventoryLogEntry logEntry ( time );
     logEntry.insertDeletion ( assetODBM.mAssetID );
     ledger.updateInventory ( accountODBM.mAccountID, logEntry );
@@ -608,7 +673,7 @@ LedgerResult Ledger_Inventory::revokeAsset ( AssetID::Index index, time_t time )
 //----------------------------------------------------------------//
 LedgerResult Ledger_Inventory::setAssetFieldValue ( AssetID::Index index, string fieldName, const AssetFieldValue& field, time_t time ) {
 
-    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_COUNT_LABELED ( "volition_inventory_ops_total", "Ledger inventory operations, by method.", "op=\"setAssetFieldValue\"", 1 );
 
     AssetODBM assetODBM ( this->getLedger (), index );
     if ( assetODBM.mAssetID == AssetID::NULL_INDEX ) return "No such account.";
@@ -623,7 +688,7 @@ LedgerResult Ledger_Inventory::setAssetFieldValue ( AssetID::Index index, string
 //----------------------------------------------------------------//
 LedgerResult Ledger_Inventory::stampAssets ( AccountID accountID, AssetID stampID, u64 price, u64 version, AssetListAdapter assetList, time_t time ) {
 
-    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_COUNT_LABELED ( "volition_inventory_ops_total", "Ledger inventory operations, by method.", "op=\"stampAssets\"", 1 );
 
     if ( !assetList.size ()) return true;
 
@@ -691,7 +756,7 @@ LedgerResult Ledger_Inventory::stampAssets ( AccountID accountID, AssetID stampI
 //----------------------------------------------------------------//
 LedgerResult Ledger_Inventory::transferAssets ( AccountODBM& senderODBM, AccountODBM& receiverODBM, AssetListAdapter assetList, time_t time ) {
     
-    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_COUNT_LABELED ( "volition_inventory_ops_total", "Ledger inventory operations, by method.", "op=\"transferAssets\"", 1 );
     
     AbstractLedger& ledger = this->getLedger ();
 
@@ -699,51 +764,51 @@ LedgerResult Ledger_Inventory::transferAssets ( AccountODBM& senderODBM, Account
     if ( receiverODBM.mAccountID == AccountID::NULL_INDEX )         return "Could not find recipient account.";
     if ( senderODBM.mAccountID == receiverODBM.mAccountID )         return "Cannot send assets to self.";
 
-    size_t senderAssetCount = senderODBM.mAssetCount.get ( 0 );
-    size_t receiverAssetCount = receiverODBM.mAssetCount.get ( 0 );
+    AccountInventory senderInventory ( senderODBM );
+    AccountInventory receiverInventory ( receiverODBM );
 
     shared_ptr < const Account > receiverAccount = receiverODBM.mBody.get ();
-    Entitlements receiverEntitlements = ledger.getEntitlements < AccountEntitlements >( *receiverAccount );
-    if ( !receiverEntitlements.check ( AccountEntitlements::MAX_ASSETS, receiverAssetCount + assetList.size ())) {
-        double max = receiverEntitlements.resolvePathAs < NumericEntitlement >( AccountEntitlements::MAX_ASSETS )->getUpperLimit ().mLimit;
+    shared_ptr < const CompiledEntitlements > receiverEntitlements = TheTransactionContextCache::get ().getEntitlements < AccountEntitlements >( ledger, *receiverAccount );
+    if ( !receiverEntitlements->check ( AccountEntitlements::MAX_ASSETS, receiverInventory.getSize () + assetList.size ())) {
+        double max = receiverEntitlements->resolvePathAs < NumericEntitlement >( AccountEntitlements::MAX_ASSETS )->getUpperLimit ().mLimit;
         return Format::write ( "Transaction would overflow receiving account's inventory limit of %d assets.", ( int )max );
     }
     
     InventoryLogEntry senderLogEntry ( time );
     InventoryLogEntry receiverLogEntry ( time );
 
-    for ( size_t i = 0; i < assetList.size (); ++i, --senderAssetCount, ++receiverAssetCount ) {
+    u64 receiverInventoryNonce = receiverODBM.mInventoryNonce.get ( 0 );
+
+    for ( size_t i = 0; i < assetList.size (); ++i ) {
         
         AssetODBM assetODBM ( ledger, assetList.getAssetIndex ( i ));
         
         // fill the asset's original position by swapping in the tail
         size_t position = assetODBM.mPosition.get ();
-        if ( position < senderAssetCount ) {
-            LedgerFieldODBM < AssetID::Index > senderInventoryField = senderODBM.getInventoryField ( position );
-            LedgerFieldODBM < AssetID::Index > senderInventoryTailField = senderODBM.getInventoryField ( senderAssetCount - 1 );
-            
-            AssetODBM tailAssetODBM ( ledger, senderInventoryTailField.get ());
-            tailAssetODBM.mPosition.set ( position );
-            senderInventoryField.set ( tailAssetODBM.mAssetID );
+        if ( position < senderInventory.getSize ()) {
+            AssetID::Index movedAssetID = senderInventory.remove ( position );
+            if ( movedAssetID != AssetID::NULL_INDEX ) {
+                AssetODBM ( ledger, movedAssetID ).mPosition.set ( position );
+            }
         }
         
         // transfer asset ownership to the receiver
         assetODBM.mOwner.set ( receiverODBM.mAccountID );
         assetODBM.mOffer.set ( OfferID::NULL_INDEX );
-        assetODBM.mInventoryNonce.set ( receiverODBM.mInventoryNonce.get ( 0 ));
-        assetODBM.mPosition.set ( receiverAssetCount );
-        receiverODBM.getInventoryField ( assetODBM.mPosition.get ()).set ( assetODBM.mAssetID );
+        assetODBM.mInventoryNonce.set ( receiverInventoryNonce );
+        assetODBM.mPosition.set ( receiverInventory.push ( assetODBM.mAssetID ));
         
         // add it to the log entries
         senderLogEntry.insertDeletion ( assetODBM.mAssetID );
         receiverLogEntry.insertAddition ( assetODBM.mAssetID );
     }
     
-    ledger.updateInventory ( senderODBM.mAccountID, senderLogEntry );
-    senderODBM.mAssetCount.set ( senderAssetCount );
+    // pages are written once per transfer, not once per asset.
+    senderInventory.commit ();
+    receiverInventory.commit ();
     
+    ledger.updateInventory ( senderODBM.mAccountID, senderLogEntry );
     ledger.updateInventory ( receiverODBM.mAccountID, receiverLogEntry );
-    receiverODBM.mAssetCount.set ( receiverAssetCount );
     
     return true;
 }
@@ -751,7 +816,7 @@ LedgerResult Ledger_Inventory::transferAssets ( AccountODBM& senderODBM, Account
 //----------------------------------------------------------------//
 LedgerResult Ledger_Inventory::transferAssets ( AccountID senderAccountIndex, AccountID receiverAccountIndex, AssetListAdapter assetList, time_t time ) {
     
-    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_COUNT_LABELED ( "volition_inventory_ops_total", "Ledger inventory operations, by method.", "op=\"transferAssets\"", 1 );
     
     AbstractLedger& ledger = this->getLedger ();
     
@@ -775,7 +840,7 @@ LedgerResult Ledger_Inventory::transferAssets ( AccountID senderAccountIndex, Ac
 //----------------------------------------------------------------//
 void Ledger_Inventory::updateInventory ( AccountID accountID, const InventoryLogEntry& entry ) {
 
-    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_COUNT_LABELED ( "volition_inventory_ops_total", "Ledger inventory operations, by method.", "op=\"updateInventory\"", 1 );
 
     AbstractLedger& ledger = this->getLedger ();
     AccountODBM accountODBM ( ledger, accountID );
@@ -783,12 +848,14 @@ void Ledger_Inventory::updateInventory ( AccountID accountID, const InventoryLog
     u64 inventoryNonce = accountODBM.mInventoryNonce.get ( 0 );
     accountODBM.getInventoryLogEntryField ( inventoryNonce ).set ( entry );
     accountODBM.mInventoryNonce.set ( inventoryNonce + 1 );
+    
+    InventoryDelta::checkpoint ( accountODBM, inventoryNonce, entry );
 }
 
 //----------------------------------------------------------------//
 void Ledger_Inventory::updateInventory ( AssetODBM& assetODBM, time_t time, InventoryLogEntry::EntryOp op ) {
 
-    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_COUNT_LABELED ( "volition_inventory_ops_total", "Ledger inventory operations, by method.", "op=\"updateInventory\"", 1 );
 
     AbstractLedger& ledger = this->getLedger ();
 
@@ -804,10 +871,41 @@ void Ledger_Inventory::updateInventory ( AssetODBM& assetODBM, time_t time, Inve
     }
 }
 
+//----------------------------------------------------------------//
+void Ledger_Inventory::unindexOpenOffer ( OfferID::Index offerID ) {
+
+    AbstractLedger& ledger = this->getLedger ();
+
+    OfferODBM offerODBM ( ledger, offerID );
+    
+    // offers already removed from the index have no types.
+    shared_ptr < const SerializableSet < string >> assetTypes = offerODBM.mAssetTypes.get ();
+    if ( !( assetTypes && assetTypes->size ())) return;
+    
+    SerializableSet < string >::const_iterator typeIt = assetTypes->cbegin ();
+    for ( ; typeIt != assetTypes->cend (); ++typeIt ) {
+    
+        LedgerFieldODBM < u64 > countField ( ledger, OfferODBM::keyFor_openOfferByTypeCount ( *typeIt ));
+        u64 count = countField.get ( 0 );
+        assert ( count > 0 );
+        
+        u64 position = offerODBM.getTypePositionField ( *typeIt ).get ();
+        u64 tail = count - 1;
+        
+        if ( position != tail ) {
+            OfferID::Index tailOfferID = LedgerFieldODBM < u64 >( ledger, OfferODBM::keyFor_openOfferByTypeElement ( *typeIt, tail )).get ();
+            LedgerFieldODBM < u64 >( ledger, OfferODBM::keyFor_openOfferByTypeElement ( *typeIt, position )).set ( tailOfferID );
+            OfferODBM ( ledger, tailOfferID ).getTypePositionField ( *typeIt ).set ( position );
+        }
+        countField.set ( tail );
+    }
+    offerODBM.mAssetTypes.set ( SerializableSet < string > ());
+}
+
 //----------------------------------------------------------------//
 LedgerResult Ledger_Inventory::upgradeAssets ( AccountID accountID, const map < string, string >& upgrades, time_t time ) {
 
-    LGN_LOG_SCOPE ( VOL_FILTER_LEDGER, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_COUNT_LABELED ( "volition_inventory_ops_total", "Ledger inventory operations, by method.", "op=\"upgradeAssets\"", 1 );
 
     AbstractLedger& ledger = this->getLedger ();
     const Schema& schema = ledger.getSchema ();
@@ -14,6 +14,7 @@ namespace Volition {
 
 class AccountODBM;
 class AssetODBM;
+class OfferODBM;
 class Schema;
 
 //================================================================//
@@ -73,12 +74,14 @@ private:
     LedgerResult                        awardAssets                 ( AccountODBM& accountODBM, u64 inventoryNonce, const list < AssetBase >& assets, InventoryLogEntry& logEntry );
     LedgerResult                        awardAssets                 ( AccountODBM& accountODBM, u64 inventoryNonce, string assetType, size_t quantity, InventoryLogEntry& logEntry );
     LedgerResult                        clearOffers                 ( AccountID accountID, AssetListAdapter assetList, time_t time );
+    void                                indexOpenOffer              ( OfferODBM& offerODBM, const SerializableSet < string >& assetTypes );
     void                                updateInventory             ( AccountID accountID, const InventoryLogEntry& entry );
     void                                updateInventory             ( AssetODBM& assetODBM, time_t time, InventoryLogEntry::EntryOp op );
 
 public:
 
     //----------------------------------------------------------------//
+    void                                affirmOpenOfferIndex        ();
     LedgerResult                        awardAssets                 ( AccountID accountID, string assetType, size_t quantity, time_t time );
     LedgerResult                        awardAssets                 ( AccountID accountID, const list < AssetBase >& assets, time_t time );
     LedgerResult                        awardAssetsAll              ( AccountID accountID, size_t quantity, time_t time );
@@ -90,6 +93,7 @@ public:
     AssetID::Index                      getAssetID                  ( string assetID ) const;
     void                                getInventory                ( AccountID accountID, SerializableList < SerializableSharedConstPtr < Asset >>& assetList, size_t base = 0, size_t count = 0, bool sparse = false );
     map < string, size_t >              getInventoryHistogram       ( AccountID accountID );
+    void                                getOpenOffers               ( string assetType, SerializableVector < OfferID::Index >& offerIDs ) const;
     LedgerResult                        offerAssets                 ( AccountID accountID, u64 minimumPrice, time_t expiration, AssetListAdapter assetList, time_t time );
     LedgerResult                        resetAssetFields            ( AssetID::Index index, time_t time );
     LedgerResult                        resetAssetFieldValue        ( AssetID::Index index, string fieldName, time_t time );
@@ -98,6 +102,7 @@ public:
     LedgerResult                        stampAssets                 ( AccountID accountID, AssetID stampID, u64 price, u64 version, AssetListAdapter assetList, time_t time );
     LedgerResult                        transferAssets              ( AccountODBM& senderODBM, AccountODBM& receiverODBM, AssetListAdapter assetList, time_t time );
     LedgerResult                        transferAssets              ( AccountID senderAccountIndex, AccountID receiverAccountIndex, AssetListAdapter assetList, time_t time );
+    void                                unindexOpenOffer            ( OfferID::Index offerID );
     LedgerResult                        upgradeAssets               ( AccountID accountID, const map < string, string >& upgrades, time_t time );
 };
 
@@ -7,6 +7,7 @@
 #include <volition/AssetMethodInvocation.h>
 #include <volition/AssetODBM.h>
 #include <volition/Block.h>
+#include <volition/Digest.h>
 #include <volition/Format.h>
 #include <volition/Ledger.h>
 #include <volition/Ledger_Miner.h>
@@ -20,6 +21,13 @@ namespace Volition {
 // Ledger_Miner
 //================================================================//
 
+//----------------------------------------------------------------//
+string Ledger_Miner::getMinerRegistryStamp () const {
+
+    // empty for ledgers created before the registry was tracked
+    return this->getLedger ().getValueOrFallback < string >( Ledger::keyFor_minerRegistryStamp (), "" );
+}
+
 //----------------------------------------------------------------//
 set < string > Ledger_Miner::getMiners () const {
 
@@ -37,6 +45,25 @@ set < string > Ledger_Miner::getMiners () const {
     return minerInfoSet;
 }
 
+//----------------------------------------------------------------//
+Ledger_Miner::MinerURLMap Ledger_Miner::getMinerURLs () const {
+
+    const AbstractLedger& ledger = this->getLedger ();
+
+    shared_ptr < MinerURLMap > minerURLs = ledger.getObjectOrNull < MinerURLMap >( Ledger::keyFor_minerURLs ());
+    if ( minerURLs ) return *minerURLs;
+
+    // older ledgers only have the set of miner names; go through the accounts.
+    MinerURLMap legacyURLs;
+    set < string > miners = this->getMiners ();
+    set < string >::const_iterator minerIt = miners.cbegin ();
+    for ( ; minerIt != miners.cend (); ++minerIt ) {
+        AccountODBM minerODBM ( ledger, *minerIt );
+        legacyURLs [ *minerIt ] = minerODBM.mMinerInfo.get ()->getURL ();
+    }
+    return legacyURLs;
+}
+
 //----------------------------------------------------------------//
 LedgerResult Ledger_Miner::registerMiner ( AccountID accountID, const MinerInfo& minerInfo ) {
 
@@ -59,9 +86,33 @@ LedgerResult Ledger_Miner::registerMiner ( AccountID accountID, const MinerInfo&
     miners->insert ( accountName );
     ledger.setObject < SerializableSet < string >>( KEY_FOR_MINERS, *miners );
 
+    this->touchMinerRegistry ( accountName, minerInfo.getURL ());
+
     return true;
 }
 
+//----------------------------------------------------------------//
+void Ledger_Miner::touchMinerRegistry ( string accountName, string url ) {
+
+    AbstractLedger& ledger = this->getLedger ();
+
+    LedgerKey KEY_FOR_MINER_URLS = Ledger::keyFor_minerURLs ();
+    shared_ptr < MinerURLMap > minerURLs = ledger.getObjectOrNull < MinerURLMap >( KEY_FOR_MINER_URLS );
+    
+    // a ledger that predates the registry gets it built in full on first touch.
+    minerURLs = minerURLs ? minerURLs : make_shared < MinerURLMap >( this->getMinerURLs ());
+    ( *minerURLs )[ accountName ] = url;
+    ledger.setObject < MinerURLMap >( KEY_FOR_MINER_URLS, *minerURLs );
+
+    // the stamp chains every registry change, so two branches only share a stamp if
+    // they share the same history of miner changes. miners compare it each step to
+    // skip re-reading the registry.
+    LedgerKey KEY_FOR_MINER_REGISTRY_STAMP = Ledger::keyFor_minerRegistryStamp ();
+    string stamp = ledger.getValueOrFallback < string >( KEY_FOR_MINER_REGISTRY_STAMP, MINER_REGISTRY_STAMP_INIT );
+    stamp = Digest ( Format::write ( "%s:%s:%s", stamp.c_str (), accountName.c_str (), url.c_str ())).toHex ();
+    ledger.setValue < string >( KEY_FOR_MINER_REGISTRY_STAMP, stamp );
+}
+
 //----------------------------------------------------------------//
 LedgerResult Ledger_Miner::updateMinerInfo ( AccountID accountID, const MinerInfo& minerInfo ) {
 
@@ -72,6 +123,7 @@ LedgerResult Ledger_Miner::updateMinerInfo ( AccountID accountID, const MinerInf
     if ( !accountODBM.mMinerInfo.exists ()) return "Account is not a miner.";
     
     MinerInfo composedInfo = *accountODBM.mMinerInfo.get ();
+    string prevURL = composedInfo.mURL;
     
     if ( minerInfo.mURL.size ()) {
         composedInfo.mURL       = minerInfo.mURL;
@@ -91,6 +143,10 @@ LedgerResult Ledger_Miner::updateMinerInfo ( AccountID accountID, const MinerInf
     accountODBM.mMinerInfo.set ( composedInfo );
     accountODBM.mMinerHeight.set ( ledger.countBlocks ());
 
+    if ( composedInfo.mURL != prevURL ) {
+        this->touchMinerRegistry ( accountODBM.mName.get (), composedInfo.mURL );
+    }
+
     return true;
 }
 
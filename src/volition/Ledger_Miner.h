@@ -24,8 +24,19 @@ public:
 
     typedef SerializableMap < string, string > MinerURLMap;
 
+    static constexpr const char* MINER_REGISTRY_STAMP_INIT = "0";
+
+private:
+
+    //----------------------------------------------------------------//
+    void                                touchMinerRegistry              ( string accountName, string url );
+
+public:
+
     //----------------------------------------------------------------//
+    string                              getMinerRegistryStamp           () const;
     set < string >                      getMiners                       () const;
+    MinerURLMap                         getMinerURLs                    () const;
     LedgerResult                        registerMiner                   ( AccountID accountID, const MinerInfo& minerInfo );
     LedgerResult                        updateMinerInfo                 ( AccountID accountID, const MinerInfo& minerInfo );
 };
@@ -0,0 +1,64 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <volition/Metrics.h>
+
+namespace Volition {
+
+//================================================================//
+// TheMetricsRegistry
+//================================================================//
+
+//----------------------------------------------------------------//
+MetricCounter& TheMetricsRegistry::getCounter ( string name, string help, string labels ) {
+
+    return this->affirmMetric < MetricCounter >( "counter", name, help, labels, []() { return new MetricCounter (); });
+}
+
+//----------------------------------------------------------------//
+MetricGauge& TheMetricsRegistry::getGauge ( string name, string help, string labels ) {
+
+    return this->affirmMetric < MetricGauge >( "gauge", name, help, labels, []() { return new MetricGauge (); });
+}
+
+//----------------------------------------------------------------//
+MetricHistogram& TheMetricsRegistry::getHistogram ( string name, string help, string labels ) {
+
+    return this->getHistogram ( name, help, labels, MetricHistogram::getDefaultLatencyBounds ());
+}
+
+//----------------------------------------------------------------//
+MetricHistogram& TheMetricsRegistry::getHistogram ( string name, string help, string labels, const vector < double >& bounds ) {
+
+    return this->affirmMetric < MetricHistogram >( "histogram", name, help, labels, [ & ]() { return new MetricHistogram ( bounds ); });
+}
+
+//----------------------------------------------------------------//
+string TheMetricsRegistry::toPrometheus () const {
+
+    stringstream out;
+    this->writePrometheus ( out );
+    return out.str ();
+}
+
+//----------------------------------------------------------------//
+void TheMetricsRegistry::writePrometheus ( ostream& out ) const {
+
+    lock_guard < mutex > lock ( this->mMutex );
+
+    map < string, Family >::const_iterator familyIt = this->mFamilies.cbegin ();
+    for ( ; familyIt != this->mFamilies.cend (); ++familyIt ) {
+    
+        const Family& family = familyIt->second;
+    
+        out << "# HELP " << familyIt->first << " " << family.mHelp << "\n";
+        out << "# TYPE " << familyIt->first << " " << family.mType << "\n";
+        
+        map < string, unique_ptr < AbstractMetric >>::const_iterator seriesIt = family.mSeries.cbegin ();
+        for ( ; seriesIt != family.mSeries.cend (); ++seriesIt ) {
+            seriesIt->second->AbstractMetric_writePrometheus ( out );
+        }
+    }
+}
+
+} // namespace Volition
@@ -0,0 +1,346 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_METRICS_H
+#define VOLITION_METRICS_H
+
+#include <volition/common.h>
+#include <volition/Format.h>
+#include <volition/Singleton.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+
+// Metrics are recorded through the VOL_METRIC_* macros below. Each call site
+// resolves its metric once (a function-local static) and after that costs a
+// relaxed atomic add on the calling thread's shard. Build with
+// VOLITION_DISABLE_METRICS defined (cmake -DVOLITION_METRICS=OFF) and the
+// macros expand to nothing; their arguments aren't evaluated (values still
+// count as used, so locals computed only for a metric don't trip warnings).
+
+namespace Volition {
+
+//================================================================//
+// AbstractMetric
+//================================================================//
+class AbstractMetric {
+public:
+
+    // writers are spread over this many cache-line sized slots; a thread always uses the same one.
+    static const size_t TOTAL_SHARDS = 16;
+
+protected:
+
+    friend class TheMetricsRegistry;
+
+    string      mName;
+    string      mLabels;
+
+    //----------------------------------------------------------------//
+    static size_t getShardIndex () {
+        static atomic < size_t > sNextShard { 0 };
+        thread_local size_t shardIndex = sNextShard.fetch_add ( 1, memory_order_relaxed ) % TOTAL_SHARDS;
+        return shardIndex;
+    }
+
+    //----------------------------------------------------------------//
+    string getSeriesName ( string suffix = "", string extraLabel = "" ) const {
+
+        string labels = this->mLabels;
+        if ( extraLabel.size ()) {
+            labels = labels.size () ? labels + "," + extraLabel : extraLabel;
+        }
+        return labels.size () ? Format::write ( "%s%s{%s}", this->mName.c_str (), suffix.c_str (), labels.c_str ()) : this->mName + suffix;
+    }
+
+    //----------------------------------------------------------------//
+    virtual void        AbstractMetric_writePrometheus      ( ostream& out ) const = 0;
+
+public:
+
+    //----------------------------------------------------------------//
+    virtual ~AbstractMetric () {
+    }
+};
+
+//================================================================//
+// MetricCounter
+//================================================================//
+class MetricCounter :
+    public AbstractMetric {
+private:
+
+    class alignas ( 64 ) Shard {
+    public:
+        atomic < u64 >      mValue { 0 };
+    };
+
+    Shard       mShards [ TOTAL_SHARDS ];
+
+    //----------------------------------------------------------------//
+    void AbstractMetric_writePrometheus ( ostream& out ) const override {
+        out << this->getSeriesName () << " " << this->get () << "\n";
+    }
+
+public:
+
+    //----------------------------------------------------------------//
+    void add ( u64 amount = 1 ) {
+        this->mShards [ getShardIndex ()].mValue.fetch_add ( amount, memory_order_relaxed );
+    }
+
+    //----------------------------------------------------------------//
+    u64 get () const {
+        u64 sum = 0;
+        for ( size_t i = 0; i < TOTAL_SHARDS; ++i ) {
+            sum += this->mShards [ i ].mValue.load ( memory_order_relaxed );
+        }
+        return sum;
+    }
+};
+
+//================================================================//
+// MetricGauge
+//================================================================//
+class MetricGauge :
+    public AbstractMetric {
+private:
+
+    atomic < double >   mValue { 0.0 };
+
+    //----------------------------------------------------------------//
+    void AbstractMetric_writePrometheus ( ostream& out ) const override {
+        out << this->getSeriesName () << " " << this->get () << "\n";
+    }
+
+public:
+
+    //----------------------------------------------------------------//
+    double get () const {
+        return this->mValue.load ( memory_order_relaxed );
+    }
+
+    //----------------------------------------------------------------//
+    void set ( double value ) {
+        this->mValue.store ( value, memory_order_relaxed );
+    }
+};
+
+//================================================================//
+// MetricHistogram
+//================================================================//
+class MetricHistogram :
+    public AbstractMetric {
+public:
+
+    static const size_t MAX_BUCKETS = 16;
+
+private:
+
+    class alignas ( 64 ) Shard {
+    public:
+        atomic < u64 >      mBuckets [ MAX_BUCKETS + 1 ]; // the last one is +Inf
+        atomic < double >   mSum { 0.0 };
+
+        //----------------------------------------------------------------//
+        Shard () {
+            for ( size_t i = 0; i <= MAX_BUCKETS; ++i ) {
+                this->mBuckets [ i ].store ( 0, memory_order_relaxed );
+            }
+        }
+    };
+
+    vector < double >   mBounds;
+    Shard               mShards [ TOTAL_SHARDS ];
+
+    //----------------------------------------------------------------//
+    void AbstractMetric_writePrometheus ( ostream& out ) const override {
+
+        u64 cumulative = 0;
+        double sum = 0.0;
+
+        for ( size_t i = 0; i <= this->mBounds.size (); ++i ) {
+            for ( size_t j = 0; j < TOTAL_SHARDS; ++j ) {
+                cumulative += this->mShards [ j ].mBuckets [ i ].load ( memory_order_relaxed );
+            }
+            string le = i < this->mBounds.size () ? Format::write ( "le=\"%g\"", this->mBounds [ i ]) : "le=\"+Inf\"";
+            out << this->getSeriesName ( "_bucket", le ) << " " << cumulative << "\n";
+        }
+
+        for ( size_t j = 0; j < TOTAL_SHARDS; ++j ) {
+            sum += this->mShards [ j ].mSum.load ( memory_order_relaxed );
+        }
+
+        out << this->getSeriesName ( "_sum" ) << " " << sum << "\n";
+        out << this->getSeriesName ( "_count" ) << " " << cumulative << "\n";
+    }
+
+public:
+
+    //----------------------------------------------------------------//
+    static vector < double > getDefaultLatencyBounds () {
+        return { 0.0001, 0.0005, 0.001, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0 };
+    }
+
+    //----------------------------------------------------------------//
+    MetricHistogram ( const vector < double >& bounds ) :
+        mBounds ( bounds ) {
+
+        assert ( bounds.size () <= MAX_BUCKETS );
+        if ( this->mBounds.size () > MAX_BUCKETS ) {
+            this->mBounds.resize ( MAX_BUCKETS );
+        }
+    }
+
+    //----------------------------------------------------------------//
+    void observe ( double value ) {
+
+        size_t bucket = ( size_t )( lower_bound ( this->mBounds.cbegin (), this->mBounds.cend (), value ) - this->mBounds.cbegin ());
+
+        Shard& shard = this->mShards [ getShardIndex ()];
+        shard.mBuckets [ bucket ].fetch_add ( 1, memory_order_relaxed );
+
+        // only this thread (and any others that share its shard) write here, so this rarely spins.
+        double sum = shard.mSum.load ( memory_order_relaxed );
+        while ( !shard.mSum.compare_exchange_weak ( sum, sum + value, memory_order_relaxed ));
+    }
+};
+
+//================================================================//
+// ScopedMetricSpan
+//================================================================//
+// Observes the lifetime of the scope, in seconds, into a histogram.
+class ScopedMetricSpan {
+private:
+
+    MetricHistogram&                    mHistogram;
+    chrono::steady_clock::time_point    mT0;
+
+public:
+
+    //----------------------------------------------------------------//
+    ScopedMetricSpan ( MetricHistogram& histogram ) :
+        mHistogram ( histogram ),
+        mT0 ( chrono::steady_clock::now ()) {
+    }
+
+    //----------------------------------------------------------------//
+    ~ScopedMetricSpan () {
+        chrono::duration < double > span = chrono::steady_clock::now () - this->mT0;
+        this->mHistogram.observe ( span.count ());
+    }
+};
+
+//================================================================//
+// TheMetricsRegistry
+//================================================================//
+// Owns every metric for the life of the process, grouped into families by
+// name. Registration takes a lock; recording never does. Metrics are never
+// removed, so references handed out stay valid.
+class TheMetricsRegistry :
+    public Singleton < TheMetricsRegistry > {
+private:
+
+    //----------------------------------------------------------------//
+    class Family {
+    public:
+
+        string                                          mType;
+        string                                          mHelp;
+        map < string, unique_ptr < AbstractMetric >>    mSeries; // by labels
+    };
+
+    mutable mutex               mMutex;
+    map < string, Family >      mFamilies;
+
+    //----------------------------------------------------------------//
+    template < typename TYPE >
+    TYPE& affirmMetric ( string type, string name, string help, string labels, function < TYPE* ()> factory ) {
+
+        lock_guard < mutex > lock ( this->mMutex );
+
+        Family& family = this->mFamilies [ name ];
+        if ( family.mType.size () == 0 ) {
+            family.mType = type;
+            family.mHelp = help;
+        }
+        assert ( family.mType == type );
+
+        unique_ptr < AbstractMetric >& metric = family.mSeries [ labels ];
+        if ( !metric ) {
+            TYPE* created = factory ();
+            created->mName = name;
+            created->mLabels = labels;
+            metric.reset ( created );
+        }
+
+        TYPE* typed = dynamic_cast < TYPE* >( metric.get ());
+        assert ( typed );
+        return *typed;
+    }
+
+public:
+
+    //----------------------------------------------------------------//
+    MetricCounter&      getCounter          ( string name, string help, string labels = "" );
+    MetricGauge&        getGauge            ( string name, string help, string labels = "" );
+    MetricHistogram&    getHistogram        ( string name, string help, string labels = "" );
+    MetricHistogram&    getHistogram        ( string name, string help, string labels, const vector < double >& bounds );
+    string              toPrometheus        () const;
+    void                writePrometheus     ( ostream& out ) const;
+};
+
+} // namespace Volition
+
+#ifndef VOLITION_DISABLE_METRICS
+
+    #define VOL_METRIC_CONCAT_INNER(a,b) a##b
+    #define VOL_METRIC_CONCAT(a,b) VOL_METRIC_CONCAT_INNER(a,b)
+
+    #define VOL_METRIC_COUNT(name,help,amount) do {                                                                         \
+        static Volition::MetricCounter& _metric = Volition::TheMetricsRegistry::get ().getCounter ( name, help );          \
+        _metric.add ( amount );                                                                                             \
+    } while ( 0 )
+
+    #define VOL_METRIC_COUNT_LABELED(name,help,labels,amount) do {                                                          \
+        static Volition::MetricCounter& _metric = Volition::TheMetricsRegistry::get ().getCounter ( name, help, labels );  \
+        _metric.add ( amount );                                                                                             \
+    } while ( 0 )
+
+    #define VOL_METRIC_GAUGE(name,help,value) do {                                                                          \
+        static Volition::MetricGauge& _metric = Volition::TheMetricsRegistry::get ().getGauge ( name, help );              \
+        _metric.set (( double )( value ));                                                                                  \
+    } while ( 0 )
+
+    #define VOL_METRIC_GAUGE_LABELED(name,help,labels,value) do {                                                           \
+        static Volition::MetricGauge& _metric = Volition::TheMetricsRegistry::get ().getGauge ( name, help, labels );      \
+        _metric.set (( double )( value ));                                                                                  \
+    } while ( 0 )
+
+    #define VOL_METRIC_OBSERVE(name,help,value) do {                                                                        \
+        static Volition::MetricHistogram& _metric = Volition::TheMetricsRegistry::get ().getHistogram ( name, help );      \
+        _metric.observe (( double )( value ));                                                                              \
+    } while ( 0 )
+
+    // labels must be the same at every pass through the call site; they are bound once.
+    #define VOL_METRIC_SPAN_LABELED(name,help,labels)                                                                       \
+        static Volition::MetricHistogram& VOL_METRIC_CONCAT ( _metricHistogram, __LINE__ ) =                               \
+            Volition::TheMetricsRegistry::get ().getHistogram ( name, help, labels );                                       \
+        Volition::ScopedMetricSpan VOL_METRIC_CONCAT ( _metricSpan, __LINE__ ) ( VOL_METRIC_CONCAT ( _metricHistogram, __LINE__ ))
+
+    #define VOL_METRIC_SPAN(name,help) VOL_METRIC_SPAN_LABELED ( name, help, "" )
+
+#else
+
+    #define VOL_METRIC_COUNT(name,help,amount)                  do { ( void )sizeof ( amount ); } while ( 0 )
+    #define VOL_METRIC_COUNT_LABELED(name,help,labels,amount)   do { ( void )sizeof ( amount ); } while ( 0 )
+    #define VOL_METRIC_GAUGE(name,help,value)                   do { ( void )sizeof ( value ); } while ( 0 )
+    #define VOL_METRIC_GAUGE_LABELED(name,help,labels,value)    do { ( void )sizeof ( value ); } while ( 0 )
+    #define VOL_METRIC_OBSERVE(name,help,value)                 do { ( void )sizeof ( value ); } while ( 0 )
+    #define VOL_METRIC_SPAN_LABELED(name,help,labels)
+    #define VOL_METRIC_SPAN(name,help)
+
+#endif
+
+#endif
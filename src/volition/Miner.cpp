@@ -4,6 +4,7 @@
 #include <volition/Block.h>
 #include <volition/BlockODBM.h>
 #include <volition/BlockSearchPool.h>
+#include <volition/DeferredBlock.h>
 #include <volition/Digest.h>
 #include <volition/FileSys.h>
 #include <volition/HTTPMiningMessenger.h>
@@ -11,6 +12,7 @@
 #include <volition/Miner.h>
 #include <volition/MinerLaunchTests.h>
 #include <volition/Release.h>
+#include <volition/SQLiteBlockStore.h>
 #include <volition/SQLiteBlockTree.h>
 #include <volition/Transaction.h>
 #include <volition/Transactions.h>
@@ -37,6 +39,26 @@ set < string > MinerSnapshot::sampleOnlineMinerURLs ( size_t sampleSize ) const
 // Miner
 //================================================================//
 
+//----------------------------------------------------------------//
+LedgerResult Miner::affirmBlockStore ( SQLiteConfig config ) {
+
+    // shared by the block tree and the ledger, so whichever is persisted first opens it.
+    if ( this->mBlockStore ) return true;
+    if ( this->mPrefixFilename.size () == 0 ) return "Missing persistence path.";
+
+    string journalModeString = config.mJournalMode == SQLiteConfig::JOURNAL_MODE_WAL ? "-jmwal" : "";
+    this->mBlockStoreFilename = Format::write ( "%s-blockstore-sqlite%s.db", this->mPrefixFilename.c_str (), journalModeString.c_str ());
+
+    try {
+        this->mBlockStore = make_shared < SQLiteBlockStore >( this->mBlockStoreFilename, config );
+    }
+    catch ( SQLiteBlockStoreUnsupportedVersionException ) {
+
+        return "Unsupported SQLite block store format; delete your persist-chain folder and re-sync.";
+    }
+    return true;
+}
+
 //----------------------------------------------------------------//
 void Miner::affirmKey ( uint keyLength, unsigned long exp ) {
 
@@ -183,6 +205,12 @@ void Miner::composeChainInnerLoop ( BlockTreeCursor branch ) {
     }
 }
 
+//----------------------------------------------------------------//
+void Miner::enableSnapshotSync ( string filename, size_t quorum ) {
+
+    this->mSnapshotSync = filename.size () ? make_shared < LedgerSnapshotSync >( filename, quorum ) : NULL;
+}
+
 //----------------------------------------------------------------//
 size_t Miner::getChainSize () const {
 
@@ -204,6 +232,13 @@ Ledger Miner::getLedgerAtBlock ( u64 index ) const {
     return ledger;
 }
 
+//----------------------------------------------------------------//
+string Miner::getResponseEpoch () {
+
+    shared_lock < shared_mutex > lock ( this->mLockedLedgerMutex );
+    return this->mResponseEpoch;
+}
+
 //----------------------------------------------------------------//
 void Miner::getSnapshot ( MinerSnapshot* snapshot, MinerStatus* status ) {
 
@@ -327,6 +362,7 @@ Miner::Miner () :
     mReportMode ( REPORT_NONE ),
     mBlockVerificationPolicy ( Block::VerificationPolicy::ALL ),
     mControlLevel ( CONTROL_NONE ),
+    mMinersFileDirty ( true ),
     mConsensusLookaheadHeight ( DEFAULT_CONSENSUS_LOOKAHEAD_HEIGHT ),
     mNetworkSearch ( false ),
     mPersistFrequency ( 0 ),
@@ -341,6 +377,18 @@ Miner::Miner () :
     MinerLaunchTests::checkEnvironment ();
     
     this->mTransactionQueue = make_shared < TransactionQueue >();
+    this->mCraftabilityIndex = make_shared < CraftabilityIndex >();
+    this->mSnapshotCache = make_shared < LedgerSnapshotCache >([ this ]( u64 height, const function < void ( AbstractLedger& )>& visitor ) {
+    
+        // the same view the API handlers read, under the same lock.
+        shared_lock < shared_mutex > lock ( this->mLockedLedgerMutex );
+        LockedLedgerIterator ledger ( this->mLockedLedger );
+        if ( ledger.countBlocks () <= height ) return false;
+        
+        ledger.seek ( height + 1 );
+        visitor ( ledger );
+        return true;
+    });
 }
 
 //----------------------------------------------------------------//
@@ -355,8 +403,11 @@ LedgerResult Miner::persistBlockTreeSQLite ( SQLiteConfig config ) {
     string journalModeString = config.mJournalMode == SQLiteConfig::JOURNAL_MODE_WAL ? "-jmwal" : "";
     this->mBlocksFilename = Format::write ( "%s-blocks-sqlite%s.db", this->mPrefixFilename.c_str (), journalModeString.c_str ());
     
+    LedgerResult result = this->affirmBlockStore ( config );
+    if ( !result ) return result;
+    
     try {
-        this->mBlockTree            = make_shared < SQLiteBlockTree >( this->mBlocksFilename, config );
+        this->mBlockTree            = make_shared < SQLiteBlockTree >( this->mBlocksFilename, config, this->mBlockStore );
         this->mBlockSearchPool      = make_shared < BlockSearchPool >( *this, *this->mBlockTree );
         this->mBlockTree->setCacheSize ( DEFAULT_BLOCK_TREE_CACHE_SIZE );
     }
@@ -380,6 +431,7 @@ LedgerResult Miner::persistLedger ( shared_ptr < AbstractPersistenceProvider > p
     
     VersionedStoreTag tag = this->mPersistenceProvider->restore ( "master" );
     shared_ptr < Ledger > ledger = make_shared < Ledger >( tag );
+    ledger->mBlockStore = this->mBlockStore;
     
     shared_ptr < const Block > topBlock = ledger->getBlock ();
     
@@ -428,6 +480,9 @@ LedgerResult Miner::persistLedgerSQLite ( shared_ptr < const Block > genesisBloc
     string journalModeString = config.mJournalMode == SQLiteConfig::JOURNAL_MODE_WAL ? "-jmwal" : "";
     this->mLedgerFilename = Format::write ( "%s-sqlite%s.db", this->mPrefixFilename.c_str (), journalModeString.c_str ());
     
+    LedgerResult result = this->affirmBlockStore ( config );
+    if ( !result ) return result;
+    
     return this->persistLedger ( SQLitePersistenceProvider::make ( this->mLedgerFilename, config ), genesisBlock );
 }
 
@@ -439,6 +494,9 @@ LedgerResult Miner::persistLedgerSQLiteStringStore ( shared_ptr < const Block >
     string journalModeString = config.mJournalMode == SQLiteConfig::JOURNAL_MODE_WAL ? "-jmwal" : "";
     this->mLedgerFilename = Format::write ( "%s-sqlite-stringstore%s.db", this->mPrefixFilename.c_str (), journalModeString.c_str ());
     
+    LedgerResult result = this->affirmBlockStore ( config );
+    if ( !result ) return result;
+    
     return this->persistLedger ( SQLiteStringStore::make ( this->mLedgerFilename, config ), genesisBlock );
 }
 
@@ -498,11 +556,36 @@ void Miner::pushBlock ( shared_ptr < const Block > block ) {
 
     this->mLedger->revertAndClear ( block->getHeight ());
 
+    // grab the deferred transactions maturing at this height before the block is pushed, so the
+    // feed can report the accounts they touch. only blocks still on the unfinished list are due;
+    // one whose transactions were never copied out only names its block, so it wakes everyone.
+    DeferredBlockList deferred = this->mLedger->getDeferred ( block->getHeight ());
+    DeferredBlockList matured;
+    bool everyone = false;
+
+    UnfinishedBlockList unfinished = this->mLedger->getUnfinished ();
+    UnfinishedBlockList::Iterator unfinishedIt = unfinished.mBlocks.cbegin ();
+    for ( ; unfinishedIt != unfinished.mBlocks.cend (); ++unfinishedIt ) {
+        if ( unfinishedIt->mMaturity != block->getHeight ()) continue;
+        
+        bool found = false;
+        DeferredBlockList::Iterator deferredIt = deferred.mBlocks.cbegin ();
+        for ( ; ( deferredIt != deferred.mBlocks.cend ()) && !found; ++deferredIt ) {
+            if ( deferredIt->mBlockID == unfinishedIt->mBlockID ) {
+                matured.mBlocks.push_back ( *deferredIt );
+                found = true;
+            }
+        }
+        everyone = everyone || !found;
+    }
+
     LedgerResult result = this->mLedger->pushBlock ( *block, this->mBlockVerificationPolicy );
     result.reportWithAssert ();
     
     BlockTreeCursor node = this->mBlockTree->affirmBlock ( this->mLedgerTag, block );
     assert ( node.hasHeader ());
+    
+    this->mEventFeed.publish ( *block, matured, everyone );
 }
 
 //----------------------------------------------------------------//
@@ -551,7 +634,20 @@ void Miner::report ( ReportMode reportMode ) const {
             
             LGN_LOG ( VOL_FILTER_MINING_REPORT, INFO, "BEST - %d: %s", ( int )maxHeight - 1, ledgerCursor.writeBranch ( minHeight, maxHeight ).c_str ());
             LGN_LOG ( VOL_FILTER_MINING_REPORT, INFO, "BLOCK SEARCHES: %d", ( int )this->mBlockSearchPool->countSearches ());
-            LGN_LOG ( VOL_FILTER_MINING_REPORT, INFO, "ACTIVE SEARCHES: %d", ( int )this->mBlockSearchPool->countActiveSearches ());
+            LGN_LOG ( VOL_FILTER_MINING_REPORT, INFO, "ACTIVE SEARCHES: %d (window: %d)", ( int )this->mBlockSearchPool->countActiveSearches (), ( int )this->mBlockSearchPool->getWindow ());
+            
+            {
+                u64 ledgerHeight = this->getLedgerTag ().getHeight ();
+                u64 behind = ( ledgerCursor.getHeight () > ledgerHeight ) ? ( ledgerCursor.getHeight () - ledgerHeight ) : 0;
+                double blockRate = this->mBlockSearchPool->getBlockRate ();
+                
+                if ( behind && ( blockRate > 0.0 )) {
+                    LGN_LOG ( VOL_FILTER_MINING_REPORT, INFO, "SYNC: %d blocks behind at %.2lf blocks/s (ETA: %ds)", ( int )behind, blockRate, ( int )(( double )behind / blockRate ));
+                }
+                else if ( behind ) {
+                    LGN_LOG ( VOL_FILTER_MINING_REPORT, INFO, "SYNC: %d blocks behind", ( int )behind );
+                }
+            }
             LGN_LOG ( VOL_FILTER_MINING_REPORT, INFO, "LEDGER TAG: %s", this->getLedgerTag ().write ().c_str ());
             break;
         }
@@ -717,6 +813,7 @@ void Miner::setGenesis ( shared_ptr < const Block > block ) {
     else {
     
         this->mLedger = make_shared < Ledger >();
+        this->mLedger->mBlockStore = this->mBlockStore;
         this->pushBlock ( block );
         this->mBlockTree->tag ( this->mBestBranchTag, this->mLedgerTag );
     }
@@ -732,6 +829,12 @@ void Miner::setMaxBlockSearches ( size_t max ) {
     this->mBlockSearchPool->setMaxSearches ( max );
 }
 
+//----------------------------------------------------------------//
+void Miner::setMaxEventWaiters ( size_t max ) {
+
+    this->mEventFeed.setMaxWaiters ( max );
+}
+
 //----------------------------------------------------------------//
 void Miner::setMinimumGratuity ( u64 minimumGratuity ) {
 
@@ -784,18 +887,40 @@ void Miner::step ( time_t now ) {
     LGN_LOG_SCOPE ( VOL_FILTER_CONSENSUS, INFO, __PRETTY_FUNCTION__ );
 
     this->affirmMessenger ();
+    
+    MinerStepProfiler::Step step ( this->mStepProfiler, now );
+    
+    step.begin ( MinerStepProfiler::PHASE_RECEIVE_RESPONSES );
     this->mMessenger->receiveResponses ( *this, now );
+    
+    step.begin ( MinerStepProfiler::PHASE_UPDATE_REMOTE_MINER_GROUPS );
     this->updateRemoteMinerGroups ();
+    
+    step.begin ( MinerStepProfiler::PHASE_UPDATE_REMOTE_MINERS );
     this->updateRemoteMiners ();
+    
+    step.begin ( MinerStepProfiler::PHASE_UPDATE_SNAPSHOT_SYNC );
+    this->updateSnapshotSync ();
+    
+    step.begin ( MinerStepProfiler::PHASE_UPDATE_BLOCK_SEARCHES );
     this->updateBlockSearches ();
+    
+    step.begin ( MinerStepProfiler::PHASE_UPDATE_NETWORK_SEARCHES );
     this->updateNetworkSearches ();
   
+    step.begin ( MinerStepProfiler::PHASE_UPDATE_BEST_BRANCH );
     this->updateBestBranch ( now );
+    
+    step.begin ( MinerStepProfiler::PHASE_SAVE_CHAIN );
     this->saveChain ();
     
+    step.begin ( MinerStepProfiler::PHASE_UPDATE_RELEASE );
     this->updateRelease ();
+    
+    step.begin ( MinerStepProfiler::PHASE_UPDATE_MINER_STATUS );
     this->updateMinerStatus ();
     
+    step.begin ( MinerStepProfiler::PHASE_SEND_REQUESTS );
     try {
         this->mMessenger->sendRequests ();
     }
@@ -955,11 +1080,25 @@ void Miner::updateMinerStatus () {
 
     this->mSnapshotMutex.unlock ();
     
+    // the response epoch identifies everything cached API responses may depend on: the
+    // locked ledger (by height and tip hash, so reorgs are caught) plus the handful of
+    // miner status fields served alongside ledger data.
+    BlockTreeCursor ledgerCursor = this->mLedgerTag.getCursor ();
+    string responseEpoch = Format::write ( "%d:%s:%d:%d:%s",
+        ( int )this->mLedger->getHeight (),
+        ledgerCursor.hasHeader () ? ledgerCursor.getHash ().c_str () : "",
+        ( int )this->mAcceptedRelease,
+        ( int )this->getMinimumGratuity (),
+        this->mMotto.c_str ()
+    );
+
     this->mLockedLedgerMutex.lock ();
     {
         LGN_LOG_SCOPE ( VOL_FILTER_CONSENSUS, INFO, "Ledger LOCK" );
         this->mLockedLedger.lock ( *this->mLedger );
         this->mLockedLedger.mSchemaCache = this->mLedger->mSchemaCache;
+        this->mLockedLedger.mBlockStore = this->mLedger->mBlockStore;
+        this->mResponseEpoch = responseEpoch;
     }
     this->mLockedLedgerMutex.unlock ();
 }
@@ -1068,18 +1207,29 @@ void Miner::updateRemoteMiners () {
     
     LGN_LOG ( VOL_FILTER_CONSENSUS, INFO, "affirming remote miner new URLs" );
     
-    // get miner URL list from ledger
-    set < string > miners = this->getLedger ().getMiners ();
-    set < string >::iterator minerIt = miners.begin ();
-    for ( ; minerIt != miners.end (); ++minerIt ) {
-        
-        string minerID = *minerIt;
-        if ( minerID == this->mMinerID ) continue;
-        
-        AccountODBM minerODBM ( this->getLedger (), *minerIt );
-        string url = minerODBM.mMinerInfo.get ()->getURL ();
+    // the registry stamp changes with every miner registration or URL update (and
+    // differs across branches with different miner histories), so the URL map only
+    // needs to be read and diffed when it moves. an empty stamp means the ledger
+    // predates the registry; fall back to reading it every step.
+    const Ledger& ledger = this->getLedger ();
+    string stamp = ledger.getMinerRegistryStamp ();
+    
+    if (( stamp.size () == 0 ) || ( stamp != this->mMinerRegistryStamp )) {
+    
+        Ledger_Miner::MinerURLMap minerURLs = ledger.getMinerURLs ();
         
-        this->affirmRemoteMiner ( url );
+        Ledger_Miner::MinerURLMap::const_iterator minerURLIt = minerURLs.cbegin ();
+        for ( ; minerURLIt != minerURLs.cend (); ++minerURLIt ) {
+            
+            if ( minerURLIt->first == this->mMinerID ) continue;
+            
+            Ledger_Miner::MinerURLMap::const_iterator prevIt = this->mMinerURLs.find ( minerURLIt->first );
+            if (( prevIt != this->mMinerURLs.cend ()) && ( prevIt->second == minerURLIt->second )) continue;
+            
+            this->affirmRemoteMiner ( minerURLIt->second );
+        }
+        this->mMinerURLs = minerURLs;
+        this->mMinerRegistryStamp = stamp;
     }
     
     LGN_LOG ( VOL_FILTER_CONSENSUS, INFO, "affirming remote miner pending URLs" );
@@ -1096,12 +1246,11 @@ void Miner::updateRemoteMiners () {
             this->mRemoteMinersByURL [ url ] = remoteMiner;
             this->mRemoteMiners.insert ( remoteMiner );
             this->mCompletedURLs.insert ( url );
+            this->mMinersFileDirty = true;
         }
         this->mNewMinerURLs.erase ( url );
     }
     
-    SerializableSet < string > minerURLs;
-    
     LGN_LOG ( VOL_FILTER_CONSENSUS, INFO, "updating remote miner state" );
     
     size_t lookahead = this->mLedger->getHeight () + this->mConsensusLookaheadHeight;
@@ -1111,15 +1260,38 @@ void Miner::updateRemoteMiners () {
     for ( ; remoteMinerIt != this->mRemoteMiners.end (); ++remoteMinerIt ) {
         shared_ptr < RemoteMiner > remoteMiner = *remoteMinerIt;
         remoteMiner->update ( this->mAcceptedRelease, lookahead );
-        minerURLs.insert ( remoteMiner->getURL ());
     }
     
-    if ( this->mMinersFilename.size ()) {
+    // the remote miner set only ever grows, so only rewrite the file when it does.
+    if ( this->mMinersFileDirty && this->mMinersFilename.size ()) {
         LGN_LOG_SCOPE ( VOL_FILTER_CONSENSUS, INFO, "writing miners.json" );
+        
+        SerializableSet < string > minerURLs;
+        set < shared_ptr < RemoteMiner >>::const_iterator minerIt = this->mRemoteMiners.cbegin ();
+        for ( ; minerIt != this->mRemoteMiners.cend (); ++minerIt ) {
+            minerURLs.insert (( *minerIt )->getURL ());
+        }
         ToJSONSerializer::toJSONFile ( minerURLs, this->mMinersFilename );
+        this->mMinersFileDirty = false;
     }
 }
 
+//----------------------------------------------------------------//
+void Miner::updateSnapshotSync () {
+
+    if ( !( this->mSnapshotSync && !this->mSnapshotSync->isDone ())) return;
+    
+    LGN_LOG_SCOPE ( VOL_FILTER_CONSENSUS, INFO, __PRETTY_FUNCTION__ );
+    
+    set < string > onlineURLs;
+    
+    set < shared_ptr < RemoteMiner >>::const_iterator remoteMinerIt = this->mOnlineMiners.cbegin ();
+    for ( ; remoteMinerIt != this->mOnlineMiners.cend (); ++remoteMinerIt ) {
+        onlineURLs.insert (( *remoteMinerIt )->getURL ());
+    }
+    this->mSnapshotSync->update ( *this->mMessenger, *this->mBlockTree, this->mBestBranchTag.getCursor (), onlineURLs );
+}
+
 //================================================================//
 // overrides
 //================================================================//
@@ -1139,6 +1311,14 @@ void Miner::AbstractMiningMessengerClient_receiveResponse ( const MiningMessenge
     
     if ( !remoteMiner ) return;
     
+    // snapshots are optional; a miner that can't serve one shouldn't be marked offline.
+    if (( request.mRequestType == MiningMessengerRequest::REQUEST_SNAPSHOT_CHUNK ) || ( request.mRequestType == MiningMessengerRequest::REQUEST_SNAPSHOT_MANIFEST )) {
+        if ( this->mSnapshotSync ) {
+            this->mSnapshotSync->receiveResponse ( response );
+        }
+        return;
+    }
+    
     // TODO: could be set deliberately as an attack (eacy to knock other miners out of circulation this way)
     if ( response.mMinerID == this->mMinerID ) {
         this->mRemoteMinersByURL.erase ( url );
@@ -1153,8 +1333,7 @@ void Miner::AbstractMiningMessengerClient_receiveResponse ( const MiningMessenge
             if ( response.mBlock ) {
                 this->mBlockTree->update ( response.mBlock );
             }
-            string hash = request.mBlockDigest.toHex ();
-            this->mBlockSearchPool->updateBlockSearch ( remoteMiner->getMinerID (), hash, ( bool )response.mBlock );
+            this->mBlockSearchPool->updateBlockSearch ( *remoteMiner, request.mBlockDigest, ( bool )response.mBlock );
             break;
         }
         
@@ -7,12 +7,18 @@
 #include <volition/common.h>
 #include <volition/AbstractMiningMessenger.h>
 #include <volition/Accessors.h>
+#include <volition/AbstractBlockStore.h>
 #include <volition/AbstractBlockTree.h>
 #include <volition/BlockTreeSampler.h>
 #include <volition/PayoutPolicy.h>
 #include <volition/TransactionFeeSchedule.h>
+#include <volition/CraftabilityIndex.h>
 #include <volition/CryptoKey.h>
 #include <volition/Ledger.h>
+#include <volition/LedgerEventFeed.h>
+#include <volition/LedgerSnapshot.h>
+#include <volition/LedgerSnapshotSync.h>
+#include <volition/MinerStepProfiler.h>
 #include <volition/MonetaryPolicy.h>
 #include <volition/RemoteMiner.h>
 #include <volition/TransactionQueue.h>
@@ -76,6 +82,7 @@ public:
     string                              mLedgerFilename;
     string                              mConfigFilename;
     string                              mBlocksFilename;
+    string                              mBlockStoreFilename;
     string                              mMinersFilename;
 
     set < string >                      mOnlineMinerURLs;
@@ -152,6 +159,7 @@ protected:
 
     friend class AbstractChainRecorder;
     friend class BlockSearch;
+    friend class BlockSearchPool;
     friend class RemoteMiner;
 
     friend class ScopedExclusiveMinerLock;
@@ -175,6 +183,11 @@ protected:
     set < string >                                  mNewMinerURLs;
     set < string >                                  mCompletedURLs;
     
+    // last miner registry seen in the ledger; refreshed only when its stamp changes.
+    Ledger_Miner::MinerURLMap                       mMinerURLs;
+    string                                          mMinerRegistryStamp;
+    bool                                            mMinersFileDirty;
+    
     set < shared_ptr < RemoteMiner >>               mRemoteMiners;
     map < string, shared_ptr < RemoteMiner >>       mRemoteMinersByID;
     map < string, shared_ptr < RemoteMiner >>       mRemoteMinersByURL;
@@ -185,6 +198,7 @@ protected:
     
     bool                                            mNetworkSearch;
     
+    shared_ptr < AbstractBlockStore >               mBlockStore;
     shared_ptr < AbstractBlockTree >                mBlockTree;
     mutex                                           mBlockTreeMutex;
     shared_ptr < BlockSearchPool >                  mBlockSearchPool;
@@ -215,15 +229,23 @@ protected:
     shared_mutex                                    mSnapshotMutex;
     
     LockedLedger                                    mLockedLedger;
+    string                                          mResponseEpoch; // guarded by mLockedLedgerMutex
     shared_mutex                                    mLockedLedgerMutex;
     
     shared_ptr < AbstractMiningMessenger >          mMessenger;
     shared_ptr < TransactionQueue >                 mTransactionQueue;
+    shared_ptr < CraftabilityIndex >                mCraftabilityIndex;
+    shared_ptr < LedgerSnapshotCache >              mSnapshotCache;
+    shared_ptr < LedgerSnapshotSync >               mSnapshotSync;
     
     u64                                             mAcceptedRelease; // will accept blocks with this release
     u64                                             mProducedRelease; // will produce blocks with this release
     
+    MinerStepProfiler                               mStepProfiler;
+    LedgerEventFeed                                 mEventFeed;
+    
     //----------------------------------------------------------------//
+    LedgerResult                        affirmBlockStore            ( SQLiteConfig config );
     void                                affirmMessenger             ();
     bool                                checkTags                   () const;
     void                                composeChain                ( BlockTreeCursor cursor );
@@ -245,6 +267,7 @@ protected:
     void                                updateRelease               ();
     void                                updateRemoteMinerGroups     ();
     void                                updateRemoteMiners          ();
+    void                                updateSnapshotSync          ();
 
     //----------------------------------------------------------------//
     void                                AbstractMiningMessengerClient_receiveResponse   ( const MiningMessengerResponse& response, time_t now ) override;
@@ -262,11 +285,15 @@ public:
     
     GET ( BlockTreeCursor,                                  BestProvisional,            mBestBranchTag.getCursor ())
     GET ( const AbstractBlockTree&,                         BlockTree,                  *mBlockTree )
+    GET ( CraftabilityIndex&,                               CraftabilityIndex,          *mCraftabilityIndex )
     GET ( const Ledger&,                                    Ledger,                     *mLedger )
     GET ( BlockTreeCursor,                                  LedgerTag,                  mLedgerTag.getCursor ())
     GET ( const LockedLedger&,                              LockedLedger,               mLockedLedger )
     GET ( u64,                                              MinimumGratuity,            mConfig.mMinimumGratuity )
     GET ( string,                                           Reward,                     mConfig.mReward )
+    GET ( const LedgerEventFeed&,                           EventFeed,                  mEventFeed )
+    GET ( LedgerSnapshotCache&,                             SnapshotCache,              *mSnapshotCache )
+    GET ( const MinerStepProfiler&,                         StepProfiler,               mStepProfiler )
     GET ( TransactionQueue&,                                TransactionQueue,           *mTransactionQueue )
         
     GET_SET ( const CryptoPublicKey&,                       ControlKey,                 mControlKey )
@@ -282,11 +309,13 @@ public:
     void                            affirmKey                           ( uint keyLength = CryptoKeyPair::RSA_1024, unsigned long exp = CryptoKeyPair::RSA_EXP_65537 );
     void                            affirmRemoteMiner                   ( string url );
     void                            affirmVisage                        ();
+    void                            enableSnapshotSync                  ( string filename, size_t quorum = LedgerSnapshotSync::DEFAULT_QUORUM );
     Signature                       calculateVisage                     ( string motto = "" );
     static Signature                calculateVisage                     ( const CryptoKeyPair& keyPair, string motto = "" );
     size_t                          getChainSize                        () const;
     Ledger&                         getLedger                           ();
     Ledger                          getLedgerAtBlock                    ( u64 index ) const;
+    string                          getResponseEpoch                    ();
     void                            getSnapshot                         ( MinerSnapshot* snapshot = NULL, MinerStatus* status = NULL );
     bool                            isLazy                              () const;
     static shared_ptr < Block >     loadGenesisBlock                    ( string genesisFile );
@@ -306,6 +335,7 @@ public:
     void                            setConsensusLookaheadHeight         ( size_t height );
     void                            setGenesis                          ( shared_ptr < const Block > block );
     void                            setMaxBlockSearches                 ( size_t max );
+    void                            setMaxEventWaiters                  ( size_t max );
     void                            setMinimumGratuity                  ( u64 minimumGratuity );
     void                            setMute                             ( bool paused );
     void                            setPersistencePath                  ( string path, shared_ptr < const Block > genesisBlock );
@@ -12,20 +12,28 @@
 #include <volition/web-miner-api/ConsensusBlockDetailsHandler.h>
 #include <volition/web-miner-api/ConsensusBlockHeaderListHandler.h>
 #include <volition/web-miner-api/ConsensusPeekHandler.h>
+#include <volition/web-miner-api/ConsensusSnapshotChunkHandler.h>
+#include <volition/web-miner-api/ConsensusSnapshotHandler.h>
 #include <volition/web-miner-api/ControlCommandHandler.h>
 #include <volition/web-miner-api/DebugHTTPEchoHandler.h>
 #include <volition/web-miner-api/DebugKeyGenHandler.h>
 #include <volition/web-miner-api/DefaultHandler.h>
 #include <volition/web-miner-api/InventoryAssetsHandler.h>
+#include <volition/web-miner-api/InventoryDeltaHandler.h>
 #include <volition/web-miner-api/InventoryHandler.h>
 #include <volition/web-miner-api/InventoryLogHandler.h>
+#include <volition/web-miner-api/InventoryMethodHandler.h>
 #include <volition/web-miner-api/KeyAccountDetailsHandler.h>
 #include <volition/web-miner-api/KeyDetailsHandler.h>
+#include <volition/web-miner-api/MetricsHandler.h>
 #include <volition/web-miner-api/MinerListHandler.h>
 #include <volition/web-miner-api/NodeDetailsHandler.h>
+#include <volition/web-miner-api/NodeStepTimingHandler.h>
 #include <volition/web-miner-api/OfferDetailsHandler.h>
+#include <volition/web-miner-api/OfferListHandler.h>
 #include <volition/web-miner-api/ResetChainHandler.h>
 #include <volition/web-miner-api/SchemaHandler.h>
+#include <volition/web-miner-api/SubscriptionHandler.h>
 #include <volition/web-miner-api/TermsOfServiceHandler.h>
 #include <volition/web-miner-api/TestExceptions.h>
 #include <volition/web-miner-api/TestKeyIDHandler.h>
@@ -55,26 +63,34 @@ void MinerAPIFactory::initializeRoutes () {
     this->mRouteTable.addEndpoint < WebMinerAPI::AccountLogHandler >                    ( HTTP::GET,        Format::write ( "%s/accounts/:accountName/log/?", prefix ));
     this->mRouteTable.addEndpoint < WebMinerAPI::InventoryHandler >                     ( HTTP::GET,        Format::write ( "%s/accounts/:accountName/inventory/?", prefix ));
     this->mRouteTable.addEndpoint < WebMinerAPI::InventoryAssetsHandler >               ( HTTP::GET,        Format::write ( "%s/accounts/:accountName/inventory/assets/?", prefix ));
+    this->mRouteTable.addEndpoint < WebMinerAPI::InventoryDeltaHandler >                ( HTTP::GET,        Format::write ( "%s/accounts/:accountName/inventory/delta/?", prefix ));
     this->mRouteTable.addEndpoint < WebMinerAPI::InventoryLogHandler >                  ( HTTP::GET,        Format::write ( "%s/accounts/:accountName/inventory/log/:nonce/?", prefix ));
+    this->mRouteTable.addEndpoint < WebMinerAPI::InventoryMethodHandler >               ( HTTP::GET,        Format::write ( "%s/accounts/:accountName/inventory/methods/:methodName/?", prefix ));
     this->mRouteTable.addEndpoint < WebMinerAPI::AccountKeyListHandler >                ( HTTP::GET,        Format::write ( "%s/accounts/:accountName/keys/?", prefix ));
     this->mRouteTable.addEndpoint < WebMinerAPI::TransactionHandler >                   ( HTTP::GET_PUT,    Format::write ( "%s/accounts/:accountName/transactions/:uuid/?", prefix ));
     this->mRouteTable.addEndpoint < WebMinerAPI::TransactionQueueHandler >              ( HTTP::GET,        Format::write ( "%s/accounts/:accountName/transactions/?", prefix ));
     this->mRouteTable.addEndpoint < WebMinerAPI::AssetDetailsHandler >                  ( HTTP::GET,        Format::write ( "%s/assets/:assetIndexOrID/?", prefix ));
     this->mRouteTable.addEndpoint < WebMinerAPI::BlockDetailsHandler >                  ( HTTP::GET,        Format::write ( "%s/blocks/:blockID/?", prefix ));
     this->mRouteTable.addEndpoint < WebMinerAPI::BlockListHandler >                     ( HTTP::GET,        Format::write ( "%s/blocks/?", prefix ));
+    this->mRouteTable.addEndpoint < WebMinerAPI::OfferListHandler >                     ( HTTP::GET,        Format::write ( "%s/offers/?", prefix ));
     this->mRouteTable.addEndpoint < WebMinerAPI::OfferDetailsHandler >                  ( HTTP::GET,        Format::write ( "%s/offers/:assetID/?", prefix ));
     
     this->mRouteTable.addEndpoint < WebMinerAPI::ConsensusBlockDetailsHandler >         ( HTTP::GET,        Format::write ( "%s/consensus/blocks/:hash/?", prefix ));
     this->mRouteTable.addEndpoint < WebMinerAPI::ConsensusBlockHeaderListHandler >      ( HTTP::GET,        Format::write ( "%s/consensus/headers/?", prefix )); // TODO: better regex for query params
     this->mRouteTable.addEndpoint < WebMinerAPI::ConsensusPeekHandler >                 ( HTTP::GET,        Format::write ( "%s/consensus/peek/?", prefix ));
+    this->mRouteTable.addEndpoint < WebMinerAPI::ConsensusSnapshotHandler >             ( HTTP::GET,        Format::write ( "%s/consensus/snapshot/?", prefix ));
+    this->mRouteTable.addEndpoint < WebMinerAPI::ConsensusSnapshotChunkHandler >        ( HTTP::GET,        Format::write ( "%s/consensus/snapshot/:height/chunks/:chunkIndex/?", prefix ));
     
     this->mRouteTable.addEndpoint < WebMinerAPI::ControlCommandHandler >                ( HTTP::POST,       Format::write ( "%s/control/?", prefix ));
     
     this->mRouteTable.addEndpoint < WebMinerAPI::KeyAccountDetailsHandler >             ( HTTP::GET,        Format::write ( "%s/keys/:keyHash/account/?", prefix ));
     this->mRouteTable.addEndpoint < WebMinerAPI::KeyDetailsHandler >                    ( HTTP::GET,        Format::write ( "%s/keys/:keyHash/?", prefix ));
+    this->mRouteTable.addEndpoint < WebMinerAPI::MetricsHandler >                       ( HTTP::GET,        Format::write ( "%s/metrics/?", prefix ));
     this->mRouteTable.addEndpoint < WebMinerAPI::MinerListHandler >                     ( HTTP::GET,        Format::write ( "%s/miners/?", prefix ));
     this->mRouteTable.addEndpoint < WebMinerAPI::NodeDetailsHandler >                   ( HTTP::GET,        Format::write ( "%s/node/?", prefix ));
+    this->mRouteTable.addEndpoint < WebMinerAPI::NodeStepTimingHandler >                ( HTTP::GET,        Format::write ( "%s/node/steps/?", prefix ));
     this->mRouteTable.addEndpoint < WebMinerAPI::SchemaHandler >                        ( HTTP::GET,        Format::write ( "%s/schema/?", prefix ));
+    this->mRouteTable.addEndpoint < WebMinerAPI::SubscriptionHandler >                  ( HTTP::GET,        Format::write ( "%s/subscribe/?", prefix ));
 
     this->mRouteTable.addEndpoint < WebMinerAPI::VisageHandler >                        ( HTTP::GET,        Format::write ( "%s/visage/?", prefix ));
 
@@ -93,6 +109,7 @@ MinerAPIFactory::MinerAPIFactory ( shared_ptr < Miner > minerActivity ) :
     mWithPrefix ( false ) {
     
     this->mMiner = minerActivity;
+    this->mResponseCache = make_shared < MinerAPIResponseCache >();
     this->initializeRoutes ();
 }
 
@@ -103,6 +120,7 @@ MinerAPIFactory::MinerAPIFactory ( const vector < shared_ptr < Miner >>& webMine
     for ( size_t i = 0; i < webMiners.size (); ++i ) {
         shared_ptr < Miner > miner = webMiners [ i ];
         this->mMiners [ miner->getMinerID ()] = miner;
+        this->mResponseCaches [ miner->getMinerID ()] = make_shared < MinerAPIResponseCache >();
     }
     this->initializeRoutes ();
 }
@@ -111,6 +129,19 @@ MinerAPIFactory::MinerAPIFactory ( const vector < shared_ptr < Miner >>& webMine
 MinerAPIFactory::~MinerAPIFactory () {
 }
 
+//----------------------------------------------------------------//
+void MinerAPIFactory::setResponseCacheSize ( size_t maxBytes ) {
+
+    if ( this->mResponseCache ) {
+        this->mResponseCache->setMaxBytes ( maxBytes );
+    }
+    
+    map < string, shared_ptr < MinerAPIResponseCache >>::iterator cacheIt = this->mResponseCaches.begin ();
+    for ( ; cacheIt != this->mResponseCaches.end (); ++cacheIt ) {
+        cacheIt->second->setMaxBytes ( maxBytes );
+    }
+}
+
 //================================================================//
 // overrides
 //================================================================//
@@ -124,11 +155,11 @@ Poco::Net::HTTPRequestHandler* MinerAPIFactory::createRequestHandler ( const Poc
         string minerID = handler->getMatchString ( "minerID" );
         map < string, shared_ptr < Miner >>::iterator webMinerIt = this->mMiners.find ( minerID );
         if ( webMinerIt != this->mMiners.end ()) {
-            handler->initialize ( webMinerIt->second );
+            handler->initialize ( webMinerIt->second, this->mResponseCaches [ minerID ]);
         }
     }
     else {
-        handler->initialize ( this->mMiner );
+        handler->initialize ( this->mMiner, this->mResponseCache );
     }
     
     return handler.release ();
@@ -5,6 +5,7 @@
 #define VOLITION_MINERAPIFACTORY_H
 
 #include <volition/AbstractMinerAPIRequestHandler.h>
+#include <volition/MinerAPIResponseCache.h>
 #include <volition/RouteTable.h>
 #include <volition/Miner.h>
 
@@ -17,10 +18,14 @@ class MinerAPIFactory :
     public Poco::Net::HTTPRequestHandlerFactory {
 private:
 
-    RouteTable < AbstractMinerAPIRequestHandler >       mRouteTable;
-    shared_ptr < Miner >                                mMiner;
-    map < string, shared_ptr < Miner >>                 mMiners;
-    bool                                                mWithPrefix;
+    RouteTable < AbstractMinerAPIRequestHandler >                   mRouteTable;
+    shared_ptr < Miner >                                            mMiner;
+    map < string, shared_ptr < Miner >>                             mMiners;
+    bool                                                            mWithPrefix;
+    
+    // one response cache per miner; each is flushed by its own miner's response epoch.
+    shared_ptr < MinerAPIResponseCache >                            mResponseCache;
+    map < string, shared_ptr < MinerAPIResponseCache >>             mResponseCaches;
 
     //----------------------------------------------------------------//
     Poco::Net::HTTPRequestHandler*      createRequestHandler        ( const Poco::Net::HTTPServerRequest& request ) override;
@@ -32,6 +37,7 @@ public:
                     MinerAPIFactory          ( shared_ptr < Miner > minerActivity );
                     MinerAPIFactory          ( const vector < shared_ptr < Miner >>& webMiners );
                     ~MinerAPIFactory         ();
+    void            setResponseCacheSize     ( size_t maxBytes );
 };
 
 } // namespace Volition
@@ -0,0 +1,154 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <volition/MinerAPIResponseCache.h>
+#include <volition/Metrics.h>
+
+namespace Volition {
+
+//================================================================//
+// MinerAPIResponseCache
+//================================================================//
+
+//----------------------------------------------------------------//
+void MinerAPIResponseCache::affirmEpoch ( string epoch ) {
+
+    if ( this->mEpoch != epoch ) {
+        this->clearInternal ();
+        this->mEpoch = epoch;
+    }
+}
+
+//----------------------------------------------------------------//
+void MinerAPIResponseCache::clear () {
+
+    lock_guard < mutex > lock ( this->mMutex );
+    this->clearInternal ();
+}
+
+//----------------------------------------------------------------//
+void MinerAPIResponseCache::clearInternal () {
+
+    this->mEntries.clear ();
+    this->mEntriesByKey.clear ();
+    this->mTotalBytes = 0;
+}
+
+//----------------------------------------------------------------//
+size_t MinerAPIResponseCache::countBytes () const {
+
+    lock_guard < mutex > lock ( this->mMutex );
+    return this->mTotalBytes;
+}
+
+//----------------------------------------------------------------//
+size_t MinerAPIResponseCache::countEntries () const {
+
+    lock_guard < mutex > lock ( this->mMutex );
+    return this->mEntries.size ();
+}
+
+//----------------------------------------------------------------//
+u64 MinerAPIResponseCache::countHits () const {
+
+    lock_guard < mutex > lock ( this->mMutex );
+    return this->mHits;
+}
+
+//----------------------------------------------------------------//
+u64 MinerAPIResponseCache::countMisses () const {
+
+    lock_guard < mutex > lock ( this->mMutex );
+    return this->mMisses;
+}
+
+//----------------------------------------------------------------//
+void MinerAPIResponseCache::evict ( size_t maxBytes ) {
+
+    while ( this->mEntries.size () && ( this->mTotalBytes > maxBytes )) {
+    
+        const Entry& entry = this->mEntries.back ();
+        this->mTotalBytes -= entry.getSize ();
+        this->mEntriesByKey.erase ( entry.mKey );
+        this->mEntries.pop_back ();
+    }
+}
+
+//----------------------------------------------------------------//
+bool MinerAPIResponseCache::get ( string epoch, string key, int& status, string& body ) {
+
+    lock_guard < mutex > lock ( this->mMutex );
+    
+    this->affirmEpoch ( epoch );
+    
+    EntriesByKey::iterator entryIt = this->mEntriesByKey.find ( key );
+    if ( entryIt == this->mEntriesByKey.end ()) {
+        this->mMisses++;
+        VOL_METRIC_COUNT_LABELED ( "volition_cache_lookups_total", "Cache lookups, by cache and result.", "cache=\"apiResponse\",result=\"miss\"", 1 );
+        return false;
+    }
+    
+    // move to front
+    this->mEntries.splice ( this->mEntries.begin (), this->mEntries, entryIt->second );
+    
+    const Entry& entry = *entryIt->second;
+    status  = entry.mStatus;
+    body    = entry.mBody;
+    
+    this->mHits++;
+    VOL_METRIC_COUNT_LABELED ( "volition_cache_lookups_total", "Cache lookups, by cache and result.", "cache=\"apiResponse\",result=\"hit\"", 1 );
+    return true;
+}
+
+//----------------------------------------------------------------//
+MinerAPIResponseCache::MinerAPIResponseCache ( size_t maxBytes ) :
+    mMaxBytes ( maxBytes ),
+    mTotalBytes ( 0 ),
+    mHits ( 0 ),
+    mMisses ( 0 ) {
+}
+
+//----------------------------------------------------------------//
+MinerAPIResponseCache::~MinerAPIResponseCache () {
+}
+
+//----------------------------------------------------------------//
+void MinerAPIResponseCache::set ( string epoch, string key, int status, const string& body ) {
+
+    lock_guard < mutex > lock ( this->mMutex );
+    
+    // if the epoch moved on while the response was being computed, the response
+    // may be stale. drop it rather than poisoning the new epoch.
+    if ( this->mEpoch != epoch ) return;
+    
+    Entry entry;
+    entry.mKey      = key;
+    entry.mStatus   = status;
+    entry.mBody     = body;
+    
+    size_t size = entry.getSize ();
+    if ( size > this->mMaxBytes ) return;
+    
+    EntriesByKey::iterator entryIt = this->mEntriesByKey.find ( key );
+    if ( entryIt != this->mEntriesByKey.end ()) {
+        this->mTotalBytes -= entryIt->second->getSize ();
+        this->mEntries.erase ( entryIt->second );
+        this->mEntriesByKey.erase ( entryIt );
+    }
+    
+    this->evict ( this->mMaxBytes - size );
+    
+    this->mEntries.push_front ( entry );
+    this->mEntriesByKey [ key ] = this->mEntries.begin ();
+    this->mTotalBytes += size;
+}
+
+//----------------------------------------------------------------//
+void MinerAPIResponseCache::setMaxBytes ( size_t maxBytes ) {
+
+    lock_guard < mutex > lock ( this->mMutex );
+    this->mMaxBytes = maxBytes;
+    this->evict ( maxBytes );
+}
+
+} // namespace Volition
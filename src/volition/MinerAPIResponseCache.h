@@ -0,0 +1,81 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_MINERAPIRESPONSECACHE_H
+#define VOLITION_MINERAPIRESPONSECACHE_H
+
+#include <volition/common.h>
+#include <unordered_map>
+
+namespace Volition {
+
+//================================================================//
+// MinerAPIResponseCache
+//================================================================//
+// Byte-bounded LRU cache of serialized API responses. Every entry belongs to
+// an "epoch" published by the miner (see Miner::getResponseEpoch ()); as soon
+// as a request arrives with a different epoch, the whole cache is flushed. The
+// epoch changes whenever the locked ledger advances or reorgs, so a cached
+// response can never outlive the ledger state it was computed from.
+class MinerAPIResponseCache {
+public:
+
+    static const size_t DEFAULT_MAX_BYTES       = 64 * 1024 * 1024;
+
+private:
+
+    // rough per-entry bookkeeping overhead (list node, map node, strings).
+    static const size_t ENTRY_OVERHEAD          = 128;
+
+    //----------------------------------------------------------------//
+    class Entry {
+    public:
+
+        string      mKey;
+        int         mStatus;
+        string      mBody;
+
+        //----------------------------------------------------------------//
+        size_t getSize () const {
+            return this->mKey.size () + this->mBody.size () + ENTRY_OVERHEAD;
+        }
+    };
+
+    typedef list < Entry >                                      Entries;
+    typedef unordered_map < string, Entries::iterator >         EntriesByKey;
+
+    mutable mutex       mMutex;
+
+    size_t              mMaxBytes;
+    size_t              mTotalBytes;
+    string              mEpoch;
+
+    // most recently used entries live at the front.
+    Entries             mEntries;
+    EntriesByKey        mEntriesByKey;
+
+    u64                 mHits;
+    u64                 mMisses;
+
+    //----------------------------------------------------------------//
+    void                affirmEpoch                 ( string epoch );
+    void                clearInternal               ();
+    void                evict                       ( size_t maxBytes );
+
+public:
+
+    //----------------------------------------------------------------//
+    void                clear                       ();
+    size_t              countBytes                  () const;
+    size_t              countEntries                () const;
+    u64                 countHits                   () const;
+    u64                 countMisses                 () const;
+    bool                get                         ( string epoch, string key, int& status, string& body );
+                        MinerAPIResponseCache       ( size_t maxBytes = DEFAULT_MAX_BYTES );
+                        ~MinerAPIResponseCache      ();
+    void                set                         ( string epoch, string key, int status, const string& body );
+    void                setMaxBytes                 ( size_t maxBytes );
+};
+
+} // namespace Volition
+#endif
@@ -0,0 +1,211 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <volition/MinerStepProfiler.h>
+
+namespace Volition {
+
+//================================================================//
+// MinerStepProfiler::Step
+//================================================================//
+
+//----------------------------------------------------------------//
+void MinerStepProfiler::Step::begin ( Phase phase ) {
+
+    Clock::time_point t1 = Clock::now ();
+    this->closePhase ( t1 );
+    this->mPhase = phase;
+    this->mPhaseT0 = t1;
+}
+
+//----------------------------------------------------------------//
+void MinerStepProfiler::Step::closePhase ( Clock::time_point t1 ) {
+
+    if ( this->mPhase >= TOTAL_PHASES ) return;
+
+    chrono::duration < double, milli > span = t1 - this->mPhaseT0;
+    this->mRecord.mPhaseMillis [ this->mPhase ] += span.count ();
+    this->mPhase = TOTAL_PHASES;
+}
+
+//----------------------------------------------------------------//
+MinerStepProfiler::Step::Step ( MinerStepProfiler& profiler, time_t now ) :
+    mProfiler ( profiler ),
+    mPhase ( TOTAL_PHASES ),
+    mStepT0 ( Clock::now ()) {
+
+    this->mRecord.mStep = 0;
+    this->mRecord.mTime = now;
+    this->mRecord.mTotalMillis = 0.0;
+    for ( size_t i = 0; i < TOTAL_PHASES; ++i ) {
+        this->mRecord.mPhaseMillis [ i ] = 0.0;
+    }
+}
+
+//----------------------------------------------------------------//
+MinerStepProfiler::Step::~Step () {
+
+    Clock::time_point t1 = Clock::now ();
+    this->closePhase ( t1 );
+
+    chrono::duration < double, milli > span = t1 - this->mStepT0;
+    this->mRecord.mTotalMillis = span.count ();
+
+    this->mProfiler.record ( this->mRecord );
+}
+
+//================================================================//
+// MinerStepProfiler
+//================================================================//
+
+//----------------------------------------------------------------//
+vector < double > MinerStepProfiler::getHistogramBounds () {
+
+    return { 1.0, 5.0, 10.0, 25.0, 50.0, 100.0, 250.0, 500.0, 1000.0, 5000.0 };
+}
+
+//----------------------------------------------------------------//
+const char* MinerStepProfiler::getPhaseName ( size_t phase ) {
+
+    switch ( phase ) {
+        case PHASE_RECEIVE_RESPONSES:               return "receiveResponses";
+        case PHASE_UPDATE_REMOTE_MINER_GROUPS:      return "updateRemoteMinerGroups";
+        case PHASE_UPDATE_REMOTE_MINERS:            return "updateRemoteMiners";
+        case PHASE_UPDATE_SNAPSHOT_SYNC:            return "updateSnapshotSync";
+        case PHASE_UPDATE_BLOCK_SEARCHES:           return "updateBlockSearches";
+        case PHASE_UPDATE_NETWORK_SEARCHES:         return "updateNetworkSearches";
+        case PHASE_UPDATE_BEST_BRANCH:              return "updateBestBranch";
+        case PHASE_SAVE_CHAIN:                      return "saveChain";
+        case PHASE_UPDATE_RELEASE:                  return "updateRelease";
+        case PHASE_UPDATE_MINER_STATUS:             return "updateMinerStatus";
+        case PHASE_SEND_REQUESTS:                   return "sendRequests";
+        default:
+            break;
+    }
+    return "";
+}
+
+//----------------------------------------------------------------//
+void MinerStepProfiler::getReport ( MinerStepReport& report ) const {
+
+    vector < StepRecord > window;
+    {
+        lock_guard < mutex > lock ( this->mMutex );
+        window = this->mWindow;
+        report.mTotalSteps = this->mTotalSteps;
+    }
+
+    report.mWindowSize = window.size ();
+    report.mHistogramBounds = MinerStepProfiler::getHistogramBounds ();
+
+    vector < double > samples;
+    samples.reserve ( window.size ());
+
+    double totalMillis = 0.0;
+    for ( size_t i = 0; i < window.size (); ++i ) {
+        samples.push_back ( window [ i ].mTotalMillis );
+        totalMillis += window [ i ].mTotalMillis;
+    }
+    MinerStepProfiler::summarize ( report.mStep, samples, totalMillis );
+
+    for ( size_t phase = 0; phase < TOTAL_PHASES; ++phase ) {
+
+        samples.clear ();
+        for ( size_t i = 0; i < window.size (); ++i ) {
+            samples.push_back ( window [ i ].mPhaseMillis [ phase ]);
+        }
+        MinerStepProfiler::summarize ( report.mPhases [ MinerStepProfiler::getPhaseName ( phase )], samples, totalMillis );
+    }
+
+    // slowest first; ties go to the most recent step.
+    size_t totalSlowest = window.size () < TOTAL_SLOWEST ? window.size () : TOTAL_SLOWEST;
+    partial_sort ( window.begin (), window.begin () + ( long )totalSlowest, window.end (), []( const StepRecord& a, const StepRecord& b ) {
+        if ( a.mTotalMillis != b.mTotalMillis ) return a.mTotalMillis > b.mTotalMillis;
+        return a.mStep > b.mStep;
+    });
+
+    for ( size_t i = 0; i < totalSlowest; ++i ) {
+
+        const StepRecord& record = window [ i ];
+
+        MinerStepSample sample;
+        sample.mStep            = record.mStep;
+        sample.mTime            = record.mTime;
+        sample.mTotalMillis     = record.mTotalMillis;
+
+        for ( size_t phase = 0; phase < TOTAL_PHASES; ++phase ) {
+            sample.mPhaseMillis [ MinerStepProfiler::getPhaseName ( phase )] = record.mPhaseMillis [ phase ];
+        }
+        report.mSlowest.push_back ( sample );
+    }
+}
+
+//----------------------------------------------------------------//
+MinerStepProfiler::MinerStepProfiler () :
+    mNext ( 0 ),
+    mTotalSteps ( 0 ) {
+
+    this->mWindow.reserve ( WINDOW_SIZE );
+
+    #ifndef VOLITION_DISABLE_METRICS
+        TheMetricsRegistry& registry = TheMetricsRegistry::get ();
+        this->mStepHistogram = &registry.getHistogram ( "volition_step_seconds", "Wall time of one miner step." );
+        for ( size_t phase = 0; phase < TOTAL_PHASES; ++phase ) {
+            string labels = Format::write ( "phase=\"%s\"", MinerStepProfiler::getPhaseName ( phase ));
+            this->mPhaseHistograms [ phase ] = &registry.getHistogram ( "volition_step_phase_seconds", "Wall time of each miner step phase.", labels );
+        }
+    #endif
+}
+
+//----------------------------------------------------------------//
+MinerStepProfiler::~MinerStepProfiler () {
+}
+
+//----------------------------------------------------------------//
+void MinerStepProfiler::record ( StepRecord& record ) {
+
+    #ifndef VOLITION_DISABLE_METRICS
+        this->mStepHistogram->observe ( record.mTotalMillis / 1000.0 );
+        for ( size_t phase = 0; phase < TOTAL_PHASES; ++phase ) {
+            this->mPhaseHistograms [ phase ]->observe ( record.mPhaseMillis [ phase ] / 1000.0 );
+        }
+    #endif
+
+    lock_guard < mutex > lock ( this->mMutex );
+
+    record.mStep = this->mTotalSteps++;
+
+    if ( this->mWindow.size () < WINDOW_SIZE ) {
+        this->mWindow.push_back ( record );
+    }
+    else {
+        this->mWindow [ this->mNext ] = record;
+    }
+    this->mNext = ( this->mNext + 1 ) % WINDOW_SIZE;
+}
+
+//----------------------------------------------------------------//
+void MinerStepProfiler::summarize ( MinerStepPhaseSummary& summary, vector < double >& samples, double total ) {
+
+    vector < double > bounds = MinerStepProfiler::getHistogramBounds ();
+    summary.mHistogram.assign ( bounds.size () + 1, 0 );
+
+    if ( samples.size () == 0 ) return;
+
+    double sum = 0.0;
+    for ( size_t i = 0; i < samples.size (); ++i ) {
+        sum += samples [ i ];
+        summary.mHistogram [( size_t )( lower_bound ( bounds.cbegin (), bounds.cend (), samples [ i ]) - bounds.cbegin ())]++;
+    }
+
+    sort ( samples.begin (), samples.end ());
+
+    size_t last = samples.size () - 1;
+    summary.mMeanMillis     = sum / ( double )samples.size ();
+    summary.mP50Millis      = samples [( size_t )(( double )last * 0.50 + 0.5 )];
+    summary.mP95Millis      = samples [( size_t )(( double )last * 0.95 + 0.5 )];
+    summary.mMaxMillis      = samples [ last ];
+    summary.mShare          = total > 0.0 ? sum / total : 0.0;
+}
+
+} // namespace Volition
@@ -0,0 +1,232 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_MINERSTEPPROFILER_H
+#define VOLITION_MINERSTEPPROFILER_H
+
+#include <volition/common.h>
+#include <volition/Metrics.h>
+#include <volition/serialization/Serialization.h>
+
+namespace Volition {
+
+//================================================================//
+// MinerStepPhaseSummary
+//================================================================//
+class MinerStepPhaseSummary :
+    public AbstractSerializable {
+public:
+
+    double                              mMeanMillis;
+    double                              mP50Millis;
+    double                              mP95Millis;
+    double                              mMaxMillis;
+    double                              mShare;         // fraction of total step time spent in this phase
+    SerializableVector < u64 >          mHistogram;     // counts per MinerStepProfiler::getHistogramBounds () bucket, then overflow
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeFrom ( const AbstractSerializerFrom& serializer ) override {
+
+        serializer.serialize ( "meanMillis",        this->mMeanMillis );
+        serializer.serialize ( "p50Millis",         this->mP50Millis );
+        serializer.serialize ( "p95Millis",         this->mP95Millis );
+        serializer.serialize ( "maxMillis",         this->mMaxMillis );
+        serializer.serialize ( "share",             this->mShare );
+        serializer.serialize ( "histogram",         this->mHistogram );
+    }
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeTo ( AbstractSerializerTo& serializer ) const override {
+
+        serializer.serialize ( "meanMillis",        this->mMeanMillis );
+        serializer.serialize ( "p50Millis",         this->mP50Millis );
+        serializer.serialize ( "p95Millis",         this->mP95Millis );
+        serializer.serialize ( "maxMillis",         this->mMaxMillis );
+        serializer.serialize ( "share",             this->mShare );
+        serializer.serialize ( "histogram",         this->mHistogram );
+    }
+
+    //----------------------------------------------------------------//
+    MinerStepPhaseSummary () :
+        mMeanMillis ( 0.0 ),
+        mP50Millis ( 0.0 ),
+        mP95Millis ( 0.0 ),
+        mMaxMillis ( 0.0 ),
+        mShare ( 0.0 ) {
+    }
+};
+
+//================================================================//
+// MinerStepSample
+//================================================================//
+class MinerStepSample :
+    public AbstractSerializable {
+public:
+
+    u64                                         mStep;
+    SerializableTime                            mTime;
+    double                                      mTotalMillis;
+    SerializableMap < string, double >          mPhaseMillis;
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeFrom ( const AbstractSerializerFrom& serializer ) override {
+
+        serializer.serialize ( "step",              this->mStep );
+        serializer.serialize ( "time",              this->mTime );
+        serializer.serialize ( "totalMillis",       this->mTotalMillis );
+        serializer.serialize ( "phases",            this->mPhaseMillis );
+    }
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeTo ( AbstractSerializerTo& serializer ) const override {
+
+        serializer.serialize ( "step",              this->mStep );
+        serializer.serialize ( "time",              this->mTime );
+        serializer.serialize ( "totalMillis",       this->mTotalMillis );
+        serializer.serialize ( "phases",            this->mPhaseMillis );
+    }
+
+    //----------------------------------------------------------------//
+    MinerStepSample () :
+        mStep ( 0 ),
+        mTotalMillis ( 0.0 ) {
+    }
+};
+
+//================================================================//
+// MinerStepReport
+//================================================================//
+class MinerStepReport :
+    public AbstractSerializable {
+public:
+
+    u64                                                 mTotalSteps;
+    u64                                                 mWindowSize;
+    SerializableVector < double >                       mHistogramBounds;
+    MinerStepPhaseSummary                               mStep;
+    SerializableMap < string, MinerStepPhaseSummary >   mPhases;
+    SerializableVector < MinerStepSample >              mSlowest;
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeFrom ( const AbstractSerializerFrom& serializer ) override {
+
+        serializer.serialize ( "totalSteps",        this->mTotalSteps );
+        serializer.serialize ( "windowSize",        this->mWindowSize );
+        serializer.serialize ( "histogramBounds",   this->mHistogramBounds );
+        serializer.serialize ( "step",              this->mStep );
+        serializer.serialize ( "phases",            this->mPhases );
+        serializer.serialize ( "slowest",           this->mSlowest );
+    }
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeTo ( AbstractSerializerTo& serializer ) const override {
+
+        serializer.serialize ( "totalSteps",        this->mTotalSteps );
+        serializer.serialize ( "windowSize",        this->mWindowSize );
+        serializer.serialize ( "histogramBounds",   this->mHistogramBounds );
+        serializer.serialize ( "step",              this->mStep );
+        serializer.serialize ( "phases",            this->mPhases );
+        serializer.serialize ( "slowest",           this->mSlowest );
+    }
+
+    //----------------------------------------------------------------//
+    MinerStepReport () :
+        mTotalSteps ( 0 ),
+        mWindowSize ( 0 ) {
+    }
+};
+
+//================================================================//
+// MinerStepProfiler
+//================================================================//
+// Times each phase of Miner::step. Keeps the last WINDOW_SIZE steps (with
+// their full phase breakdown) in a ring, from which the report derives rolling
+// percentiles, bucket counts and the slowest recent steps. Each completed step
+// also feeds the volition_step_* Prometheus histograms.
+class MinerStepProfiler {
+public:
+
+    enum Phase : size_t {
+        PHASE_RECEIVE_RESPONSES,
+        PHASE_UPDATE_REMOTE_MINER_GROUPS,
+        PHASE_UPDATE_REMOTE_MINERS,
+        PHASE_UPDATE_SNAPSHOT_SYNC,
+        PHASE_UPDATE_BLOCK_SEARCHES,
+        PHASE_UPDATE_NETWORK_SEARCHES,
+        PHASE_UPDATE_BEST_BRANCH,
+        PHASE_SAVE_CHAIN,
+        PHASE_UPDATE_RELEASE,
+        PHASE_UPDATE_MINER_STATUS,
+        PHASE_SEND_REQUESTS,
+        TOTAL_PHASES,
+    };
+
+    static const size_t WINDOW_SIZE     = 256;
+    static const size_t TOTAL_SLOWEST   = 8;
+
+    typedef chrono::steady_clock Clock;
+
+private:
+
+    //----------------------------------------------------------------//
+    class StepRecord {
+    public:
+
+        u64         mStep;
+        time_t      mTime;
+        double      mTotalMillis;
+        double      mPhaseMillis [ TOTAL_PHASES ];
+    };
+
+    mutable mutex               mMutex;
+    vector < StepRecord >       mWindow;
+    size_t                      mNext;
+    u64                         mTotalSteps;
+
+    #ifndef VOLITION_DISABLE_METRICS
+        MetricHistogram*        mStepHistogram;
+        MetricHistogram*        mPhaseHistograms [ TOTAL_PHASES ];
+    #endif
+
+    //----------------------------------------------------------------//
+    void                        record                  ( StepRecord& record );
+    static void                 summarize               ( MinerStepPhaseSummary& summary, vector < double >& samples, double total );
+
+public:
+
+    //================================================================//
+    // Step
+    //================================================================//
+    // Scoped timer for one step. Each call to begin () closes the phase
+    // before it; the last phase closes (and the step is recorded) when the
+    // Step goes out of scope.
+    class Step {
+    private:
+
+        MinerStepProfiler&      mProfiler;
+        StepRecord              mRecord;
+        size_t                  mPhase;
+        Clock::time_point       mStepT0;
+        Clock::time_point       mPhaseT0;
+
+        //----------------------------------------------------------------//
+        void                    closePhase              ( Clock::time_point t1 );
+
+    public:
+
+        //----------------------------------------------------------------//
+        void                    begin                   ( Phase phase );
+                                Step                    ( MinerStepProfiler& profiler, time_t now );
+                                ~Step                   ();
+    };
+
+    //----------------------------------------------------------------//
+    static vector < double >    getHistogramBounds      ();
+    static const char*          getPhaseName            ( size_t phase );
+    void                        getReport               ( MinerStepReport& report ) const;
+                                MinerStepProfiler       ();
+                                ~MinerStepProfiler      ();
+};
+
+} // namespace Volition
+#endif
@@ -22,6 +22,11 @@ private:
         return LedgerKey ([ = ]() { return Format::write ( "offer.%d.assetIdentifiers", index ); });
     }
 
+    //----------------------------------------------------------------//
+    static LedgerKey keyFor_assetTypes ( OfferID::Index index ) {
+        return LedgerKey ([ = ]() { return Format::write ( "offer.%d.assetTypes", index ); });
+    }
+
     //----------------------------------------------------------------//
     static LedgerKey keyFor_buyer ( OfferID::Index index ) {
         return LedgerKey ([ = ]() { return Format::write ( "offer.%d.buyer", index ); });
@@ -42,6 +47,11 @@ private:
         return LedgerKey ([ = ]() { return Format::write ( "offer.%d.seller", index ); });
     }
 
+    //----------------------------------------------------------------//
+    static LedgerKey keyFor_typePosition ( OfferID::Index index, string assetType ) {
+        return LedgerKey ([ = ]() { return Format::write ( "offer.%d.typePosition.%s", index, assetType.c_str ()); });
+    }
+
 public:
 
     //----------------------------------------------------------------//
@@ -59,6 +69,21 @@ public:
         return LedgerKey ([ = ]() { return Format::write ( "offer.openList.%d", index ); });
     }
     
+    //----------------------------------------------------------------//
+    static LedgerKey keyFor_openOfferByTypeBuilt () {
+        return Format::write ( "offer.openByType.built" );
+    }
+    
+    //----------------------------------------------------------------//
+    static LedgerKey keyFor_openOfferByTypeCount ( string assetType ) {
+        return LedgerKey ([ = ]() { return Format::write ( "offer.openByType.%s.count", assetType.c_str ()); });
+    }
+    
+    //----------------------------------------------------------------//
+    static LedgerKey keyFor_openOfferByTypeElement ( string assetType, u64 index ) {
+        return LedgerKey ([ = ]() { return Format::write ( "offer.openByType.%s.%llu", assetType.c_str (), ( unsigned long long )index ); });
+    }
+    
     ConstOpt < AbstractLedger >             mLedger;
     OfferID                                 mOfferID;
     LedgerFieldODBM < AccountID::Index >    mSeller;
@@ -67,12 +92,18 @@ public:
     LedgerFieldODBM < string >              mExpiration;
 
     LedgerObjectFieldODBM < SerializableVector < AssetID::Index >> mAssetIdentifiers;
+    LedgerObjectFieldODBM < SerializableSet < string >> mAssetTypes; // types this offer is indexed under while open
 
     //----------------------------------------------------------------//
     operator bool () {
         return this->mSeller.exists ();
     }
 
+    //----------------------------------------------------------------//
+    LedgerFieldODBM < u64 > getTypePositionField ( string assetType ) {
+        return LedgerFieldODBM < u64 >( this->mLedger, keyFor_typePosition ( this->mOfferID, assetType ), 0 );
+    }
+
     //----------------------------------------------------------------//
     OfferODBM ( ConstOpt < AbstractLedger > ledger, OfferID::Index index ) :
         mLedger ( ledger ),
@@ -81,7 +112,8 @@ public:
         mBuyer ( ledger,                keyFor_buyer ( this->mOfferID ),                OfferID::NULL_INDEX ),
         mMinimumPrice ( ledger,         keyFor_minimumPrice ( this->mOfferID ),         0 ),
         mExpiration ( ledger,           keyFor_expiration ( this->mOfferID ),           "" ),
-        mAssetIdentifiers ( ledger,     keyFor_assetIdentifiers ( this->mOfferID )) {
+        mAssetIdentifiers ( ledger,     keyFor_assetIdentifiers ( this->mOfferID )),
+        mAssetTypes ( ledger,           keyFor_assetTypes ( this->mOfferID )) {
     }
 };
 
@@ -17,6 +17,8 @@ class PathEntitlement :
     public AbstractEntitlement {
 protected:
 
+    friend class CompiledEntitlements;
+
     typedef SerializableMap < string, SerializableSharedPtr < AbstractEntitlement, EntitlementFactory >> Children;
 
     Children    mChildren;
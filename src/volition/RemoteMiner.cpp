@@ -15,6 +15,45 @@ namespace Volition {
 // RemoteMiner
 //================================================================//
 
+//----------------------------------------------------------------//
+void RemoteMiner::beginBlockRequest () {
+
+    this->mBlocksInFlight++;
+}
+
+//----------------------------------------------------------------//
+bool RemoteMiner::canFetchBlock () const {
+
+    return ( this->isOnline () && ( this->mBlocksInFlight < this->mBlockWindow ));
+}
+
+//----------------------------------------------------------------//
+void RemoteMiner::endBlockRequest ( double latency ) {
+
+    if ( this->mBlocksInFlight > 0 ) {
+        this->mBlocksInFlight--;
+    }
+
+    // a negative latency means the request was abandoned (timed out); nothing to measure.
+    if ( latency < 0.0 ) return;
+    
+    this->mBlockLatency = ( this->mBlockLatency > 0.0 ) ? (( this->mBlockLatency * 0.75 ) + ( latency * 0.25 )) : latency;
+    
+    if (( this->mBlockLatency < TARGET_BLOCK_LATENCY ) && ( this->mBlockWindow < MAX_BLOCK_WINDOW )) {
+        this->mBlockWindow++;
+    }
+    else if (( this->mBlockLatency > ( TARGET_BLOCK_LATENCY * 2.0 )) && ( this->mBlockWindow > 1 )) {
+        this->mBlockWindow--;
+    }
+}
+
+//----------------------------------------------------------------//
+double RemoteMiner::getBlockTimeout () const {
+
+    double timeout = this->mBlockLatency * 4.0;
+    return timeout < MIN_BLOCK_TIMEOUT ? MIN_BLOCK_TIMEOUT : timeout;
+}
+
 //----------------------------------------------------------------//
 bool RemoteMiner::isContributor () const {
 
@@ -141,7 +180,10 @@ RemoteMiner::RemoteMiner ( Miner& miner ) :
     mAcceptedRelease ( 0 ),
     mRewind ( 0 ),
     mHeight ( 0 ),
-    mNextRelease ( 0 ) {
+    mNextRelease ( 0 ),
+    mBlocksInFlight ( 0 ),
+    mBlockWindow ( INITIAL_BLOCK_WINDOW ),
+    mBlockLatency ( 0.0 ) {
 }
 
 //----------------------------------------------------------------//
@@ -227,6 +269,12 @@ void RemoteMiner::setMinerID ( string minerID ) {
     this->mTag.setTree ( this->mMiner.mBlockTree.get ());
 }
 
+//----------------------------------------------------------------//
+void RemoteMiner::timeoutBlockRequest () {
+
+    this->mBlockWindow = ( this->mBlockWindow > 1 ) ? ( this->mBlockWindow / 2 ) : 1;
+}
+
 //----------------------------------------------------------------//
 void RemoteMiner::update ( u64 acceptedRelease, u64 heightLimit ) {
     
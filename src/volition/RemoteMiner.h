@@ -41,6 +41,14 @@ public:
         STATE_ERROR,                // unrecoverable error
     };
 
+    // block requests are windowed per miner: the window grows while the miner answers
+    // faster than TARGET_BLOCK_LATENCY, shrinks while it answers slower, and is halved
+    // whenever a request times out (and is handed to another miner).
+    static const size_t         INITIAL_BLOCK_WINDOW    = 4;
+    static const size_t         MAX_BLOCK_WINDOW        = 32;
+    static constexpr double     TARGET_BLOCK_LATENCY    = 1.0;  // seconds
+    static constexpr double     MIN_BLOCK_TIMEOUT       = 3.0;  // seconds
+
     string                      mURL;
     BlockTreeTag                mTag;
     MinerState                  mState;
@@ -49,13 +57,21 @@ public:
     size_t                      mHeight;
     u64                         mAcceptedRelease;
     u64                         mNextRelease;
+    
+    size_t                      mBlocksInFlight;
+    size_t                      mBlockWindow;
+    double                      mBlockLatency;              // moving average, in seconds; zero until measured
 
     GET ( string,       MinerID,        mMinerID )
     GET ( string,       URL,            mURL )
 
     //----------------------------------------------------------------//
+    void            beginBlockRequest       ();
+    bool            canFetchBlock           () const;
     bool            canFetchInfo            () const;
     bool            canFetchHeaders         () const;
+    void            endBlockRequest         ( double latency );
+    double          getBlockTimeout         () const;
     bool            isContributor           () const;
     bool            isOnline                () const;
     bool            receiveResponse         ( const MiningMessengerResponse& response, time_t now, u64 acceptedRelease );
@@ -65,6 +81,7 @@ public:
     void            reset                   ();
     void            setError                ();
     void            setMinerID              ( string minerID );
+    void            timeoutBlockRequest     ();
     void            update                  ( u64 acceptedRelease, u64 heightLimit );
 };
 
@@ -0,0 +1,170 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <volition/SQLiteBlockStore.h>
+#include <Poco/Base64Decoder.h>
+#include <Poco/Base64Encoder.h>
+#include <Poco/DeflatingStream.h>
+#include <Poco/InflatingStream.h>
+
+#define SQL_STR(...) #__VA_ARGS__
+
+namespace Volition {
+
+//================================================================//
+// SQLiteBlockStore
+//================================================================//
+
+//----------------------------------------------------------------//
+string SQLiteBlockStore::decode ( string encoding, const string& data ) {
+
+    if ( encoding != ENCODING_ZLIB ) return data;
+
+    istringstream inStream ( data );
+    Poco::Base64Decoder base64 ( inStream );
+    Poco::InflatingInputStream inflater ( base64, Poco::InflatingStreamBuf::STREAM_ZLIB );
+    return string ( istreambuf_iterator < char >( inflater ), istreambuf_iterator < char >());
+}
+
+//----------------------------------------------------------------//
+string SQLiteBlockStore::encode ( string encoding, const string& json ) {
+
+    if ( encoding != ENCODING_ZLIB ) return json;
+
+    ostringstream outStream;
+    Poco::Base64Encoder base64 ( outStream );
+    Poco::DeflatingOutputStream deflater ( base64, Poco::DeflatingStreamBuf::STREAM_ZLIB );
+    deflater << json;
+    deflater.close ();
+    base64.close ();
+    return outStream.str ();
+}
+
+//----------------------------------------------------------------//
+SQLiteBlockStore::SQLiteBlockStore ( string filename, SQLiteConfig config, bool compress ) :
+    mCompress ( compress ) {
+
+    SQLiteResult result = this->mDB.open ( filename, config );
+    result.reportWithAssert ();
+
+    size_t userVersion = 0;
+    result = this->mDB.exec ( "PRAGMA user_version", NULL,
+
+        //--------------------------------//
+        [ & ]( int, const SQLiteStatement& stmt ) {
+            userVersion = ( size_t ) stmt.getValue < int >( 0 );
+        }
+    );
+    result.reportWithAssert ();
+
+    if ( userVersion && ( userVersion < MIN_SUPPORTED_USER_VERSION )) throw SQLiteBlockStoreUnsupportedVersionException ();
+
+    // blocks
+    result = this->mDB.exec ( SQL_STR (
+        CREATE TABLE IF NOT EXISTS blocks (
+            hash            TEXT                                            PRIMARY KEY,
+            encoding        TEXT CHECK ( encoding IN ( 'J', 'Z' ))          NOT NULL DEFAULT 'J',
+            data            TEXT                                            NOT NULL
+        ) WITHOUT ROWID
+    ));
+    result.reportWithAssert ();
+
+    if ( userVersion != CURRENT_USER_VERSION ) {
+        result = this->mDB.exec ( Format::write ( "PRAGMA user_version = %d", ( int )CURRENT_USER_VERSION ));
+        result.reportWithAssert ();
+    }
+}
+
+//----------------------------------------------------------------//
+SQLiteBlockStore::~SQLiteBlockStore () {
+}
+
+//================================================================//
+// virtual
+//================================================================//
+
+//----------------------------------------------------------------//
+shared_ptr < const Block > SQLiteBlockStore::AbstractBlockStore_getBlock ( string hash ) const {
+
+    lock_guard < mutex > lock ( this->mMutex );
+
+    shared_ptr < Block > block;
+
+    SQLiteResult result = this->mDB.exec (
+
+        "SELECT encoding, data FROM blocks WHERE hash IS ?1",
+
+        //--------------------------------//
+        [ & ]( SQLiteStatement& stmt ) {
+            stmt.bind ( 1, hash );
+        },
+
+        //--------------------------------//
+        [ & ]( int, const SQLiteStatement& stmt ) {
+
+            string json = SQLiteBlockStore::decode ( stmt.getValue < string >( "encoding" ), stmt.getValue < string >( "data" ));
+            assert ( json.size ());
+
+            block = make_shared < Block >();
+            FromJSONStreamSerializer::fromJSONString ( *block, json );
+        }
+    );
+    result.reportWithAssert ();
+
+    return block;
+}
+
+//----------------------------------------------------------------//
+bool SQLiteBlockStore::AbstractBlockStore_hasBlock ( string hash ) const {
+
+    lock_guard < mutex > lock ( this->mMutex );
+
+    bool found = false;
+
+    SQLiteResult result = this->mDB.exec (
+
+        "SELECT 1 FROM blocks WHERE hash IS ?1",
+
+        //--------------------------------//
+        [ & ]( SQLiteStatement& stmt ) {
+            stmt.bind ( 1, hash );
+        },
+
+        //--------------------------------//
+        [ & ]( int, const SQLiteStatement& ) {
+            found = true;
+        }
+    );
+    result.reportWithAssert ();
+
+    return found;
+}
+
+//----------------------------------------------------------------//
+void SQLiteBlockStore::AbstractBlockStore_putBlock ( const Block& block ) {
+
+    string hash = block.getDigest ().toHex ();
+
+    // blocks are immutable; skip the (comparatively expensive) encode if we already have it.
+    if ( this->hasBlock ( hash )) return;
+
+    string encoding = this->mCompress ? ENCODING_ZLIB : ENCODING_JSON;
+    string data = SQLiteBlockStore::encode ( encoding, ToJSONSerializer::toJSONString ( block ));
+
+    lock_guard < mutex > lock ( this->mMutex );
+
+    SQLiteResult result = this->mDB.exec (
+
+        "INSERT OR IGNORE INTO blocks ( hash, encoding, data ) VALUES ( ?1, ?2, ?3 )",
+
+        //--------------------------------//
+        [ & ]( SQLiteStatement& stmt ) {
+            stmt.bind ( 1, hash );
+            stmt.bind ( 2, encoding );
+            stmt.bind ( 3, data );
+        }
+    );
+    result.reportWithAssert ();
+}
+
+} // namespace Volition
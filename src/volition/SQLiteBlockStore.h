@@ -0,0 +1,62 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_SQLITEBLOCKSTORE_H
+#define VOLITION_SQLITEBLOCKSTORE_H
+
+#include <volition/common.h>
+#include <volition/AbstractBlockStore.h>
+
+namespace Volition {
+
+//================================================================//
+// SQLiteBlockStoreUnsupportedVersionException
+//================================================================//
+class SQLiteBlockStoreUnsupportedVersionException :
+    public runtime_error {
+public:
+
+    SQLiteBlockStoreUnsupportedVersionException ( string what = "" ) :
+        std::runtime_error ( what ) {
+    }
+};
+
+//================================================================//
+// SQLiteBlockStore
+//================================================================//
+// One row per block: compact JSON, optionally deflated (and base64'd, since
+// the column is text). The encoding is recorded per row, so compression may
+// be toggled without rewriting existing blocks. Has its own connection and
+// lock; ledger readers on the HTTP threads may hit it while the miner writes.
+class SQLiteBlockStore :
+    public AbstractBlockStore {
+private:
+
+    static const size_t MIN_SUPPORTED_USER_VERSION      = 1;
+    static const size_t CURRENT_USER_VERSION            = 1;
+
+    static constexpr const char* ENCODING_JSON          = "J";
+    static constexpr const char* ENCODING_ZLIB          = "Z";
+
+    mutable mutex                       mMutex;
+    mutable SQLite                      mDB;
+    bool                                mCompress;
+
+    //----------------------------------------------------------------//
+    static string                       decode                          ( string encoding, const string& data );
+    static string                       encode                          ( string encoding, const string& json );
+
+    //----------------------------------------------------------------//
+    shared_ptr < const Block >          AbstractBlockStore_getBlock     ( string hash ) const override;
+    bool                                AbstractBlockStore_hasBlock     ( string hash ) const override;
+    void                                AbstractBlockStore_putBlock     ( const Block& block ) override;
+
+public:
+
+    //----------------------------------------------------------------//
+                                        SQLiteBlockStore                ( string filename, SQLiteConfig config, bool compress = true );
+                                        ~SQLiteBlockStore               ();
+};
+
+} // namespace Volition
+#endif
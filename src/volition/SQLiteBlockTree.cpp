@@ -46,7 +46,7 @@ void BlockCursorCache::cacheCursor ( int nodeID, const BlockTreeCursor& cursor )
             assert ( cacheIt != this->mCache.end ());
             
             this->mCacheKeysByNodeID.erase ( cacheIt->first ); // do this first
-            this->mNodeIDByHash.erase ( cacheIt->second.getHash ()); // do this first
+            this->mNodeIDByHash.erase ( cacheIt->second.getDigest ()); // do this first
             
             this->mExpirationSet.erase ( *expiryIt ); // now it's safe - will invalidate iterator
             this->mCache.erase ( cacheIt ); // now it's safe - will invalidate iterator
@@ -60,7 +60,7 @@ void BlockCursorCache::cacheCursor ( int nodeID, const BlockTreeCursor& cursor )
     BlockCursorCacheKey key = BlockCursorCacheKey ( nodeID );
     this->mCacheKeysByNodeID [ nodeID ] = key;
     this->mExpirationSet.insert ( key );
-    this->mNodeIDByHash [ cursor.getHash ()] = nodeID;
+    this->mNodeIDByHash [ cursor.getDigest ()] = nodeID;
     this->mCache [ nodeID ] = cursor;
 }
 
@@ -75,9 +75,9 @@ const BlockTreeCursor* BlockCursorCache::getCursor ( int nodeID ) const {
 }
 
 //----------------------------------------------------------------//
-int BlockCursorCache::getNodeIDFromHash ( string hash ) const {
+int BlockCursorCache::getNodeIDFromHash ( const Digest256& hash ) const {
 
-    map < string, int >::const_iterator cursorIt = this->mNodeIDByHash.find ( hash );
+    unordered_map < Digest256, int, Digest256::Hash >::const_iterator cursorIt = this->mNodeIDByHash.find ( hash );
     if ( cursorIt != this->mNodeIDByHash.cend ()) {
         return cursorIt->second;
     }
@@ -95,7 +95,7 @@ void BlockCursorCache::invalidate ( int nodeID ) {
         BlockCursorCacheKey lastKey = this->mCacheKeysByNodeID [ nodeID ];
         this->mExpirationSet.erase ( lastKey );
         this->mCacheKeysByNodeID.erase ( nodeID );
-        this->mNodeIDByHash.erase ( cursorIt->second.getHash ());
+        this->mNodeIDByHash.erase ( cursorIt->second.getDigest ());
         this->mCache.erase ( nodeID );
     }
 }
@@ -111,7 +111,7 @@ void BlockCursorCache::setMaxSize ( size_t size ) {
 //================================================================//
 
 //----------------------------------------------------------------//
-int SQLiteBlockTree::getNodeIDFromHash ( string hash ) const {
+int SQLiteBlockTree::getNodeIDFromHash ( const Digest256& hash ) const {
 
     int nodeID = this->mCache.getNodeIDFromHash ( hash );
     if ( nodeID ) return nodeID;
@@ -122,7 +122,7 @@ int SQLiteBlockTree::getNodeIDFromHash ( string hash ) const {
         
         //--------------------------------//
         [ & ]( SQLiteStatement& stmt ) {
-            stmt.bind ( 1, hash );
+            stmt.bind ( 1, hash.toHex ());
         },
         
         //--------------------------------//
@@ -211,7 +211,7 @@ BlockTreeCursor SQLiteBlockTree::readCursor ( const SQLiteStatement& stmt ) cons
     assert ( headerJSON.size ());
     
     shared_ptr < BlockHeader >header = make_shared < BlockHeader >();
-    FromJSONSerializer::fromJSONString ( *header, headerJSON );
+    FromJSONStreamSerializer::fromJSONString ( *header, headerJSON );
 
     return this->makeCursor (
         header,
@@ -227,7 +227,7 @@ void SQLiteBlockTree::setBranchStatus ( int nodeID, const Digest& parentDigest,
 
     if ( status == BRANCH_STATUS_COMPLETE ) {
 
-        int parentID = this->getNodeIDFromHash ( parentDigest.toHex ());
+        int parentID = this->getNodeIDFromHash ( parentDigest );
 
         if ( parentID ) {
             kBlockTreeBranchStatus parentBranchStatus = this->getNodeBranchStatus ( parentID, kBlockTreeBranchStatus::BRANCH_STATUS_INVALID );
@@ -372,6 +372,16 @@ void SQLiteBlockTree::setTag ( string tagName, int nodeID ) {
     this->pruneUnreferencedNodes ();
 }
 
+//----------------------------------------------------------------//
+string SQLiteBlockTree::storeBlock ( const Block& block ) {
+
+    // returns what belongs in the 'block' column.
+    if ( !this->mBlockStore ) return ToJSONSerializer::toJSONString ( block );
+
+    this->mBlockStore->putBlock ( block );
+    return "";
+}
+
 //----------------------------------------------------------------//
 string SQLiteBlockTree::stringFromBranchStatus ( kBlockTreeBranchStatus status ) {
 
@@ -426,7 +436,8 @@ kBlockTreeSearchStatus SQLiteBlockTree::stringToSearchStatus ( string str ) {
 }
 
 //----------------------------------------------------------------//
-SQLiteBlockTree::SQLiteBlockTree ( string filename, SQLiteConfig config ) {
+SQLiteBlockTree::SQLiteBlockTree ( string filename, SQLiteConfig config, shared_ptr < AbstractBlockStore > blockStore ) :
+    mBlockStore ( blockStore ) {
 
     SQLiteResult result = this->mDB.open ( filename, config );
     result.reportWithAssert ();
@@ -501,8 +512,9 @@ SQLiteBlockTree::~SQLiteBlockTree () {
 BlockTreeCursor SQLiteBlockTree::AbstractBlockTree_affirm ( BlockTreeTag& tag, shared_ptr < const BlockHeader > header, shared_ptr < const Block > block, bool isProvisional ) {
         
     string tagName = tag.getName ();
-    string hash = header->getDigest ().toHex ();
-    BlockTreeCursor cursor = this->findCursorForHash ( hash );
+    Digest256 digest ( header->getDigest ());
+    string hash = digest.toHex ();
+    BlockTreeCursor cursor = this->findCursorForHash ( digest );
 
     if ( cursor.hasHeader ()) {
         if ( block && !cursor.getBlock ()) {
@@ -517,7 +529,7 @@ BlockTreeCursor SQLiteBlockTree::AbstractBlockTree_affirm ( BlockTreeTag& tag, s
 
     kBlockTreeBranchStatus branchStatus = block ? kBlockTreeBranchStatus::BRANCH_STATUS_COMPLETE : kBlockTreeBranchStatus::BRANCH_STATUS_NEW;
 
-    int parentID = header->isGenesis () ? 0 : this->getNodeIDFromHash ( header->getPrevDigest ().toHex ());
+    int parentID = header->isGenesis () ? 0 : this->getNodeIDFromHash ( header->getPrevDigest ());
 
     if ( parentID ) {
         
@@ -542,7 +554,7 @@ BlockTreeCursor SQLiteBlockTree::AbstractBlockTree_affirm ( BlockTreeTag& tag, s
             stmt.bind ( 2,      hash );
             stmt.bind ( 3,      ( int )header->getHeight ());
             stmt.bind ( 4,      ToJSONSerializer::toJSONString ( headerOnly ));
-            stmt.bind ( 5,      block ? ToJSONSerializer::toJSONString ( *block ) : "" );
+            stmt.bind ( 5,      block ? this->storeBlock ( *block ) : "" );
             stmt.bind ( 6,      SQLiteBlockTree::stringFromBranchStatus ( branchStatus ));
             stmt.bind ( 7,      SQLiteBlockTree::stringFromSearchStatus ( searchStatus ));
         }
@@ -558,7 +570,7 @@ BlockTreeCursor SQLiteBlockTree::AbstractBlockTree_affirm ( BlockTreeTag& tag, s
 }
 
 //----------------------------------------------------------------//
-BlockTreeCursor SQLiteBlockTree::AbstractBlockTree_findCursorForHash ( string hash ) const {
+BlockTreeCursor SQLiteBlockTree::AbstractBlockTree_findCursorForHash ( const Digest256& hash ) const {
 
     BlockTreeCursor cursor;
     
@@ -634,15 +646,18 @@ shared_ptr < const Block > SQLiteBlockTree::AbstractBlockTree_getBlock ( const B
         [ & ]( int, const SQLiteStatement& stmt ) {
         
             string blockJSON = stmt.getValue < string >( "block" );
-
-            assert ( blockJSON.size ());
+            if ( blockJSON.size () == 0 ) return;
         
             block = make_shared < Block >();
-            FromJSONSerializer::fromJSONString ( *block, blockJSON );
+            FromJSONStreamSerializer::fromJSONString ( *block, blockJSON );
         }
     );
     result.reportWithAssert ();
 
+    if ( !block && this->mBlockStore ) {
+        return this->mBlockStore->getBlock ( cursor.getHash ());
+    }
+
     assert ( block );
     return block;
 }
@@ -650,7 +665,7 @@ shared_ptr < const Block > SQLiteBlockTree::AbstractBlockTree_getBlock ( const B
 //----------------------------------------------------------------//
 void SQLiteBlockTree::AbstractBlockTree_setBranchStatus ( const BlockTreeCursor& cursor, kBlockTreeBranchStatus status ) {
 
-    int nodeID = this->getNodeIDFromHash ( cursor.getDigest ().toHex ());
+    int nodeID = this->getNodeIDFromHash ( cursor.getDigest ());
     this->setBranchStatus ( nodeID, cursor.getPrevDigest (), status );
 }
 
@@ -662,14 +677,14 @@ void SQLiteBlockTree::AbstractBlockTree_setCacheSize ( size_t size ) {
 //----------------------------------------------------------------//
 void SQLiteBlockTree::AbstractBlockTree_setSearchStatus ( const BlockTreeCursor& cursor, kBlockTreeSearchStatus status ) {
 
-    int nodeID = this->getNodeIDFromHash ( cursor.getDigest ().toHex ());
+    int nodeID = this->getNodeIDFromHash ( cursor.getDigest ());
     this->setSearchStatus ( nodeID, status );
 }
 
 //----------------------------------------------------------------//
 BlockTreeCursor SQLiteBlockTree::AbstractBlockTree_tag ( BlockTreeTag& tag, const BlockTreeCursor& cursor ) {
 
-    int nodeID = this->getNodeIDFromHash ( cursor.getHash ());
+    int nodeID = this->getNodeIDFromHash ( cursor.getDigest ());
     assert ( nodeID != 0 );
 
     this->setTag ( tag.getName (), nodeID );
@@ -691,7 +706,7 @@ void SQLiteBlockTree::AbstractBlockTree_update ( shared_ptr < const Block > bloc
 
     if ( !block ) return;
     
-    int nodeID = this->getNodeIDFromHash ( block->getDigest ().toHex ());
+    int nodeID = this->getNodeIDFromHash ( block->getDigest ());
     if ( !nodeID ) return;
     
     this->mCache.invalidate ( nodeID );
@@ -706,7 +721,7 @@ void SQLiteBlockTree::AbstractBlockTree_update ( shared_ptr < const Block > bloc
         
         //--------------------------------//
         [ & ]( SQLiteStatement& stmt ) {
-            stmt.bind ( 1, ToJSONSerializer::toJSONString ( *block ));
+            stmt.bind ( 1, this->storeBlock ( *block ));
             stmt.bind ( 2, nodeID );
         }
     );
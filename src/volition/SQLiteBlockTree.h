@@ -5,11 +5,13 @@
 #define VOLITION_SQLITEBLOCKTREE_H
 
 #include <volition/common.h>
+#include <volition/AbstractBlockStore.h>
 #include <volition/AbstractBlockTree.h>
 #include <volition/Accessors.h>
 #include <volition/Block.h>
 #include <volition/BlockTreeCursor.h>
 #include <volition/BlockTreeTag.h>
+#include <volition/Digest256.h>
 
 namespace Volition {
 
@@ -55,7 +57,7 @@ private:
     set < BlockCursorCacheKey >         mExpirationSet;
     map < int, BlockCursorCacheKey >    mCacheKeysByNodeID;
     map < int, BlockTreeCursor >        mCache;
-    map < string, int >                 mNodeIDByHash;
+    unordered_map < Digest256, int, Digest256::Hash >   mNodeIDByHash;
     size_t                              mMaxSize;
 
 public:
@@ -65,7 +67,7 @@ public:
                                         ~BlockCursorCache               ();
     void                                cacheCursor                     ( int nodeID, const BlockTreeCursor& cursor );
     const BlockTreeCursor*              getCursor                       ( int nodeID ) const;
-    int                                 getNodeIDFromHash               ( string hash ) const;
+    int                                 getNodeIDFromHash               ( const Digest256& hash ) const;
     void                                invalidate                      ( int nodeID );
     void                                setMaxSize                      ( size_t size );
 };
@@ -95,10 +97,14 @@ private:
     mutable SQLite                      mDB;
     mutable BlockCursorCache            mCache;
 
+    // if set, block bodies live here and the 'block' column is left empty.
+    // rows written before the store existed still carry their body inline.
+    shared_ptr < AbstractBlockStore >   mBlockStore;
+
     //----------------------------------------------------------------//
     void                                cacheCursor                     ( const BlockTreeCursor& cursor );
     const BlockTreeCursor*              getCursorFromCache              ( string hash ) const;
-    int                                 getNodeIDFromHash               ( string hash ) const;
+    int                                 getNodeIDFromHash               ( const Digest256& hash ) const;
     int                                 getNodeIDFromTagName            ( string tagName ) const;
     kBlockTreeBranchStatus              getNodeBranchStatus             ( int nodeID, kBlockTreeBranchStatus status = kBlockTreeBranchStatus::BRANCH_STATUS_INVALID ) const;
     void                                invalidate                      ( string hash );
@@ -108,6 +114,7 @@ private:
     void                                setBranchStatusInner            ( int nodeID, kBlockTreeBranchStatus status, set < int >& queue );
     void                                setSearchStatus                 ( int nodeID, kBlockTreeSearchStatus status );
     void                                setTag                          ( string tagName, int nodeID );
+    string                              storeBlock                      ( const Block& block );
     static string                       stringFromBranchStatus          ( kBlockTreeBranchStatus status );
     static string                       stringFromSearchStatus          ( kBlockTreeSearchStatus status );
     static kBlockTreeBranchStatus       stringToBranchStatus            ( string str );
@@ -115,7 +122,7 @@ private:
 
     //----------------------------------------------------------------//
     BlockTreeCursor                     AbstractBlockTree_affirm                    ( BlockTreeTag& tag, shared_ptr < const BlockHeader > header, shared_ptr < const Block > block, bool isProvisional = false ) override;
-    BlockTreeCursor                     AbstractBlockTree_findCursorForHash         ( string hash ) const override;
+    BlockTreeCursor                     AbstractBlockTree_findCursorForHash         ( const Digest256& hash ) const override;
     BlockTreeCursor                     AbstractBlockTree_findCursorForTagName      ( string tagName ) const override;
     shared_ptr < const Block >          AbstractBlockTree_getBlock                  ( const BlockTreeCursor& cursor ) const override;
     void                                AbstractBlockTree_setBranchStatus           ( const BlockTreeCursor& cursor, kBlockTreeBranchStatus status ) override;
@@ -128,7 +135,7 @@ private:
 public:
 
     //----------------------------------------------------------------//
-                                        SQLiteBlockTree                 ( string filename, SQLiteConfig config );
+                                        SQLiteBlockTree                 ( string filename, SQLiteConfig config, shared_ptr < AbstractBlockStore > blockStore = NULL );
                                         ~SQLiteBlockTree                ();
 };
 
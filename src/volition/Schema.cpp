@@ -35,9 +35,28 @@ bool Schema::compose ( const Schema& other ) {
 
     this->mVersion.compose ( other.mVersion );
 
+    this->compileDeckTables ();
+
     return true;
 }
 
+//----------------------------------------------------------------//
+void Schema::compileDeckTables () {
+
+    this->mDeckTables.clear ();
+
+    // sets shadow decks of the same name (see getDeck ()).
+    Decks::const_iterator deckIt = this->mDecks.cbegin ();
+    for ( ; deckIt != this->mDecks.cend (); ++deckIt ) {
+        this->mDeckTables [ deckIt->first ].build ( deckIt->second );
+    }
+
+    deckIt = this->mSets.cbegin ();
+    for ( ; deckIt != this->mSets.cend (); ++deckIt ) {
+        this->mDeckTables [ deckIt->first ].build ( deckIt->second );
+    }
+}
+
 //----------------------------------------------------------------//
 const Schema::Deck* Schema::getDeck ( string deckOrSetName ) const {
 
@@ -49,6 +68,13 @@ const Schema::Deck* Schema::getDeck ( string deckOrSetName ) const {
    return deckIt != this->mDecks.cend () ? &deckIt->second : NULL;
 }
 
+//----------------------------------------------------------------//
+const DeckTable* Schema::getDeckTable ( string deckOrSetName ) const {
+
+    map < string, DeckTable >::const_iterator deckTableIt = this->mDeckTables.find ( deckOrSetName );
+    return ( deckTableIt != this->mDeckTables.cend ()) ? &deckTableIt->second : NULL;
+}
+
 //----------------------------------------------------------------//
 const Schema::Definitions& Schema::getDefinitions () const {
     return this->mDefinitions;
@@ -126,6 +152,8 @@ void Schema::AbstractSerializable_serializeFrom ( const AbstractSerializerFrom&
     serializer.serialize ( "sets",              this->mSets );
     serializer.serialize ( "upgrades",          this->mUpgrades );
     serializer.serialize ( "version",           this->mVersion );
+
+    this->compileDeckTables ();
 }
 
 //----------------------------------------------------------------//
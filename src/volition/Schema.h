@@ -7,6 +7,7 @@
 #include <volition/common.h>
 #include <volition/AssetDefinition.h>
 #include <volition/AssetMethod.h>
+#include <volition/DeckTable.h>
 #include <volition/MiningReward.h>
 #include <volition/SchemaVersion.h>
 #include <volition/SquapFactory.h>
@@ -48,6 +49,9 @@ private:
     Upgrades                mUpgrades;
     SchemaVersion           mVersion;
 
+    // mDecks and mSets, compiled for sampling when the schema is loaded.
+    map < string, DeckTable >   mDeckTables;
+
     //----------------------------------------------------------------//
     template < typename TYPE >
     static bool hasKeyCollisions ( const TYPE& container0, const TYPE& container1 ) {
@@ -70,6 +74,7 @@ private:
     }
 
     //----------------------------------------------------------------//
+    void            compileDeckTables                       ();
     void            AbstractSerializable_serializeFrom      ( const AbstractSerializerFrom& serializer );
     void            AbstractSerializable_serializeTo        ( AbstractSerializerTo& serializer ) const;
 
@@ -79,6 +84,7 @@ public:
     bool                        canUpgrade                  ( string type, string upgrade ) const;
     bool                        compose                     ( const Schema& other );
     const Deck*                 getDeck                     ( string deckOrSetName ) const;
+    const DeckTable*            getDeckTable                ( string deckOrSetName ) const;
     const Definitions&          getDefinitions              () const;
     const AssetDefinition*      getDefinitionOrNull         ( string name ) const;
     const Methods&              getMethods                  () const;
@@ -45,6 +45,13 @@ public:
         return AssetFieldValue ();
     };
 
+    //----------------------------------------------------------------//
+    const AssetFieldValue* getValueOrNull ( const string& paramName ) const {
+        
+        map < string, AssetFieldValue >::const_iterator paramIt = this->mValueParams.find ( paramName );
+        return ( paramIt != this->mValueParams.cend ()) ? &paramIt->second : NULL;
+    };
+
     //----------------------------------------------------------------//
     SquapEvaluationContext ( shared_ptr < const Asset > assetParam ) {
     
@@ -0,0 +1,258 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <volition/BinarySquap.h>
+#include <volition/ConstSquap.h>
+#include <volition/FuncSquap.h>
+#include <volition/IndexSquap.h>
+#include <volition/SquapProgram.h>
+#include <volition/UnarySquap.h>
+
+namespace Volition {
+
+//================================================================//
+// SquapProgram
+//================================================================//
+
+//----------------------------------------------------------------//
+u32 SquapProgram::affirmName ( vector < string >& names, string name ) {
+
+    for ( size_t i = 0; i < names.size (); ++i ) {
+        if ( names [ i ] == name ) return ( u32 )i;
+    }
+    names.push_back ( name );
+    return ( u32 )( names.size () - 1 );
+}
+
+//----------------------------------------------------------------//
+SquapProgram::Scratch& SquapProgram::bind () const {
+
+    thread_local Scratch scratch;
+
+    // assign and resize keep their capacity, so these only allocate the first time a thread sees a program this big.
+    scratch.mBindings.assign ( this->mParamNames.size (), Binding { NULL, NULL });
+    if ( scratch.mTemps.size () < this->mMaxDepth ) {
+        scratch.mTemps.resize ( this->mMaxDepth );
+    }
+    scratch.mStack.clear ();
+    scratch.mStack.reserve ( this->mMaxDepth );
+    return scratch;
+}
+
+//----------------------------------------------------------------//
+bool SquapProgram::compile ( const AbstractSquap* squap ) {
+
+    this->reset ();
+    if ( !squap ) return false;
+
+    size_t depth = 0;
+    if ( !this->compileRecurse ( *squap, depth )) {
+        this->reset ();
+        return false;
+    }
+    assert ( depth == 1 );
+
+    this->mIsCompiled = true;
+    return true;
+}
+
+//----------------------------------------------------------------//
+bool SquapProgram::compileRecurse ( const AbstractSquap& squap, size_t& depth ) {
+
+    const ConstSquap* constSquap = dynamic_cast < const ConstSquap* >( &squap );
+    if ( constSquap ) {
+        this->mConsts.push_back ( constSquap->mConst );
+        this->emit ( OP_CONST, squap.mOpCode, 0, ( u32 )( this->mConsts.size () - 1 ), depth, 1 );
+        return true;
+    }
+
+    const IndexSquap* indexSquap = dynamic_cast < const IndexSquap* >( &squap );
+    if ( indexSquap ) {
+        u32 param = this->affirmName ( this->mParamNames, indexSquap->mArgName );
+        string indexer = indexSquap->mIndexer;
+        u32 field = (( indexer.size () == 0 ) || ( indexer == "@" )) ? NO_FIELD : this->affirmName ( this->mFieldNames, indexer );
+        this->emit ( OP_INDEX, squap.mOpCode, param, field, depth, 1 );
+        return true;
+    }
+
+    const UnarySquap* unarySquap = dynamic_cast < const UnarySquap* >( &squap );
+    if ( unarySquap ) {
+        if ( !unarySquap->mOperand ) {
+            this->emit ( OP_UNDEFINED, squap.mOpCode, 0, 0, depth, 1 );
+            return true;
+        }
+        if ( !this->compileRecurse ( *unarySquap->mOperand, depth )) return false;
+        this->emit ( OP_UNARY, squap.mOpCode, 0, 0, depth, 0 );
+        return true;
+    }
+
+    const BinarySquap* binarySquap = dynamic_cast < const BinarySquap* >( &squap );
+    if ( binarySquap ) {
+        if ( !( binarySquap->mLeft && binarySquap->mRight )) {
+            this->emit ( OP_UNDEFINED, squap.mOpCode, 0, 0, depth, 1 );
+            return true;
+        }
+        if ( !this->compileRecurse ( *binarySquap->mLeft, depth )) return false;
+        if ( !this->compileRecurse ( *binarySquap->mRight, depth )) return false;
+        this->emit ( OP_BINARY, squap.mOpCode, 0, 0, depth, -1 );
+        return true;
+    }
+
+    // FUNC is not implemented by the tree evaluator either; it is always undefined.
+    if ( dynamic_cast < const FuncSquap* >( &squap )) {
+        this->emit ( OP_UNDEFINED, squap.mOpCode, 0, 0, depth, 1 );
+        return true;
+    }
+
+    return false;
+}
+
+//----------------------------------------------------------------//
+void SquapProgram::emit ( Op op, AbstractSquap::OpCode opCode, u32 param, u32 index, size_t& depth, int stackDelta ) {
+
+    Instruction instruction;
+    instruction.mOp         = op;
+    instruction.mOpCode     = opCode;
+    instruction.mParam      = param;
+    instruction.mIndex      = index;
+    this->mCode.push_back ( instruction );
+
+    depth = ( size_t )(( int )depth + stackDelta );
+    if ( this->mMaxDepth < depth ) {
+        this->mMaxDepth = depth;
+    }
+}
+
+//----------------------------------------------------------------//
+AssetFieldValue SquapProgram::evaluate ( const Asset& asset ) const {
+
+    Scratch& scratch = this->bind ();
+    for ( size_t i = 0; i < this->mParamNames.size (); ++i ) {
+        if ( this->mParamNames [ i ].size () == 0 ) {
+            scratch.mBindings [ i ].mAsset = &asset;
+        }
+    }
+    return this->run ( scratch );
+}
+
+//----------------------------------------------------------------//
+AssetFieldValue SquapProgram::evaluate ( const AssetFieldValue& value ) const {
+
+    Scratch& scratch = this->bind ();
+    for ( size_t i = 0; i < this->mParamNames.size (); ++i ) {
+        if ( this->mParamNames [ i ].size () == 0 ) {
+            scratch.mBindings [ i ].mValue = &value;
+        }
+    }
+    return this->run ( scratch );
+}
+
+//----------------------------------------------------------------//
+AssetFieldValue SquapProgram::evaluate ( const SquapEvaluationContext& context ) const {
+
+    Scratch& scratch = this->bind ();
+    for ( size_t i = 0; i < this->mParamNames.size (); ++i ) {
+        const string& paramName = this->mParamNames [ i ];
+        scratch.mBindings [ i ].mAsset = context.getAsset ( paramName );
+        scratch.mBindings [ i ].mValue = context.getValueOrNull ( paramName );
+    }
+    return this->run ( scratch );
+}
+
+//----------------------------------------------------------------//
+void SquapProgram::reset () {
+
+    this->mIsCompiled = false;
+    this->mCode.clear ();
+    this->mConsts.clear ();
+    this->mFieldNames.clear ();
+    this->mParamNames.clear ();
+    this->mMaxDepth = 0;
+}
+
+//----------------------------------------------------------------//
+AssetFieldValue SquapProgram::run ( Scratch& scratch ) const {
+
+    assert ( this->mIsCompiled );
+
+    static const AssetFieldValue UNDEFINED;
+
+    const vector < Binding >& bindings = scratch.mBindings;
+    vector < AssetFieldValue >& temps = scratch.mTemps;
+    vector < const AssetFieldValue* >& stack = scratch.mStack;
+
+    // leaves that already exist (consts, asset fields, value params) are pushed by
+    // address and never copied; computed values go in the temp for their stack slot.
+    size_t size = this->mCode.size ();
+    for ( size_t pc = 0; pc < size; ++pc ) {
+
+        const Instruction& instruction = this->mCode [ pc ];
+
+        switch ( instruction.mOp ) {
+
+            case OP_BINARY: {
+                const AssetFieldValue* rval = stack.back ();
+                stack.pop_back ();
+                size_t slot = stack.size () - 1;
+                temps [ slot ] = BinarySquap::apply ( instruction.mOpCode, *stack [ slot ], *rval );
+                stack [ slot ] = &temps [ slot ];
+                break;
+            }
+
+            case OP_CONST:
+                stack.push_back ( &this->mConsts [ instruction.mIndex ]);
+                break;
+
+            case OP_INDEX: {
+
+                const Binding& binding = bindings [ instruction.mParam ];
+                const AssetFieldValue* value = &UNDEFINED;
+
+                if ( binding.mAsset ) {
+                    if ( instruction.mIndex == NO_FIELD ) {
+                        size_t slot = stack.size ();
+                        temps [ slot ] = AssetFieldValue ( binding.mAsset->mType );
+                        value = &temps [ slot ];
+                    }
+                    else {
+                        const AssetFieldValue* field = binding.mAsset->getFieldOrNull ( this->mFieldNames [ instruction.mIndex ]);
+                        if ( field ) {
+                            value = field;
+                        }
+                    }
+                }
+                else if ( binding.mValue ) {
+                    value = binding.mValue;
+                }
+                stack.push_back ( value );
+                break;
+            }
+
+            case OP_UNARY: {
+                size_t slot = stack.size () - 1;
+                temps [ slot ] = UnarySquap::apply ( instruction.mOpCode, *stack [ slot ]);
+                stack [ slot ] = &temps [ slot ];
+                break;
+            }
+
+            case OP_UNDEFINED:
+                stack.push_back ( &UNDEFINED );
+                break;
+        }
+    }
+
+    assert ( stack.size () == 1 );
+    return *stack.back ();
+}
+
+//----------------------------------------------------------------//
+SquapProgram::SquapProgram () :
+    mIsCompiled ( false ),
+    mMaxDepth ( 0 ) {
+}
+
+//----------------------------------------------------------------//
+SquapProgram::~SquapProgram () {
+}
+
+} // namespace Volition
@@ -0,0 +1,100 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_SQUAPPROGRAM_H
+#define VOLITION_SQUAPPROGRAM_H
+
+#include <volition/common.h>
+#include <volition/AbstractSquap.h>
+#include <volition/Asset.h>
+#include <volition/AssetFieldValue.h>
+#include <volition/SquapEvaluationContext.h>
+
+namespace Volition {
+
+//================================================================//
+// SquapProgram
+//================================================================//
+// A squap tree flattened into a postfix instruction array. Param names and
+// field names are interned once at compile time, so evaluation binds each
+// param a single time and then runs a loop over the instructions, pushing
+// pointers to leaf values rather than copying them. Intermediate results
+// live in per-thread scratch slots, one per stack depth. Compiled alongside the
+// schema (see AssetMethod, Stamp), so it is cached with the schema per hash.
+// Produces exactly the same results as AbstractSquap::evaluate ().
+class SquapProgram {
+private:
+
+    static const u32 NO_FIELD   = ( u32 )-1;
+
+    enum Op : u8 {
+        OP_BINARY,          // pop rval, lval; push apply ( mOpCode, lval, rval )
+        OP_CONST,           // push mConsts [ mIndex ]
+        OP_INDEX,           // push param mParam (its type or field mIndex if an asset)
+        OP_UNARY,           // pop val; push apply ( mOpCode, val )
+        OP_UNDEFINED,       // push undefined
+    };
+
+    //----------------------------------------------------------------//
+    class Instruction {
+    public:
+
+        Op                      mOp;
+        AbstractSquap::OpCode   mOpCode;
+        u32                     mParam;
+        u32                     mIndex;
+    };
+
+    //----------------------------------------------------------------//
+    class Binding {
+    public:
+
+        const Asset*            mAsset;
+        const AssetFieldValue*  mValue;
+    };
+
+    //----------------------------------------------------------------//
+    // per-thread working storage for evaluate (); sized up to the largest
+    // program seen on the thread and then reused, so a warm evaluation
+    // doesn't allocate.
+    class Scratch {
+    public:
+
+        vector < Binding >                  mBindings;
+        vector < AssetFieldValue >          mTemps;     // one per stack slot
+        vector < const AssetFieldValue* >   mStack;
+    };
+
+    bool                        mIsCompiled;
+    vector < Instruction >      mCode;
+    vector < AssetFieldValue >  mConsts;
+    vector < string >           mFieldNames;
+    vector < string >           mParamNames;
+    size_t                      mMaxDepth;
+
+    //----------------------------------------------------------------//
+    u32                 affirmName                  ( vector < string >& names, string name );
+    bool                compileRecurse              ( const AbstractSquap& squap, size_t& depth );
+    void                emit                        ( Op op, AbstractSquap::OpCode opCode, u32 param, u32 index, size_t& depth, int stackDelta );
+    Scratch&            bind                        () const;
+    AssetFieldValue     run                         ( Scratch& scratch ) const;
+
+public:
+
+    //----------------------------------------------------------------//
+    operator bool () const {
+        return this->mIsCompiled;
+    }
+
+    //----------------------------------------------------------------//
+    bool                compile                     ( const AbstractSquap* squap );
+    AssetFieldValue     evaluate                    ( const Asset& asset ) const;
+    AssetFieldValue     evaluate                    ( const AssetFieldValue& value ) const;
+    AssetFieldValue     evaluate                    ( const SquapEvaluationContext& context ) const;
+    void                reset                       ();
+                        SquapProgram                ();
+                        ~SquapProgram               ();
+};
+
+} // namespace Volition
+#endif
@@ -11,6 +11,7 @@
 #include <volition/Format.h>
 #include <volition/serialization/Serialization.h>
 #include <volition/SquapEvaluationContext.h>
+#include <volition/SquapProgram.h>
 
 namespace Volition {
 
@@ -25,12 +26,15 @@ public:
     
     SerializableSharedPtr < AbstractSquap, SquapFactory >   mQualifier;     // asset qualifier
     Fields                                                  mFields;        // fields to overwrite
+    SquapProgram                                            mProgram;       // compiled mQualifier
     
     //----------------------------------------------------------------//
     void AbstractSerializable_serializeFrom ( const AbstractSerializerFrom& serializer ) override {
         
         serializer.serialize ( "qualifier",     this->mQualifier );
         serializer.serialize ( "fields",        this->mFields );
+        
+        this->mProgram.compile ( this->mQualifier.get ());
     }
     
     //----------------------------------------------------------------//
@@ -46,6 +50,7 @@ public:
     //----------------------------------------------------------------//
     bool checkAsset ( shared_ptr < const Asset > assetParam ) const {
         
+        if ( this->mProgram && assetParam ) return ( bool )this->mProgram.evaluate ( *assetParam );
         return this->mQualifier ? ( bool )this->mQualifier->evaluate ( SquapEvaluationContext ( assetParam )) : true;
     }
     
@@ -0,0 +1,79 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <volition/Format.h>
+#include <volition/Metrics.h>
+#include <volition/ThePoseCache.h>
+
+namespace Volition {
+
+//================================================================//
+// ThePoseCache
+//================================================================//
+
+//----------------------------------------------------------------//
+Signature ThePoseCache::sign ( const CryptoKeyPair& key, const Digest& digest, string hashAlgorithm ) {
+
+    string cacheKey = Format::write ( "%s:%s:%s", key.getKeyID ().c_str (), hashAlgorithm.c_str (), digest.toHex ().c_str ());
+
+    {
+        lock_guard < mutex > lock ( this->mMutex );
+
+        map < string, Signature >::const_iterator signatureIt = this->mSignatures.find ( cacheKey );
+        if ( signatureIt != this->mSignatures.cend ()) {
+            VOL_METRIC_COUNT_LABELED ( "volition_cache_lookups_total", "Cache lookups, by cache and result.", "cache=\"poseSignature\",result=\"hit\"", 1 );
+            return signatureIt->second;
+        }
+    }
+
+    VOL_METRIC_COUNT_LABELED ( "volition_cache_lookups_total", "Cache lookups, by cache and result.", "cache=\"poseSignature\",result=\"miss\"", 1 );
+
+    // sign outside the lock; if two threads race, either signature is valid.
+    Signature signature = key.sign ( digest, hashAlgorithm );
+
+    lock_guard < mutex > lock ( this->mMutex );
+
+    if ( this->mSignatures.size () >= MAX_ENTRIES ) {
+        this->mSignatures.clear ();
+    }
+    this->mSignatures [ cacheKey ] = signature;
+    return signature;
+}
+
+//----------------------------------------------------------------//
+ThePoseCache::ThePoseCache () {
+}
+
+//----------------------------------------------------------------//
+ThePoseCache::~ThePoseCache () {
+}
+
+//----------------------------------------------------------------//
+bool ThePoseCache::verify ( const CryptoPublicKey& key, const Signature& pose, const Digest& digest ) {
+
+    // the hash algorithm isn't part of the pose's bytes, but it is part of what gets checked.
+    string cacheKey = Format::write ( "%s:%s:%s:%s", key.getKeyID ().c_str (), pose.getHashAlgorithm ().c_str (), digest.toHex ().c_str (), pose.toHex ().c_str ());
+
+    {
+        lock_guard < mutex > lock ( this->mMutex );
+
+        if ( this->mVerified.find ( cacheKey ) != this->mVerified.cend ()) {
+            VOL_METRIC_COUNT_LABELED ( "volition_cache_lookups_total", "Cache lookups, by cache and result.", "cache=\"poseVerified\",result=\"hit\"", 1 );
+            return true;
+        }
+    }
+
+    VOL_METRIC_COUNT_LABELED ( "volition_cache_lookups_total", "Cache lookups, by cache and result.", "cache=\"poseVerified\",result=\"miss\"", 1 );
+
+    if ( !key.verify ( pose, digest )) return false;
+
+    lock_guard < mutex > lock ( this->mMutex );
+
+    if ( this->mVerified.size () >= MAX_ENTRIES ) {
+        this->mVerified.clear ();
+    }
+    this->mVerified.insert ( cacheKey );
+    return true;
+}
+
+} // namespace Volition
@@ -0,0 +1,51 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_THEPOSECACHE_H
+#define VOLITION_THEPOSECACHE_H
+
+#include <volition/common.h>
+#include <volition/CryptoKey.h>
+#include <volition/Digest.h>
+#include <volition/Signature.h>
+#include <volition/Singleton.h>
+#include <mutex>
+
+namespace Volition {
+
+//================================================================//
+// ThePoseCache
+//================================================================//
+// Process-wide memo of pose signatures. A miner re-prepares its provisional
+// block on every step while it waits out the block delay; without the memo
+// each pass re-signs the same parent pose with the miner's private key.
+// Signatures are keyed by the signing key's ID, the hash algorithm and the
+// pose digest (which covers the miner ID, height and parent pose), so a
+// rotated key never sees the old key's entries. Successful pose
+// verifications are remembered the same way, keyed by public key, hash
+// algorithm, digest and pose, so a header seen on one branch isn't
+// re-verified on another. Failures are never cached. Both tables are
+// dropped when they grow past MAX_ENTRIES.
+class ThePoseCache :
+    public Singleton < ThePoseCache > {
+public:
+
+    static const size_t MAX_ENTRIES = 4096;
+
+private:
+
+    mutex                       mMutex;
+    map < string, Signature >   mSignatures;
+    set < string >              mVerified;
+
+public:
+
+    //----------------------------------------------------------------//
+    Signature       sign                ( const CryptoKeyPair& key, const Digest& digest, string hashAlgorithm );
+                    ThePoseCache        ();
+                    ~ThePoseCache       ();
+    bool            verify              ( const CryptoPublicKey& key, const Signature& pose, const Digest& digest );
+};
+
+} // namespace Volition
+#endif
@@ -0,0 +1,79 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <volition/Metrics.h>
+#include <volition/TheTransactionContextCache.h>
+
+namespace Volition {
+
+//================================================================//
+// TheTransactionContextCache
+//================================================================//
+
+//----------------------------------------------------------------//
+shared_ptr < const CompiledEntitlements > TheTransactionContextCache::affirmEntitlements ( string key, EntitlementsResolver resolve ) {
+
+    {
+        lock_guard < mutex > lock ( this->mMutex );
+
+        map < string, shared_ptr < const CompiledEntitlements >>::const_iterator entitlementsIt = this->mEntitlements.find ( key );
+        if ( entitlementsIt != this->mEntitlements.cend ()) {
+            VOL_METRIC_COUNT_LABELED ( "volition_cache_lookups_total", "Cache lookups, by cache and result.", "cache=\"entitlements\",result=\"hit\"", 1 );
+            return entitlementsIt->second;
+        }
+    }
+
+    VOL_METRIC_COUNT_LABELED ( "volition_cache_lookups_total", "Cache lookups, by cache and result.", "cache=\"entitlements\",result=\"miss\"", 1 );
+
+    // resolve and compile outside the lock; if two threads race, both results are identical.
+    shared_ptr < const CompiledEntitlements > compiled = make_shared < CompiledEntitlements >( resolve ());
+
+    lock_guard < mutex > lock ( this->mMutex );
+
+    if ( this->mEntitlements.size () >= MAX_ENTRIES ) {
+        this->mEntitlements.clear ();
+    }
+    this->mEntitlements [ key ] = compiled;
+    return compiled;
+}
+
+//----------------------------------------------------------------//
+shared_ptr < const TransactionFeeSchedule > TheTransactionContextCache::getFeeSchedule ( const AbstractLedger& ledger ) {
+
+    string json = ledger.getValueOrFallback < string >( AbstractLedger::keyFor_transactionFeeSchedule (), "" );
+
+    {
+        lock_guard < mutex > lock ( this->mMutex );
+
+        map < string, shared_ptr < const TransactionFeeSchedule >>::const_iterator feeScheduleIt = this->mFeeSchedules.find ( json );
+        if ( feeScheduleIt != this->mFeeSchedules.cend ()) {
+            VOL_METRIC_COUNT_LABELED ( "volition_cache_lookups_total", "Cache lookups, by cache and result.", "cache=\"feeSchedule\",result=\"hit\"", 1 );
+            return feeScheduleIt->second;
+        }
+    }
+
+    VOL_METRIC_COUNT_LABELED ( "volition_cache_lookups_total", "Cache lookups, by cache and result.", "cache=\"feeSchedule\",result=\"miss\"", 1 );
+
+    shared_ptr < TransactionFeeSchedule > feeSchedule = make_shared < TransactionFeeSchedule >();
+    if ( json.size () > 0 ) {
+        FromJSONStreamSerializer::fromJSONString ( *feeSchedule, json );
+    }
+
+    lock_guard < mutex > lock ( this->mMutex );
+
+    if ( this->mFeeSchedules.size () >= MAX_ENTRIES ) {
+        this->mFeeSchedules.clear ();
+    }
+    this->mFeeSchedules [ json ] = feeSchedule;
+    return feeSchedule;
+}
+
+//----------------------------------------------------------------//
+TheTransactionContextCache::TheTransactionContextCache () {
+}
+
+//----------------------------------------------------------------//
+TheTransactionContextCache::~TheTransactionContextCache () {
+}
+
+} // namespace Volition
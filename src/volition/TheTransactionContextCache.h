@@ -0,0 +1,98 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_THETRANSACTIONCONTEXTCACHE_H
+#define VOLITION_THETRANSACTIONCONTEXTCACHE_H
+
+#include <volition/common.h>
+#include <volition/CompiledEntitlements.h>
+#include <volition/Ledger.h>
+#include <volition/Policy.h>
+#include <volition/Singleton.h>
+#include <volition/TransactionFeeSchedule.h>
+#include <functional>
+#include <mutex>
+
+namespace Volition {
+
+//================================================================//
+// TheTransactionContextCache
+//================================================================//
+// Process-wide cache of the ledger objects every TransactionContext needs:
+// resolved, compiled entitlements and the parsed fee schedule. Entries are
+// keyed by the ledger content they were built from (the stored JSON), not by
+// ledger version, so they stay valid across blocks and across branches and
+// can never be served stale after a rewind. The only per-lookup cost is
+// reading that JSON back out of the ledger (and serializing a policy's
+// restrictions, if it has any). Both tables are simply dropped when they
+// grow past MAX_ENTRIES.
+class TheTransactionContextCache :
+    public Singleton < TheTransactionContextCache > {
+public:
+
+    static const size_t MAX_ENTRIES = 4096;
+
+private:
+
+    typedef std::function < shared_ptr < const Entitlements > ()> EntitlementsResolver;
+
+    mutex                                                               mMutex;
+    map < string, shared_ptr < const CompiledEntitlements >>            mEntitlements;
+    map < string, shared_ptr < const TransactionFeeSchedule >>          mFeeSchedules;
+
+    //----------------------------------------------------------------//
+    shared_ptr < const CompiledEntitlements >       affirmEntitlements          ( string key, EntitlementsResolver resolve );
+
+public:
+
+    //----------------------------------------------------------------//
+    shared_ptr < const TransactionFeeSchedule >     getFeeSchedule              ( const AbstractLedger& ledger );
+                                                    TheTransactionContextCache  ();
+                                                    ~TheTransactionContextCache ();
+
+    //----------------------------------------------------------------//
+    // same result as ledger.getEntitlements < ENTITLEMENTS_FAMILY >( policy ).
+    template < typename ENTITLEMENTS_FAMILY >
+    shared_ptr < const CompiledEntitlements > getEntitlements ( const AbstractLedger& ledger, const Policy& policy ) {
+
+        string base = policy.getBase ();
+        const Entitlements* restrictions = policy.getRestrictions ();
+
+        string baseJSON = base.size () ? ledger.getValueOrFallback < string >( AbstractLedger::keyFor_entitlements ( base ), "" ) : "";
+        string restrictionsJSON = restrictions ? ToJSONSerializer::toJSONString ( *restrictions ) : "";
+
+        // an empty base name means the family's master entitlements.
+        string key = Format::write ( "%s:%s:%d:", typeid ( ENTITLEMENTS_FAMILY ).name (), base.size () ? "base" : "master", ( int )baseJSON.size ());
+        key = key + baseJSON + restrictionsJSON;
+
+        return this->affirmEntitlements ( key, [ & ]() -> shared_ptr < const Entitlements > {
+
+            shared_ptr < const Entitlements > entitlements;
+            if ( base.size () == 0 ) {
+                entitlements = ENTITLEMENTS_FAMILY::getMasterEntitlements ();
+            }
+            else if ( baseJSON.size ()) {
+                shared_ptr < Entitlements > parsed = make_shared < Entitlements >();
+                FromJSONStreamSerializer::fromJSONString ( *parsed, baseJSON );
+                entitlements = parsed;
+            }
+            else {
+                entitlements = make_shared < Entitlements >();
+            }
+            return policy.applyRestrictions ( *entitlements );
+        });
+    }
+
+    //----------------------------------------------------------------//
+    template < typename ENTITLEMENTS_FAMILY >
+    shared_ptr < const CompiledEntitlements > getMasterEntitlements () {
+
+        string key = Format::write ( "%s:genesis", typeid ( ENTITLEMENTS_FAMILY ).name ());
+        return this->affirmEntitlements ( key, []() {
+            return ENTITLEMENTS_FAMILY::getMasterEntitlements ();
+        });
+    }
+};
+
+} // namespace Volition
+#endif
@@ -0,0 +1,118 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <volition/TheWorkerPool.h>
+
+namespace Volition {
+
+//================================================================//
+// TheWorkerPool::Batch
+//================================================================//
+
+//----------------------------------------------------------------//
+void TheWorkerPool::Batch::drain () {
+
+    size_t finished = 0;
+    for ( size_t i = this->mNext++; i < this->mCount; i = this->mNext++ ) {
+        this->mTask ( i );
+        finished++;
+    }
+
+    if ( finished ) {
+        lock_guard < mutex > lock ( this->mMutex );
+        this->mPending -= finished;
+        if ( this->mPending == 0 ) {
+            this->mDone.notify_all ();
+        }
+    }
+}
+
+//================================================================//
+// TheWorkerPool
+//================================================================//
+
+//----------------------------------------------------------------//
+size_t TheWorkerPool::countThreads () const {
+
+    return this->mThreads.size ();
+}
+
+//----------------------------------------------------------------//
+void TheWorkerPool::parallelFor ( size_t count, const function < void ( size_t )>& task ) {
+
+    if ( count == 0 ) return;
+
+    if (( count == 1 ) || ( this->mThreads.size () == 0 )) {
+        for ( size_t i = 0; i < count; ++i ) {
+            task ( i );
+        }
+        return;
+    }
+
+    shared_ptr < Batch > batch = make_shared < Batch >();
+    batch->mTask        = task;
+    batch->mCount       = count;
+    batch->mNext        = 0;
+    batch->mPending     = count;
+
+    // one queue entry per helper; a helper that wakes after the work is gone just drops the batch.
+    size_t helpers = ( count - 1 ) < this->mThreads.size () ? ( count - 1 ) : this->mThreads.size ();
+    {
+        lock_guard < mutex > lock ( this->mMutex );
+        for ( size_t i = 0; i < helpers; ++i ) {
+            this->mQueue.push_back ( batch );
+        }
+    }
+    this->mWake.notify_all ();
+
+    batch->drain ();
+
+    unique_lock < mutex > lock ( batch->mMutex );
+    batch->mDone.wait ( lock, [ & ]() { return batch->mPending == 0; });
+}
+
+//----------------------------------------------------------------//
+TheWorkerPool::TheWorkerPool () :
+    mStop ( false ) {
+
+    size_t totalThreads = ( size_t )thread::hardware_concurrency ();
+    totalThreads = totalThreads > 1 ? totalThreads - 1 : 0;
+
+    for ( size_t i = 0; i < totalThreads; ++i ) {
+        this->mThreads.emplace_back ( &TheWorkerPool::work, this );
+    }
+}
+
+//----------------------------------------------------------------//
+TheWorkerPool::~TheWorkerPool () {
+
+    {
+        lock_guard < mutex > lock ( this->mMutex );
+        this->mStop = true;
+    }
+    this->mWake.notify_all ();
+
+    for ( size_t i = 0; i < this->mThreads.size (); ++i ) {
+        this->mThreads [ i ].join ();
+    }
+}
+
+//----------------------------------------------------------------//
+void TheWorkerPool::work () {
+
+    while ( true ) {
+
+        shared_ptr < Batch > batch;
+        {
+            unique_lock < mutex > lock ( this->mMutex );
+            this->mWake.wait ( lock, [ this ]() { return this->mStop || this->mQueue.size (); });
+            if ( this->mStop ) return;
+
+            batch = this->mQueue.front ();
+            this->mQueue.pop_front ();
+        }
+        batch->drain ();
+    }
+}
+
+} // namespace Volition
@@ -0,0 +1,65 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_THEWORKERPOOL_H
+#define VOLITION_THEWORKERPOOL_H
+
+#include <volition/common.h>
+#include <volition/Singleton.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Volition {
+
+//================================================================//
+// TheWorkerPool
+//================================================================//
+// Process-wide pool of compute threads (one per hardware thread, less the
+// caller) for CPU-bound fan-out such as qualifier evaluation and signature
+// checks. Threads are started once and parked between jobs. parallelFor
+// runs task ( 0 ) through task ( count - 1 ) and returns when every index
+// has finished; the calling thread takes indices too, so a call made from
+// inside a task (or while every worker is busy) still completes.
+class TheWorkerPool :
+    public Singleton < TheWorkerPool > {
+private:
+
+    //----------------------------------------------------------------//
+    class Batch {
+    public:
+
+        function < void ( size_t )>     mTask;
+        size_t                          mCount;
+        atomic < size_t >               mNext;
+        size_t                          mPending;
+        mutex                           mMutex;
+        condition_variable              mDone;
+
+        //----------------------------------------------------------------//
+        void        drain       ();
+    };
+
+    mutex                                   mMutex;
+    condition_variable                      mWake;
+    deque < shared_ptr < Batch >>           mQueue;
+    vector < thread >                       mThreads;
+    bool                                    mStop;
+
+    //----------------------------------------------------------------//
+    void            work                    ();
+
+public:
+
+    //----------------------------------------------------------------//
+    size_t          countThreads            () const;
+    void            parallelFor             ( size_t count, const function < void ( size_t )>& task );
+                    TheWorkerPool           ();
+                    ~TheWorkerPool          ();
+};
+
+} // namespace Volition
+#endif
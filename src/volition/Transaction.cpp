@@ -57,7 +57,7 @@ TransactionResult Transaction::applyInner ( AbstractLedger& ledger, u64 blockHei
         
         TransactionContext context ( ledger, accountODBM, keyAndPolicy, blockHeight, release, index, time );
         
-        const TransactionFeeProfile& feeProfile = context.mFeeSchedule.getFeeProfile ( this->getTypeString ());
+        const TransactionFeeProfile& feeProfile = context.mFeeSchedule->getFeeProfile ( this->getTypeString ());
         
         if ( !feeProfile.checkProfitShare ( maker->getGratuity (), maker->getProfitShare ())) return "Incorrect profit share.";
         if ( !feeProfile.checkTransferTax ( this->mBody->getVOL ( context ), maker->getTransferTax ())) return "Incorrect transfer tax.";
@@ -120,13 +120,21 @@ TransactionResult Transaction::checkNonceAndSignature ( const AbstractLedger& le
     if ( nonce != this->getNonce ()) return false;
 
     if ( policy & Block::VERIFY_TRANSACTION_SIG ) {
-    
-        Signature* signature = this->mSignature.get ();
-        return signature ? key.verify ( *signature, this->mBodyString ) : false;
+        return this->verifySignature ( key );
     }
     return true;
 }
 
+//----------------------------------------------------------------//
+TransactionAccessSet Transaction::getAccessSet () const {
+
+    if ( this->mBody ) return this->mBody->getAccessSet ();
+
+    TransactionAccessSet accessSet;
+    accessSet.mGlobal = true;
+    return accessSet;
+}
+
 //----------------------------------------------------------------//
 TransactionDetailsPtr Transaction::getDetails ( const AbstractLedger& ledger ) const {
 
@@ -155,6 +163,13 @@ Transaction::Transaction () {
 Transaction::~Transaction () {
 }
 
+//----------------------------------------------------------------//
+bool Transaction::verifySignature ( const CryptoPublicKey& key ) const {
+
+    Signature* signature = this->mSignature.get ();
+    return signature ? key.verify ( *signature, this->mBodyString ) : false;
+}
+
 //================================================================//
 // overrides
 //================================================================//
@@ -172,7 +187,7 @@ void Transaction::AbstractSerializable_serializeFrom ( const AbstractSerializerF
     else {
         serializer.serialize ( "body", this->mBodyString );
         if ( this->mBodyString.size ()) {
-            FromJSONSerializer::fromJSONString ( this->mBody, this->mBodyString );
+            FromJSONStreamSerializer::fromJSONString ( this->mBody, this->mBodyString );
             assert ( this->mBody );
         }
     }
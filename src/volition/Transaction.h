@@ -57,11 +57,13 @@ public:
     TransactionResult           apply                       ( AbstractLedger& ledger, u64 blockHeight, u64 release, u64 index, time_t time, Block::VerificationPolicy policy ) const;
     bool                        checkMaker                  ( string accountName, string uuid ) const;
     TransactionResult           checkNonceAndSignature      ( const AbstractLedger& ledger, AccountID accountID, const CryptoPublicKey& key, Block::VerificationPolicy policy ) const;
+    TransactionAccessSet        getAccessSet                () const;
     TransactionDetailsPtr       getDetails                  ( const AbstractLedger& ledger ) const;
     void                        setBody                     ( shared_ptr < AbstractTransactionBody > body );
     void                        sign                        ( const CryptoKeyPair& keyPair );
                                 Transaction                 ();
                                 ~Transaction                ();
+    bool                        verifySignature             ( const CryptoPublicKey& key ) const;
 };
 
 } // namespace Volition
@@ -0,0 +1,44 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_TRANSACTIONACCESSSET_H
+#define VOLITION_TRANSACTIONACCESSSET_H
+
+#include <volition/common.h>
+
+namespace Volition {
+
+//================================================================//
+// TransactionAccessSet
+//================================================================//
+// What a transaction body may write when applied, declared up front so that
+// transactions in the same batch can be checked for conflicts without
+// running them. Declarations must be conservative: anything a body can't
+// bound statically goes in as mAllAccounts or mGlobal. The maker's account
+// is always included by AbstractTransactionBody::getAccessSet ().
+class TransactionAccessSet {
+public:
+
+    bool                        mGlobal;        // may write anything, including keys, names and ledger-wide settings
+    bool                        mAllAccounts;   // may write any account's funds, inventory or log (but not its keys)
+    set < string >              mAccounts;      // accounts whose funds, inventory, nonce or log are written
+    set < string >              mKeys;          // accounts whose keys, policies, miner info or name are written
+
+    //----------------------------------------------------------------//
+    void merge ( const TransactionAccessSet& other ) {
+
+        this->mGlobal = this->mGlobal || other.mGlobal;
+        this->mAllAccounts = this->mAllAccounts || other.mAllAccounts;
+        this->mAccounts.insert ( other.mAccounts.cbegin (), other.mAccounts.cend ());
+        this->mKeys.insert ( other.mKeys.cbegin (), other.mKeys.cend ());
+    }
+
+    //----------------------------------------------------------------//
+    TransactionAccessSet () :
+        mGlobal ( false ),
+        mAllAccounts ( false ) {
+    }
+};
+
+} // namespace Volition
+#endif
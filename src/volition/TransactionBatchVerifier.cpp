@@ -0,0 +1,160 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <volition/AccountODBM.h>
+#include <volition/Metrics.h>
+#include <volition/Transaction.h>
+#include <volition/TransactionAccessSet.h>
+#include <volition/TransactionBatchVerifier.h>
+#include <volition/TransactionMaker.h>
+#include <volition/TheWorkerPool.h>
+
+namespace Volition {
+
+//================================================================//
+// TransactionBatchVerifier
+//================================================================//
+
+//----------------------------------------------------------------//
+void TransactionBatchVerifier::addWrites ( const AbstractLedger& ledger, const Transaction& transaction, TransactionAccessSet& written, set < AccountID::Index >& keysWritten ) {
+
+    TransactionAccessSet accessSet = transaction.getAccessSet ();
+    written.merge ( accessSet );
+
+    // names are resolved against the ledger as it stands, so every alias of an account collides.
+    // a name that doesn't resolve yet can't be a maker the verifier would check anyway.
+    set < string >::const_iterator keyIt = accessSet.mKeys.cbegin ();
+    for ( ; keyIt != accessSet.mKeys.cend (); ++keyIt ) {
+        AccountID accountID = ledger.getAccountID ( *keyIt );
+        if ( accountID != AccountID::NULL_INDEX ) {
+            keysWritten.insert ( accountID );
+        }
+    }
+}
+
+//----------------------------------------------------------------//
+Block::VerificationPolicy TransactionBatchVerifier::getPolicy ( const Transaction& transaction, Block::VerificationPolicy policy ) const {
+
+    if ( this->mVerified.find ( &transaction ) == this->mVerified.cend ()) return policy;
+    return ( Block::VerificationPolicy )( policy & ~Block::VERIFY_TRANSACTION_SIG );
+}
+
+//----------------------------------------------------------------//
+size_t TransactionBatchVerifier::getTotalVerified () const {
+
+    return this->mVerified.size ();
+}
+
+//----------------------------------------------------------------//
+TransactionBatchVerifier::TransactionBatchVerifier () {
+}
+
+//----------------------------------------------------------------//
+TransactionBatchVerifier::~TransactionBatchVerifier () {
+}
+
+//----------------------------------------------------------------//
+void TransactionBatchVerifier::verify ( const AbstractLedger& ledger, const vector < const Transaction* >& transactions, Ordering ordering, Block::VerificationPolicy policy ) {
+
+    this->mVerified.clear ();
+
+    if ( ledger.isGenesis ()) return;
+    if ( !( policy & Block::VERIFY_TRANSACTION_SIG )) return;
+
+    TheWorkerPool& pool = TheWorkerPool::get ();
+
+    size_t totalJobs = pool.countThreads () + 1;
+    if (( totalJobs <= 1 ) || ( transactions.size () < ( MIN_SIGNATURES_PER_JOB * 2 ))) return;
+
+    VOL_METRIC_SPAN ( "volition_transaction_batch_verify_seconds", "Wall time to check a batch of transaction signatures ahead of applying them." );
+
+    // everything that may be written ahead of the transaction being planned. in block order that's
+    // whatever precedes it; in any order it's the whole batch.
+    TransactionAccessSet written;
+    set < AccountID::Index > keysWritten;
+    if ( ordering == ANY_ORDER ) {
+        for ( size_t i = 0; i < transactions.size (); ++i ) {
+            if ( transactions [ i ]) {
+                TransactionBatchVerifier::addWrites ( ledger, *transactions [ i ], written, keysWritten );
+            }
+        }
+    }
+
+    vector < Job > jobs;
+    jobs.reserve ( transactions.size ());
+
+    for ( size_t i = 0; ( i < transactions.size ()) && !written.mGlobal; ++i ) {
+
+        const Transaction* transaction = transactions [ i ];
+        if ( !transaction ) continue;
+
+        const TransactionMaker* maker = transaction->getMaker ();
+        if ( maker ) {
+
+            try {
+                AccountODBM accountODBM ( ledger, maker->getAccountName ());
+                if ( accountODBM && ( keysWritten.find ( accountODBM.mAccountID ) == keysWritten.cend ())) {
+                    KeyAndPolicy keyAndPolicy = accountODBM.getKeyAndPolicyOrNull ( maker->getKeyName ());
+                    if ( keyAndPolicy ) {
+
+                        Job job;
+                        job.mTransaction    = transaction;
+                        job.mKey            = keyAndPolicy.mKey;
+                        job.mVerified       = false;
+                        jobs.push_back ( job );
+                    }
+                }
+            }
+            catch ( ... ) {
+                // leave it to the inline check, which reports the error in context.
+            }
+        }
+
+        if ( ordering == IN_ORDER ) {
+            TransactionBatchVerifier::addWrites ( ledger, *transaction, written, keysWritten );
+        }
+    }
+
+    size_t maxJobs = jobs.size () / MIN_SIGNATURES_PER_JOB;
+    if ( maxJobs < totalJobs ) {
+        totalJobs = maxJobs;
+    }
+    if ( totalJobs <= 1 ) return;
+
+    // each job checks its own slice; nothing is shared but the (read-only) transactions.
+    size_t chunkSize = ( jobs.size () + totalJobs - 1 ) / totalJobs;
+    pool.parallelFor ( totalJobs, [ & ]( size_t i ) {
+
+        size_t base = i * chunkSize;
+        size_t top = ( base + chunkSize ) < jobs.size () ? ( base + chunkSize ) : jobs.size ();
+        if ( base < top ) {
+            TransactionBatchVerifier::verifyRange ( jobs, base, top );
+        }
+    });
+
+    for ( size_t i = 0; i < jobs.size (); ++i ) {
+        if ( jobs [ i ].mVerified ) {
+            this->mVerified.insert ( jobs [ i ].mTransaction );
+        }
+    }
+
+    VOL_METRIC_COUNT_LABELED ( "volition_transaction_batch_signatures_total", "Transaction signatures checked ahead of applying, by result.", "result=\"verified\"", this->mVerified.size ());
+    VOL_METRIC_COUNT_LABELED ( "volition_transaction_batch_signatures_total", "Transaction signatures checked ahead of applying, by result.", "result=\"rejected\"", jobs.size () - this->mVerified.size ());
+}
+
+//----------------------------------------------------------------//
+void TransactionBatchVerifier::verifyRange ( vector < Job >& jobs, size_t base, size_t top ) {
+
+    for ( size_t i = base; i < top; ++i ) {
+
+        Job& job = jobs [ i ];
+        try {
+            job.mVerified = job.mTransaction->verifySignature ( job.mKey );
+        }
+        catch ( ... ) {
+            job.mVerified = false;
+        }
+    }
+}
+
+} // namespace Volition
@@ -0,0 +1,69 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_TRANSACTIONBATCHVERIFIER_H
+#define VOLITION_TRANSACTIONBATCHVERIFIER_H
+
+#include <volition/common.h>
+#include <volition/Block.h>
+#include <volition/CryptoKey.h>
+#include <volition/Ledger.h>
+#include <unordered_set>
+
+namespace Volition {
+
+class Transaction;
+class TransactionAccessSet;
+
+//================================================================//
+// TransactionBatchVerifier
+//================================================================//
+// Checks the signatures of a batch of transactions in parallel, ahead of
+// applying them one at a time. Signature checks are the bulk of the cost of
+// applying a typical transaction and only read the maker's key, so any
+// transaction whose maker's keys can't be touched by another transaction in
+// the batch (per their declared access sets) is checked against the ledger
+// as it stands before the batch. Everything else is left to the usual
+// inline check when it's applied. Ledger writes stay serial and in order,
+// so the result is exactly what applying without a verifier produces; a
+// signature that fails here is simply checked again inline, so it fails
+// with the same result too.
+class TransactionBatchVerifier {
+public:
+
+    enum Ordering {
+        IN_ORDER,       // transactions will be applied in the order given
+        ANY_ORDER,      // transactions may be applied in any order, or not at all
+    };
+
+private:
+
+    static const size_t MIN_SIGNATURES_PER_JOB    = 8;
+
+    //----------------------------------------------------------------//
+    class Job {
+    public:
+
+        const Transaction*      mTransaction;
+        CryptoPublicKey         mKey;
+        bool                    mVerified;
+    };
+
+    unordered_set < const Transaction* >    mVerified;
+
+    //----------------------------------------------------------------//
+    static void         addWrites                       ( const AbstractLedger& ledger, const Transaction& transaction, TransactionAccessSet& written, set < AccountID::Index >& keysWritten );
+    static void         verifyRange                     ( vector < Job >& jobs, size_t base, size_t top );
+
+public:
+
+    //----------------------------------------------------------------//
+    Block::VerificationPolicy   getPolicy                       ( const Transaction& transaction, Block::VerificationPolicy policy ) const;
+    size_t                      getTotalVerified                () const;
+                                TransactionBatchVerifier        ();
+                                ~TransactionBatchVerifier       ();
+    void                        verify                          ( const AbstractLedger& ledger, const vector < const Transaction* >& transactions, Ordering ordering, Block::VerificationPolicy policy );
+};
+
+} // namespace Volition
+#endif
@@ -3,6 +3,7 @@
 
 #include <volition/Ledger.h>
 #include <volition/LedgerFieldODBM.h>
+#include <volition/TheTransactionContextCache.h>
 #include <volition/TransactionContext.h>
 
 namespace Volition {
@@ -35,16 +36,19 @@ TransactionContext::TransactionContext ( AbstractLedger& ledger, AccountODBM& ac
     mIndex ( index ),
     mTime ( time ) {
     
+    // resolved entitlements and the fee schedule are shared, read-only, across every transaction with the same inputs.
+    TheTransactionContextCache& cache = TheTransactionContextCache::get ();
+    
     if ( ledger.isGenesis ()) {
-        this->mAccountEntitlements = *AccountEntitlements::getMasterEntitlements ();
-        this->mKeyEntitlements = *KeyEntitlements::getMasterEntitlements ();
+        this->mAccountEntitlements = cache.getMasterEntitlements < AccountEntitlements >();
+        this->mKeyEntitlements = cache.getMasterEntitlements < KeyEntitlements >();
     }
     else {
-        this->mAccountEntitlements = ledger.getEntitlements < AccountEntitlements >( *accountODBM.mBody.get ());
-        this->mKeyEntitlements = ledger.getEntitlements < KeyEntitlements >( keyAndPolicy );
+        this->mAccountEntitlements = cache.getEntitlements < AccountEntitlements >( ledger, this->mAccount.mPolicy );
+        this->mKeyEntitlements = cache.getEntitlements < KeyEntitlements >( ledger, keyAndPolicy.mPolicy );
     }
     
-    this->mFeeSchedule = ledger.getTransactionFeeSchedule ();
+    this->mFeeSchedule = cache.getFeeSchedule ( ledger );
 }
 
 } // namespace Volition
@@ -7,6 +7,7 @@
 #include <volition/common.h>
 #include <volition/AccountEntitlements.h>
 #include <volition/AccountODBM.h>
+#include <volition/CompiledEntitlements.h>
 #include <volition/TransactionFeeSchedule.h>
 #include <volition/KeyEntitlements.h>
 #include <volition/serialization/Serialization.h>
@@ -24,18 +25,18 @@ class Ledger;
 class TransactionContext {
 public:
 
-    const Account           mAccount;
-    AccountID               mAccountID;
-    Entitlements            mAccountEntitlements;
-    AccountODBM&            mAccountODBM;
-    TransactionFeeSchedule  mFeeSchedule;
-    const KeyAndPolicy&     mKeyAndPolicy;
-    Entitlements            mKeyEntitlements;
-    AbstractLedger&         mLedger;
-    u64                     mBlockHeight;
-    u64                     mRelease;
-    u64                     mIndex;
-    time_t                  mTime;
+    const Account                                   mAccount;
+    AccountID                                       mAccountID;
+    shared_ptr < const CompiledEntitlements >       mAccountEntitlements;
+    AccountODBM&                                    mAccountODBM;
+    shared_ptr < const TransactionFeeSchedule >     mFeeSchedule;
+    const KeyAndPolicy&                             mKeyAndPolicy;
+    shared_ptr < const CompiledEntitlements >       mKeyEntitlements;
+    AbstractLedger&                                 mLedger;
+    u64                                             mBlockHeight;
+    u64                                             mRelease;
+    u64                                             mIndex;
+    time_t                                          mTime;
 
     //----------------------------------------------------------------//
     LedgerResult            pushAccountLogEntry         ();
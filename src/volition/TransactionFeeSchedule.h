@@ -74,7 +74,7 @@ public:
     }
     
     //----------------------------------------------------------------//
-    TransactionFeeProfile getFeeProfile ( string feeType ) {
+    TransactionFeeProfile getFeeProfile ( string feeType ) const {
         
         SerializableMap < string, TransactionFeeProfile >::const_iterator profileIt = this->mTransactionProfiles.find ( feeType );
         if ( profileIt != this->mTransactionProfiles.cend ()) return profileIt->second;
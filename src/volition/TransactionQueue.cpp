@@ -3,7 +3,10 @@
 
 #include <volition/AccountODBM.h>
 #include <volition/Block.h>
+#include <volition/LedgerWriteOverlay.h>
+#include <volition/Metrics.h>
 #include <volition/Transaction.h>
+#include <volition/TransactionBatchVerifier.h>
 #include <volition/TransactionQueue.h>
 
 namespace Volition {
@@ -162,6 +165,7 @@ void MakerQueue::setTransactionResult ( TransactionResult result ) {
 void TransactionQueue::acceptTransaction ( shared_ptr < const Transaction > transaction ) {
 
     LGN_LOG_SCOPE ( VOL_FILTER_TRANSACTION_QUEUE, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_COUNT ( "volition_transactions_accepted_total", "Transactions accepted into the transaction queue.", 1 );
 
     const TransactionMaker* maker = transaction->getMaker ();
     assert ( maker );
@@ -173,6 +177,7 @@ void TransactionQueue::acceptTransaction ( shared_ptr < const Transaction > tran
 void TransactionQueue::fillBlock ( Ledger& chain, Block& block, Block::VerificationPolicy policy, u64 minimumGratuity ) {
 
     LGN_LOG_SCOPE ( VOL_FILTER_TRANSACTION_QUEUE, INFO, __PRETTY_FUNCTION__ );
+    VOL_METRIC_SPAN ( "volition_transaction_queue_fill_block_seconds", "Wall time to fill a block from the transaction queue." );
 
     Ledger ledger = chain;
 
@@ -184,6 +189,24 @@ void TransactionQueue::fillBlock ( Ledger& chain, Block& block, Block::Verificat
 
     map < string, MakerQueueInfo > infoCache;
 
+    // check signatures of everything that might go into the block in parallel, up front. the
+    // order transactions get picked in isn't known yet, so plan for any order.
+    vector < const Transaction* > candidates;
+    MakerQueueConstIt makerQueueConstIt = this->mDatabase.cbegin ();
+    for ( ; makerQueueConstIt != this->mDatabase.cend (); ++makerQueueConstIt ) {
+    
+        const MakerQueue& makerQueue = makerQueueConstIt->second;
+        if ( makerQueue.isBlocked ()) continue;
+        
+        MakerQueue::TransactionQueueConstIt transactionIt = makerQueue.mQueue.cbegin ();
+        for ( ; transactionIt != makerQueue.mQueue.cend (); ++transactionIt ) {
+            candidates.push_back ( transactionIt->second.get ());
+        }
+    }
+    
+    TransactionBatchVerifier verifier;
+    verifier.verify ( ledger, candidates, TransactionBatchVerifier::ANY_ORDER, policy );
+
     bool more = true;
     while ( more ) {
 
@@ -242,13 +265,14 @@ void TransactionQueue::fillBlock ( Ledger& chain, Block& block, Block::Verificat
             
             if (( blockWeight + transactionWeight ) > maxBlockWeight ) continue;
             
-            // push a version in case the transaction fails
-            ledger.pushVersion ();
+            // buffer the transaction's writes; if it fails, they're simply dropped.
+            LedgerWriteOverlay overlay ( ledger );
             
-            TransactionResult result = transaction->apply ( ledger, blockHeight, release, transactionIndex, block.getTime (), policy );
+            TransactionResult result = transaction->apply ( ledger, blockHeight, release, transactionIndex, block.getTime (), verifier.getPolicy ( *transaction, policy ));
             
             if ( result ) {
                 // transaction succeeded!
+                overlay.commit ();
                 block.pushTransaction ( transaction );
                 transactionIndex++;
                 blockWeight += transactionWeight;
@@ -259,7 +283,7 @@ void TransactionQueue::fillBlock ( Ledger& chain, Block& block, Block::Verificat
             }
             else {
                 makerQueue.setTransactionResult ( result );
-                ledger.popVersion ();
+                overlay.discard ();
             }
         }
     }
@@ -23,9 +23,13 @@ public:
         
         if ( !this->mOperand ) return AssetFieldValue ();
         
-        AssetFieldValue val = this->mOperand->evaluate ( context );
+        return UnarySquap::apply ( this->mOpCode, this->mOperand->evaluate ( context ));
+    }
+    
+    //----------------------------------------------------------------//
+    static AssetFieldValue apply ( OpCode opCode, const AssetFieldValue& val ) {
         
-        switch ( this->mOpCode ) {
+        switch ( opCode ) {
             
             case LENGTH:
                 return AssetFieldValue::length ( val );
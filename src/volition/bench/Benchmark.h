@@ -0,0 +1,265 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_BENCH_BENCHMARK_H
+#define VOLITION_BENCH_BENCHMARK_H
+
+#include <volition/common.h>
+#include <volition/Accessors.h>
+#include <volition/Format.h>
+#include <volition/serialization/Serialization.h>
+#include <algorithm>
+#include <atomic>
+
+namespace Volition {
+namespace Bench {
+
+//================================================================//
+// AllocationCounter
+//================================================================//
+// Process-wide allocation tally. volition-bench replaces the global operator
+// new/delete to bump these; anywhere else they just stay at zero.
+class AllocationCounter {
+public:
+
+    static inline atomic < u64 >    sCount { 0 };
+    static inline atomic < u64 >    sBytes { 0 };
+
+    //----------------------------------------------------------------//
+    static void record ( size_t size ) {
+        sCount.fetch_add ( 1, memory_order_relaxed );
+        sBytes.fetch_add ( size, memory_order_relaxed );
+    }
+};
+
+//================================================================//
+// BenchmarkResult
+//================================================================//
+class BenchmarkResult :
+    public AbstractSerializable {
+public:
+
+    string      mName;
+    u64         mIterations;
+    double      mOpsPerSecond;
+    double      mMeanNanos;
+    double      mP50Nanos;
+    double      mP99Nanos;
+    double      mAllocsPerOp;
+    double      mBytesPerOp;
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeFrom ( const AbstractSerializerFrom& serializer ) override {
+
+        serializer.serialize ( "name",              this->mName );
+        serializer.serialize ( "iterations",        this->mIterations );
+        serializer.serialize ( "opsPerSecond",      this->mOpsPerSecond );
+        serializer.serialize ( "meanNanos",         this->mMeanNanos );
+        serializer.serialize ( "p50Nanos",          this->mP50Nanos );
+        serializer.serialize ( "p99Nanos",          this->mP99Nanos );
+        serializer.serialize ( "allocsPerOp",       this->mAllocsPerOp );
+        serializer.serialize ( "bytesPerOp",        this->mBytesPerOp );
+    }
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeTo ( AbstractSerializerTo& serializer ) const override {
+
+        serializer.serialize ( "name",              this->mName );
+        serializer.serialize ( "iterations",        this->mIterations );
+        serializer.serialize ( "opsPerSecond",      this->mOpsPerSecond );
+        serializer.serialize ( "meanNanos",         this->mMeanNanos );
+        serializer.serialize ( "p50Nanos",          this->mP50Nanos );
+        serializer.serialize ( "p99Nanos",          this->mP99Nanos );
+        serializer.serialize ( "allocsPerOp",       this->mAllocsPerOp );
+        serializer.serialize ( "bytesPerOp",        this->mBytesPerOp );
+    }
+
+    //----------------------------------------------------------------//
+    BenchmarkResult () :
+        mIterations ( 0 ),
+        mOpsPerSecond ( 0.0 ),
+        mMeanNanos ( 0.0 ),
+        mP50Nanos ( 0.0 ),
+        mP99Nanos ( 0.0 ),
+        mAllocsPerOp ( 0.0 ),
+        mBytesPerOp ( 0.0 ) {
+    }
+};
+
+//================================================================//
+// BenchmarkReport
+//================================================================//
+class BenchmarkReport :
+    public AbstractSerializable {
+public:
+
+    string                                  mVersion;
+    SerializableVector < BenchmarkResult >  mResults;
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeFrom ( const AbstractSerializerFrom& serializer ) override {
+
+        serializer.serialize ( "version",           this->mVersion );
+        serializer.serialize ( "results",           this->mResults );
+    }
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeTo ( AbstractSerializerTo& serializer ) const override {
+
+        serializer.serialize ( "version",           this->mVersion );
+        serializer.serialize ( "results",           this->mResults );
+    }
+};
+
+//================================================================//
+// Benchmark
+//================================================================//
+// Runs each registered case until it has used up the time budget (or hit the
+// iteration cap), timing every iteration on its own. The setup function runs
+// before each iteration and is not timed; use it to fork a ledger or rebuild
+// whatever the case consumes, so every iteration sees identical input.
+class Benchmark {
+public:
+
+    typedef std::function < void ()> Func;
+
+private:
+
+    //----------------------------------------------------------------//
+    class Case {
+    public:
+
+        string      mName;
+        Func        mSetup;
+        Func        mRun;
+    };
+
+    vector < Case >     mCases;
+
+    double              mMinSeconds;
+    u64                 mMinIterations;
+    u64                 mMaxIterations;
+    u64                 mWarmupIterations;
+
+    //----------------------------------------------------------------//
+    static double percentile ( const vector < u64 >& sorted, double p ) {
+
+        if ( sorted.size () == 0 ) return 0.0;
+        size_t index = ( size_t )( p * ( double )( sorted.size () - 1 ) + 0.5 );
+        return ( double )sorted [ index ];
+    }
+
+    //----------------------------------------------------------------//
+    BenchmarkResult runCase ( const Case& benchCase ) const {
+
+        typedef chrono::steady_clock Clock;
+
+        for ( u64 i = 0; i < this->mWarmupIterations; ++i ) {
+            if ( benchCase.mSetup ) benchCase.mSetup ();
+            benchCase.mRun ();
+        }
+
+        vector < u64 > samples;
+        u64 totalNanos = 0;
+        u64 totalAllocs = 0;
+        u64 totalBytes = 0;
+        u64 budgetNanos = ( u64 )( this->mMinSeconds * 1e9 );
+
+        while (( samples.size () < this->mMaxIterations ) && (( samples.size () < this->mMinIterations ) || ( totalNanos < budgetNanos ))) {
+
+            if ( benchCase.mSetup ) benchCase.mSetup ();
+
+            u64 allocs0 = AllocationCounter::sCount.load ( memory_order_relaxed );
+            u64 bytes0 = AllocationCounter::sBytes.load ( memory_order_relaxed );
+            Clock::time_point t0 = Clock::now ();
+
+            benchCase.mRun ();
+
+            Clock::time_point t1 = Clock::now ();
+            totalAllocs += AllocationCounter::sCount.load ( memory_order_relaxed ) - allocs0;
+            totalBytes += AllocationCounter::sBytes.load ( memory_order_relaxed ) - bytes0;
+
+            u64 nanos = ( u64 )chrono::duration_cast < chrono::nanoseconds >( t1 - t0 ).count ();
+            samples.push_back ( nanos );
+            totalNanos += nanos;
+        }
+
+        sort ( samples.begin (), samples.end ());
+
+        double iterations = ( double )samples.size ();
+
+        BenchmarkResult result;
+        result.mName            = benchCase.mName;
+        result.mIterations      = samples.size ();
+        result.mOpsPerSecond    = totalNanos ? ( iterations * 1e9 ) / ( double )totalNanos : 0.0;
+        result.mMeanNanos       = iterations > 0.0 ? ( double )totalNanos / iterations : 0.0;
+        result.mP50Nanos        = Benchmark::percentile ( samples, 0.50 );
+        result.mP99Nanos        = Benchmark::percentile ( samples, 0.99 );
+        result.mAllocsPerOp     = iterations > 0.0 ? ( double )totalAllocs / iterations : 0.0;
+        result.mBytesPerOp      = iterations > 0.0 ? ( double )totalBytes / iterations : 0.0;
+        return result;
+    }
+
+public:
+
+    GET_SET ( double,   MinSeconds,         mMinSeconds )
+    GET_SET ( u64,      MinIterations,      mMinIterations )
+    GET_SET ( u64,      MaxIterations,      mMaxIterations )
+    GET_SET ( u64,      WarmupIterations,   mWarmupIterations )
+
+    //----------------------------------------------------------------//
+    void add ( string name, Func run ) {
+
+        this->add ( name, Func (), run );
+    }
+
+    //----------------------------------------------------------------//
+    void add ( string name, Func setup, Func run ) {
+
+        Case benchCase;
+        benchCase.mName     = name;
+        benchCase.mSetup    = setup;
+        benchCase.mRun      = run;
+        this->mCases.push_back ( benchCase );
+    }
+
+    //----------------------------------------------------------------//
+    Benchmark () :
+        mMinSeconds ( 1.0 ),
+        mMinIterations ( 10 ),
+        mMaxIterations ( 1000000 ),
+        mWarmupIterations ( 3 ) {
+    }
+
+    //----------------------------------------------------------------//
+    static string format ( const BenchmarkResult& result ) {
+
+        return Format::write ( "%-40s %10llu iters %14.1f ops/s   p50 %12.0f ns   p99 %12.0f ns   %10.1f allocs/op %12.0f B/op",
+            result.mName.c_str (),
+            ( unsigned long long )result.mIterations,
+            result.mOpsPerSecond,
+            result.mP50Nanos,
+            result.mP99Nanos,
+            result.mAllocsPerOp,
+            result.mBytesPerOp
+        );
+    }
+
+    //----------------------------------------------------------------//
+    void run ( BenchmarkReport& report, string filter = "" ) const {
+
+        for ( size_t i = 0; i < this->mCases.size (); ++i ) {
+
+            const Case& benchCase = this->mCases [ i ];
+            if ( filter.size () && ( benchCase.mName.find ( filter ) == string::npos )) continue;
+
+            BenchmarkResult result = this->runCase ( benchCase );
+            printf ( "%s\n", Benchmark::format ( result ).c_str ());
+            report.mResults.push_back ( result );
+        }
+    }
+};
+
+} // namespace Bench
+} // namespace Volition
+#endif
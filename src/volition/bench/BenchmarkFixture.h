@@ -0,0 +1,217 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_BENCH_BENCHMARKFIXTURE_H
+#define VOLITION_BENCH_BENCHMARKFIXTURE_H
+
+#include <volition/common.h>
+#include <volition/Block.h>
+#include <volition/CryptoKey.h>
+#include <volition/Ledger.h>
+#include <volition/Miner.h>
+#include <volition/Schema.h>
+#include <volition/simulation/SimTransaction.h>
+
+namespace Volition {
+namespace Bench {
+
+#define BENCH_JSON_STR(...) #__VA_ARGS__
+
+static const char* BENCH_SCHEMA_JSON = BENCH_JSON_STR (
+    {
+        "definitions": {
+            "common": {
+                "fields": {
+                    "name": { "type": "STRING", "value": "Common", "mutable": false }
+                }
+            },
+            "pack": {
+                "fields": {
+                    "name": { "type": "STRING", "value": "Pack", "mutable": false }
+                }
+            }
+        },
+        "methods": {
+            "openPack": {
+                "weight": 1,
+                "maturity": 0,
+                "friendlyName": "",
+                "description": "",
+                "assetArgs": {
+                    "pack": {
+                        "qualifier": {
+                            "op": "EQUAL",
+                            "left": { "op": "INDEX", "paramID": "", "value": "@" },
+                            "right": { "op": "CONST", "const": { "type": "STRING", "value": "pack" }}
+                        }
+                    }
+                },
+                "constArgs": {},
+                "constraints": [],
+                "lua": "function main ( caller, assetArgs, constArgs )\r\n    awardAsset ( caller, 'common', 3 )\r\n    revokeAsset ( assetArgs.pack.assetID )\r\nend"
+            }
+        },
+        "version": {
+            "release": "bench",
+            "major": 0,
+            "minor": 0,
+            "revision": 0
+        }
+    }
+);
+
+//================================================================//
+// BenchmarkFixture
+//================================================================//
+// A deterministic chain for the ledger benchmarks: a genesis block with
+// TOTAL_ACCOUNTS funded accounts (account 0 is the miner), the bench schema,
+// one 'common' for every account, a 'pack' for account 1 and a large
+// inventory on account 0. mLedger sits at height 1; fork it before
+// applying anything.
+class BenchmarkFixture {
+public:
+
+    enum Mix {
+        MIX_SEND_VOL,
+        MIX_SEND_ASSETS,
+        MIX_MIXED,
+    };
+
+    static const size_t     TOTAL_ACCOUNTS          = 257;
+    static const size_t     LARGE_INVENTORY         = 10000;
+    static const u64        GRANT                   = 1000000;
+    static const time_t     GENESIS_TIME            = 1577836800; // 2020-01-01
+
+    vector < CryptoKeyPair >        mKeys;
+    Signature                       mVisage;
+    shared_ptr < Block >            mGenesis;
+    shared_ptr < Ledger >           mLedger;
+    vector < string >               mCommons;       // one asset identifier per account
+    AssetID::Index                  mPack;
+
+    //----------------------------------------------------------------//
+    static string getAccountName ( size_t index ) {
+        return Format::write ( "account-%d", ( int )index );
+    }
+
+    //----------------------------------------------------------------//
+    shared_ptr < Block > makeBlock ( size_t totalTransactions, Mix mix, bool sign = false ) const {
+
+        assert ( totalTransactions < TOTAL_ACCOUNTS );
+
+        shared_ptr < Block > block = make_shared < Block >();
+        block->initialize ( getAccountName ( 0 ), 0, this->mVisage, GENESIS_TIME + 60, this->mGenesis.get (), this->mKeys [ 0 ]);
+        block->setBlockDelayInSeconds ( this->mLedger->getBlockDelayInSeconds ());
+        block->setRewriteWindow ( this->mLedger->getRewriteWindowInSeconds ());
+
+        for ( size_t i = 0; i < totalTransactions; ++i ) {
+            block->pushTransaction ( this->makeTransaction ( i + 1, mix, sign ));
+        }
+        block->sign ( this->mKeys [ 0 ], Digest::DEFAULT_HASH_ALGORITHM );
+        return block;
+    }
+
+    //----------------------------------------------------------------//
+    shared_ptr < Transaction > makeTransaction ( size_t sender, Mix mix, bool sign = false ) const {
+
+        string from     = getAccountName ( sender );
+        string to       = getAccountName (( sender % ( TOTAL_ACCOUNTS - 1 )) + 1 );
+        string uuid     = Format::write ( "bench-%d", ( int )sender );
+
+        bool sendAssets = ( mix == MIX_SEND_ASSETS ) || (( mix == MIX_MIXED ) && ( sender & 1 ));
+
+        shared_ptr < AbstractTransactionBody > body;
+
+        if ( sendAssets ) {
+            shared_ptr < Transactions::SendAssets > sendAssetsBody = make_shared < Transactions::SendAssets >();
+            sendAssetsBody->mAccountName = to;
+            sendAssetsBody->mAssetIdentifiers.push_back ( this->mCommons [ sender ]);
+            body = sendAssetsBody;
+        }
+        else {
+            body = Simulation::SimTransaction::makeBody_SendVOL ( to, 1 );
+        }
+
+        return sign ?
+            Simulation::SimTransaction::makeTransaction ( body, uuid, this->mKeys [ sender ], from ) :
+            Simulation::SimTransaction::makeTransaction ( body, uuid, from );
+    }
+
+    //----------------------------------------------------------------//
+    BenchmarkFixture () :
+        mPack ( AssetID::NULL_INDEX ) {
+
+        shared_ptr < Transactions::Genesis > genesisBody = make_shared < Transactions::Genesis >();
+        genesisBody->setIdentity ( "BENCH" );
+        genesisBody->setBlockDelayInSeconds ( 1 );
+        genesisBody->setRewriteWindowInSeconds ( 600 );
+        genesisBody->setMaxBlockWeight ( 1 << 20 );
+        genesisBody->mTotalVOL = GRANT * TOTAL_ACCOUNTS * 2;
+        genesisBody->mPrizePool = 0;
+
+        this->mKeys.resize ( TOTAL_ACCOUNTS );
+        for ( size_t i = 0; i < TOTAL_ACCOUNTS; ++i ) {
+
+            this->mKeys [ i ].elliptic ();
+
+            Transactions::GenesisAccount genesisAccount;
+            genesisAccount.mName    = getAccountName ( i );
+            genesisAccount.mKey     = this->mKeys [ i ].getPublicKey ();
+            genesisAccount.mGrant   = GRANT;
+
+            if ( i == 0 ) {
+                this->mVisage = Miner::calculateVisage ( this->mKeys [ i ]);
+                genesisAccount.mMinerInfo = make_shared < MinerInfo >( "http://127.0.0.1:9090", this->mKeys [ i ].getPublicKey (), "", this->mVisage );
+            }
+            genesisBody->pushAccount ( genesisAccount );
+        }
+
+        shared_ptr < Transaction > transaction = make_shared < Transaction >();
+        transaction->setBody ( genesisBody );
+
+        this->mGenesis = make_shared < Block >();
+        this->mGenesis->setBlockDelayInSeconds ( 1 );
+        this->mGenesis->setRewriteWindow ( 600 );
+        this->mGenesis->pushTransaction ( transaction );
+        this->mGenesis->affirmHash ();
+
+        this->mLedger = make_shared < Ledger >();
+        LedgerResult result = this->mLedger->pushBlock ( *this->mGenesis, Block::VerificationPolicy::NONE );
+        result.reportWithAssert ();
+
+        Schema schema;
+        FromJSONSerializer::fromJSONString ( schema, BENCH_SCHEMA_JSON );
+        this->mLedger->setSchema ( schema );
+
+        this->mCommons.resize ( TOTAL_ACCOUNTS );
+        for ( size_t i = 0; i < TOTAL_ACCOUNTS; ++i ) {
+
+            AccountID accountID = this->mLedger->getAccountID ( getAccountName ( i ));
+            this->mLedger->awardAssets ( accountID, "common", 1, GENESIS_TIME );
+
+            SerializableList < SerializableSharedConstPtr < Asset >> inventory;
+            this->mLedger->getInventory ( accountID, inventory );
+            assert ( inventory.size () == 1 );
+            this->mCommons [ i ] = AssetID::encode ( inventory.front ()->mAssetID.mIndex );
+        }
+
+        AccountID packOwner = this->mLedger->getAccountID ( getAccountName ( 1 ));
+        this->mLedger->awardAssets ( packOwner, "pack", 1, GENESIS_TIME );
+
+        SerializableList < SerializableSharedConstPtr < Asset >> inventory;
+        this->mLedger->getInventory ( packOwner, inventory );
+        SerializableList < SerializableSharedConstPtr < Asset >>::const_iterator assetIt = inventory.cbegin ();
+        for ( ; assetIt != inventory.cend (); ++assetIt ) {
+            if (( *assetIt )->mType == "pack" ) {
+                this->mPack = ( *assetIt )->mAssetID.mIndex;
+            }
+        }
+        assert ( this->mPack != AssetID::NULL_INDEX );
+
+        this->mLedger->awardAssets ( this->mLedger->getAccountID ( getAccountName ( 0 )), "common", LARGE_INVENTORY, GENESIS_TIME );
+    }
+};
+
+} // namespace Bench
+} // namespace Volition
+#endif
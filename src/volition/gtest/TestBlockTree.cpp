@@ -6,27 +6,119 @@
 #include <volition/CryptoKeyPair.h>
 #include <volition/Digest.h>
 #include <volition/FileSys.h>
+#include <volition/Format.h>
 #include <volition/InMemoryBlockTree.h>
+#include <volition/Ledger.h>
 #include <volition/Miner.h>
+#include <volition/SQLiteBlockStore.h>
 #include <volition/SQLiteBlockTree.h>
+#include <volition/Transactions.h>
 
 using namespace Volition;
 
-static cc8* SQLITE_FILE     = "sqlite-blocktree-test.db";
+static cc8* SQLITE_FILE             = "sqlite-blocktree-test.db";
+static cc8* SQLITE_COMPARE_FILE     = "sqlite-blocktree-compare.db";
+static cc8* SQLITE_STORE_FILE       = "sqlite-blockstore-test.db";
+
+//================================================================//
+// DebugBlockTree
+//================================================================//
+namespace Volition {
+class DebugBlockTree {
+public:
+
+    //----------------------------------------------------------------//
+    // the unmemoized comparison: findFork () over live cursors, scored the way
+    // AbstractBlockTree::compare () did before results were cached.
+    static int compareByFork ( const BlockTreeCursor& cursor0, const BlockTreeCursor& cursor1 ) {
+
+        BlockTreeFork fork;
+        cursor0.getTree ()->findFork ( fork, cursor0, cursor1 );
+
+        if ( fork.mStatus == BlockTreeFork::SAME ) return 0;
+        if ( fork.mStatus == BlockTreeFork::LEFT_DOMINANT_SUBSET ) return -1;
+        if ( fork.mStatus == BlockTreeFork::RIGHT_DOMINANT_SUBSET ) return 1;
+
+        size_t fullLength0  = fork.mSeg0.getFullLength ();
+        size_t fullLength1  = fork.mSeg1.getFullLength ();
+        size_t segLength    = fork.getSegLength ();
+
+        if (( segLength < fullLength0 ) && ( segLength < fork.mSeg0.getRewriteDefeatCount ())) return -1;
+        if (( segLength < fullLength1 ) && ( segLength < fork.mSeg1.getRewriteDefeatCount ())) return 1;
+
+        BlockTreeSegment::Iterator cursorIt0 = fork.mSeg0.mTail;
+        BlockTreeSegment::Iterator cursorIt1 = fork.mSeg1.mTail;
+
+        int tieBreaker = 0;
+        int score = 0;
+
+        for ( size_t i = 0; i < segLength; ++i ) {
+            tieBreaker = BlockHeader::compare ( cursorIt0->getHeader (), cursorIt1->getHeader ());
+            score += tieBreaker;
+            --cursorIt0;
+            --cursorIt1;
+        }
+        return score == 0 ? tieBreaker : ( score < 0 ? -1 : 1 );
+    }
+};
+} // namespace Volition
 
 //----------------------------------------------------------------//
 shared_ptr < Block >    makeBlock           ( string minerID, const Digest& visage, time_t now, const BlockHeader* prevBlock, const CryptoKeyPair& key );
+shared_ptr < Block >    makeGenesis         ( string minerID, const Signature& visage, const CryptoKeyPair& key );
+BlockTreeCursor         rankBranches        ( const list < BlockTreeCursor >& leaves );
 void                    standardTest        ( AbstractBlockTree& tree );
 
 //----------------------------------------------------------------//
 shared_ptr < Block > makeBlock ( string minerID, const Digest& visage, time_t now, const BlockHeader* prevBlock, const CryptoKeyPair& key ) {
 
     shared_ptr < Block > block = make_shared < Block >();
-    block->initialize ( minerID, visage, now, prevBlock, key );
+    block->initialize ( minerID, 0, visage, now, prevBlock, key );
     block->sign ( key );
     return block;
 }
 
+//----------------------------------------------------------------//
+shared_ptr < Block > makeGenesis ( string minerID, const Signature& visage, const CryptoKeyPair& key ) {
+
+    shared_ptr < Transactions::Genesis > body = make_shared < Transactions::Genesis >();
+    body->setIdentity ( "TEST" );
+    body->setBlockDelayInSeconds ( 1 );
+    body->setRewriteWindowInSeconds ( 10 );
+    body->setMaxBlockWeight ( 1024 );
+    
+    Transactions::GenesisAccount account;
+    account.mName       = minerID;
+    account.mKey        = key.getPublicKey ();
+    account.mGrant      = 0;
+    account.mMinerInfo  = make_shared < MinerInfo >( "http://127.0.0.1", key.getPublicKey (), "", visage );
+    body->pushAccount ( account );
+    
+    shared_ptr < Transaction > transaction = make_shared < Transaction >();
+    transaction->setBody ( body );
+
+    shared_ptr < Block > genesis = make_shared < Block >();
+    genesis->setBlockDelayInSeconds ( 1 );
+    genesis->setRewriteWindow ( 10 );
+    genesis->pushTransaction ( transaction );
+    genesis->affirmHash ();
+    return genesis;
+}
+
+//----------------------------------------------------------------//
+BlockTreeCursor rankBranches ( const list < BlockTreeCursor >& leaves ) {
+
+    // same ranking loop as Miner::updateBestBranch ().
+    BlockTreeCursor bestCursor;
+    list < BlockTreeCursor >::const_iterator leafIt = leaves.cbegin ();
+    for ( ; leafIt != leaves.cend (); ++leafIt ) {
+        if ( !bestCursor.hasHeader () || ( BlockTreeCursor::compare ( *leafIt, bestCursor ) < 0 )) {
+            bestCursor = *leafIt;
+        }
+    }
+    return bestCursor;
+}
+
 //----------------------------------------------------------------//
 void standardTest ( AbstractBlockTree& tree ) {
 
@@ -86,3 +178,148 @@ TEST ( BlockTree, sqlite ) {
 //    ASSERT_EQ ( remove ( SQLITE_FILE ), 0 );
 //    ASSERT_EQ ( FileSys::exists ( SQLITE_FILE ), false );
 }
+
+//----------------------------------------------------------------//
+TEST ( BlockTree, compare_memoized ) {
+
+    static const size_t TRUNK_LENGTH        = 64;
+    static const size_t BRANCH_LENGTH       = 32;
+    static const size_t TOTAL_BRANCHES      = 32;
+
+    if ( FileSys::exists ( SQLITE_COMPARE_FILE )) {
+        remove ( SQLITE_COMPARE_FILE );
+    }
+
+    SQLiteBlockTree tree ( SQLITE_COMPARE_FILE, SQLiteConfig ());
+    tree.setCacheSize ( 1024 );
+
+    CryptoKeyPair keyPair;
+    keyPair.elliptic ();
+    Signature visage = Miner::calculateVisage ( keyPair );
+
+    BlockTreeTag trunkTag ( "trunk" );
+
+    // one long trunk, then many peers on similar branches forking near its end.
+    vector < shared_ptr < Block >> trunk;
+    trunk.push_back ( makeBlock ( "9090", visage, 0, NULL, keyPair ));
+    tree.affirmBlock ( trunkTag, trunk.back ());
+
+    for ( size_t i = 1; i < TRUNK_LENGTH; ++i ) {
+        trunk.push_back ( makeBlock ( "9090", visage, ( time_t )i, trunk.back ().get (), keyPair ));
+        tree.affirmBlock ( trunkTag, trunk.back ());
+    }
+
+    list < BlockTreeCursor > leaves;
+    list < BlockTreeTag > branchTags;
+
+    for ( size_t i = 0; i < TOTAL_BRANCHES; ++i ) {
+
+        branchTags.emplace_back ( Format::write ( "branch-%d", ( int )i ));
+        BlockTreeTag& branchTag = branchTags.back ();
+
+        shared_ptr < Block > block = trunk [ TRUNK_LENGTH - 1 - ( i % 8 )];
+        BlockTreeCursor cursor;
+
+        for ( size_t j = 0; j < BRANCH_LENGTH; ++j ) {
+            block = makeBlock ( Format::write ( "%d", ( int )i ), visage, block->getTime () + 1, block.get (), keyPair );
+            cursor = tree.affirmBlock ( branchTag, block );
+        }
+        leaves.push_back ( cursor );
+    }
+
+    // memoized results, cold and warm, must match the unmemoized walk for every ordered pair.
+    tree.clearCompareCache ();
+
+    for ( size_t pass = 0; pass < 2; ++pass ) {
+
+        list < BlockTreeCursor >::const_iterator leafIt0 = leaves.cbegin ();
+        for ( ; leafIt0 != leaves.cend (); ++leafIt0 ) {
+            list < BlockTreeCursor >::const_iterator leafIt1 = leaves.cbegin ();
+            for ( ; leafIt1 != leaves.cend (); ++leafIt1 ) {
+                ASSERT_EQ ( BlockTreeCursor::compare ( *leafIt0, *leafIt1 ), DebugBlockTree::compareByFork ( *leafIt0, *leafIt1 ));
+            }
+        }
+    }
+
+    // and against a trunk block, which each branch extends (the subset case).
+    list < BlockTreeCursor >::const_iterator leafIt = leaves.cbegin ();
+    for ( ; leafIt != leaves.cend (); ++leafIt ) {
+        BlockTreeCursor trunkCursor = tree.findCursorForHash ( trunk [ TRUNK_LENGTH / 2 ]->getDigest ());
+        ASSERT_EQ ( BlockTreeCursor::compare ( *leafIt, trunkCursor ), DebugBlockTree::compareByFork ( *leafIt, trunkCursor ));
+        ASSERT_EQ ( BlockTreeCursor::compare ( trunkCursor, *leafIt ), DebugBlockTree::compareByFork ( trunkCursor, *leafIt ));
+    }
+
+    // the best branch picked with a warm cache is the one the unmemoized walk picks.
+    BlockTreeCursor best = rankBranches ( leaves );
+    BlockTreeCursor expected;
+    for ( leafIt = leaves.cbegin (); leafIt != leaves.cend (); ++leafIt ) {
+        if ( !expected.hasHeader () || ( DebugBlockTree::compareByFork ( *leafIt, expected ) < 0 )) {
+            expected = *leafIt;
+        }
+    }
+    ASSERT_TRUE ( best.equals ( expected ));
+}
+
+//----------------------------------------------------------------//
+TEST ( BlockStore, round_trip ) {
+
+    // the genesis registers this key as a miner's, and MinerInfo only takes RSA keys.
+    CryptoKeyPair keyPair;
+    keyPair.rsa ();
+    Signature visage = Miner::calculateVisage ( keyPair );
+
+    shared_ptr < Block > genesis = makeGenesis ( "9090", visage, keyPair );
+    string genesisJSON = ToJSONSerializer::toJSONString ( *genesis );
+
+    // plain and deflated rows both come back as the block that went in.
+    for ( size_t compress = 0; compress < 2; ++compress ) {
+    
+        remove ( SQLITE_STORE_FILE );
+        
+        SQLiteBlockStore store ( SQLITE_STORE_FILE, SQLiteConfig (), compress == 1 );
+        ASSERT_FALSE ( store.hasBlock ( genesis->getDigest ().toHex ()));
+        
+        store.putBlock ( *genesis );
+        store.putBlock ( *genesis );
+        ASSERT_TRUE ( store.hasBlock ( genesis->getDigest ().toHex ()));
+        
+        shared_ptr < const Block > block = store.getBlock ( genesis->getDigest ().toHex ());
+        ASSERT_TRUE ( block );
+        ASSERT_EQ ( ToJSONSerializer::toJSONString ( *block ), genesisJSON );
+    }
+    remove ( SQLITE_STORE_FILE );
+
+    shared_ptr < SQLiteBlockStore > store = make_shared < SQLiteBlockStore >( SQLITE_STORE_FILE, SQLiteConfig ());
+
+    Ledger ledger;
+    ledger.mBlockStore = store;
+    ASSERT_TRUE ( ledger.pushBlock ( *genesis, Block::VerificationPolicy::NONE ));
+    ASSERT_TRUE ( store->hasBlock ( genesis->getDigest ().toHex ()));
+    
+    shared_ptr < const Block > genesisFromLedger = ledger.getBlock (( u64 )0 );
+    ASSERT_TRUE ( genesisFromLedger );
+    ASSERT_EQ ( ToJSONSerializer::toJSONString ( *genesisFromLedger ), genesisJSON );
+
+    shared_ptr < Block > block = make_shared < Block >();
+    block->initialize ( "9090", 0, visage, 1, genesis.get (), keyPair );
+    block->setBlockDelayInSeconds ( 1 );
+    block->setRewriteWindow ( 10 );
+    block->setReward ( "" );
+    block->sign ( keyPair );
+
+    // applied to a scratch fork, the block is not committed, so its body must not reach the store.
+    {
+        Ledger fork ( ledger );
+        ASSERT_TRUE ( block->apply ( fork, Block::VerificationPolicy::NONE ));
+        ASSERT_FALSE ( store->hasBlock ( block->getDigest ().toHex ()));
+    }
+    
+    ASSERT_TRUE ( ledger.pushBlock ( *block, Block::VerificationPolicy::NONE ));
+    ASSERT_TRUE ( store->hasBlock ( block->getDigest ().toHex ()));
+    
+    shared_ptr < const Block > blockFromLedger = ledger.getBlock (( u64 )1 );
+    ASSERT_TRUE ( blockFromLedger );
+    ASSERT_EQ ( ToJSONSerializer::toJSONString ( *blockFromLedger ), ToJSONSerializer::toJSONString ( *block ));
+    
+    remove ( SQLITE_STORE_FILE );
+}
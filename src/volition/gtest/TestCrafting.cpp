@@ -2,11 +2,17 @@
 // http://cryptogogue.com
 
 #include <gtest/gtest.h>
+#include <volition/AccountInventory.h>
 #include <volition/AssetMethodInvocation.h>
+#include <volition/AssetODBM.h>
+#include <volition/CraftabilityIndex.h>
 #include <volition/CryptoKey.h>
+#include <volition/InventoryDelta.h>
 #include <volition/Ledger.h>
+#include <volition/OfferODBM.h>
 #include <volition/Schema.h>
 #include <volition/serialization/Serialization.h>
+#include <thread>
 
 #include "TestCrafting.json.h"
 
@@ -99,3 +105,407 @@ TEST ( Rewards, rewards ) {
     ASSERT_TRUE ( histogram [ "pack" ] == 36 );
 }
 
+//----------------------------------------------------------------//
+// every asset's position must match its slot in its owner's (paged) inventory.
+static void checkInventory ( Ledger& ledger, AccountID accountID, size_t expectedSize ) {
+
+    SerializableList < SerializableSharedConstPtr < Asset >> inventory;
+    ledger.getInventory ( accountID, inventory );
+    ASSERT_TRUE ( inventory.size () == expectedSize );
+
+    size_t position = 0;
+    SerializableList < SerializableSharedConstPtr < Asset >>::const_iterator inventoryIt = inventory.cbegin ();
+    for ( ; inventoryIt != inventory.cend (); ++inventoryIt, ++position ) {
+        AssetODBM assetODBM ( ledger, ( *inventoryIt )->mAssetID );
+        ASSERT_TRUE ( assetODBM.mOwner.get () == accountID );
+        ASSERT_TRUE ( assetODBM.mPosition.get () == position );
+    }
+}
+
+//----------------------------------------------------------------//
+TEST ( Inventory, inventory_pages ) {
+
+    time_t t;
+    time ( &t );
+
+    LedgerResult result = false;
+
+    Ledger ledger;
+    ledger.init ();
+
+    Schema schema;
+    FromJSONSerializer::fromJSONString ( schema, schema_json );
+    ledger.setSchema ( schema );
+
+    CryptoKeyPair key;
+    key.elliptic ();
+
+    Policy keyPolicy;
+    ledger.getEntitlements < KeyEntitlements >( keyPolicy );
+
+    Policy accountPolicy;
+    ledger.getEntitlements < AccountEntitlements >( accountPolicy );
+
+    result = ledger.newAccount ( "alice", 1000, "master", key.getPublicKey (), keyPolicy, accountPolicy );
+    ASSERT_TRUE ( result );
+    result = ledger.newAccount ( "bob", 1000, "master", key.getPublicKey (), keyPolicy, accountPolicy );
+    ASSERT_TRUE ( result );
+
+    AccountID aliceID = ledger.getAccountID ( "alice" );
+    AccountID bobID = ledger.getAccountID ( "bob" );
+
+    // enough to span three pages.
+    size_t total = ( AccountInventory::PAGE_SIZE * 2 ) + 88;
+    result = ledger.awardAssets ( aliceID, "common", total, t );
+    ASSERT_TRUE ( result );
+    checkInventory ( ledger, aliceID, total );
+
+    // pull from the head, the tail and both sides of each page boundary.
+    AssetID::Index transfers [] = { 0, 255, 256, 511, 512, total - 1 };
+    size_t totalTransfers = sizeof ( transfers ) / sizeof ( AssetID::Index );
+
+    result = ledger.transferAssets ( aliceID, bobID, AssetListAdapter ( transfers, totalTransfers ), t );
+    ASSERT_TRUE ( result );
+    checkInventory ( ledger, aliceID, total - totalTransfers );
+    checkInventory ( ledger, bobID, totalTransfers );
+
+    result = ledger.revokeAsset ( 10, t );
+    ASSERT_TRUE ( result );
+    checkInventory ( ledger, aliceID, total - totalTransfers - 1 );
+
+    result = ledger.clearInventory ( bobID, t );
+    ASSERT_TRUE ( result );
+    checkInventory ( ledger, bobID, 0 );
+
+    // the cleared slots must not come back when the inventory grows again.
+    result = ledger.awardAssets ( bobID, "common", 3, t );
+    ASSERT_TRUE ( result );
+    checkInventory ( ledger, bobID, 3 );
+}
+
+//----------------------------------------------------------------//
+TEST ( Inventory, revoked_asset ) {
+
+    time_t t;
+    time ( &t );
+
+    LedgerResult result = false;
+
+    Ledger ledger;
+    ledger.init ();
+
+    Schema schema;
+    FromJSONSerializer::fromJSONString ( schema, schema_json );
+    ledger.setSchema ( schema );
+
+    CryptoKeyPair key;
+    key.elliptic ();
+
+    Policy keyPolicy;
+    ledger.getEntitlements < KeyEntitlements >( keyPolicy );
+
+    Policy accountPolicy;
+    ledger.getEntitlements < AccountEntitlements >( accountPolicy );
+
+    result = ledger.newAccount ( "alice", 1000, "master", key.getPublicKey (), keyPolicy, accountPolicy );
+    ASSERT_TRUE ( result );
+
+    AccountID aliceID = ledger.getAccountID ( "alice" );
+
+    result = ledger.awardAssets ( aliceID, "common", 2, t );
+    ASSERT_TRUE ( result );
+
+    result = ledger.revokeAsset ( 0, t );
+    ASSERT_TRUE ( result );
+    checkInventory ( ledger, aliceID, 1 );
+
+    // a revoked asset keeps its owner key (as NULL_INDEX), so it still reads back, without an owner.
+    shared_ptr < const Asset > revoked = AssetODBM ( ledger, 0 ).getAsset ();
+    ASSERT_TRUE ( revoked );
+    ASSERT_EQ (( AssetID::Index )revoked->mAssetID, ( AssetID::Index )0 );
+    ASSERT_EQ ( revoked->mType, "common" );
+    ASSERT_EQ ( revoked->mOwner, "" );
+
+    shared_ptr < const Asset > kept = AssetODBM ( ledger, 1 ).getAsset ();
+    ASSERT_TRUE ( kept );
+    ASSERT_EQ ( kept->mOwner, "alice" );
+
+    // an asset that was never awarded has no owner key at all.
+    ASSERT_FALSE ( AssetODBM ( ledger, 2 ).getAsset ());
+}
+
+//----------------------------------------------------------------//
+static void checkOpenOffers ( Ledger& ledger, string assetType, set < OfferID::Index > expected ) {
+
+    SerializableVector < OfferID::Index > offerIDs;
+    ledger.getOpenOffers ( assetType, offerIDs );
+    ASSERT_EQ ( offerIDs.size (), expected.size ());
+    ASSERT_EQ ( set < OfferID::Index >( offerIDs.cbegin (), offerIDs.cend ()), expected );
+}
+
+//----------------------------------------------------------------//
+TEST ( Offers, open_offer_index_backfill ) {
+
+    time_t t;
+    time ( &t );
+
+    LedgerResult result = false;
+
+    Ledger ledger;
+    ledger.init ();
+
+    Schema schema;
+    FromJSONSerializer::fromJSONString ( schema, schema_json );
+    ledger.setSchema ( schema );
+
+    CryptoKeyPair key;
+    key.elliptic ();
+
+    Policy keyPolicy;
+    ledger.getEntitlements < KeyEntitlements >( keyPolicy );
+
+    Policy accountPolicy;
+    ledger.getEntitlements < AccountEntitlements >( accountPolicy );
+
+    result = ledger.newAccount ( "alice", 1000, "master", key.getPublicKey (), keyPolicy, accountPolicy );
+    ASSERT_TRUE ( result );
+
+    AccountID aliceID = ledger.getAccountID ( "alice" );
+
+    result = ledger.awardAssets ( aliceID, "common", 3, t );
+    ASSERT_TRUE ( result );
+    result = ledger.awardAssets ( aliceID, "pack", 1, t );
+    ASSERT_TRUE ( result );
+
+    // offer 0: one common; offer 1: a common and the pack; offer 2: one common, cancelled.
+    AssetID::Index offer0 [] = { 0 };
+    AssetID::Index offer1 [] = { 1, 3 };
+    AssetID::Index offer2 [] = { 2 };
+
+    ASSERT_TRUE ( ledger.offerAssets ( aliceID, 10, t + 3600, AssetListAdapter ( offer0, 1 ), t ));
+    ASSERT_TRUE ( ledger.offerAssets ( aliceID, 20, t + 3600, AssetListAdapter ( offer1, 2 ), t ));
+    ASSERT_TRUE ( ledger.offerAssets ( aliceID, 30, t + 3600, AssetListAdapter ( offer2, 1 ), t ));
+    ASSERT_TRUE ( ledger.cancelOffer ( aliceID, AssetID::encode ( 2 ), t ));
+
+    checkOpenOffers ( ledger, "common", { 0, 1 });
+    checkOpenOffers ( ledger, "pack", { 1 });
+
+    // strip the index to look like a ledger whose offers predate it.
+    ledger.unindexOpenOffer ( 0 );
+    ledger.unindexOpenOffer ( 1 );
+    checkOpenOffers ( ledger, "common", {});
+    checkOpenOffers ( ledger, "pack", {});
+
+    // the backfill finds the open offers (and skips the cancelled one); running it again changes nothing.
+    ledger.affirmOpenOfferIndex ();
+    checkOpenOffers ( ledger, "common", { 0, 1 });
+    checkOpenOffers ( ledger, "pack", { 1 });
+
+    ledger.affirmOpenOfferIndex ();
+    checkOpenOffers ( ledger, "common", { 0, 1 });
+
+    // backfilled entries come out of the index like any other.
+    ASSERT_TRUE ( ledger.cancelOffer ( aliceID, AssetID::encode ( 3 ), t ));
+    checkOpenOffers ( ledger, "common", { 0 });
+    checkOpenOffers ( ledger, "pack", {});
+
+    // offers made after the backfill are indexed as they're made.
+    ASSERT_TRUE ( ledger.offerAssets ( aliceID, 40, t + 3600, AssetListAdapter ( offer1, 2 ), t ));
+    checkOpenOffers ( ledger, "common", { 0, 3 });
+    checkOpenOffers ( ledger, "pack", { 3 });
+}
+
+//----------------------------------------------------------------//
+static void checkInventoryDelta ( Ledger& ledger, AccountID accountID, u64 from, u64 to ) {
+
+    AccountODBM accountODBM ( ledger, accountID );
+
+    InventoryDelta delta;
+    delta.load ( accountODBM, from, to );
+
+    SerializableSet < AssetID::Index > additions;
+    SerializableSet < AssetID::Index > deletions;
+    for ( u64 nonce = from; nonce < to; ++nonce ) {
+        shared_ptr < const InventoryLogEntry > logEntry = accountODBM.getInventoryLogEntryField ( nonce ).get ();
+        if ( logEntry ) {
+            logEntry->apply ( additions, deletions );
+        }
+    }
+
+    ASSERT_TRUE ( delta.mAdditions == additions );
+    ASSERT_TRUE ( delta.mDeletions == deletions );
+}
+
+//----------------------------------------------------------------//
+TEST ( Inventory, inventory_delta ) {
+
+    time_t t;
+    time ( &t );
+
+    LedgerResult result = false;
+
+    Ledger ledger;
+    ledger.init ();
+
+    Schema schema;
+    FromJSONSerializer::fromJSONString ( schema, schema_json );
+    ledger.setSchema ( schema );
+
+    CryptoKeyPair key;
+    key.elliptic ();
+
+    Policy keyPolicy;
+    ledger.getEntitlements < KeyEntitlements >( keyPolicy );
+
+    Policy accountPolicy;
+    ledger.getEntitlements < AccountEntitlements >( accountPolicy );
+
+    result = ledger.newAccount ( "alice", 1000, "master", key.getPublicKey (), keyPolicy, accountPolicy );
+    ASSERT_TRUE ( result );
+
+    AccountID aliceID = ledger.getAccountID ( "alice" );
+
+    // one log entry per award, enough to complete a few checkpoints and leave a partial interval.
+    u64 total = ( InventoryDelta::CHECKPOINT_INTERVAL * 3 ) + 10;
+    for ( u64 i = 0; i < total; ++i ) {
+        result = ledger.awardAssets ( aliceID, "common", 1, t );
+        ASSERT_TRUE ( result );
+    }
+
+    // deletions land in the last interval.
+    result = ledger.revokeAsset ( 3, t );
+    ASSERT_TRUE ( result );
+    result = ledger.revokeAsset ( 100, t );
+    ASSERT_TRUE ( result );
+
+    AccountODBM accountODBM ( ledger, aliceID );
+    u64 inventoryNonce = accountODBM.mInventoryNonce.get ( 0 );
+    ASSERT_TRUE ( inventoryNonce == ( total + 2 ));
+    ASSERT_TRUE ( accountODBM.getInventoryCheckpointField ( 2 ).exists ());
+    ASSERT_FALSE ( accountODBM.getInventoryCheckpointField ( 3 ).exists ());
+
+    checkInventoryDelta ( ledger, aliceID, 0, inventoryNonce );
+    checkInventoryDelta ( ledger, aliceID, 1, inventoryNonce );
+    checkInventoryDelta ( ledger, aliceID, InventoryDelta::CHECKPOINT_INTERVAL, InventoryDelta::CHECKPOINT_INTERVAL * 2 );
+    checkInventoryDelta ( ledger, aliceID, 5, ( InventoryDelta::CHECKPOINT_INTERVAL * 2 ) + 5 );
+    checkInventoryDelta ( ledger, aliceID, inventoryNonce - 3, inventoryNonce );
+    checkInventoryDelta ( ledger, aliceID, 7, 7 );
+}
+
+//----------------------------------------------------------------//
+// qualify every asset in the account's inventory directly, without the index.
+static CraftabilityIndex::AssetsByParam qualifyInventory ( Ledger& ledger, AccountID accountID, string methodName ) {
+
+    const AssetMethod* method = ledger.getSchema ().getMethodOrNull ( methodName );
+
+    SerializableList < SerializableSharedConstPtr < Asset >> inventory;
+    ledger.getInventory ( accountID, inventory );
+
+    CraftabilityIndex::AssetsByParam assetsByParam;
+
+    AssetMethod::AssetArgs::const_iterator assetArgIt = method->mAssetArgs.cbegin ();
+    for ( ; assetArgIt != method->mAssetArgs.cend (); ++assetArgIt ) {
+
+        CraftabilityIndex::AssetSet& assets = assetsByParam [ assetArgIt->first ];
+
+        SerializableList < SerializableSharedConstPtr < Asset >>::const_iterator inventoryIt = inventory.cbegin ();
+        for ( ; inventoryIt != inventory.cend (); ++inventoryIt ) {
+            shared_ptr < const Asset > asset = *inventoryIt;
+            if ( assetArgIt->second.qualifies ( asset )) {
+                assets.insert ( asset->mAssetID );
+            }
+        }
+    }
+    return assetsByParam;
+}
+
+//----------------------------------------------------------------//
+TEST ( Crafting, craftability_index ) {
+
+    time_t t;
+    time ( &t );
+
+    LedgerResult result = false;
+
+    Ledger ledger;
+    ledger.init ();
+
+    Schema schema;
+    FromJSONSerializer::fromJSONString ( schema, schema_json );
+    ledger.setSchema ( schema );
+
+    CryptoKeyPair key;
+    key.elliptic ();
+
+    Policy keyPolicy;
+    ledger.getEntitlements < KeyEntitlements >( keyPolicy );
+
+    Policy accountPolicy;
+    ledger.getEntitlements < AccountEntitlements >( accountPolicy );
+
+    result = ledger.newAccount ( "alice", 1000, "master", key.getPublicKey (), keyPolicy, accountPolicy );
+    ASSERT_TRUE ( result );
+    result = ledger.newAccount ( "bob", 1000, "master", key.getPublicKey (), keyPolicy, accountPolicy );
+    ASSERT_TRUE ( result );
+
+    AccountID aliceID = ledger.getAccountID ( "alice" );
+    AccountID bobID = ledger.getAccountID ( "bob" );
+
+    // enough assets that a rebuild is split into several jobs.
+    result = ledger.awardAssets ( aliceID, "pack", 300, t );
+    ASSERT_TRUE ( result );
+    result = ledger.awardAssets ( aliceID, "common", 50, t );
+    ASSERT_TRUE ( result );
+
+    CraftabilityIndex index;
+    CraftabilityIndex::AssetsByParam assetsByParam;
+
+    // cold: a full rebuild.
+    ASSERT_TRUE ( index.getQualifiedAssets ( ledger, "alice", "openPack", assetsByParam ));
+    ASSERT_TRUE ( assetsByParam == qualifyInventory ( ledger, aliceID, "openPack" ));
+
+    // warm, with nothing new to replay.
+    ASSERT_TRUE ( index.getQualifiedAssets ( ledger, "alice", "openPack", assetsByParam ));
+    ASSERT_TRUE ( assetsByParam == qualifyInventory ( ledger, aliceID, "openPack" ));
+
+    // additions, revocations and transfers out all go through the replay path.
+    result = ledger.awardAssets ( aliceID, "pack", 20, t );
+    ASSERT_TRUE ( result );
+    result = ledger.revokeAsset ( 3, t );
+    ASSERT_TRUE ( result );
+
+    AssetID::Index transfers [] = { 0, 7, 310 };
+    result = ledger.transferAssets ( aliceID, bobID, AssetListAdapter ( transfers, 3 ), t );
+    ASSERT_TRUE ( result );
+
+    ASSERT_TRUE ( index.getQualifiedAssets ( ledger, "alice", "openPack", assetsByParam ));
+    ASSERT_TRUE ( assetsByParam == qualifyInventory ( ledger, aliceID, "openPack" ));
+
+    CraftabilityIndex freshIndex;
+    CraftabilityIndex::AssetsByParam freshAssetsByParam;
+    ASSERT_TRUE ( freshIndex.getQualifiedAssets ( ledger, "alice", "openPack", freshAssetsByParam ));
+    ASSERT_TRUE ( assetsByParam == freshAssetsByParam );
+
+    // concurrent queries for both accounts, with replays racing to swap in.
+    result = ledger.awardAssets ( aliceID, "pack", 5, t );
+    ASSERT_TRUE ( result );
+
+    CraftabilityIndex::AssetsByParam expectedAlice = qualifyInventory ( ledger, aliceID, "openPack" );
+    CraftabilityIndex::AssetsByParam expectedBob = qualifyInventory ( ledger, bobID, "openPack" );
+
+    // each thread reads through its own ledger, as the request handlers do.
+    vector < Ledger > ledgers ( 8, ledger );
+    vector < CraftabilityIndex::AssetsByParam > results ( ledgers.size ());
+    vector < thread > threads;
+    for ( size_t i = 0; i < results.size (); ++i ) {
+        threads.emplace_back ([ &, i ]() {
+            index.getQualifiedAssets ( ledgers [ i ], ( i & 1 ) ? "bob" : "alice", "openPack", results [ i ]);
+        });
+    }
+    for ( size_t i = 0; i < threads.size (); ++i ) {
+        threads [ i ].join ();
+    }
+    for ( size_t i = 0; i < results.size (); ++i ) {
+        ASSERT_TRUE ( results [ i ] == (( i & 1 ) ? expectedBob : expectedAlice ));
+    }
+}
@@ -0,0 +1,138 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <gtest/gtest.h>
+#include <volition/DeckTable.h>
+#include <volition/Schema.h>
+#include <volition/serialization/Serialization.h>
+
+using namespace Volition;
+
+#define JSON_STR(...) #__VA_ARGS__
+
+// "pack" is both a deck and a set; the set is the one that's drawn from.
+static const char* schema_json = JSON_STR ({
+    "decks": {
+        "pack": {
+            "common": 9,
+            "rare": 1
+        },
+        "starter": {
+            "common": 4,
+            "empty": 0,
+            "rare": 2,
+            "uncommon": 3
+        }
+    },
+    "sets": {
+        "pack": {
+            "legendary": 1,
+            "none": 0,
+            "uncommon": 5
+        }
+    }
+});
+
+//----------------------------------------------------------------//
+// the deck the way awardAssetsRandom used to sample it: one entry per card, in deck order.
+static vector < string > expandDeck ( const map < string, u64 >& deck ) {
+
+    vector < string > expanded;
+    map < string, u64 >::const_iterator deckIt = deck.cbegin ();
+    for ( ; deckIt != deck.cend (); ++deckIt ) {
+        for ( u64 i = 0; i < deckIt->second; ++i ) {
+            expanded.push_back ( deckIt->first );
+        }
+    }
+    return expanded;
+}
+
+//----------------------------------------------------------------//
+static void expectSameDraws ( const DeckTable& table, const map < string, u64 >& deck ) {
+
+    vector < string > expanded = expandDeck ( deck );
+    ASSERT_EQ ( table.getTotal (), ( u64 )expanded.size ());
+
+    // every card a few times around, then the far end of the range a u32 draw can reach.
+    vector < u64 > cards;
+    for ( u64 card = 0; card < ( expanded.size () * 3 ); ++card ) {
+        cards.push_back ( card );
+    }
+    cards.push_back ( 0x7fffffff );
+    cards.push_back ( 0x80000000 );
+    cards.push_back ( 0xfffffffe );
+    cards.push_back ( 0xffffffff );
+
+    for ( size_t i = 0; i < cards.size (); ++i ) {
+        u64 card = cards [ i ];
+        ASSERT_EQ ( table.getType ( table.draw ( card )), expanded [ card % expanded.size ()]);
+    }
+}
+
+//----------------------------------------------------------------//
+TEST ( DeckTable, mixed_counts ) {
+
+    map < string, u64 > deck;
+    deck [ "a" ] = 3;
+    deck [ "b" ] = 1;
+    deck [ "c" ] = 7;
+    deck [ "d" ] = 2;
+
+    DeckTable table;
+    table.build ( deck );
+
+    ASSERT_EQ ( table.size (), ( size_t )4 );
+    expectSameDraws ( table, deck );
+}
+
+//----------------------------------------------------------------//
+TEST ( DeckTable, zero_counts ) {
+
+    map < string, u64 > deck;
+    deck [ "a" ] = 0;
+    deck [ "b" ] = 2;
+    deck [ "c" ] = 0;
+    deck [ "d" ] = 1;
+    deck [ "e" ] = 0;
+
+    DeckTable table;
+    table.build ( deck );
+
+    // types with no cards are never drawn, so they aren't in the table at all.
+    ASSERT_EQ ( table.size (), ( size_t )2 );
+    ASSERT_EQ ( table.getType ( 0 ), "b" );
+    ASSERT_EQ ( table.getType ( 1 ), "d" );
+    expectSameDraws ( table, deck );
+
+    map < string, u64 > empty;
+    empty [ "a" ] = 0;
+
+    table.build ( empty );
+    ASSERT_EQ ( table.getTotal (), ( u64 )0 );
+    ASSERT_EQ ( table.size (), ( size_t )0 );
+}
+
+//----------------------------------------------------------------//
+TEST ( DeckTable, schema_sets_shadow_decks ) {
+
+    Schema schema;
+    FromJSONSerializer::fromJSONString ( schema, schema_json );
+
+    const char* names [] = { "pack", "starter" };
+    for ( const char* name : names ) {
+
+        const Schema::Deck* deck = schema.getDeck ( name );
+        const DeckTable* table = schema.getDeckTable ( name );
+        ASSERT_TRUE ( deck );
+        ASSERT_TRUE ( table );
+        expectSameDraws ( *table, *deck );
+    }
+
+    // the table for "pack" is the set's, not the deck's.
+    const DeckTable* pack = schema.getDeckTable ( "pack" );
+    ASSERT_EQ ( pack->getTotal (), ( u64 )6 );
+    ASSERT_EQ ( pack->getType ( pack->draw ( 0 )), "legendary" );
+    ASSERT_EQ ( pack->getType ( pack->draw ( 1 )), "uncommon" );
+
+    ASSERT_FALSE ( schema.getDeckTable ( "missing" ));
+}
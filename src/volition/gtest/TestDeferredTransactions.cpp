@@ -0,0 +1,227 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <gtest/gtest.h>
+#include <volition/AccountODBM.h>
+#include <volition/Block.h>
+#include <volition/CryptoKeyPair.h>
+#include <volition/DeferredBlock.h>
+#include <volition/Format.h>
+#include <volition/Ledger.h>
+#include <volition/Miner.h>
+#include <volition/TheTransactionBodyFactory.h>
+#include <volition/Transaction.h>
+#include <volition/TransactionContext.h>
+#include <volition/TransactionMaker.h>
+#include <volition/Transactions.h>
+
+using namespace Volition;
+
+//================================================================//
+// TestDeferred
+//================================================================//
+// Matures mMaturity blocks after the block it's in and records the height
+// it was applied at, so a test can see when (and whether) it ran. All of the
+// real transactions mature at once.
+class TestDeferred :
+    public AbstractTransactionBody {
+public:
+
+    TRANSACTION_TYPE ( "TEST_DEFERRED" )
+    TRANSACTION_WEIGHT ( 1 )
+
+    u64     mMaturity;
+
+    //----------------------------------------------------------------//
+    static string keyFor_appliedAt ( string uuid ) {
+        return Format::write ( "test.deferred.%s", uuid.c_str ());
+    }
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeFrom ( const AbstractSerializerFrom& serializer ) override {
+        AbstractTransactionBody::AbstractSerializable_serializeFrom ( serializer );
+
+        serializer.serialize ( "maturity",      this->mMaturity );
+    }
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeTo ( AbstractSerializerTo& serializer ) const override {
+        AbstractTransactionBody::AbstractSerializable_serializeTo ( serializer );
+
+        serializer.serialize ( "maturity",      this->mMaturity );
+    }
+
+    //----------------------------------------------------------------//
+    TransactionResult AbstractTransactionBody_apply ( TransactionContext& context ) const override {
+
+        context.mLedger.setValue < u64 >( keyFor_appliedAt ( this->mUUID ), context.mBlockHeight );
+        return true;
+    }
+
+    //----------------------------------------------------------------//
+    u64 AbstractTransactionBody_maturity () const override {
+        return this->mMaturity;
+    }
+
+    //----------------------------------------------------------------//
+    TestDeferred () :
+        mMaturity ( 0 ) {
+    }
+};
+
+//----------------------------------------------------------------//
+static u64 appliedAt ( const Ledger& ledger, string uuid ) {
+
+    return ledger.getValueOrFallback < u64 >( TestDeferred::keyFor_appliedAt ( uuid ), 0 );
+}
+
+//----------------------------------------------------------------//
+static bool hasDeferred ( const Ledger& ledger, u64 height ) {
+
+    return ( ledger.getValueOrFallback < string >( Ledger::keyFor_deferred ( height ), "" ).size () > 0 );
+}
+
+//----------------------------------------------------------------//
+static shared_ptr < Block > makeGenesis ( string minerID, const Signature& visage, const CryptoKeyPair& key ) {
+
+    shared_ptr < Transactions::Genesis > body = make_shared < Transactions::Genesis >();
+    body->setIdentity ( "TEST" );
+    body->setBlockDelayInSeconds ( 1 );
+    body->setRewriteWindowInSeconds ( 10 );
+    body->setMaxBlockWeight ( 1024 );
+
+    Transactions::GenesisAccount account;
+    account.mName       = minerID;
+    account.mKey        = key.getPublicKey ();
+    account.mGrant      = 0;
+    account.mMinerInfo  = make_shared < MinerInfo >( "http://127.0.0.1", key.getPublicKey (), "", visage );
+    body->pushAccount ( account );
+
+    shared_ptr < Transaction > transaction = make_shared < Transaction >();
+    transaction->setBody ( body );
+
+    shared_ptr < Block > genesis = make_shared < Block >();
+    genesis->setBlockDelayInSeconds ( 1 );
+    genesis->setRewriteWindow ( 10 );
+    genesis->pushTransaction ( transaction );
+    genesis->affirmHash ();
+    return genesis;
+}
+
+//----------------------------------------------------------------//
+static shared_ptr < const Transaction > makeDeferred ( string uuid, u64 nonce, u64 maturity, const CryptoKeyPair& key ) {
+
+    TransactionMaker maker;
+    maker.setAccountName ( "9090" );
+    maker.setKeyName ( "master" );
+    maker.setNonce ( nonce );
+
+    shared_ptr < TestDeferred > body = make_shared < TestDeferred >();
+    body->mMaturity = maturity;
+    body->setMaker ( maker );
+    body->setUUID ( uuid );
+
+    shared_ptr < Transaction > transaction = make_shared < Transaction >();
+    transaction->setBody ( body );
+    transaction->sign ( key );
+    return transaction;
+}
+
+//----------------------------------------------------------------//
+static void pushBlock ( Ledger& ledger, const vector < shared_ptr < const Transaction >>& transactions, const CryptoKeyPair& key ) {
+
+    shared_ptr < const Block > prevBlock = ledger.getBlock ();
+    ASSERT_TRUE ( prevBlock );
+
+    shared_ptr < Block > block = make_shared < Block >();
+    block->initialize ( "9090", 0, Miner::calculateVisage ( key ), prevBlock->getTime () + 1, prevBlock.get (), key );
+    block->setBlockDelayInSeconds ( 1 );
+    block->setRewriteWindow ( 10 );
+    block->setReward ( "" );
+    for ( size_t i = 0; i < transactions.size (); ++i ) {
+        block->pushTransaction ( transactions [ i ]);
+    }
+    block->sign ( key );
+
+    ASSERT_TRUE ( ledger.pushBlock ( *block, Block::VerificationPolicy::NONE ));
+}
+
+//----------------------------------------------------------------//
+// two blocks whose deferred transactions overlap: the second is scheduled (at 3) while the
+// first (due at 4) is still pending, and the unfinished list has only ever kept what was due.
+// if clearCache is set, the copied-out transactions are thrown away after the second block, as
+// for an entry scheduled before they were kept; the outcome has to be the same. either way, each
+// copy has to be gone once its entry leaves the unfinished list.
+static void testOverlappingMaturities ( bool clearCache ) {
+
+    TheTransactionBodyFactory::get ().registerTransaction < TestDeferred >();
+
+    // the genesis registers this key as a miner's, and MinerInfo only takes RSA keys.
+    CryptoKeyPair key;
+    key.rsa ();
+
+    Ledger ledger;
+    ASSERT_TRUE ( ledger.pushBlock ( *makeGenesis ( "9090", Miner::calculateVisage ( key ), key ), Block::VerificationPolicy::NONE ));
+
+    // 1: C applies now; A is due at 4.
+    pushBlock ( ledger, { makeDeferred ( "C", 0, 0, key ), makeDeferred ( "A", 1, 3, key )}, key );
+    ASSERT_EQ ( appliedAt ( ledger, "C" ), ( u64 )1 );
+    ASSERT_EQ ( ledger.getUnfinished ().mBlocks.size (), ( size_t )1 );
+    ASSERT_TRUE ( hasDeferred ( ledger, 4 ));
+
+    // 2: B is due at 3. the list changes, so block 1 (not yet due) falls off it.
+    pushBlock ( ledger, { makeDeferred ( "B", 1, 1, key )}, key );
+
+    UnfinishedBlockList unfinished = ledger.getUnfinished ();
+    ASSERT_EQ ( unfinished.mBlocks.size (), ( size_t )1 );
+    ASSERT_EQ ( unfinished.mBlocks.front ().mBlockID, ( u64 )2 );
+    ASSERT_EQ ( unfinished.mBlocks.front ().mMaturity, ( u64 )3 );
+
+    // block 1's copy went with its entry.
+    ASSERT_FALSE ( hasDeferred ( ledger, 4 ));
+    ASSERT_TRUE ( hasDeferred ( ledger, 3 ));
+
+    if ( clearCache ) {
+        ledger.clearDeferred ( 3 );
+        ASSERT_FALSE ( hasDeferred ( ledger, 3 ));
+    }
+
+    // 3: B.
+    pushBlock ( ledger, {}, key );
+    ASSERT_EQ ( appliedAt ( ledger, "B" ), ( u64 )3 );
+    ASSERT_EQ ( ledger.getUnfinished ().mBlocks.size (), ( size_t )0 );
+    ASSERT_FALSE ( hasDeferred ( ledger, 3 ));
+
+    // 4: nothing; A was dropped, whatever was copied out for it.
+    pushBlock ( ledger, {}, key );
+    ASSERT_EQ ( appliedAt ( ledger, "A" ), ( u64 )0 );
+
+    // 5, 6: a later deferral still runs, with the nonce A never took.
+    pushBlock ( ledger, { makeDeferred ( "D", 2, 1, key )}, key );
+    ASSERT_EQ ( appliedAt ( ledger, "D" ), ( u64 )0 );
+    ASSERT_TRUE ( hasDeferred ( ledger, 6 ));
+
+    pushBlock ( ledger, {}, key );
+    ASSERT_EQ ( appliedAt ( ledger, "D" ), ( u64 )6 );
+
+    // nothing copied out is left behind.
+    for ( u64 height = 0; height <= 6; ++height ) {
+        ASSERT_FALSE ( hasDeferred ( ledger, height ));
+    }
+
+    ASSERT_EQ ( appliedAt ( ledger, "A" ), ( u64 )0 );
+    ASSERT_EQ ( AccountODBM ( ledger, "9090" ).mTransactionNonce.get (), ( u64 )3 );
+    ASSERT_EQ ( ledger.getUnfinished ().mBlocks.size (), ( size_t )0 );
+}
+
+//----------------------------------------------------------------//
+TEST ( DeferredTransactions, overlapping_maturities ) {
+
+    testOverlappingMaturities ( false );
+}
+
+//----------------------------------------------------------------//
+TEST ( DeferredTransactions, overlapping_maturities_from_block ) {
+
+    testOverlappingMaturities ( true );
+}
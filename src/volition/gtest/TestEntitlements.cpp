@@ -2,6 +2,7 @@
 // http://cryptogogue.com
 
 #include <gtest/gtest.h>
+#include <volition/CompiledEntitlements.h>
 #include <volition/Entitlements.h>
 #include <volition/serialization/Serialization.h>
 
@@ -113,6 +114,25 @@ TEST ( Entitlements, entitlements ) {
     ASSERT_FALSE ( entitlements0.isMatchOrSubsetOf ( &entitlements0_subset ));
 }
 
+//----------------------------------------------------------------//
+TEST ( Entitlements, entitlements_compiled ) {
+    
+    shared_ptr < Entitlements > entitlements0 = make_shared < Entitlements >();
+    FromJSONSerializer::fromJSONString ( *entitlements0, entitlements0_json );
+    
+    CompiledEntitlements compiled ( entitlements0 );
+    
+    const char* paths [] = { "", "p0", "p0.p0", "p0.p1", "p0.p2", "p1", "p2", "p3", "p0.", "p1.p0", "p4" };
+    for ( size_t i = 0; i < ( sizeof ( paths ) / sizeof ( const char* )); ++i ) {
+        ASSERT_EQ ( compiled.check ( paths [ i ]), entitlements0->check ( paths [ i ]));
+        ASSERT_EQ ( compiled.check ( paths [ i ], 5 ), entitlements0->check ( paths [ i ], 5 ));
+        ASSERT_EQ ( compiled.check ( paths [ i ], 150 ), entitlements0->check ( paths [ i ], 150 ));
+    }
+    
+    ASSERT_TRUE ( compiled.resolvePathAs < NumericEntitlement >( "p3" ) != NULL );
+    ASSERT_TRUE ( compiled.resolvePathAs < NumericEntitlement >( "p0.p0" ) == NULL );
+}
+
 //----------------------------------------------------------------//
 TEST ( Entitlements, entitlements_affirm_path ) {
     
@@ -0,0 +1,138 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <gtest/gtest.h>
+#include <volition/serialization/Serialization.h>
+
+using namespace Volition;
+
+//================================================================//
+// TestRecord
+//================================================================//
+class TestRecord :
+    public AbstractSerializable {
+public:
+
+    bool                                    mFlag;
+    double                                  mRatio;
+    u64                                     mCount;
+    u64                                     mHex;
+    string                                  mName;
+    SerializableVector < u64 >              mValues;
+    SerializableMap < string, string >      mTags;
+    SerializableOpaque                      mOpaque;
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeFrom ( const AbstractSerializerFrom& serializer ) override {
+
+        serializer.serialize ( "flag",      this->mFlag );
+        serializer.serialize ( "ratio",     this->mRatio );
+        serializer.serialize ( "count",     this->mCount );
+        serializer.serialize ( "hex",       this->mHex );
+        serializer.serialize ( "name",      this->mName );
+        serializer.serialize ( "values",    this->mValues );
+        serializer.serialize ( "tags",      this->mTags );
+        serializer.serialize ( "opaque",    this->mOpaque );
+    }
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeTo ( AbstractSerializerTo& serializer ) const override {
+        UNUSED ( serializer );
+    }
+
+    //----------------------------------------------------------------//
+    TestRecord () :
+        mFlag ( false ),
+        mRatio ( 0.0 ),
+        mCount ( 0 ),
+        mHex ( 0 ) {
+    }
+};
+
+static const char* TEST_RECORD_JSON = R"({
+    "flag": true,
+    "ratio": 0.25,
+    "count": 18446744073709551615,
+    "hex": "0x00ff",
+    "name": "café \"quoted\"",
+    "values": [ 1, 2, 3 ],
+    "tags": { "b": "two", "a": "one" },
+    "opaque": { "x": [ 1, { "y": null } ] }
+})";
+
+//----------------------------------------------------------------//
+TEST ( JSONStreamSerializer, matches_dom_serializer ) {
+
+    TestRecord fromDOM;
+    FromJSONSerializer::fromJSONString ( fromDOM, TEST_RECORD_JSON );
+
+    TestRecord fromStream;
+    FromJSONStreamSerializer::fromJSONString ( fromStream, TEST_RECORD_JSON );
+
+    ASSERT_EQ ( fromDOM.mFlag,              fromStream.mFlag );
+    ASSERT_EQ ( fromDOM.mRatio,             fromStream.mRatio );
+    ASSERT_EQ ( fromDOM.mCount,             fromStream.mCount );
+    ASSERT_EQ ( fromDOM.mHex,               fromStream.mHex );
+    ASSERT_EQ ( fromDOM.mName,              fromStream.mName );
+    ASSERT_EQ ( fromDOM.mValues,            fromStream.mValues );
+    ASSERT_EQ ( fromDOM.mTags,              fromStream.mTags );
+
+    // opaque subtrees are returned as source text rather than re-stringified.
+    ASSERT_EQ ( fromStream.mOpaque.mString, "{ \"x\": [ 1, { \"y\": null } ] }" );
+}
+
+//----------------------------------------------------------------//
+TEST ( JSONStreamSerializer, rejects_malformed_json ) {
+
+    TestRecord record;
+    ASSERT_THROW ( FromJSONStreamSerializer::fromJSONString ( record, "{ \"flag\": tru }" ), Poco::JSON::JSONException );
+    ASSERT_THROW ( FromJSONStreamSerializer::fromJSONString ( record, "{ \"values\": [ 1, 2, ] }" ), Poco::JSON::JSONException );
+    ASSERT_THROW ( FromJSONStreamSerializer::fromJSONString ( record, "{ \"name\": \"unterminated }" ), Poco::JSON::JSONException );
+    ASSERT_THROW ( FromJSONStreamSerializer::fromJSONString ( record, "{} {}" ), Poco::JSON::JSONException );
+}
+
+//----------------------------------------------------------------//
+TEST ( JSONStreamSerializer, rejects_out_of_range_numbers ) {
+
+    TestRecord record;
+
+    // the DOM serializer throws on these through Poco::Dynamic::Var; the stream one has to as well.
+    ASSERT_THROW ( FromJSONSerializer::fromJSONString ( record, "{ \"count\": -1 }" ), Poco::RangeException );
+    ASSERT_THROW ( FromJSONStreamSerializer::fromJSONString ( record, "{ \"count\": -1 }" ), Poco::RangeException );
+    ASSERT_THROW ( FromJSONSerializer::fromJSONString ( record, "{ \"count\": -0.5 }" ), Poco::RangeException );
+    ASSERT_THROW ( FromJSONStreamSerializer::fromJSONString ( record, "{ \"count\": -0.5 }" ), Poco::RangeException );
+
+    ASSERT_THROW ( FromJSONStreamSerializer::fromJSONString ( record, "{ \"count\": 18446744073709551616 }" ), Poco::RangeException );
+    ASSERT_THROW ( FromJSONStreamSerializer::fromJSONString ( record, "{ \"count\": 1e20 }" ), Poco::RangeException );
+    ASSERT_THROW ( FromJSONStreamSerializer::fromJSONString ( record, "{ \"count\": 18446744073709551616.0 }" ), Poco::RangeException );
+    ASSERT_THROW ( FromJSONStreamSerializer::fromJSONString ( record, "{ \"values\": [ 1, -2 ] }" ), Poco::RangeException );
+
+    // the edges still convert.
+    FromJSONStreamSerializer::fromJSONString ( record, "{ \"count\": -0 }" );
+    ASSERT_EQ ( record.mCount, 0 );
+    FromJSONStreamSerializer::fromJSONString ( record, "{ \"count\": 18446744073709551615 }" );
+    ASSERT_EQ ( record.mCount, 18446744073709551615ULL );
+    FromJSONStreamSerializer::fromJSONString ( record, "{ \"count\": 2.5e3 }" );
+    ASSERT_EQ ( record.mCount, 2500 );
+}
+
+//----------------------------------------------------------------//
+TEST ( JSONStreamSerializer, rejects_bad_escapes ) {
+
+    TestRecord record;
+    ASSERT_THROW ( FromJSONStreamSerializer::fromJSONString ( record, R"({ "name": "\x41" })" ), Poco::JSON::JSONException );
+    ASSERT_THROW ( FromJSONStreamSerializer::fromJSONString ( record, R"({ "name": "\u12" })" ), Poco::JSON::JSONException );
+    ASSERT_THROW ( FromJSONStreamSerializer::fromJSONString ( record, R"({ "name": "\ud800" })" ), Poco::JSON::JSONException );
+    ASSERT_THROW ( FromJSONStreamSerializer::fromJSONString ( record, R"({ "name": "\ud800\u0041" })" ), Poco::JSON::JSONException );
+    ASSERT_THROW ( FromJSONStreamSerializer::fromJSONString ( record, R"({ "name": "\udc00" })" ), Poco::JSON::JSONException );
+    ASSERT_THROW ( FromJSONStreamSerializer::fromJSONString ( record, R"({ "\q": 1 })" ), Poco::JSON::JSONException );
+
+    // a proper pair and the simple escapes decode as the DOM serializer decodes them.
+    static const char* ESCAPES = R"({ "name": "\ud83d\ude00 \/ \\ \" \t \u00e9" })";
+
+    TestRecord fromDOM;
+    FromJSONSerializer::fromJSONString ( fromDOM, ESCAPES );
+    FromJSONStreamSerializer::fromJSONString ( record, ESCAPES );
+    ASSERT_EQ ( record.mName, "\xF0\x9F\x98\x80 / \\ \" \t \xC3\xA9" );
+    ASSERT_EQ ( record.mName, fromDOM.mName );
+}
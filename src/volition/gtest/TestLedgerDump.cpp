@@ -0,0 +1,248 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <gtest/gtest.h>
+#include <volition/Block.h>
+#include <volition/BlockODBM.h>
+#include <volition/CryptoKey.h>
+#include <volition/FileSys.h>
+#include <volition/Ledger.h>
+#include <volition/LedgerSnapshot.h>
+#include <volition/Schema.h>
+#include <volition/serialization/Serialization.h>
+#include <volition/Transactions.h>
+#include <thread>
+
+#include "TestCrafting.json.h"
+
+using namespace Volition;
+
+static cc8* DUMP_FILE           = "ledger-dump-test.txt";
+static cc8* DUMP_GZIP_FILE      = "ledger-dump-test.txt.gz";
+static cc8* GENESIS_FILE        = "ledger-dump-test-genesis.json";
+static cc8* SNAPSHOT_FILE       = "ledger-dump-test-snapshot.txt";
+
+//----------------------------------------------------------------//
+static void makeLedger ( Ledger& ledger ) {
+
+    time_t t;
+    time ( &t );
+
+    ledger.init ();
+
+    Schema schema;
+    FromJSONSerializer::fromJSONString ( schema, schema_json );
+    ledger.setSchema ( schema );
+
+    Transactions::ConsensusSettings settings;
+    settings.mIdentity                  = "ledger-dump-test";
+    settings.mMaxBlockWeight            = 1024;
+    settings.mBlockDelayInSeconds       = 30;
+    settings.mRewriteWindowInSeconds    = 60;
+    ASSERT_TRUE ( settings.apply ( ledger ));
+
+    CryptoKeyPair key;
+    key.elliptic ();
+
+    Policy keyPolicy;
+    ledger.getEntitlements < KeyEntitlements >( keyPolicy );
+
+    Policy accountPolicy;
+    ledger.getEntitlements < AccountEntitlements >( accountPolicy );
+
+    // more accounts than one batch, so the dump writes several.
+    for ( size_t i = 0; i < 40; ++i ) {
+    
+        string accountName = Format::write ( "account%d", ( int )i );
+        ASSERT_TRUE ( ledger.newAccount ( accountName, 1000 + i, "master", key.getPublicKey (), keyPolicy, accountPolicy ));
+        ASSERT_TRUE ( ledger.awardAssets ( ledger.getAccountID ( accountName ), "common", i % 5, t ));
+    }
+}
+
+//----------------------------------------------------------------//
+static void expectSameAccounts ( AbstractLedger& ledger0, AbstractLedger& ledger1 ) {
+
+    AccountID::Index totalAccounts = ledger0.getValue < AccountID::Index >( Ledger::keyFor_globalAccountCount ());
+    ASSERT_EQ ( totalAccounts, ledger1.getValue < AccountID::Index >( Ledger::keyFor_globalAccountCount ()));
+
+    for ( AccountID::Index i = 0; i < totalAccounts; ++i ) {
+    
+        Transactions::LoadLedgerAccount account0;
+        Transactions::LoadLedgerAccount account1;
+        ASSERT_EQ ( account0.init ( ledger0, AccountID ( i )), account1.init ( ledger1, AccountID ( i )));
+        ASSERT_EQ ( ToJSONSerializer::toJSONString ( account0 ), ToJSONSerializer::toJSONString ( account1 ));
+    }
+}
+
+//----------------------------------------------------------------//
+static string loadFile ( string filename ) {
+
+    ifstream inStream ( filename, ios_base::in | ios_base::binary );
+    stringstream stream;
+    stream << inStream.rdbuf ();
+    return stream.str ();
+}
+
+//----------------------------------------------------------------//
+TEST ( LedgerDump, round_trip ) {
+
+    Ledger ledger;
+    makeLedger ( ledger );
+
+    const char* files [] = { DUMP_FILE, DUMP_GZIP_FILE };
+    for ( const char* filename : files ) {
+    
+        ASSERT_TRUE ( ledger.dump ( filename, false, 16 ));
+        ASSERT_TRUE ( Ledger::isDumpStream ( filename ));
+    
+        Ledger restored;
+        restored.init ();
+        ASSERT_TRUE ( restored.restoreDump ( filename ));
+        
+        ASSERT_EQ ( restored.getIdentity (), ledger.getIdentity ());
+        ASSERT_EQ ( restored.getMaxBlockWeight (), ledger.getMaxBlockWeight ());
+        ASSERT_EQ ( restored.getBlockDelayInSeconds (), ledger.getBlockDelayInSeconds ());
+        ASSERT_EQ ( restored.getRewriteWindowInSeconds (), ledger.getRewriteWindowInSeconds ());
+        ASSERT_EQ ( restored.getSchemaHash (), ledger.getSchemaHash ());
+        expectSameAccounts ( ledger, restored );
+        
+        remove ( filename );
+    }
+}
+
+//----------------------------------------------------------------//
+TEST ( LedgerDump, genesis_matches_legacy ) {
+
+    Ledger ledger;
+    makeLedger ( ledger );
+
+    // the genesis block written from a dump stream must be the one the legacy path builds in memory.
+    shared_ptr < Transactions::LoadLedger > loadLedger = make_shared < Transactions::LoadLedger >();
+    loadLedger->init ( ledger );
+    
+    shared_ptr < Transaction > transaction = make_shared < Transaction >();
+    transaction->setBody ( loadLedger );
+    
+    Block expected;
+    expected.pushTransaction ( transaction );
+
+    ASSERT_TRUE ( ledger.dump ( DUMP_FILE, false, 16 ));
+    ASSERT_TRUE ( Ledger::writeGenesisBlock ( DUMP_FILE, GENESIS_FILE ));
+    
+    Block block;
+    FromJSONSerializer::fromJSONFile ( block, GENESIS_FILE );
+    ASSERT_EQ ( ToJSONSerializer::toJSONString ( block ), ToJSONSerializer::toJSONString ( expected ));
+    
+    remove ( DUMP_FILE );
+    remove ( GENESIS_FILE );
+}
+
+//----------------------------------------------------------------//
+TEST ( LedgerDump, resume ) {
+
+    Ledger ledger;
+    makeLedger ( ledger );
+
+    ASSERT_TRUE ( ledger.dump ( DUMP_FILE, false, 16 ));
+    string complete = loadFile ( DUMP_FILE );
+    
+    // cut the dump off partway through an account record, then resume it.
+    size_t cut = complete.find ( "\"index\":20" );
+    ASSERT_TRUE ( cut != string::npos );
+    {
+        ofstream outStream ( DUMP_FILE, ios_base::out | ios_base::binary | ios_base::trunc );
+        outStream << complete.substr ( 0, cut + 5 );
+    }
+    ASSERT_TRUE ( ledger.dump ( DUMP_FILE, true, 16 ));
+    ASSERT_EQ ( loadFile ( DUMP_FILE ), complete );
+    
+    // a dump taken at some other block must not be appended to.
+    size_t headerEnd = complete.find ( '\n' );
+    string header = complete.substr ( 0, headerEnd );
+    size_t hashAt = header.find ( "\"blockHash\":\"\"" );
+    ASSERT_TRUE ( hashAt != string::npos );
+    header.replace ( hashAt, 14, "\"blockHash\":\"00\"" );
+    {
+        ofstream outStream ( DUMP_FILE, ios_base::out | ios_base::binary | ios_base::trunc );
+        outStream << header << "\n";
+    }
+    ASSERT_FALSE ( ledger.dump ( DUMP_FILE, true, 16 ));
+    
+    remove ( DUMP_FILE );
+}
+
+//----------------------------------------------------------------//
+TEST ( LedgerSnapshot, manifest ) {
+
+    CryptoKeyPair key;
+    key.elliptic ();
+    Signature visage = key.sign ( "visage", Digest::HASH_ALGORITHM_SHA256 );
+
+    // a short chain; only the block records are written, since a manifest only names the block it was taken after.
+    vector < shared_ptr < const Block >> blocks;
+    
+    Ledger ledger;
+    makeLedger ( ledger );
+    
+    for ( size_t i = 0; i < 3; ++i ) {
+    
+        shared_ptr < Block > block = make_shared < Block >();
+        block->initialize ( "9090", 0, visage, ( time_t )i, i ? blocks.back ().get () : NULL, key );
+        block->sign ( key );
+        blocks.push_back ( block );
+        
+        BlockODBM blockODBM ( ledger, i );
+        blockODBM.mHash.set ( block->getDigest ().toHex ());
+        blockODBM.mPose.set ( block->getPose ().toHex ());
+        blockODBM.mHeader.set ( *block );
+        blockODBM.mBlock.set ( *block );
+        ledger.pushVersion ();
+    }
+    
+    shared_ptr < const LedgerSnapshotManifest > manifest = LedgerSnapshot::makeManifest ( ledger, 16 );
+    ASSERT_TRUE ( manifest && manifest->isConsistent ());
+    ASSERT_EQ ( manifest->mHeight, 2 );
+    ASSERT_EQ ( manifest->countChunks (), 4 );
+    
+    // the background builder reads the ledger a chunk at a time and must come up with the same manifest.
+    {
+        LedgerSnapshotCache cache ([ & ]( u64 height, const function < void ( AbstractLedger& )>& visitor ) {
+            if ( ledger.countBlocks () <= height ) return false;
+            visitor ( ledger );
+            return true;
+        }, 16 );
+        
+        string blockHash = manifest->mBlockHash;
+        shared_ptr < const LedgerSnapshotManifest > built = cache.getManifest ( 2, blockHash );
+        for ( size_t i = 0; ( i < 500 ) && !built; ++i ) {
+            this_thread::sleep_for ( chrono::milliseconds ( 10 ));
+            built = cache.getManifest ( 2, blockHash );
+        }
+        ASSERT_TRUE ( built );
+        ASSERT_EQ ( built->getDigest (), manifest->getDigest ());
+    }
+    
+    // what a peer downloads: every chunk in order, then the end record.
+    {
+        ofstream outStream ( SNAPSHOT_FILE, ios_base::out | ios_base::binary | ios_base::trunc );
+        for ( size_t i = 0; i < manifest->countChunks (); ++i ) {
+            string chunk = LedgerSnapshot::encodeChunk ( ledger, 16, i );
+            ASSERT_TRUE ( manifest->verifyChunk ( i, chunk ));
+            outStream << chunk;
+        }
+        outStream << LedgerSnapshot::encodeEnd ( *manifest );
+    }
+    
+    // the download is an ordinary dump, restored like any other.
+    ASSERT_TRUE ( Ledger::isDumpStream ( SNAPSHOT_FILE ));
+    
+    Ledger restored;
+    restored.init ();
+    ASSERT_TRUE ( restored.restoreDump ( SNAPSHOT_FILE ));
+    
+    ASSERT_EQ ( restored.getIdentity (), ledger.getIdentity ());
+    ASSERT_EQ ( restored.getSchemaHash (), ledger.getSchemaHash ());
+    expectSameAccounts ( ledger, restored );
+    
+    remove ( SNAPSHOT_FILE );
+}
@@ -0,0 +1,251 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <gtest/gtest.h>
+#include <volition/Block.h>
+#include <volition/CryptoKeyPair.h>
+#include <volition/DeferredBlock.h>
+#include <volition/LedgerEventFeed.h>
+#include <volition/Miner.h>
+#include <volition/Transaction.h>
+#include <volition/TransactionMaker.h>
+#include <volition/Transactions.h>
+#include <thread>
+
+using namespace Volition;
+
+//----------------------------------------------------------------//
+static shared_ptr < const Transaction > makeTransaction ( shared_ptr < AbstractTransactionBody > body, string makerName, string uuid ) {
+
+    TransactionMaker maker;
+    maker.setAccountName ( makerName );
+    maker.setKeyName ( "master" );
+
+    body->setMaker ( maker );
+    body->setUUID ( uuid );
+
+    shared_ptr < Transaction > transaction = make_shared < Transaction >();
+    transaction->setBody ( body );
+    return transaction;
+}
+
+//----------------------------------------------------------------//
+static shared_ptr < const Transaction > makeSendVOL ( string makerName, string receiver, string uuid ) {
+
+    shared_ptr < Transactions::SendVOL > body = make_shared < Transactions::SendVOL >();
+    body->mAccountName  = receiver;
+    body->mAmount       = 1;
+    return makeTransaction ( body, makerName, uuid );
+}
+
+//----------------------------------------------------------------//
+static shared_ptr < Block > makeBlock ( string minerID, const Block* prevBlock, const vector < shared_ptr < const Transaction >>& transactions, const CryptoKeyPair& key ) {
+
+    shared_ptr < Block > block = make_shared < Block >();
+    block->initialize ( minerID, 0, Miner::calculateVisage ( key ), prevBlock ? prevBlock->getTime () + 1 : 0, prevBlock, key );
+    for ( size_t i = 0; i < transactions.size (); ++i ) {
+        block->pushTransaction ( transactions [ i ]);
+    }
+    block->sign ( key );
+    return block;
+}
+
+//----------------------------------------------------------------//
+static LedgerEventFeed::WaitResult poll ( const LedgerEventFeed& feed, u64 since, const set < string >& accounts, const set < string >& transactions, vector < LedgerEvent >& events, u64& next ) {
+
+    events.clear ();
+    return feed.wait ( since, accounts, transactions, 0, events, next );
+}
+
+//----------------------------------------------------------------//
+TEST ( LedgerEventFeed, wait ) {
+
+    CryptoKeyPair key;
+    key.elliptic ();
+
+    LedgerEventFeed feed;
+    DeferredBlockList none;
+
+    vector < LedgerEvent > events;
+    u64 next = 0;
+
+    shared_ptr < Block > block0 = makeBlock ( "9090", NULL, {}, key );
+    feed.publish ( *block0, none, false );
+
+    ASSERT_EQ ( poll ( feed, 0, { "alice" }, {}, events, next ), LedgerEventFeed::WAIT_OK );
+    ASSERT_EQ ( events.size (), ( size_t )0 );
+    ASSERT_EQ ( next, ( u64 )1 );
+
+    // a send touches its maker, its receiver and the block's miner; nobody else.
+    shared_ptr < Block > block1 = makeBlock ( "9090", block0.get (), { makeSendVOL ( "alice", "bob", "alice-0" )}, key );
+    feed.publish ( *block1, none, false );
+
+    ASSERT_EQ ( poll ( feed, 1, { "bob" }, {}, events, next ), LedgerEventFeed::WAIT_OK );
+    ASSERT_EQ ( events.size (), ( size_t )1 );
+    ASSERT_FALSE ( events [ 0 ].mEveryone );
+    ASSERT_EQ ( events [ 0 ].mHeight, ( u64 )1 );
+    ASSERT_EQ (( const set < string >& )events [ 0 ].mAccounts, set < string >({ "9090", "alice", "bob" }));
+    ASSERT_EQ ( next, ( u64 )2 );
+
+    ASSERT_EQ ( poll ( feed, 1, { "carol" }, {}, events, next ), LedgerEventFeed::WAIT_OK );
+    ASSERT_EQ ( events.size (), ( size_t )0 );
+
+    ASSERT_EQ ( poll ( feed, 1, {}, { "alice-0" }, events, next ), LedgerEventFeed::WAIT_OK );
+    ASSERT_EQ ( events.size (), ( size_t )1 );
+
+    // a reader blocked on the feed wakes when a matching block is published.
+    vector < LedgerEvent > waited;
+    u64 waitedNext = 0;
+    LedgerEventFeed::WaitResult waitedResult = LedgerEventFeed::WAIT_BUSY;
+
+    thread waiter ([ & ]() {
+        waitedResult = feed.wait ( 2, { "carol" }, {}, 10000, waited, waitedNext );
+    });
+
+    shared_ptr < Block > block2 = makeBlock ( "9090", block1.get (), { makeSendVOL ( "alice", "carol", "alice-1" )}, key );
+    feed.publish ( *block2, none, false );
+    waiter.join ();
+
+    ASSERT_EQ ( waitedResult, LedgerEventFeed::WAIT_OK );
+    ASSERT_EQ ( waited.size (), ( size_t )1 );
+    ASSERT_EQ ( waited [ 0 ].mHeight, ( u64 )2 );
+    ASSERT_EQ ( waitedNext, ( u64 )3 );
+
+    // a body that doesn't declare what it writes wakes everyone.
+    shared_ptr < Transactions::RenameAccount > rename = make_shared < Transactions::RenameAccount >();
+    rename->mRevealedName = "dan";
+    shared_ptr < Block > block3 = makeBlock ( "9090", block2.get (), { makeTransaction ( rename, "dave", "dave-0" )}, key );
+    feed.publish ( *block3, none, false );
+
+    ASSERT_EQ ( poll ( feed, 3, { "carol" }, {}, events, next ), LedgerEventFeed::WAIT_OK );
+    ASSERT_EQ ( events.size (), ( size_t )1 );
+    ASSERT_TRUE ( events [ 0 ].mEveryone );
+
+    // deferred transactions maturing with a block are reported by the accounts they touch.
+    DeferredTransaction deferredTransaction;
+    deferredTransaction.mTransaction = makeSendVOL ( "erin", "frank", "erin-0" );
+
+    DeferredBlock deferredBlock;
+    deferredBlock.mMinerID = "9091";
+    deferredBlock.mTransactions.push_back ( deferredTransaction );
+
+    DeferredBlockList matured;
+    matured.mBlocks.push_back ( deferredBlock );
+
+    shared_ptr < Block > block4 = makeBlock ( "9090", block3.get (), {}, key );
+    feed.publish ( *block4, matured, false );
+
+    ASSERT_EQ ( poll ( feed, 4, { "frank" }, {}, events, next ), LedgerEventFeed::WAIT_OK );
+    ASSERT_EQ ( events.size (), ( size_t )1 );
+    ASSERT_FALSE ( events [ 0 ].mEveryone );
+    ASSERT_EQ (( const set < string >& )events [ 0 ].mAccounts, set < string >({ "9090", "9091", "erin", "frank" }));
+
+    ASSERT_EQ ( poll ( feed, 4, { "bob" }, {}, events, next ), LedgerEventFeed::WAIT_OK );
+    ASSERT_EQ ( events.size (), ( size_t )0 );
+}
+
+//----------------------------------------------------------------//
+TEST ( LedgerEventFeed, resync_and_rewind ) {
+
+    CryptoKeyPair key;
+    key.elliptic ();
+
+    LedgerEventFeed feed;
+    DeferredBlockList none;
+
+    vector < LedgerEvent > events;
+    u64 next = 0;
+
+    shared_ptr < Block > block0 = makeBlock ( "9090", NULL, {}, key );
+    shared_ptr < Block > block1 = makeBlock ( "9090", block0.get (), {}, key );
+    shared_ptr < Block > block2 = makeBlock ( "9090", block1.get (), {}, key );
+
+    feed.publish ( *block0, none, false );
+    feed.publish ( *block1, none, false );
+    feed.publish ( *block2, none, false );
+
+    ASSERT_EQ ( poll ( feed, 0, { "alice" }, {}, events, next ), LedgerEventFeed::WAIT_OK );
+    ASSERT_EQ ( events.size (), ( size_t )0 );
+    ASSERT_EQ ( next, ( u64 )3 );
+
+    // a block at or below the last height replaces history, so it's news to everyone.
+    shared_ptr < Block > block1b = makeBlock ( "9091", block0.get (), {}, key );
+    feed.publish ( *block1b, none, false );
+
+    ASSERT_EQ ( poll ( feed, 3, { "alice" }, {}, events, next ), LedgerEventFeed::WAIT_OK );
+    ASSERT_EQ ( events.size (), ( size_t )1 );
+    ASSERT_TRUE ( events [ 0 ].mEveryone );
+    ASSERT_EQ ( events [ 0 ].mHeight, ( u64 )1 );
+
+    // moving forward again is not.
+    shared_ptr < Block > block2b = makeBlock ( "9091", block1b.get (), {}, key );
+    feed.publish ( *block2b, none, false );
+
+    ASSERT_EQ ( poll ( feed, 4, { "alice" }, {}, events, next ), LedgerEventFeed::WAIT_OK );
+    ASSERT_EQ ( events.size (), ( size_t )0 );
+    ASSERT_EQ ( next, ( u64 )5 );
+
+    // a reader from the future (i.e. from before a restart) has to resync.
+    ASSERT_EQ ( poll ( feed, 100, { "alice" }, {}, events, next ), LedgerEventFeed::WAIT_RESYNC );
+    ASSERT_EQ ( next, ( u64 )5 );
+
+    // so does one that has fallen behind the retained window.
+    for ( size_t i = 0; i < LedgerEventFeed::MAX_EVENTS; ++i ) {
+        feed.publish ( *block2b, none, false );
+    }
+
+    ASSERT_EQ ( poll ( feed, 4, { "alice" }, {}, events, next ), LedgerEventFeed::WAIT_RESYNC );
+    ASSERT_EQ ( events.size (), ( size_t )0 );
+    ASSERT_EQ ( next, ( u64 )( LedgerEventFeed::MAX_EVENTS + 5 ));
+
+    ASSERT_EQ ( poll ( feed, 5, { "alice" }, {}, events, next ), LedgerEventFeed::WAIT_OK );
+    ASSERT_EQ ( events.size (), LedgerEventFeed::MAX_EVENTS );
+}
+
+//----------------------------------------------------------------//
+TEST ( LedgerEventFeed, max_waiters ) {
+
+    CryptoKeyPair key;
+    key.elliptic ();
+
+    LedgerEventFeed feed;
+    DeferredBlockList none;
+
+    vector < LedgerEvent > events;
+    u64 next = 0;
+
+    feed.setMaxWaiters ( 0 );
+    ASSERT_EQ ( poll ( feed, 0, { "alice" }, {}, events, next ), LedgerEventFeed::WAIT_BUSY );
+    ASSERT_EQ ( next, ( u64 )0 );
+
+    // with room for one, a second reader is turned away while the first is blocked.
+    feed.setMaxWaiters ( 1 );
+
+    vector < LedgerEvent > waited;
+    u64 waitedNext = 0;
+    LedgerEventFeed::WaitResult waitedResult = LedgerEventFeed::WAIT_BUSY;
+
+    thread waiter ([ & ]() {
+        waitedResult = feed.wait ( 0, { "alice" }, {}, 10000, waited, waitedNext );
+    });
+
+    LedgerEventFeed::WaitResult result = LedgerEventFeed::WAIT_OK;
+    for ( size_t i = 0; ( i < 5000 ) && ( result != LedgerEventFeed::WAIT_BUSY ); ++i ) {
+        result = poll ( feed, 0, { "alice" }, {}, events, next );
+        if ( result != LedgerEventFeed::WAIT_BUSY ) {
+            this_thread::sleep_for ( chrono::milliseconds ( 1 ));
+        }
+    }
+    ASSERT_EQ ( result, LedgerEventFeed::WAIT_BUSY );
+
+    shared_ptr < Block > block0 = makeBlock ( "9090", NULL, { makeSendVOL ( "alice", "bob", "alice-0" )}, key );
+    feed.publish ( *block0, none, false );
+    waiter.join ();
+
+    ASSERT_EQ ( waitedResult, LedgerEventFeed::WAIT_OK );
+    ASSERT_EQ ( waited.size (), ( size_t )1 );
+
+    // the slot is given back once the reader is done.
+    ASSERT_EQ ( poll ( feed, 0, { "alice" }, {}, events, next ), LedgerEventFeed::WAIT_OK );
+    ASSERT_EQ ( events.size (), ( size_t )1 );
+}
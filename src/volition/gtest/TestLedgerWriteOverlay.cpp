@@ -0,0 +1,224 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <gtest/gtest.h>
+#include <volition/AccountODBM.h>
+#include <volition/Block.h>
+#include <volition/CryptoKeyPair.h>
+#include <volition/Format.h>
+#include <volition/Ledger.h>
+#include <volition/LedgerWriteOverlay.h>
+#include <volition/Miner.h>
+#include <volition/Transaction.h>
+#include <volition/TransactionMaker.h>
+#include <volition/TransactionQueue.h>
+#include <volition/Transactions.h>
+
+using namespace Volition;
+
+//----------------------------------------------------------------//
+static string encodeAccount ( Ledger& ledger, string accountName ) {
+
+    AccountID::Index accountID = ledger.getAccountID ( accountName );
+    return Ledger_Dump::encodeAccountRange ( ledger, accountID, accountID + 1 );
+}
+
+//----------------------------------------------------------------//
+static shared_ptr < Block > makeGenesis ( const CryptoKeyPair& key ) {
+
+    shared_ptr < Transactions::Genesis > body = make_shared < Transactions::Genesis >();
+    body->setIdentity ( "TEST" );
+    body->setBlockDelayInSeconds ( 1 );
+    body->setRewriteWindowInSeconds ( 10 );
+    body->setMaxBlockWeight ( 1024 );
+
+    const char* names [] = { "9090", "alice", "bob" };
+    for ( const char* name : names ) {
+        Transactions::GenesisAccount account;
+        account.mName       = name;
+        account.mKey        = key.getPublicKey ();
+        account.mGrant      = 1000;
+        if ( account.mName == "9090" ) {
+            account.mMinerInfo = make_shared < MinerInfo >( "http://127.0.0.1", key.getPublicKey (), "", Miner::calculateVisage ( key ));
+        }
+        body->pushAccount ( account );
+    }
+
+    shared_ptr < Transaction > transaction = make_shared < Transaction >();
+    transaction->setBody ( body );
+
+    shared_ptr < Block > genesis = make_shared < Block >();
+    genesis->setBlockDelayInSeconds ( 1 );
+    genesis->setRewriteWindow ( 10 );
+    genesis->pushTransaction ( transaction );
+    genesis->affirmHash ();
+    return genesis;
+}
+
+//----------------------------------------------------------------//
+static shared_ptr < Block > makeBlock ( const Ledger& chain, const CryptoKeyPair& key ) {
+
+    shared_ptr < const Block > prevBlock = chain.getBlock ();
+    assert ( prevBlock );
+
+    shared_ptr < Block > block = make_shared < Block >();
+    block->initialize ( "9090", 0, Miner::calculateVisage ( key ), prevBlock->getTime () + 1, prevBlock.get (), key );
+    block->setBlockDelayInSeconds ( 1 );
+    block->setRewriteWindow ( 10 );
+    block->setReward ( "" );
+    return block;
+}
+
+//----------------------------------------------------------------//
+static shared_ptr < const Transaction > makeSendVOL ( string makerName, u64 nonce, string receiver, u64 amount, u64 maxHeight, const CryptoKeyPair& key ) {
+
+    TransactionMaker maker;
+    maker.setAccountName ( makerName );
+    maker.setKeyName ( Ledger::MASTER_KEY_NAME );
+    maker.setNonce ( nonce );
+
+    shared_ptr < Transactions::SendVOL > body = make_shared < Transactions::SendVOL >();
+    body->mAccountName  = receiver;
+    body->mAmount       = amount;
+    body->setMaker ( maker );
+    body->setMaxHeight ( maxHeight );
+    body->setUUID ( Format::write ( "%s-%d", makerName.c_str (), ( int )nonce ));
+
+    shared_ptr < Transaction > transaction = make_shared < Transaction >();
+    transaction->setBody ( body );
+    transaction->sign ( key );
+    return transaction;
+}
+
+//----------------------------------------------------------------//
+TEST ( LedgerWriteOverlay, commit_and_discard ) {
+
+    Ledger ledger;
+    ledger.init ();
+
+    CryptoKeyPair key;
+    key.elliptic ();
+
+    Policy keyPolicy;
+    Policy accountPolicy;
+
+    {
+        LedgerWriteOverlay overlay ( ledger );
+        ASSERT_TRUE ( ledger.newAccount ( "alice", 1000, "master", key.getPublicKey (), keyPolicy, accountPolicy ));
+        ASSERT_TRUE ( ledger.getAccountID ( "alice" ) != AccountID::NULL_INDEX );
+        ASSERT_TRUE ( overlay.countKeys () > 0 );
+        overlay.discard ();
+        ASSERT_TRUE ( ledger.getAccountID ( "alice" ) == AccountID::NULL_INDEX );
+    }
+    ASSERT_TRUE ( ledger.getAccountID ( "alice" ) == AccountID::NULL_INDEX );
+
+    {
+        LedgerWriteOverlay overlay ( ledger );
+        ASSERT_TRUE ( ledger.newAccount ( "alice", 1000, "master", key.getPublicKey (), keyPolicy, accountPolicy ));
+        overlay.commit ();
+    }
+    ASSERT_TRUE ( ledger.getAccountID ( "alice" ) != AccountID::NULL_INDEX );
+
+    // LedgerKey and string keys reach the same value, through the overlay or not.
+    {
+        LedgerWriteOverlay overlay ( ledger );
+        ledger.setValue < u64 >( Ledger::keyFor_blockHeightByHash ( "test" ), 7 );
+        ASSERT_TRUE ( ledger.hasValue ( Ledger::keyFor_blockHeightByHash ( "test" )));
+        ASSERT_EQ ( ledger.getValue < u64 >( string ( "blockHeightByHash.test" )), ( u64 )7 );
+        overlay.commit ();
+    }
+    ASSERT_EQ ( ledger.getValue < u64 >( Ledger::keyFor_blockHeightByHash ( "test" )), ( u64 )7 );
+    ASSERT_EQ ( ledger.getValueOrFallback < u64 >( string ( "blockHeightByHash.test" ), 0 ), ( u64 )7 );
+}
+
+//----------------------------------------------------------------//
+TEST ( LedgerWriteOverlay, matches_versions ) {
+
+    // the genesis registers this key as a miner's, and MinerInfo only takes RSA keys.
+    CryptoKeyPair key;
+    key.rsa ();
+
+    Ledger chain;
+    ASSERT_TRUE ( chain.pushBlock ( *makeGenesis ( key ), Block::VerificationPolicy::NONE ));
+
+    // two makers; bob's second send can't be paid for, so it fails and has to leave no trace.
+    vector < shared_ptr < const Transaction >> attempts;
+    attempts.push_back ( makeSendVOL ( "alice", 0, "bob", 10, 0, key ));
+    attempts.push_back ( makeSendVOL ( "bob", 0, "alice", 3, 0, key ));
+    attempts.push_back ( makeSendVOL ( "alice", 1, "bob", 5, 0, key ));
+    attempts.push_back ( makeSendVOL ( "bob", 1, "alice", 100000, 0, key ));
+
+    // fill a block from the queue; the transactions are tried in the order above.
+    shared_ptr < Block > block = makeBlock ( chain, key );
+
+    TransactionQueue queue;
+    for ( size_t i = 0; i < attempts.size (); ++i ) {
+        queue.pushTransaction ( attempts [ i ]);
+    }
+    queue.fillBlock ( chain, *block, Block::ALL );
+
+    ASSERT_EQ ( block->countTransactions (), ( size_t )3 );
+    ASSERT_EQ ( block->getTransaction ( 0 )->getUUID (), "alice-0" );
+    ASSERT_EQ ( block->getTransaction ( 1 )->getUUID (), "bob-0" );
+    ASSERT_EQ ( block->getTransaction ( 2 )->getUUID (), "alice-1" );
+
+    // the same attempts the way fillBlock used to make them: a version pushed for each, and
+    // popped again if the transaction fails.
+    Ledger reference ( chain );
+    u64 blockHeight = block->getHeight ();
+    u64 transactionIndex = 0;
+
+    for ( size_t i = 0; i < attempts.size (); ++i ) {
+
+        reference.pushVersion ();
+        TransactionResult result = attempts [ i ]->apply ( reference, blockHeight, block->getRelease (), transactionIndex, block->getTime (), Block::ALL );
+        if ( result ) {
+            transactionIndex++;
+        }
+        else {
+            reference.popVersion ();
+        }
+        ASSERT_EQ (( bool )result, ( i < 3 ));
+    }
+
+    // applying the filled block (one overlay per transaction) ends in the same account state.
+    block->sign ( key );
+    ASSERT_TRUE ( chain.pushBlock ( *block, Block::VerificationPolicy::NONE ));
+
+    const char* names [] = { "alice", "bob" };
+    for ( const char* name : names ) {
+        ASSERT_EQ ( encodeAccount ( chain, name ), encodeAccount ( reference, name ));
+        ASSERT_EQ ( AccountODBM ( chain, name ).mTransactionNonce.get (), AccountODBM ( reference, name ).mTransactionNonce.get ());
+    }
+    ASSERT_EQ ( AccountODBM ( chain, "alice" ).mBalance.get (), ( u64 )( 1000 - 10 - 5 + 3 ));
+    ASSERT_EQ ( AccountODBM ( chain, "bob" ).mTransactionNonce.get (), ( u64 )1 );
+}
+
+//----------------------------------------------------------------//
+TEST ( LedgerWriteOverlay, fill_block_height ) {
+
+    CryptoKeyPair key;
+    key.rsa ();
+
+    Ledger chain;
+    ASSERT_TRUE ( chain.pushBlock ( *makeGenesis ( key ), Block::VerificationPolicy::NONE ));
+
+    shared_ptr < Block > block = makeBlock ( chain, key );
+    u64 blockHeight = block->getHeight ();
+
+    // fillBlock's ledger stays at the block's height while the block fills, so a transaction
+    // expiring at that height is judged the same way here as when the block is applied (it
+    // used to see one height more for every transaction accepted ahead of it).
+    TransactionQueue queue;
+    queue.pushTransaction ( makeSendVOL ( "alice", 0, "bob", 10, blockHeight, key ));
+    queue.pushTransaction ( makeSendVOL ( "alice", 1, "bob", 10, blockHeight, key ));
+    queue.pushTransaction ( makeSendVOL ( "alice", 2, "bob", 10, blockHeight, key ));
+    queue.fillBlock ( chain, *block, Block::ALL );
+
+    ASSERT_EQ ( block->countTransactions (), ( size_t )3 );
+
+    block->sign ( key );
+    ASSERT_TRUE ( chain.pushBlock ( *block, Block::VerificationPolicy::NONE ));
+    ASSERT_EQ ( AccountODBM ( chain, "alice" ).mTransactionNonce.get (), ( u64 )3 );
+    ASSERT_EQ ( AccountODBM ( chain, "bob" ).mBalance.get (), ( u64 )1030 );
+}
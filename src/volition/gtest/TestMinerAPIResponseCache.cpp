@@ -0,0 +1,280 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <gtest/gtest.h>
+#include <volition/AbstractMinerAPIRequestHandler.h>
+#include <volition/Block.h>
+#include <volition/CryptoKeyPair.h>
+#include <volition/Format.h>
+#include <volition/Miner.h>
+#include <volition/MinerAPIResponseCache.h>
+#include <volition/Transaction.h>
+#include <volition/Transactions.h>
+
+using namespace Volition;
+
+//================================================================//
+// ResponseCacheMiner
+//================================================================//
+// A miner with just a genesis block, whose response epoch can be moved on
+// by hand.
+class ResponseCacheMiner :
+    public Miner {
+public:
+
+    //----------------------------------------------------------------//
+    void publishStatus () {
+        this->updateMinerStatus ();
+    }
+
+    //----------------------------------------------------------------//
+    ResponseCacheMiner () {
+
+        this->mBlockVerificationPolicy = Block::VerificationPolicy::NONE;
+
+        CryptoKeyPair key;
+        key.elliptic ();
+
+        this->setMinerID ( "9090" );
+        this->setKeyPair ( key );
+        this->setBlockTree ();
+
+        shared_ptr < Transactions::Genesis > body = make_shared < Transactions::Genesis >();
+        body->setIdentity ( "TEST" );
+        body->setBlockDelayInSeconds ( 1 );
+        body->setRewriteWindowInSeconds ( 10 );
+        body->setMaxBlockWeight ( 1024 );
+
+        Transactions::GenesisAccount account;
+        account.mName       = "9090";
+        account.mKey        = key.getPublicKey ();
+        account.mGrant      = 0;
+        body->pushAccount ( account );
+
+        shared_ptr < Transaction > transaction = make_shared < Transaction >();
+        transaction->setBody ( body );
+
+        shared_ptr < Block > genesis = make_shared < Block >();
+        genesis->setBlockDelayInSeconds ( 1 );
+        genesis->setRewriteWindow ( 10 );
+        genesis->pushTransaction ( transaction );
+        genesis->affirmHash ();
+
+        this->setGenesis ( genesis );
+    }
+};
+
+//================================================================//
+// ResponseCacheHandler
+//================================================================//
+// Calls the handler's cache hooks the way AbstractAPIRequestHandler does around
+// a GET: a lookup first, then (on a miss) a store of whatever was computed.
+class ResponseCacheHandler :
+    public AbstractMinerAPIRequestHandler {
+public:
+
+    SUPPORTED_HTTP_METHODS ( HTTP::GET )
+    CACHEABLE_RESPONSE
+
+    //----------------------------------------------------------------//
+    HTTPStatus AbstractMinerAPIRequestHandler_handleRequest ( HTTP::Method method, shared_ptr < Miner > miner, const Poco::JSON::Object& jsonIn, Poco::JSON::Object& jsonOut ) const override {
+        UNUSED ( method );
+        UNUSED ( miner );
+        UNUSED ( jsonIn );
+        UNUSED ( jsonOut );
+        return Poco::Net::HTTPResponse::HTTP_OK;
+    }
+
+    //----------------------------------------------------------------//
+    bool lookup ( string uri, HTTPStatus& status, string& body ) const {
+        return this->AbstractAPIRequestHandler_getCachedResponse ( uri, status, body );
+    }
+
+    //----------------------------------------------------------------//
+    void store ( string uri, HTTPStatus status, const string& body ) const {
+        this->AbstractAPIRequestHandler_setCachedResponse ( uri, status, body );
+    }
+};
+
+//----------------------------------------------------------------//
+static size_t entrySize ( string key, string body ) {
+
+    // key, body and the cache's fixed per-entry overhead (128 bytes).
+    return key.size () + body.size () + 128;
+}
+
+//----------------------------------------------------------------//
+static bool isCached ( MinerAPIResponseCache& cache, string epoch, string key ) {
+
+    int status;
+    string body;
+    return cache.get ( epoch, key, status, body );
+}
+
+//----------------------------------------------------------------//
+TEST ( MinerAPIResponseCache, epoch_change_flushes ) {
+
+    MinerAPIResponseCache cache;
+
+    ASSERT_FALSE ( isCached ( cache, "e0", "/a" ));
+    cache.set ( "e0", "/a", 200, "A" );
+    cache.set ( "e0", "/b", 404, "B" );
+    ASSERT_EQ ( cache.countEntries (), ( size_t )2 );
+
+    int status;
+    string body;
+    ASSERT_TRUE ( cache.get ( "e0", "/a", status, body ));
+    ASSERT_EQ ( status, 200 );
+    ASSERT_EQ ( body, "A" );
+
+    // the first lookup under a new epoch throws out everything from the old one.
+    ASSERT_FALSE ( isCached ( cache, "e1", "/b" ));
+    ASSERT_EQ ( cache.countEntries (), ( size_t )0 );
+    ASSERT_EQ ( cache.countBytes (), ( size_t )0 );
+
+    // and going back doesn't bring it back.
+    ASSERT_FALSE ( isCached ( cache, "e0", "/a" ));
+}
+
+//----------------------------------------------------------------//
+TEST ( MinerAPIResponseCache, stale_epoch_set_rejected ) {
+
+    MinerAPIResponseCache cache;
+
+    // a response computed under e0 arrives after a lookup under e1.
+    ASSERT_FALSE ( isCached ( cache, "e0", "/a" ));
+    ASSERT_FALSE ( isCached ( cache, "e1", "/b" ));
+
+    cache.set ( "e0", "/a", 200, "A" );
+    ASSERT_EQ ( cache.countEntries (), ( size_t )0 );
+    ASSERT_FALSE ( isCached ( cache, "e1", "/a" ));
+
+    cache.set ( "e1", "/a", 200, "A" );
+    ASSERT_TRUE ( isCached ( cache, "e1", "/a" ));
+}
+
+//----------------------------------------------------------------//
+TEST ( MinerAPIResponseCache, lru_evicts_by_bytes ) {
+
+    string body ( 100, 'x' );
+    size_t size = entrySize ( "/a", body );
+
+    MinerAPIResponseCache cache ( size * 3 );
+    ASSERT_FALSE ( isCached ( cache, "e0", "/a" ));
+
+    cache.set ( "e0", "/a", 200, body );
+    cache.set ( "e0", "/b", 200, body );
+    cache.set ( "e0", "/c", 200, body );
+    ASSERT_EQ ( cache.countEntries (), ( size_t )3 );
+    ASSERT_EQ ( cache.countBytes (), size * 3 );
+
+    // touching /a leaves /b least recently used.
+    ASSERT_TRUE ( isCached ( cache, "e0", "/a" ));
+    cache.set ( "e0", "/d", 200, body );
+    ASSERT_EQ ( cache.countEntries (), ( size_t )3 );
+    ASSERT_FALSE ( isCached ( cache, "e0", "/b" ));
+
+    // most recent first: /c, /a, /d. an entry twice the size takes two out, oldest first.
+    ASSERT_TRUE ( isCached ( cache, "e0", "/d" ));
+    ASSERT_TRUE ( isCached ( cache, "e0", "/a" ));
+    ASSERT_TRUE ( isCached ( cache, "e0", "/c" ));
+
+    string bigBody (( size * 2 ) - entrySize ( "/e", "" ), 'y' );
+
+    cache.set ( "e0", "/e", 200, bigBody );
+    ASSERT_EQ ( cache.countEntries (), ( size_t )2 );
+    ASSERT_EQ ( cache.countBytes (), size * 3 );
+    ASSERT_TRUE ( isCached ( cache, "e0", "/c" ));
+    ASSERT_TRUE ( isCached ( cache, "e0", "/e" ));
+    ASSERT_FALSE ( isCached ( cache, "e0", "/a" ));
+    ASSERT_FALSE ( isCached ( cache, "e0", "/d" ));
+
+    // an entry that could never fit isn't stored, and doesn't evict anything.
+    cache.set ( "e0", "/f", 200, string ( size * 3, 'z' ));
+    ASSERT_EQ ( cache.countEntries (), ( size_t )2 );
+    ASSERT_FALSE ( isCached ( cache, "e0", "/f" ));
+
+    // shrinking the cache evicts down to the new size.
+    cache.setMaxBytes ( size * 2 );
+    ASSERT_EQ ( cache.countEntries (), ( size_t )1 );
+    ASSERT_EQ ( cache.countBytes (), size * 2 );
+    ASSERT_TRUE ( isCached ( cache, "e0", "/e" ));
+}
+
+//----------------------------------------------------------------//
+TEST ( MinerAPIResponseCache, handler_stores_ok_and_not_found ) {
+
+    shared_ptr < ResponseCacheMiner > miner = make_shared < ResponseCacheMiner >();
+    shared_ptr < MinerAPIResponseCache > cache = make_shared < MinerAPIResponseCache >();
+
+    ResponseCacheHandler handler;
+    handler.initialize ( miner, cache );
+
+    Poco::Net::HTTPResponse::HTTPStatus status;
+    string body;
+
+    const Poco::Net::HTTPResponse::HTTPStatus statuses [] = {
+        Poco::Net::HTTPResponse::HTTP_OK,
+        Poco::Net::HTTPResponse::HTTP_NOT_FOUND,
+        Poco::Net::HTTPResponse::HTTP_BAD_REQUEST,
+        Poco::Net::HTTPResponse::HTTP_SERVICE_UNAVAILABLE,
+        Poco::Net::HTTPResponse::HTTP_INTERNAL_SERVER_ERROR,
+    };
+
+    for ( size_t i = 0; i < ( sizeof ( statuses ) / sizeof ( statuses [ 0 ])); ++i ) {
+        string uri = Format::write ( "/%d", ( int )statuses [ i ]);
+        ASSERT_FALSE ( handler.lookup ( uri, status, body ));
+        handler.store ( uri, statuses [ i ], uri );
+    }
+
+    // only the answers that are fully determined by the ledger are kept.
+    ASSERT_EQ ( cache->countEntries (), ( size_t )2 );
+
+    ASSERT_TRUE ( handler.lookup ( "/200", status, body ));
+    ASSERT_EQ ( status, Poco::Net::HTTPResponse::HTTP_OK );
+    ASSERT_EQ ( body, "/200" );
+
+    ASSERT_TRUE ( handler.lookup ( "/404", status, body ));
+    ASSERT_EQ ( status, Poco::Net::HTTPResponse::HTTP_NOT_FOUND );
+    ASSERT_EQ ( body, "/404" );
+
+    ASSERT_FALSE ( handler.lookup ( "/400", status, body ));
+    ASSERT_FALSE ( handler.lookup ( "/503", status, body ));
+    ASSERT_FALSE ( handler.lookup ( "/500", status, body ));
+}
+
+//----------------------------------------------------------------//
+TEST ( MinerAPIResponseCache, handler_drops_response_across_epochs ) {
+
+    shared_ptr < ResponseCacheMiner > miner = make_shared < ResponseCacheMiner >();
+    shared_ptr < MinerAPIResponseCache > cache = make_shared < MinerAPIResponseCache >();
+
+    ResponseCacheHandler handler;
+    handler.initialize ( miner, cache );
+
+    Poco::Net::HTTPResponse::HTTPStatus status;
+    string body;
+
+    ASSERT_FALSE ( handler.lookup ( "/a", status, body ));
+    handler.store ( "/a", Poco::Net::HTTPResponse::HTTP_OK, "A" );
+    ASSERT_EQ ( cache->countEntries (), ( size_t )1 );
+
+    // the miner publishes a new epoch while /b is being computed.
+    string epoch = miner->getResponseEpoch ();
+    ASSERT_FALSE ( handler.lookup ( "/b", status, body ));
+
+    miner->setMotto ( "moved on" );
+    miner->publishStatus ();
+    ASSERT_NE ( miner->getResponseEpoch (), epoch );
+
+    handler.store ( "/b", Poco::Net::HTTPResponse::HTTP_OK, "B" );
+    ASSERT_EQ ( cache->countEntries (), ( size_t )1 );
+
+    // the next lookup is under the new epoch, and finds nothing from the old one.
+    ASSERT_FALSE ( handler.lookup ( "/a", status, body ));
+    ASSERT_EQ ( cache->countEntries (), ( size_t )0 );
+
+    handler.store ( "/a", Poco::Net::HTTPResponse::HTTP_OK, "A2" );
+    ASSERT_TRUE ( handler.lookup ( "/a", status, body ));
+    ASSERT_EQ ( body, "A2" );
+}
@@ -0,0 +1,79 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <gtest/gtest.h>
+#include <volition/CryptoKey.h>
+#include <volition/Digest.h>
+#include <volition/ThePoseCache.h>
+
+using namespace Volition;
+
+//----------------------------------------------------------------//
+TEST ( ThePoseCache, sign ) {
+
+    ThePoseCache& cache = ThePoseCache::get ();
+
+    CryptoKeyPair key0;
+    key0.elliptic ();
+
+    CryptoKeyPair key1;
+    key1.elliptic ();
+
+    Digest digest ( "pose" );
+
+    // EC signatures are randomized, so getting the same bytes back means the second call was a hit.
+    Signature pose0 = cache.sign ( key0, digest, Digest::HASH_ALGORITHM_SHA256 );
+    ASSERT_TRUE ( key0.getPublicKey ().verify ( pose0, digest ));
+    ASSERT_EQ ( cache.sign ( key0, digest, Digest::HASH_ALGORITHM_SHA256 ), pose0 );
+
+    // another digest misses.
+    Digest other ( "other pose" );
+    Signature poseOther = cache.sign ( key0, other, Digest::HASH_ALGORITHM_SHA256 );
+    ASSERT_TRUE ( key0.getPublicKey ().verify ( poseOther, other ));
+    ASSERT_FALSE ( key0.getPublicKey ().verify ( poseOther, digest ));
+
+    // another hash algorithm misses, and the signature says which one it used.
+    Signature poseMD5 = cache.sign ( key0, digest, Digest::HASH_ALGORITHM_MD5 );
+    ASSERT_EQ ( poseMD5.getHashAlgorithm (), Digest::HASH_ALGORITHM_MD5 );
+    ASSERT_EQ ( cache.sign ( key0, digest, Digest::HASH_ALGORITHM_SHA256 ).getHashAlgorithm (), Digest::HASH_ALGORITHM_SHA256 );
+
+    // a rotated key never gets the old key's signature.
+    Signature pose1 = cache.sign ( key1, digest, Digest::HASH_ALGORITHM_SHA256 );
+    ASSERT_TRUE ( key1.getPublicKey ().verify ( pose1, digest ));
+    ASSERT_FALSE ( key1.getPublicKey ().verify ( pose0, digest ));
+    ASSERT_EQ ( cache.sign ( key1, digest, Digest::HASH_ALGORITHM_SHA256 ), pose1 );
+}
+
+//----------------------------------------------------------------//
+TEST ( ThePoseCache, verify ) {
+
+    ThePoseCache& cache = ThePoseCache::get ();
+
+    // RSA checks the hash algorithm as part of the signature, so a relabeled pose has to fail.
+    CryptoKeyPair key0;
+    key0.rsa ();
+
+    CryptoKeyPair key1;
+    key1.rsa ();
+
+    Digest digest ( "pose" );
+    Signature pose = key0.sign ( digest, Digest::HASH_ALGORITHM_SHA256 );
+
+    // a hit is as good as the check it stands in for.
+    ASSERT_TRUE ( cache.verify ( key0.getPublicKey (), pose, digest ));
+    ASSERT_TRUE ( cache.verify ( key0.getPublicKey (), pose, digest ));
+
+    // the same bytes under another hash algorithm don't hit the verified entry.
+    Signature relabeled ( pose.getSignature (), Digest::HASH_ALGORITHM_MD5 );
+    ASSERT_FALSE ( cache.verify ( key0.getPublicKey (), relabeled, digest ));
+
+    // nor does another digest, or another key.
+    ASSERT_FALSE ( cache.verify ( key0.getPublicKey (), pose, Digest ( "other pose" )));
+    ASSERT_FALSE ( cache.verify ( key1.getPublicKey (), pose, digest ));
+
+    // a rotated key checks its own pose, and only that.
+    Signature pose1 = key1.sign ( digest, Digest::HASH_ALGORITHM_SHA256 );
+    ASSERT_FALSE ( cache.verify ( key1.getPublicKey (), pose, digest ));
+    ASSERT_TRUE ( cache.verify ( key1.getPublicKey (), pose1, digest ));
+    ASSERT_TRUE ( cache.verify ( key1.getPublicKey (), pose1, digest ));
+}
@@ -0,0 +1,274 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <gtest/gtest.h>
+#include <volition/AbstractMiningMessenger.h>
+#include <volition/Block.h>
+#include <volition/CryptoKeyPair.h>
+#include <volition/Format.h>
+#include <volition/Ledger.h>
+#include <volition/Miner.h>
+#include <volition/MinerInfo.h>
+#include <volition/Transaction.h>
+#include <volition/TransactionMaker.h>
+#include <volition/Transactions.h>
+
+using namespace Volition;
+
+//================================================================//
+// QuietMiningMessenger
+//================================================================//
+// Queues requests and never sends them; remote miners stay offline.
+class QuietMiningMessenger :
+    public AbstractMiningMessenger {
+protected:
+
+    //----------------------------------------------------------------//
+    bool AbstractMiningMessenger_isFull ( MiningMessengerRequest::Type requestType ) const override {
+        UNUSED ( requestType );
+        return false;
+    }
+
+    //----------------------------------------------------------------//
+    void AbstractMiningMessenger_sendRequest ( const MiningMessengerRequest& request ) override {
+        UNUSED ( request );
+    }
+};
+
+//================================================================//
+// RegistryMiner
+//================================================================//
+// A miner whose chain is built (and rewound) by hand, to watch which miner
+// URLs updateRemoteMiners picks up from the ledger. "9090" mines every
+// block; "9091" and "9092" start out as plain accounts.
+class RegistryMiner :
+    public Miner {
+public:
+
+    //----------------------------------------------------------------//
+    size_t countRemoteMiners () const {
+        return this->mRemoteMiners.size ();
+    }
+
+    //----------------------------------------------------------------//
+    string getRegistryStamp () const {
+        return this->mMinerRegistryStamp;
+    }
+
+    //----------------------------------------------------------------//
+    bool hasRemoteMiner ( string url ) const {
+        return ( this->mRemoteMinersByURL.find ( url ) != this->mRemoteMinersByURL.cend ());
+    }
+
+    //----------------------------------------------------------------//
+    void pushTransaction ( shared_ptr < const Transaction > transaction ) {
+
+        shared_ptr < const Block > prevBlock = this->mLedger->getBlock ();
+        assert ( prevBlock );
+
+        shared_ptr < Block > block = make_shared < Block >();
+        block->initialize ( "9090", 0, Miner::calculateVisage ( this->mKeyPair ), prevBlock->getTime () + 1, prevBlock.get (), this->mKeyPair );
+        block->setBlockDelayInSeconds ( 1 );
+        block->setRewriteWindow ( 10 );
+        block->setReward ( "" );
+        block->pushTransaction ( transaction );
+        block->sign ( this->mKeyPair );
+
+        this->pushBlock ( block );
+    }
+
+    //----------------------------------------------------------------//
+    RegistryMiner ( const CryptoKeyPair& key ) {
+
+        this->mBlockVerificationPolicy = Block::VerificationPolicy::NONE;
+
+        this->setMinerID ( "9090" );
+        this->setKeyPair ( key );
+        this->setMessenger ( make_shared < QuietMiningMessenger >());
+        this->setBlockTree ();
+
+        shared_ptr < Transactions::Genesis > body = make_shared < Transactions::Genesis >();
+        body->setIdentity ( "TEST" );
+        body->setBlockDelayInSeconds ( 1 );
+        body->setRewriteWindowInSeconds ( 10 );
+        body->setMaxBlockWeight ( 1024 );
+
+        const char* names [] = { "9090", "9091", "9092" };
+        for ( const char* name : names ) {
+            Transactions::GenesisAccount account;
+            account.mName       = name;
+            account.mKey        = key.getPublicKey ();
+            account.mGrant      = 1000;
+            if ( account.mName == "9090" ) {
+                account.mMinerInfo = make_shared < MinerInfo >( "http://127.0.0.1:9090", key.getPublicKey (), "", Miner::calculateVisage ( key ));
+            }
+            body->pushAccount ( account );
+        }
+
+        shared_ptr < Transaction > transaction = make_shared < Transaction >();
+        transaction->setBody ( body );
+
+        shared_ptr < Block > genesis = make_shared < Block >();
+        genesis->setBlockDelayInSeconds ( 1 );
+        genesis->setRewriteWindow ( 10 );
+        genesis->pushTransaction ( transaction );
+        genesis->affirmHash ();
+
+        this->setGenesis ( genesis );
+    }
+
+    //----------------------------------------------------------------//
+    void rewind ( u64 height ) {
+
+        BlockTreeCursor cursor = this->mLedgerTag.getCursor ();
+        while ( cursor.getHeight () > height ) {
+            cursor = cursor.getParent ();
+        }
+        this->composeChain ( cursor );
+        assert ( this->mLedger->countBlocks () == ( height + 1 ));
+    }
+
+    //----------------------------------------------------------------//
+    void updateRegistry () {
+        this->updateRemoteMiners ();
+    }
+};
+
+//----------------------------------------------------------------//
+static shared_ptr < const Transaction > makeTransaction ( shared_ptr < AbstractTransactionBody > body, string makerName, u64 nonce, const CryptoKeyPair& key ) {
+
+    TransactionMaker maker;
+    maker.setAccountName ( makerName );
+    maker.setKeyName ( Ledger::MASTER_KEY_NAME );
+    maker.setNonce ( nonce );
+
+    body->setMaker ( maker );
+    body->setUUID ( Format::write ( "%s-%d", makerName.c_str (), ( int )nonce ));
+
+    shared_ptr < Transaction > transaction = make_shared < Transaction >();
+    transaction->setBody ( body );
+    transaction->sign ( key );
+    return transaction;
+}
+
+//----------------------------------------------------------------//
+static shared_ptr < const Transaction > makeRegisterMiner ( string accountName, string url, u64 nonce, const CryptoKeyPair& key ) {
+
+    shared_ptr < Transactions::RegisterMiner > body = make_shared < Transactions::RegisterMiner >();
+    body->mAccountName  = accountName;
+    body->mMinerInfo    = make_shared < MinerInfo >( url, key.getPublicKey (), "", Miner::calculateVisage ( key ));
+
+    // 9090 registers the others.
+    return makeTransaction ( body, "9090", nonce, key );
+}
+
+//----------------------------------------------------------------//
+static shared_ptr < const Transaction > makeUpdateMinerURL ( string accountName, string url, u64 nonce, const CryptoKeyPair& key ) {
+
+    shared_ptr < Transactions::UpdateMinerInfo > body = make_shared < Transactions::UpdateMinerInfo >();
+    body->mMinerInfo    = make_shared < MinerInfo >( url, key.getPublicKey (), "", Miner::calculateVisage ( key ));
+
+    // a miner can only update its own info.
+    return makeTransaction ( body, accountName, nonce, key );
+}
+
+//----------------------------------------------------------------//
+TEST ( RemoteMiners, new_registration ) {
+
+    // miner info only takes RSA keys.
+    CryptoKeyPair key;
+    key.rsa ();
+
+    RegistryMiner miner ( key );
+
+    // only this miner is registered, and it doesn't track itself.
+    miner.updateRegistry ();
+    ASSERT_EQ ( miner.countRemoteMiners (), ( size_t )0 );
+    ASSERT_EQ ( miner.getRegistryStamp (), miner.getLedger ().getMinerRegistryStamp ());
+
+    string stamp = miner.getRegistryStamp ();
+
+    miner.pushTransaction ( makeRegisterMiner ( "9091", "http://127.0.0.1:9091", 0, key ));
+    ASSERT_NE ( miner.getLedger ().getMinerRegistryStamp (), stamp );
+
+    miner.updateRegistry ();
+    ASSERT_EQ ( miner.countRemoteMiners (), ( size_t )1 );
+    ASSERT_TRUE ( miner.hasRemoteMiner ( "http://127.0.0.1:9091" ));
+    ASSERT_EQ ( miner.getRegistryStamp (), miner.getLedger ().getMinerRegistryStamp ());
+
+    // a block that doesn't touch the registry leaves the stamp (and the miners) alone.
+    stamp = miner.getRegistryStamp ();
+    
+    shared_ptr < Transactions::SendVOL > sendVOL = make_shared < Transactions::SendVOL >();
+    sendVOL->mAccountName   = "9091";
+    sendVOL->mAmount        = 10;
+    miner.pushTransaction ( makeTransaction ( sendVOL, "9090", 1, key ));
+    ASSERT_EQ ( miner.getLedger ().getMinerRegistryStamp (), stamp );
+    
+    miner.updateRegistry ();
+    ASSERT_EQ ( miner.countRemoteMiners (), ( size_t )1 );
+}
+
+//----------------------------------------------------------------//
+TEST ( RemoteMiners, url_change ) {
+
+    CryptoKeyPair key;
+    key.rsa ();
+
+    RegistryMiner miner ( key );
+
+    miner.pushTransaction ( makeRegisterMiner ( "9091", "http://127.0.0.1:9091", 0, key ));
+    miner.updateRegistry ();
+    ASSERT_TRUE ( miner.hasRemoteMiner ( "http://127.0.0.1:9091" ));
+
+    string stamp = miner.getRegistryStamp ();
+
+    miner.pushTransaction ( makeUpdateMinerURL ( "9091", "http://127.0.0.1:9191", 0, key ));
+    ASSERT_NE ( miner.getLedger ().getMinerRegistryStamp (), stamp );
+
+    // the new URL is picked up; the old one stays known (the set only grows).
+    miner.updateRegistry ();
+    ASSERT_EQ ( miner.countRemoteMiners (), ( size_t )2 );
+    ASSERT_TRUE ( miner.hasRemoteMiner ( "http://127.0.0.1:9191" ));
+    ASSERT_TRUE ( miner.hasRemoteMiner ( "http://127.0.0.1:9091" ));
+    ASSERT_EQ ( miner.getRegistryStamp (), miner.getLedger ().getMinerRegistryStamp ());
+}
+
+//----------------------------------------------------------------//
+TEST ( RemoteMiners, rewind_to_branch_with_different_stamp ) {
+
+    CryptoKeyPair key;
+    key.rsa ();
+
+    RegistryMiner miner ( key );
+
+    // branch A: 9091 registers at height 1.
+    miner.pushTransaction ( makeRegisterMiner ( "9091", "http://127.0.0.1:9091", 0, key ));
+    miner.updateRegistry ();
+    ASSERT_TRUE ( miner.hasRemoteMiner ( "http://127.0.0.1:9091" ));
+
+    string stampA = miner.getRegistryStamp ();
+
+    // branch B: back to genesis, and 9092 registers at height 1 instead. same height, same
+    // number of registrations, same nonce; only the stamp tells the two apart.
+    miner.rewind ( 0 );
+    miner.pushTransaction ( makeRegisterMiner ( "9092", "http://127.0.0.1:9092", 0, key ));
+    ASSERT_EQ ( miner.getLedger ().countBlocks (), ( u64 )2 );
+
+    string stampB = miner.getLedger ().getMinerRegistryStamp ();
+    ASSERT_NE ( stampB, stampA );
+
+    miner.updateRegistry ();
+    ASSERT_EQ ( miner.getRegistryStamp (), stampB );
+    ASSERT_TRUE ( miner.hasRemoteMiner ( "http://127.0.0.1:9092" ));
+    ASSERT_EQ ( miner.countRemoteMiners (), ( size_t )2 );
+
+    // a third branch: 9091 again, at another URL. the old URL is known already; the new one isn't.
+    miner.rewind ( 0 );
+    miner.pushTransaction ( makeRegisterMiner ( "9091", "http://127.0.0.1:9093", 0, key ));
+    ASSERT_NE ( miner.getLedger ().getMinerRegistryStamp (), stampB );
+
+    miner.updateRegistry ();
+    ASSERT_TRUE ( miner.hasRemoteMiner ( "http://127.0.0.1:9093" ));
+    ASSERT_EQ ( miner.countRemoteMiners (), ( size_t )3 );
+}
@@ -0,0 +1,125 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <gtest/gtest.h>
+#include <volition/Asset.h>
+#include <volition/AssetMethod.h>
+#include <volition/serialization/Serialization.h>
+
+using namespace Volition;
+
+//----------------------------------------------------------------//
+// a qualifier over the subject asset: (( @ == "sword" ) AND ( power + 1 > 3 )) OR NOT ( name )
+static const char* ASSET_QUALIFIER = R"({
+    "qualifier": {
+        "op": "OR",
+        "left": {
+            "op": "AND",
+            "left": {
+                "op": "EQUAL",
+                "left": { "op": "INDEX", "argName": "", "indexer": "@" },
+                "right": { "op": "CONST", "const": { "type": "STRING", "value": "sword" }}
+            },
+            "right": {
+                "op": "GREATER",
+                "left": {
+                    "op": "ADD",
+                    "left": { "op": "INDEX", "argName": "", "indexer": "power" },
+                    "right": { "op": "CONST", "const": { "type": "NUMERIC", "value": 1 }}
+                },
+                "right": { "op": "CONST", "const": { "type": "NUMERIC", "value": 3 }}
+            }
+        },
+        "right": {
+            "op": "NOT",
+            "operand": { "op": "INDEX", "argName": "", "indexer": "name" }
+        }
+    },
+    "isSubject": true
+})";
+
+//----------------------------------------------------------------//
+// a qualifier over a const param: ( value * 2 ) >= 10 XOR value == 7
+static const char* CONST_QUALIFIER = R"({
+    "qualifier": {
+        "op": "XOR",
+        "left": {
+            "op": "GREATER_OR_EQUAL",
+            "left": {
+                "op": "MUL",
+                "left": { "op": "INDEX", "argName": "" },
+                "right": { "op": "CONST", "const": { "type": "NUMERIC", "value": 2 }}
+            },
+            "right": { "op": "CONST", "const": { "type": "NUMERIC", "value": 10 }}
+        },
+        "right": {
+            "op": "EQUAL",
+            "left": { "op": "INDEX", "argName": "" },
+            "right": { "op": "CONST", "const": { "type": "NUMERIC", "value": 7 }}
+        }
+    },
+    "defaultValue": { "type": "NUMERIC", "value": 0 },
+    "inputScheme": {}
+})";
+
+//----------------------------------------------------------------//
+static void expectSame ( const AssetFieldValue& program, const AssetFieldValue& tree ) {
+
+    ASSERT_EQ ( ToJSONSerializer::toJSONString ( program ), ToJSONSerializer::toJSONString ( tree ));
+}
+
+//----------------------------------------------------------------//
+TEST ( SquapProgram, matches_tree_for_assets ) {
+
+    AssetMethodParamDesc desc;
+    FromJSONSerializer::fromJSONString ( desc, ASSET_QUALIFIER );
+    ASSERT_TRUE ( desc.mQualifier );
+    ASSERT_TRUE ( desc.mProgram );
+
+    const char* types [] = { "sword", "shield" };
+    const double powers [] = { 0, 2, 3, 10 };
+
+    for ( const char* type : types ) {
+        for ( double power : powers ) {
+            for ( int named = 0; named < 3; ++named ) {
+
+                shared_ptr < Asset > asset = make_shared < Asset >();
+                asset->mType = type;
+                asset->mFields [ "power" ] = AssetFieldValue ( power );
+                if ( named == 1 ) {
+                    asset->mFields [ "name" ] = AssetFieldValue ( "excalibur" );
+                }
+                else if ( named == 2 ) {
+                    asset->mFields [ "name" ] = AssetFieldValue ( "" );
+                }
+
+                // evaluate twice so the second run goes through warm scratch.
+                expectSame ( desc.mProgram.evaluate ( *asset ), desc.mQualifier->evaluate ( SquapEvaluationContext ( asset )));
+                expectSame ( desc.mProgram.evaluate ( *asset ), desc.mQualifier->evaluate ( SquapEvaluationContext ( asset )));
+            }
+        }
+    }
+
+    // a missing field is undefined on both paths.
+    shared_ptr < Asset > bare = make_shared < Asset >();
+    bare->mType = "sword";
+    expectSame ( desc.mProgram.evaluate ( *bare ), desc.mQualifier->evaluate ( SquapEvaluationContext ( bare )));
+}
+
+//----------------------------------------------------------------//
+TEST ( SquapProgram, matches_tree_for_values ) {
+
+    ConstMethodParamDesc desc;
+    FromJSONSerializer::fromJSONString ( desc, CONST_QUALIFIER );
+    ASSERT_TRUE ( desc.mQualifier );
+    ASSERT_TRUE ( desc.mProgram );
+
+    const double values [] = { -1, 0, 4, 5, 7, 100 };
+    for ( double value : values ) {
+        AssetFieldValue field ( value );
+        expectSame ( desc.mProgram.evaluate ( field ), desc.mQualifier->evaluate ( SquapEvaluationContext ( field )));
+    }
+
+    AssetFieldValue text ( "seven" );
+    expectSame ( desc.mProgram.evaluate ( text ), desc.mQualifier->evaluate ( SquapEvaluationContext ( text )));
+}
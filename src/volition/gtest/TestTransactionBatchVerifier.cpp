@@ -0,0 +1,246 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <gtest/gtest.h>
+#include <volition/AccountODBM.h>
+#include <volition/CryptoKey.h>
+#include <volition/Format.h>
+#include <volition/Ledger.h>
+#include <volition/TheWorkerPool.h>
+#include <volition/Transaction.h>
+#include <volition/TransactionBatchVerifier.h>
+#include <volition/TransactionContext.h>
+#include <volition/TransactionMaker.h>
+#include <volition/Transactions.h>
+
+using namespace Volition;
+
+//================================================================//
+// TestReplaceKey
+//================================================================//
+// Replaces the maker's signing key. Stands in for AFFIRM_KEY, whose ledger
+// path refuses any key with a key ID, so that a batch can actually change
+// a key mid-stream. Declares no access set, so it conflicts with
+// everything.
+class TestReplaceKey :
+    public AbstractTransactionBody {
+public:
+
+    TRANSACTION_TYPE ( "TEST_REPLACE_KEY" )
+    TRANSACTION_WEIGHT ( 1 )
+    TRANSACTION_MATURITY ( 0 )
+
+    CryptoPublicKey     mKey;
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeFrom ( const AbstractSerializerFrom& serializer ) override {
+        AbstractTransactionBody::AbstractSerializable_serializeFrom ( serializer );
+
+        serializer.serialize ( "key",           this->mKey );
+    }
+
+    //----------------------------------------------------------------//
+    void AbstractSerializable_serializeTo ( AbstractSerializerTo& serializer ) const override {
+        AbstractTransactionBody::AbstractSerializable_serializeTo ( serializer );
+
+        serializer.serialize ( "key",           this->mKey );
+    }
+
+    //----------------------------------------------------------------//
+    TransactionResult AbstractTransactionBody_apply ( TransactionContext& context ) const override {
+
+        Account account = *context.mAccountODBM.mBody.get ();
+        account.mKeys [ this->mMaker->getKeyName ()] = KeyAndPolicy ( this->mKey, context.mKeyAndPolicy.mPolicy );
+        context.mAccountODBM.mBody.set ( account );
+        return true;
+    }
+};
+
+//----------------------------------------------------------------//
+static shared_ptr < Transaction > makeTransaction ( shared_ptr < AbstractTransactionBody > body, string makerName, u64 nonce, const CryptoKeyPair& key ) {
+
+    TransactionMaker maker;
+    maker.setAccountName ( makerName );
+    maker.setKeyName ( "master" );
+    maker.setNonce ( nonce );
+
+    body->setMaker ( maker );
+    body->setUUID ( Format::write ( "%s-%d", makerName.c_str (), ( int )nonce ));
+
+    shared_ptr < Transaction > transaction = make_shared < Transaction >();
+    transaction->setBody ( body );
+    transaction->sign ( key );
+    return transaction;
+}
+
+//----------------------------------------------------------------//
+static shared_ptr < Transaction > makeReplaceKey ( u64 nonce, const CryptoKeyPair& signer, const CryptoKeyPair& replacement ) {
+
+    shared_ptr < TestReplaceKey > body = make_shared < TestReplaceKey >();
+    body->mKey = replacement.getPublicKey ();
+    return makeTransaction ( body, "alice", nonce, signer );
+}
+
+//----------------------------------------------------------------//
+static shared_ptr < Transaction > makeSendVOL ( u64 nonce, const CryptoKeyPair& signer ) {
+
+    shared_ptr < Transactions::SendVOL > body = make_shared < Transactions::SendVOL >();
+    body->mAccountName  = "bob";
+    body->mAmount       = 1;
+    return makeTransaction ( body, "alice", nonce, signer );
+}
+
+//----------------------------------------------------------------//
+TEST ( TransactionBatchVerifier, key_change_mid_batch ) {
+
+    time_t t;
+    time ( &t );
+
+    Ledger ledger;
+    ledger.init ();
+
+    CryptoKeyPair key0;
+    key0.elliptic ();
+
+    CryptoKeyPair key1;
+    key1.elliptic ();
+
+    CryptoKeyPair key2;
+    key2.elliptic ();
+
+    CryptoKeyPair bobKey;
+    bobKey.elliptic ();
+
+    Policy keyPolicy;
+    ledger.getEntitlements < KeyEntitlements >( keyPolicy );
+
+    Policy accountPolicy;
+    ledger.getEntitlements < AccountEntitlements >( accountPolicy );
+
+    ASSERT_TRUE ( ledger.newAccount ( "alice", 1000, "master", key0.getPublicKey (), keyPolicy, accountPolicy ));
+    ASSERT_TRUE ( ledger.newAccount ( "bob", 1000, "master", bobKey.getPublicKey (), keyPolicy, accountPolicy ));
+
+    // the verifier does nothing on a genesis ledger.
+    ledger.pushVersion ();
+
+    // sends under key0, a key change, sends under key1 (with one still signed by the retired key0),
+    // then a second key change. only the sends ahead of the first change may be checked up front.
+    static const size_t SENDS = 20;
+
+    vector < shared_ptr < Transaction >> batch;
+    u64 nonce = 0;
+
+    for ( size_t i = 0; i < SENDS; ++i ) {
+        batch.push_back ( makeSendVOL ( nonce++, key0 ));
+    }
+    batch.push_back ( makeReplaceKey ( nonce++, key0, key1 ));
+
+    size_t staleIndex = batch.size () + 1;
+    for ( size_t i = 0; i < SENDS; ++i ) {
+        if ( batch.size () == staleIndex ) {
+            batch.push_back ( makeSendVOL ( nonce, key0 )); // fails, so doesn't use up the nonce
+        }
+        batch.push_back ( makeSendVOL ( nonce++, key1 ));
+    }
+    batch.push_back ( makeReplaceKey ( nonce++, key1, key2 ));
+
+    vector < const Transaction* > transactions;
+    for ( size_t i = 0; i < batch.size (); ++i ) {
+        transactions.push_back ( batch [ i ].get ());
+    }
+
+    TransactionBatchVerifier verifier;
+    verifier.verify ( ledger, transactions, TransactionBatchVerifier::IN_ORDER, Block::ALL );
+
+    if ( TheWorkerPool::get ().countThreads () > 0 ) {
+        ASSERT_EQ ( verifier.getTotalVerified (), SENDS );
+    }
+    for ( size_t i = SENDS; i < transactions.size (); ++i ) {
+        ASSERT_EQ ( verifier.getPolicy ( *transactions [ i ], Block::ALL ), Block::ALL );
+    }
+
+    // applied with the verifier's policies, every transaction does exactly what it does when checked inline.
+    Ledger verified ( ledger );
+    Ledger reference ( ledger );
+
+    for ( size_t i = 0; i < transactions.size (); ++i ) {
+
+        const Transaction& transaction = *transactions [ i ];
+
+        TransactionResult verifiedResult = transaction.apply ( verified, 1, 0, i, t, verifier.getPolicy ( transaction, Block::ALL ));
+        TransactionResult referenceResult = transaction.apply ( reference, 1, 0, i, t, Block::ALL );
+
+        ASSERT_EQ (( bool )verifiedResult, ( bool )referenceResult );
+        ASSERT_EQ (( bool )verifiedResult, ( i != staleIndex ));
+    }
+
+    ASSERT_EQ ( AccountODBM ( verified, "alice" ).mBalance.get (), 1000 - ( SENDS * 2 ));
+    ASSERT_EQ ( AccountODBM ( verified, "bob" ).mBalance.get (), 1000 + ( SENDS * 2 ));
+    ASSERT_EQ ( AccountODBM ( reference, "alice" ).mBalance.get (), AccountODBM ( verified, "alice" ).mBalance.get ());
+    ASSERT_EQ ( AccountODBM ( verified, "alice" ).mTransactionNonce.get (), nonce );
+
+    // in any order, the key changes may run first, so nothing can be checked up front.
+    verifier.verify ( ledger, transactions, TransactionBatchVerifier::ANY_ORDER, Block::ALL );
+    ASSERT_EQ ( verifier.getTotalVerified (), ( size_t )0 );
+}
+
+//----------------------------------------------------------------//
+TEST ( TransactionBatchVerifier, declared_key_writes ) {
+
+    Ledger ledger;
+    ledger.init ();
+
+    CryptoKeyPair aliceKey;
+    aliceKey.elliptic ();
+
+    CryptoKeyPair bobKey;
+    bobKey.elliptic ();
+
+    Policy keyPolicy;
+    ledger.getEntitlements < KeyEntitlements >( keyPolicy );
+
+    Policy accountPolicy;
+    ledger.getEntitlements < AccountEntitlements >( accountPolicy );
+
+    ASSERT_TRUE ( ledger.newAccount ( "alice", 1000, "master", aliceKey.getPublicKey (), keyPolicy, accountPolicy ));
+    ASSERT_TRUE ( ledger.newAccount ( "bob", 1000, "master", bobKey.getPublicKey (), keyPolicy, accountPolicy ));
+    ledger.pushVersion ();
+
+    // a key affirmed under any spelling of alice's name holds back alice's later transactions, but not bob's.
+    static const size_t SENDS = 20;
+
+    vector < shared_ptr < Transaction >> batch;
+    u64 aliceNonce = 0;
+    u64 bobNonce = 0;
+
+    shared_ptr < Transactions::AffirmKey > affirmKey = make_shared < Transactions::AffirmKey >();
+    affirmKey->mKeyName = "spare";
+    affirmKey->mKey = bobKey.getPublicKey ();
+    batch.push_back ( makeTransaction ( affirmKey, "ALICE", aliceNonce++, aliceKey ));
+
+    for ( size_t i = 0; i < SENDS; ++i ) {
+        batch.push_back ( makeSendVOL ( aliceNonce++, aliceKey ));
+
+        shared_ptr < Transactions::SendVOL > send = make_shared < Transactions::SendVOL >();
+        send->mAccountName  = "alice";
+        send->mAmount       = 1;
+        batch.push_back ( makeTransaction ( send, "bob", bobNonce++, bobKey ));
+    }
+
+    vector < const Transaction* > transactions;
+    for ( size_t i = 0; i < batch.size (); ++i ) {
+        transactions.push_back ( batch [ i ].get ());
+    }
+
+    TransactionBatchVerifier verifier;
+    verifier.verify ( ledger, transactions, TransactionBatchVerifier::IN_ORDER, Block::ALL );
+
+    if ( TheWorkerPool::get ().countThreads () > 0 ) {
+        ASSERT_EQ ( verifier.getTotalVerified (), SENDS );
+    }
+    for ( size_t i = 0; i < transactions.size (); ++i ) {
+        if ( transactions [ i ]->getMaker ()->getAccountName () != "bob" ) {
+            ASSERT_EQ ( verifier.getPolicy ( *transactions [ i ], Block::ALL ), Block::ALL );
+        }
+    }
+}
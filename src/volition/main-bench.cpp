@@ -0,0 +1,330 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#include <padamose/padamose.h>
+#include <volition/bench/Benchmark.h>
+#include <volition/bench/BenchmarkFixture.h>
+#include <volition/AssetMethodInvocation.h>
+#include <volition/Block.h>
+#include <volition/Digest.h>
+#include <volition/InMemoryBlockTree.h>
+#include <volition/TransactionQueue.h>
+#include <volition/version.h>
+#include <new>
+
+using namespace Volition;
+using namespace Bench;
+
+//================================================================//
+// allocation counting
+//================================================================//
+
+//----------------------------------------------------------------//
+void* operator new ( size_t size ) {
+
+    AllocationCounter::record ( size );
+    void* ptr = malloc ( size ? size : 1 );
+    if ( !ptr ) throw bad_alloc ();
+    return ptr;
+}
+
+//----------------------------------------------------------------//
+void operator delete ( void* ptr ) noexcept {
+
+    free ( ptr );
+}
+
+//----------------------------------------------------------------//
+void operator delete ( void* ptr, size_t ) noexcept {
+
+    free ( ptr );
+}
+
+//================================================================//
+// cases
+//================================================================//
+
+//----------------------------------------------------------------//
+void check ( const LedgerResult& result, string name );
+void check ( const LedgerResult& result, string name ) {
+
+    // a benchmark that silently fails measures the wrong thing; stop.
+    if ( result ) return;
+    fprintf ( stderr, "%s failed: %s\n", name.c_str (), result.getMessage ().c_str ());
+    exit ( Poco::Util::Application::EXIT_SOFTWARE );
+}
+
+//----------------------------------------------------------------//
+void addBlockCases ( Benchmark& bench, shared_ptr < BenchmarkFixture > fixture );
+void addBlockCases ( Benchmark& bench, shared_ptr < BenchmarkFixture > fixture ) {
+
+    shared_ptr < unique_ptr < Ledger >> fork = make_shared < unique_ptr < Ledger >>();
+
+    static const struct {
+        const char*                 mName;
+        size_t                      mTransactions;
+        BenchmarkFixture::Mix       mMix;
+        bool                        mSign;
+    } BLOCK_CASES [] = {
+        { "block.apply.empty",              0,      BenchmarkFixture::MIX_SEND_VOL,         false },
+        { "block.apply.vol.16",             16,     BenchmarkFixture::MIX_SEND_VOL,         false },
+        { "block.apply.vol.256",            256,    BenchmarkFixture::MIX_SEND_VOL,         false },
+        { "block.apply.assets.256",         256,    BenchmarkFixture::MIX_SEND_ASSETS,      false },
+        { "block.apply.mixed.256",          256,    BenchmarkFixture::MIX_MIXED,            false },
+        { "block.apply.mixed.256.verify",   256,    BenchmarkFixture::MIX_MIXED,            true },
+    };
+
+    for ( size_t i = 0; i < ( sizeof ( BLOCK_CASES ) / sizeof ( BLOCK_CASES [ 0 ])); ++i ) {
+
+        string name = BLOCK_CASES [ i ].mName;
+        shared_ptr < const Block > block = fixture->makeBlock ( BLOCK_CASES [ i ].mTransactions, BLOCK_CASES [ i ].mMix, BLOCK_CASES [ i ].mSign );
+        Block::VerificationPolicy policy = BLOCK_CASES [ i ].mSign ? Block::VerificationPolicy::VERIFY_TRANSACTION_SIG : Block::VerificationPolicy::NONE;
+
+        bench.add ( name,
+            [ = ]() { *fork = make_unique < Ledger >( *fixture->mLedger ); },
+            [ = ]() { check (( *fork )->pushBlock ( *block, policy ), name ); }
+        );
+    }
+
+    // fillBlock pulls from a full queue into an empty block; both are rebuilt every iteration.
+    shared_ptr < unique_ptr < TransactionQueue >> queue = make_shared < unique_ptr < TransactionQueue >>();
+    shared_ptr < shared_ptr < Block >> block = make_shared < shared_ptr < Block >>();
+
+    bench.add ( "queue.fillBlock.256",
+        [ = ]() {
+            *queue = make_unique < TransactionQueue >();
+            for ( size_t i = 1; i < BenchmarkFixture::TOTAL_ACCOUNTS; ++i ) {
+                ( *queue )->pushTransaction ( fixture->makeTransaction ( i, BenchmarkFixture::MIX_MIXED ));
+            }
+            *block = fixture->makeBlock ( 0, BenchmarkFixture::MIX_MIXED );
+        },
+        [ = ]() {
+            ( *queue )->fillBlock ( *fixture->mLedger, **block, Block::VerificationPolicy::NONE );
+        }
+    );
+}
+
+//----------------------------------------------------------------//
+void addBlockTreeCases ( Benchmark& bench, shared_ptr < BenchmarkFixture > fixture );
+void addBlockTreeCases ( Benchmark& bench, shared_ptr < BenchmarkFixture > fixture ) {
+
+    static const size_t BRANCH_LENGTH = 64;
+
+    shared_ptr < InMemoryBlockTree > tree = make_shared < InMemoryBlockTree >();
+    shared_ptr < vector < BlockTreeCursor >> heads = make_shared < vector < BlockTreeCursor >>( 2 );
+
+    BlockTreeTag rootTag ( "root" );
+    tree->affirmHeader ( rootTag, fixture->mGenesis );
+
+    // two branches forking at the genesis block, a few seconds apart.
+    for ( size_t branch = 0; branch < 2; ++branch ) {
+
+        BlockTreeTag tag ( Format::write ( "branch-%d", ( int )branch ));
+        shared_ptr < const Block > prev = fixture->mGenesis;
+
+        for ( size_t i = 0; i < BRANCH_LENGTH; ++i ) {
+
+            shared_ptr < Block > block = make_shared < Block >();
+            block->initialize ( BenchmarkFixture::getAccountName ( 0 ), 0, fixture->mVisage, BenchmarkFixture::GENESIS_TIME + ( time_t )(( i + 1 ) * 60 ) + ( time_t )branch, prev.get (), fixture->mKeys [ 0 ]);
+            block->sign ( fixture->mKeys [ 0 ]);
+            ( *heads )[ branch ] = tree->affirmHeader ( tag, block );
+            prev = block;
+        }
+    }
+
+    bench.add ( "blocktree.compare.64.cold",
+        [ = ]() { tree->clearCompareCache (); },
+        [ = ]() { tree->compare (( *heads )[ 0 ], ( *heads )[ 1 ]); }
+    );
+
+    bench.add ( "blocktree.compare.64.warm",
+        [ = ]() { tree->compare (( *heads )[ 0 ], ( *heads )[ 1 ]); }
+    );
+}
+
+//----------------------------------------------------------------//
+void addDigestCases ( Benchmark& bench, shared_ptr < BenchmarkFixture > fixture );
+void addDigestCases ( Benchmark& bench, shared_ptr < BenchmarkFixture > fixture ) {
+
+    shared_ptr < const BlockHeader > header = make_shared < BlockHeader >( *fixture->makeBlock ( 0, BenchmarkFixture::MIX_SEND_VOL ));
+
+    bench.add ( "digest.header",
+        [ = ]() { Digest digest ( *header ); }
+    );
+}
+
+//----------------------------------------------------------------//
+void addInventoryCases ( Benchmark& bench, shared_ptr < BenchmarkFixture > fixture );
+void addInventoryCases ( Benchmark& bench, shared_ptr < BenchmarkFixture > fixture ) {
+
+    AccountID accountID = fixture->mLedger->getAccountID ( BenchmarkFixture::getAccountName ( 0 ));
+
+    bench.add ( Format::write ( "inventory.get.%d", ( int )BenchmarkFixture::LARGE_INVENTORY ),
+        [ = ]() {
+            SerializableList < SerializableSharedConstPtr < Asset >> assets;
+            fixture->mLedger->getInventory ( accountID, assets );
+        }
+    );
+
+    bench.add ( Format::write ( "inventory.get.%d.page100", ( int )BenchmarkFixture::LARGE_INVENTORY ),
+        [ = ]() {
+            SerializableList < SerializableSharedConstPtr < Asset >> assets;
+            fixture->mLedger->getInventory ( accountID, assets, BenchmarkFixture::LARGE_INVENTORY / 2, 100 );
+        }
+    );
+}
+
+//----------------------------------------------------------------//
+void addLuaCases ( Benchmark& bench, shared_ptr < BenchmarkFixture > fixture );
+void addLuaCases ( Benchmark& bench, shared_ptr < BenchmarkFixture > fixture ) {
+
+    shared_ptr < unique_ptr < Ledger >> fork = make_shared < unique_ptr < Ledger >>();
+
+    AssetMethodInvocation invocation;
+    invocation.setMethod ( "openPack" );
+    invocation.setAssetParam ( "pack", fixture->mPack );
+
+    // the pack is revoked by the script, so each iteration needs a fresh fork.
+    bench.add ( "lua.invoke.openPack",
+        [ = ]() { *fork = make_unique < Ledger >( *fixture->mLedger ); },
+        [ = ]() { check (( *fork )->invoke ( BenchmarkFixture::getAccountName ( 1 ), invocation, BenchmarkFixture::GENESIS_TIME ), "lua.invoke.openPack" ); }
+    );
+}
+
+//----------------------------------------------------------------//
+void addSerializationCases ( Benchmark& bench, shared_ptr < BenchmarkFixture > fixture );
+void addSerializationCases ( Benchmark& bench, shared_ptr < BenchmarkFixture > fixture ) {
+
+    shared_ptr < const Block > block = fixture->makeBlock ( 256, BenchmarkFixture::MIX_MIXED, true );
+    string json = ToJSONSerializer::toJSONString ( *block );
+
+    bench.add ( "json.block.256.to",
+        [ = ]() { ToJSONSerializer::toJSONString ( *block ); }
+    );
+
+    bench.add ( "json.block.256.from",
+        [ = ]() {
+            Block copy;
+            FromJSONSerializer::fromJSONString ( copy, json );
+        }
+    );
+
+    bench.add ( "json.block.256.from.stream",
+        [ = ]() {
+            Block copy;
+            FromJSONStreamSerializer::fromJSONString ( copy, json );
+        }
+    );
+
+    bench.add ( "json.block.256.roundtrip",
+        [ = ]() {
+            Block copy;
+            FromJSONSerializer::fromJSONString ( copy, ToJSONSerializer::toJSONString ( *block ));
+        }
+    );
+}
+
+//================================================================//
+// BenchApp
+//================================================================//
+class BenchApp :
+    public Poco::Util::Application {
+protected:
+
+    //----------------------------------------------------------------//
+    void addOption ( Poco::Util::OptionSet& opts, string name, string shortname, string desc, string def = "" ) {
+
+        string defStr = def.size () ? Format::write ( "default: %s.", def.c_str ()) : "";
+
+        opts.addOption (
+            Poco::Util::Option ( name, shortname, Format::write ( "%s. %s", desc.c_str (), defStr.c_str ()))
+                .required ( false )
+                .argument ( "value", true )
+                .binding ( name )
+        );
+    }
+
+    //----------------------------------------------------------------//
+    void defineOptions ( Poco::Util::OptionSet& opts ) override {
+        Application::defineOptions ( opts );
+
+        this->addOption ( opts, "filter", "f",              "only run benchmarks whose name contains this string" );
+        this->addOption ( opts, "json", "j",                "write results as JSON to the given filename" );
+        this->addOption ( opts, "max-iterations", "",       "stop each benchmark after N timed iterations",         "1000000" );
+        this->addOption ( opts, "min-iterations", "",       "run each benchmark at least N timed iterations",       "10" );
+        this->addOption ( opts, "min-time", "",             "run each benchmark for at least N milliseconds",       "1000" );
+        this->addOption ( opts, "warmup", "",               "untimed iterations before each benchmark",             "3" );
+    }
+
+    //----------------------------------------------------------------//
+    int main ( const vector < string >& ) override {
+
+        Poco::Util::AbstractConfiguration& configuration = this->config ();
+
+        string filter       = configuration.getString ( "filter", "" );
+        string jsonFile     = configuration.getString ( "json", "" );
+
+        Benchmark bench;
+        bench.setMaxIterations (( u64 )configuration.getUInt ( "max-iterations", 1000000 ));
+        bench.setMinIterations (( u64 )configuration.getUInt ( "min-iterations", 10 ));
+        bench.setMinSeconds (( double )configuration.getUInt ( "min-time", 1000 ) / 1000.0 );
+        bench.setWarmupIterations (( u64 )configuration.getUInt ( "warmup", 3 ));
+
+        printf ( "building fixture (%d accounts)...\n", ( int )BenchmarkFixture::TOTAL_ACCOUNTS );
+        shared_ptr < BenchmarkFixture > fixture = make_shared < BenchmarkFixture >();
+
+        addBlockCases ( bench, fixture );
+        addBlockTreeCases ( bench, fixture );
+        addDigestCases ( bench, fixture );
+        addInventoryCases ( bench, fixture );
+        addLuaCases ( bench, fixture );
+        addSerializationCases ( bench, fixture );
+
+        BenchmarkReport report;
+        report.mVersion = VOLITION_GIT_COMMIT_STR;
+        bench.run ( report, filter );
+
+        if ( jsonFile.size ()) {
+            ToJSONSerializer::toJSONFile ( report, jsonFile );
+            printf ( "wrote %s\n", jsonFile.c_str ());
+        }
+        return EXIT_OK;
+    }
+};
+
+//================================================================//
+// main
+//================================================================//
+
+//----------------------------------------------------------------//
+int main ( int argc, char** argv ) {
+
+    // logging would dominate most of these timings.
+    static const char* FILTERS [] = {
+        PDM_FILTER_ROOT,
+        VOL_FILTER_APP,
+        VOL_FILTER_BLOCK,
+        VOL_FILTER_CONSENSUS,
+        VOL_FILTER_JSON,
+        VOL_FILTER_LEDGER,
+        VOL_FILTER_LUA,
+        VOL_FILTER_STORE,
+        VOL_FILTER_TRANSACTION_QUEUE,
+    };
+    for ( size_t i = 0; i < ( sizeof ( FILTERS ) / sizeof ( FILTERS [ 0 ])); ++i ) {
+        Lognosis::setFilter ( FILTERS [ i ], Lognosis::OFF );
+    }
+    Lognosis::init ( argc, argv );
+
+    Poco::Crypto::OpenSSLInitializer::initialize ();
+
+    Poco::AutoPtr < Poco::Util::Application > app = new BenchApp ();
+    try {
+        app->init ( argc, argv );
+    }
+    catch ( Poco::Exception& exc ) {
+        app->logger ().log ( exc );
+        return Poco::Util::Application::EXIT_CONFIG;
+    }
+    return app->run ();
+}
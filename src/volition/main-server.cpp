@@ -64,8 +64,10 @@ protected:
         this->addOption ( opts, "config", "c",                          "path to configuration file" );
         this->addOption ( opts, "control-key", "",                      "path to public key for verifying control commands" );
         this->addOption ( opts, "control-level", "",                    "miner control level",                                                      "none, config, admin",  "none" );
-        this->addOption ( opts, "dump", "",                             "dump ledger to sqlite give filename" );
+        this->addOption ( opts, "dump", "",                             "stream ledger dump to given filename (gzipped if it ends in .gz)" );
+        this->addOption ( opts, "dump-resume", "",                      "resume an interrupted (uncompressed) ledger dump",                         "true, false",          "false" );
         this->addOption ( opts, "genesis", "g",                         "path to the genesis file",                                                 "",                     "genesis.json" );
+        this->addOption ( opts, "http-threads", "",                     "maximum number of HTTP server threads",                                    "",                     "16" );
         this->addOption ( opts, "keyfile", "k",                         "path to public miner key file" );
         this->addOption ( opts, "ledger-persist-check-retry", "",       "retry the post-save integrity check N times",                              "",                     "0" );
         this->addOption ( opts, "ledger-persist-frequency", "",         "force a persist every N blocks (during chain composition)",                "",                     "0" );
@@ -76,11 +78,15 @@ protected:
         this->addOption ( opts, "persist", "",                          "alias for 'persist-path'; DEPRECATED",                                     "",                     "persist" );
         this->addOption ( opts, "persist-path", "",                     "base path to folder for persist files",                                    "",                     "persist-chain" );
         this->addOption ( opts, "port", "p",                            "set port to serve from",                                                   "",                     "9090" );
+        this->addOption ( opts, "response-cache-size", "",              "max bytes of cached API responses (0 to disable)",                         "",                     "67108864" );
         this->addOption ( opts, "sleep-fixed", "",                      "set fixed update sleep (in milliseconds)"                                  "",                     "1000" );
         this->addOption ( opts, "sleep-variable", "",                   "set variable update sleep (in milliseconds)"                               "",                     "1000" );
+        this->addOption ( opts, "snapshot-sync", "",                    "download a verified ledger snapshot from peers to the given filename" );
+        this->addOption ( opts, "snapshot-sync-quorum", "",             "number of miners that must agree on a snapshot",                           "",                     "3" );
         this->addOption ( opts, "sqlite-journal-mode", "",              "the sqlite journaling mode",                                               "rollback, wal",        "wal" );
 //        this->addOption ( opts, "sqlite-sleep-frequency", "",           "sleep after N writes",                                                     "",                     "0" );
 //        this->addOption ( opts, "sqlite-sleep-millis", "",              "approx milliseconds to sleep if 'sqlite-sleep-frequency' is non-zero",     "",                     "100" );
+        this->addOption ( opts, "subscription-max-waiters", "",         "maximum number of long-poll subscribers blocked at once",                  "",                     "8" );
     }
 
     //----------------------------------------------------------------//
@@ -139,7 +145,9 @@ protected:
         string controlKeyfile               = configuration.getString       ( "control-key", "" );
         string controlLevel                 = configuration.getString       ( "control-level", "" );
         string dump                         = configuration.getString       ( "dump", "" );
+        bool dumpResume                     = configuration.getBool         ( "dump-resume", false );
         string genesis                      = configuration.getString       ( "genesis", "genesis.json" );
+        int httpThreads                     = configuration.getInt          ( "http-threads", 16 );
         string keyfile                      = configuration.getString       ( "keyfile" );
         int ledgerPersistCheckRetry         = configuration.getInt          ( "ledger-persist-check-retry", 0 );
         int ledgerPersistFrequency          = configuration.getInt          ( "ledger-persist-frequency", 0 );
@@ -151,12 +159,16 @@ protected:
         string persistPath                  = configuration.getString       ( "persist", "persist-chain" );
         persistPath                         = configuration.getString       ( "persist-path", persistPath );
         int port                            = configuration.getInt          ( "port", 9090 );
+        u64 responseCacheSize               = configuration.getUInt64       ( "response-cache-size", MinerAPIResponseCache::DEFAULT_MAX_BYTES );
         int sleepFixed                      = configuration.getInt          ( "sleep-fixed", MinerActivity::DEFAULT_FIXED_UPDATE_MILLIS );
         int sleepVariable                   = configuration.getInt          ( "sleep-variable", MinerActivity::DEFAULT_VARIABLE_UPDATE_MILLIS );
+        string snapshotSync                 = configuration.getString       ( "snapshot-sync", "" );
+        int snapshotSyncQuorum              = configuration.getInt          ( "snapshot-sync-quorum", ( int )LedgerSnapshotSync::DEFAULT_QUORUM );
         string sqliteJournalMode            = configuration.getString       ( "sqlite-journal-mode", "wal" );
 //        int sqliteSleepFrequency            = configuration.getInt          ( "sqlite-sleep-frequency", 0 ); // TODO
 //        int sqliteSleepMillis               = configuration.getInt          ( "sqlite-sleep-millis", 100 ); // TODO
         string sslCertFile                  = configuration.getString       ( "openSSL.server.certificateFile", "" );
+        int subscriptionMaxWaiters          = configuration.getInt          ( "subscription-max-waiters", ( int )LedgerEventFeed::DEFAULT_MAX_WAITERS );
         
         if ( logpath.size () > 0 ) {
             
@@ -307,7 +319,11 @@ protected:
         }
         
         if ( dump.size ()) {
-            this->mMinerActivity->getLedger ().dump ( dump );
+            LedgerResult result = this->mMinerActivity->getLedger ().dump ( dump, dumpResume );
+            if ( !result ) {
+                LGN_LOG ( VOL_FILTER_APP, ERROR, "LEDGER DUMP FAILED: %s", result.getMessage ().c_str ());
+                return Application::EXIT_IOERR;
+            }
             return Application::EXIT_OK;
         }
         
@@ -327,10 +343,25 @@ protected:
         this->mMinerActivity->setBlockTreeCacheSize (( size_t )blockTreeCacheSize );
         this->mMinerActivity->setConsensusLookaheadHeight (( size_t )consensusLookaheadHeight );
         this->mMinerActivity->setMaxBlockSearches (( size_t )blockSearchMax );
+
+        // long-poll subscribers park HTTP threads; always leave some for everything else.
+        if ( httpThreads < 2 ) {
+            httpThreads = 2;
+        }
+        if (( subscriptionMaxWaiters < 0 ) || ( subscriptionMaxWaiters >= httpThreads )) {
+            LGN_LOG ( VOL_FILTER_APP, WARNING, "SUBSCRIPTION MAX WAITERS (%d) MUST BE LESS THAN HTTP THREADS (%d); USING %d", subscriptionMaxWaiters, httpThreads, httpThreads / 2 );
+            subscriptionMaxWaiters = httpThreads / 2;
+        }
+        this->mMinerActivity->setMaxEventWaiters (( size_t )subscriptionMaxWaiters );
+        
+        if ( snapshotSync.size ()) {
+            LGN_LOG ( VOL_FILTER_APP, INFO, "SNAPSHOT SYNC: %s", snapshotSync.c_str ());
+            this->mMinerActivity->enableSnapshotSync ( snapshotSync, ( size_t )snapshotSyncQuorum );
+        }
         
         LGN_LOG ( VOL_FILTER_APP, INFO, "MINER ID: %s", this->mMinerActivity->getMinerID ().c_str ());
 
-        this->serve ( port, sslCertFile.length () > 0 );
+        this->serve ( port, sslCertFile.length () > 0, ( size_t )responseCacheSize, httpThreads );
         
         LGN_LOG ( VOL_FILTER_APP, INFO, "SHUTDOWN: main" );
         
@@ -369,15 +400,21 @@ protected:
     }
     
     //----------------------------------------------------------------//
-    void serve ( int port, bool ssl ) {
+    void serve ( int port, bool ssl, size_t responseCacheSize, int httpThreads ) {
+
+        Poco::ThreadPool threadPool ( 2, httpThreads );
+
+        Poco::Net::HTTPServerParams* params = new Poco::Net::HTTPServerParams ();
+        params->setMaxThreads ( httpThreads );
 
-        Poco::ThreadPool threadPool;
+        MinerAPIFactory* factory = new MinerAPIFactory ( this->mMinerActivity );
+        factory->setResponseCacheSize ( responseCacheSize );
 
         Poco::Net::HTTPServer server (
-            new MinerAPIFactory ( this->mMinerActivity ),
+            factory,
             threadPool,
             ssl ? Poco::Net::SecureServerSocket (( Poco::UInt16 )port ) : Poco::Net::ServerSocket (( Poco::UInt16 )port ),
-            new Poco::Net::HTTPServerParams ()
+            params
         );
         
         server.start ();
@@ -222,17 +222,11 @@ public:
         string infile       = configuration.getString ( "infile", "" );
         string outfile      = configuration.getString ( "outfile", "" );
         
-        shared_ptr < Transactions::LoadLedger > loadLedger = make_shared < Transactions::LoadLedger >();
-        FromJSONSerializer::fromJSONFile ( *loadLedger, infile );
-        
-        shared_ptr < Transaction > transaction = make_shared < Transaction >();
-        transaction->setBody ( loadLedger );
-        
-        shared_ptr < Block > block = make_shared < Block >();
-        block->pushTransaction ( transaction );
-
-        ToJSONSerializer::toJSONFile ( *block, outfile );
-        
+        LedgerResult result = Ledger::writeGenesisBlock ( infile, outfile );
+        if ( !result ) {
+            this->logger ().error ( result.getMessage ());
+            return EXIT_DATAERR;
+        }
         return EXIT_OK;
     }
 };
@@ -0,0 +1,375 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_SERIALIZATION_FROMJSONSTREAMSERIALIZER_H
+#define VOLITION_SERIALIZATION_FROMJSONSTREAMSERIALIZER_H
+
+#include <volition/serialization/AbstractSerializerFrom.h>
+#include <volition/serialization/JSONTokenizer.h>
+#include <algorithm>
+#include <iterator>
+
+namespace Volition {
+
+//================================================================//
+// FromJSONStreamSerializer
+//================================================================//
+// Same contract as FromJSONSerializer, but reads straight from the bytes of
+// the document (via JSONTokenizer) instead of a Poco::JSON tree. Values are
+// converted the way Poco::Dynamic::Var would convert them, down to the
+// Poco::RangeException for a number that doesn't fit, and the tokenizer
+// rejects what the Poco parser rejects, so the two are interchangeable; use
+// this one wherever the input arrives as text.
+class FromJSONStreamSerializer :
+    public AbstractSerializerFrom {
+protected:
+
+    typedef JSONTokenizer::Token Token;
+
+    const JSONTokenizer*                mDocument;
+    size_t                              mToken;
+    const FromJSONStreamSerializer*     mParent;
+
+    SerializerPropertyName              mName;
+
+    //----------------------------------------------------------------//
+    SerializerKeys AbstractSerializerFrom_getKeys () const override {
+
+        const Token* token = this->getToken ();
+        if ( !token ) return SerializerKeys ();
+
+        if ( token->mType == JSONTokenizer::TYPE_ARRAY ) {
+            return SerializerKeys ( token->mSize );
+        }
+
+        if ( token->mType == JSONTokenizer::TYPE_OBJECT ) {
+
+            vector < string > keys;
+            keys.reserve ( token->mSize );
+
+            for ( size_t i = 0; i < token->mSize; ++i ) {
+                keys.push_back ( this->mDocument->getKey ( this->mDocument->getChild ( this->mToken, i )));
+            }
+
+            // Poco::JSON::Object keeps its members sorted and unique; match it.
+            sort ( keys.begin (), keys.end ());
+            keys.erase ( unique ( keys.begin (), keys.end ()), keys.end ());
+            return SerializerKeys ( keys );
+        }
+
+        return SerializerKeys ();
+    }
+
+    //----------------------------------------------------------------//
+    KeyType AbstractSerializerFrom_getKeyType () const override {
+
+        const Token* token = this->getToken ();
+        if ( token && ( token->mType == JSONTokenizer::TYPE_ARRAY )) return KEY_TYPE_INDEX;
+        if ( token && ( token->mType == JSONTokenizer::TYPE_OBJECT )) return KEY_TYPE_STRING;
+        return KEY_TYPE_NONE;
+    }
+
+    //----------------------------------------------------------------//
+    SerializerPropertyName AbstractSerializerFrom_getName () const override {
+        return this->mName;
+    }
+
+    //----------------------------------------------------------------//
+    const AbstractSerializerFrom* AbstractSerializerFrom_getParent () const override {
+        return this->mParent;
+    }
+
+    //----------------------------------------------------------------//
+    size_t AbstractSerializerFrom_getSize () const override {
+
+        const Token* token = this->getToken ();
+        return token ? token->mSize : 0;
+    }
+
+    //----------------------------------------------------------------//
+    bool AbstractSerializerFrom_has ( SerializerPropertyName name ) const override {
+        return ( this->find ( name ) != JSONTokenizer::NO_TOKEN );
+    }
+
+    //----------------------------------------------------------------//
+    void AbstractSerializerFrom_serialize ( SerializerPropertyName name, bool& value ) const override {
+
+        size_t member = this->find ( name );
+        if ( member == JSONTokenizer::NO_TOKEN ) return;
+
+        const Token& token = this->mDocument->getToken ( member );
+
+        switch ( token.mType ) {
+
+            case JSONTokenizer::TYPE_BOOL:
+                value = ( *this->mDocument->getRawData ( member ) == 't' );
+                break;
+
+            case JSONTokenizer::TYPE_NUMBER:
+                value = ( strtod ( this->mDocument->getRaw ( member ).c_str (), NULL ) != 0.0 );
+                break;
+
+            case JSONTokenizer::TYPE_STRING: {
+                string str = this->mDocument->getString ( member );
+                transform ( str.begin (), str.end (), str.begin (), ::tolower );
+                value = !(( str.size () == 0 ) || ( str == "0" ) || ( str == "false" ));
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+
+    //----------------------------------------------------------------//
+    void AbstractSerializerFrom_serialize ( SerializerPropertyName name, double& value ) const override {
+
+        size_t member = this->find ( name );
+        if ( member == JSONTokenizer::NO_TOKEN ) return;
+
+        const Token& token = this->mDocument->getToken ( member );
+
+        switch ( token.mType ) {
+
+            case JSONTokenizer::TYPE_BOOL:
+                value = ( *this->mDocument->getRawData ( member ) == 't' ) ? 1.0 : 0.0;
+                break;
+
+            case JSONTokenizer::TYPE_NUMBER:
+                value = strtod ( this->mDocument->getRaw ( member ).c_str (), NULL );
+                break;
+
+            case JSONTokenizer::TYPE_STRING: {
+                string str = this->mDocument->getString ( member );
+                char* end = NULL;
+                double result = strtod ( str.c_str (), &end );
+                if ( str.size () && ( end == ( str.c_str () + str.size ()))) {
+                    value = result;
+                }
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+
+    //----------------------------------------------------------------//
+    void AbstractSerializerFrom_serialize ( SerializerPropertyName name, u64& value ) const override {
+
+        size_t member = this->find ( name );
+        if ( member == JSONTokenizer::NO_TOKEN ) return;
+
+        const Token& token = this->mDocument->getToken ( member );
+
+        switch ( token.mType ) {
+
+            case JSONTokenizer::TYPE_BOOL:
+                value = ( *this->mDocument->getRawData ( member ) == 't' ) ? 1 : 0;
+                break;
+
+            case JSONTokenizer::TYPE_NUMBER: {
+
+                // out of range numbers throw, as Poco::Dynamic::Var's convert < u64 > does.
+                string raw = this->mDocument->getRaw ( member );
+
+                if ( raw.find_first_of ( ".eE" ) == string::npos ) {
+                
+                    if ( raw [ 0 ] == '-' ) {
+                        if ( raw.find_first_not_of ( "-0" ) != string::npos ) throw Poco::RangeException ( "Value too small." );
+                        value = 0;
+                        break;
+                    }
+                    errno = 0;
+                    u64 result = strtoull ( raw.c_str (), NULL, 10 );
+                    if ( errno == ERANGE ) throw Poco::RangeException ( "Value too large." );
+                    value = result;
+                }
+                else {
+                
+                    double number = strtod ( raw.c_str (), NULL );
+                    if ( number < 0.0 ) throw Poco::RangeException ( "Value too small." );
+                    if ( number >= 18446744073709551616.0 ) throw Poco::RangeException ( "Value too large." );
+                    
+                    // in range and not negative, so the conversion is defined.
+                    value = ( u64 )number;
+                }
+                break;
+            }
+
+            case JSONTokenizer::TYPE_STRING: {
+
+                // same as FromJSONSerializer: strings hold hex with a two character prefix.
+                string strValue = this->mDocument->getString ( member );
+                if ( strValue.size () > 2 ) {
+                    errno = 0;
+                    u64 result = strtoull ( &strValue.c_str ()[ 2 ], NULL, 16 );
+                    if ( errno == 0 ) {
+                        value = result;
+                    }
+                }
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+
+    //----------------------------------------------------------------//
+    void AbstractSerializerFrom_serialize ( SerializerPropertyName name, string& value ) const override {
+
+        size_t member = this->find ( name );
+        if ( member == JSONTokenizer::NO_TOKEN ) return;
+
+        const Token& token = this->mDocument->getToken ( member );
+
+        switch ( token.mType ) {
+
+            case JSONTokenizer::TYPE_NULL:
+                break;
+
+            case JSONTokenizer::TYPE_STRING:
+                value = this->mDocument->getString ( member );
+                break;
+
+            default:
+                value = this->mDocument->getRaw ( member );
+                break;
+        }
+    }
+
+    //----------------------------------------------------------------//
+    void AbstractSerializerFrom_serialize ( SerializerPropertyName name, AbstractSerializable& value ) const override {
+
+        size_t member = this->find ( name );
+
+        if ( member != JSONTokenizer::NO_TOKEN ) {
+
+            FromJSONStreamSerializer serializer;
+            serializer.mDocument = this->mDocument;
+            serializer.mToken = member;
+            serializer.mParent = this;
+            serializer.mName = name;
+
+            value.serializeFrom ( serializer );
+        }
+        else {
+
+            value.serializeFrom ();
+        }
+    }
+
+    //----------------------------------------------------------------//
+    void AbstractSerializerFrom_serialize ( SerializerPropertyName name, const SerializationFunc& serializeFunc ) const override {
+
+        size_t member = this->find ( name );
+
+        if ( member != JSONTokenizer::NO_TOKEN ) {
+
+            FromJSONStreamSerializer serializer;
+            serializer.mDocument = this->mDocument;
+            serializer.mToken = member;
+            serializer.mParent = this;
+            serializer.mName = name;
+
+            serializeFunc ( serializer );
+        }
+    }
+
+    //----------------------------------------------------------------//
+    void AbstractSerializerFrom_stringFromTree ( SerializerPropertyName name, string& value ) const override {
+
+        size_t member = this->find ( name );
+        if ( member == JSONTokenizer::NO_TOKEN ) return;
+
+        // the source text of the subtree; no need to build and re-stringify it.
+        JSONTokenizer::Type type = this->mDocument->getToken ( member ).mType;
+        bool isTree = (( type == JSONTokenizer::TYPE_ARRAY ) || ( type == JSONTokenizer::TYPE_OBJECT ));
+        value = isTree ? this->mDocument->getRaw ( member ) : "";
+    }
+
+    //----------------------------------------------------------------//
+    size_t find ( SerializerPropertyName name ) const {
+
+        const Token* token = this->getToken ();
+        if ( !token ) return JSONTokenizer::NO_TOKEN;
+
+        if ( token->mType == JSONTokenizer::TYPE_ARRAY ) {
+            return name.isIndex () ? this->mDocument->getChild ( this->mToken, name.getIndex ()) : JSONTokenizer::NO_TOKEN;
+        }
+        if ( token->mType == JSONTokenizer::TYPE_OBJECT ) {
+            return name.isIndex () ? JSONTokenizer::NO_TOKEN : this->mDocument->findMember ( this->mToken, name.getName ());
+        }
+        return JSONTokenizer::NO_TOKEN;
+    }
+
+    //----------------------------------------------------------------//
+    const Token* getToken () const {
+
+        return ( this->mDocument && ( this->mToken != JSONTokenizer::NO_TOKEN )) ? &this->mDocument->getToken ( this->mToken ) : NULL;
+    }
+
+public:
+
+    //----------------------------------------------------------------//
+    FromJSONStreamSerializer () :
+        mDocument ( NULL ),
+        mToken ( JSONTokenizer::NO_TOKEN ),
+        mParent ( NULL ) {
+    }
+
+    //----------------------------------------------------------------//
+    static void fromJSON ( AbstractSerializable& serializable, const JSONTokenizer& document ) {
+
+        LGN_LOG_SCOPE ( VOL_FILTER_JSON, INFO, __PRETTY_FUNCTION__ );
+
+        FromJSONStreamSerializer serializer;
+        serializer.mDocument = &document;
+        serializer.mToken = document.size () ? 0 : JSONTokenizer::NO_TOKEN;
+        serializable.serializeFrom ( serializer );
+    }
+
+    //----------------------------------------------------------------//
+    static void fromJSON ( const JSONTokenizer& document, const std::function < void ( const AbstractSerializerFrom& )>& serializeFunc ) {
+
+        LGN_LOG_SCOPE ( VOL_FILTER_JSON, INFO, __PRETTY_FUNCTION__ );
+
+        FromJSONStreamSerializer serializer;
+        serializer.mDocument = &document;
+        serializer.mToken = document.size () ? 0 : JSONTokenizer::NO_TOKEN;
+        serializeFunc ( serializer );
+    }
+
+    //----------------------------------------------------------------//
+    static void fromJSON ( AbstractSerializable& serializable, istream& inStream ) {
+
+        LGN_LOG_SCOPE ( VOL_FILTER_JSON, INFO, __PRETTY_FUNCTION__ );
+
+        FromJSONStreamSerializer::fromJSONString ( serializable, string ( istreambuf_iterator < char >( inStream ), istreambuf_iterator < char >()));
+    }
+
+    //----------------------------------------------------------------//
+    static void fromJSONFile ( AbstractSerializable& serializable, string filename ) {
+
+        LGN_LOG_SCOPE ( VOL_FILTER_JSON, INFO, __PRETTY_FUNCTION__ );
+
+        fstream inStream;
+        inStream.open ( filename, ios_base::in );
+        FromJSONStreamSerializer::fromJSON ( serializable, inStream );
+        inStream.close ();
+    }
+
+    //----------------------------------------------------------------//
+    static void fromJSONString ( AbstractSerializable& serializable, string json ) {
+
+        LGN_LOG_SCOPE ( VOL_FILTER_JSON, INFO, __PRETTY_FUNCTION__ );
+
+        JSONTokenizer document;
+        document.tokenize ( move ( json ));
+        FromJSONStreamSerializer::fromJSON ( serializable, document );
+    }
+};
+
+} // namespace Volition
+#endif
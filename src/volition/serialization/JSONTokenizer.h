@@ -0,0 +1,484 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_SERIALIZATION_JSONTOKENIZER_H
+#define VOLITION_SERIALIZATION_JSONTOKENIZER_H
+
+#include <volition/common.h>
+#include <volition/Format.h>
+
+namespace Volition {
+
+//================================================================//
+// JSONTokenizer
+//================================================================//
+// Scans a JSON document once and records each value as a token: its type
+// and the span of source bytes it covers. Nothing is decoded up front;
+// strings are unescaped and numbers converted only when a caller asks for
+// them, and a nested object or array can be handed back as its original
+// text. Containers list their children in mChildren, so array elements are
+// reached by index and object members by a scan over their keys (the key
+// of a member is always the token just before its value).
+class JSONTokenizer {
+public:
+
+    enum Type {
+        TYPE_ARRAY,
+        TYPE_BOOL,
+        TYPE_NULL,
+        TYPE_NUMBER,
+        TYPE_OBJECT,
+        TYPE_STRING,
+    };
+
+    static const size_t MAX_DEPTH       = 512;
+    static const size_t NO_TOKEN        = ( size_t )-1;
+
+    //----------------------------------------------------------------//
+    struct Token {
+
+        Type        mType;
+        size_t      mBegin;         // strings exclude their quotes
+        size_t      mEnd;
+        size_t      mSize;          // elements or members
+        size_t      mChildren;      // offset into mChildren
+        bool        mEscaped;       // string contains escape sequences
+    };
+
+private:
+
+    string              mJSON;
+    vector < Token >    mTokens;
+    vector < size_t >   mChildren;
+    vector < size_t >   mStack;
+
+    //----------------------------------------------------------------//
+    static void appendUTF8 ( string& out, u64 codepoint ) {
+
+        if ( codepoint < 0x80 ) {
+            out.push_back (( char )codepoint );
+        }
+        else if ( codepoint < 0x800 ) {
+            out.push_back (( char )( 0xC0 | ( codepoint >> 6 )));
+            out.push_back (( char )( 0x80 | ( codepoint & 0x3F )));
+        }
+        else if ( codepoint < 0x10000 ) {
+            out.push_back (( char )( 0xE0 | ( codepoint >> 12 )));
+            out.push_back (( char )( 0x80 | (( codepoint >> 6 ) & 0x3F )));
+            out.push_back (( char )( 0x80 | ( codepoint & 0x3F )));
+        }
+        else {
+            out.push_back (( char )( 0xF0 | ( codepoint >> 18 )));
+            out.push_back (( char )( 0x80 | (( codepoint >> 12 ) & 0x3F )));
+            out.push_back (( char )( 0x80 | (( codepoint >> 6 ) & 0x3F )));
+            out.push_back (( char )( 0x80 | ( codepoint & 0x3F )));
+        }
+    }
+
+    //----------------------------------------------------------------//
+    void fail ( const char* message, size_t cursor ) const {
+
+        throw Poco::JSON::JSONException ( Format::write ( "%s at offset %d", message, ( int )cursor ));
+    }
+
+    //----------------------------------------------------------------//
+    void expect ( size_t& cursor, char c ) const {
+
+        this->skipWhitespace ( cursor );
+        if (( cursor >= this->mJSON.size ()) || ( this->mJSON [ cursor ] != c )) {
+            this->fail ( "unexpected character", cursor );
+        }
+        cursor++;
+    }
+
+    //----------------------------------------------------------------//
+    void finishContainer ( size_t index, size_t stackBase ) {
+
+        Token& token = this->mTokens [ index ];
+        token.mChildren = this->mChildren.size ();
+        token.mSize = this->mStack.size () - stackBase;
+
+        this->mChildren.insert ( this->mChildren.end (), this->mStack.begin () + ( ptrdiff_t )stackBase, this->mStack.end ());
+        this->mStack.resize ( stackBase );
+    }
+
+    //----------------------------------------------------------------//
+    static bool parseHex ( const char* hex, u64& result ) {
+
+        result = 0;
+        for ( size_t i = 0; i < 4; ++i ) {
+            char c = hex [ i ];
+            result <<= 4;
+            if (( c >= '0' ) && ( c <= '9' )) result |= ( u64 )( c - '0' );
+            else if (( c >= 'a' ) && ( c <= 'f' )) result |= ( u64 )( c - 'a' + 10 );
+            else if (( c >= 'A' ) && ( c <= 'F' )) result |= ( u64 )( c - 'A' + 10 );
+            else return false;
+        }
+        return true;
+    }
+
+    //----------------------------------------------------------------//
+    // checks the escape sequence at cursor (the backslash) and leaves cursor on its last
+    // character. the same escapes the DOM parser accepts: a \u escape has to be four hex
+    // digits, and a surrogate only counts as part of a high/low pair.
+    void scanEscape ( size_t& cursor ) const {
+
+        const string& json = this->mJSON;
+        size_t size = json.size ();
+        size_t start = cursor++;
+
+        if ( cursor >= size ) this->fail ( "unterminated string", start );
+
+        switch ( json [ cursor ]) {
+
+            case '"':
+            case '\\':
+            case '/':
+            case 'b':
+            case 'f':
+            case 'n':
+            case 'r':
+            case 't':
+                return;
+
+            case 'u': {
+
+                u64 codepoint;
+                if ( !((( cursor + 4 ) < size ) && JSONTokenizer::parseHex ( &json.c_str ()[ cursor + 1 ], codepoint ))) {
+                    this->fail ( "invalid unicode escape", start );
+                }
+                cursor += 4;
+
+                if (( codepoint >= 0xDC00 ) && ( codepoint < 0xE000 )) this->fail ( "unpaired surrogate in string", start );
+
+                if (( codepoint >= 0xD800 ) && ( codepoint < 0xDC00 )) {
+                    u64 low;
+                    bool isPair = ((( cursor + 6 ) < size ) && ( json [ cursor + 1 ] == '\\' ) && ( json [ cursor + 2 ] == 'u' ) && JSONTokenizer::parseHex ( &json.c_str ()[ cursor + 3 ], low ));
+                    if ( !( isPair && ( low >= 0xDC00 ) && ( low < 0xE000 ))) this->fail ( "unpaired surrogate in string", start );
+                    cursor += 6;
+                }
+                return;
+            }
+
+            default:
+                this->fail ( "invalid escape in string", start );
+        }
+    }
+
+    //----------------------------------------------------------------//
+    void scanLiteral ( size_t& cursor, const char* literal ) const {
+
+        size_t length = strlen ( literal );
+        if ( this->mJSON.compare ( cursor, length, literal ) != 0 ) {
+            this->fail ( "invalid literal", cursor );
+        }
+        cursor += length;
+    }
+
+    //----------------------------------------------------------------//
+    void scanNumber ( size_t& cursor ) const {
+
+        const string& json = this->mJSON;
+        size_t size = json.size ();
+        size_t start = cursor;
+
+        if (( cursor < size ) && ( json [ cursor ] == '-' )) cursor++;
+
+        size_t digits = cursor;
+        while (( cursor < size ) && isdigit (( unsigned char )json [ cursor ])) cursor++;
+        if ( cursor == digits ) this->fail ( "invalid number", start );
+
+        if (( cursor < size ) && ( json [ cursor ] == '.' )) {
+            cursor++;
+            digits = cursor;
+            while (( cursor < size ) && isdigit (( unsigned char )json [ cursor ])) cursor++;
+            if ( cursor == digits ) this->fail ( "invalid number", start );
+        }
+
+        if (( cursor < size ) && (( json [ cursor ] == 'e' ) || ( json [ cursor ] == 'E' ))) {
+            cursor++;
+            if (( cursor < size ) && (( json [ cursor ] == '+' ) || ( json [ cursor ] == '-' ))) cursor++;
+            digits = cursor;
+            while (( cursor < size ) && isdigit (( unsigned char )json [ cursor ])) cursor++;
+            if ( cursor == digits ) this->fail ( "invalid number", start );
+        }
+    }
+
+    //----------------------------------------------------------------//
+    size_t scanString ( size_t& cursor ) {
+
+        const string& json = this->mJSON;
+        size_t size = json.size ();
+
+        Token token;
+        token.mType         = TYPE_STRING;
+        token.mBegin        = ++cursor;
+        token.mSize         = 0;
+        token.mChildren     = 0;
+        token.mEscaped      = false;
+
+        for ( ; cursor < size; ++cursor ) {
+            unsigned char c = ( unsigned char )json [ cursor ];
+            if ( c == '"' ) break;
+            if ( c < 0x20 ) this->fail ( "control character in string", cursor );
+            if ( c == '\\' ) {
+                token.mEscaped = true;
+                this->scanEscape ( cursor );
+            }
+        }
+        if ( cursor >= size ) this->fail ( "unterminated string", token.mBegin );
+
+        token.mEnd = cursor++;
+        this->mTokens.push_back ( token );
+        return this->mTokens.size () - 1;
+    }
+
+    //----------------------------------------------------------------//
+    size_t scanValue ( size_t& cursor, size_t depth ) {
+
+        if ( depth > MAX_DEPTH ) this->fail ( "document nested too deeply", cursor );
+
+        this->skipWhitespace ( cursor );
+        if ( cursor >= this->mJSON.size ()) this->fail ( "unexpected end of document", cursor );
+
+        char c = this->mJSON [ cursor ];
+        if ( c == '"' ) return this->scanString ( cursor );
+
+        size_t index = this->mTokens.size ();
+
+        Token token;
+        token.mBegin        = cursor;
+        token.mSize         = 0;
+        token.mChildren     = 0;
+        token.mEscaped      = false;
+
+        switch ( c ) {
+
+            case '{':
+            case '[': {
+
+                bool isObject = ( c == '{' );
+                char close = isObject ? '}' : ']';
+
+                token.mType = isObject ? TYPE_OBJECT : TYPE_ARRAY;
+                this->mTokens.push_back ( token );
+
+                size_t stackBase = this->mStack.size ();
+
+                cursor++;
+                this->skipWhitespace ( cursor );
+
+                if (( cursor < this->mJSON.size ()) && ( this->mJSON [ cursor ] == close )) {
+                    cursor++;
+                }
+                else {
+                    while ( true ) {
+
+                        if ( isObject ) {
+                            this->skipWhitespace ( cursor );
+                            if (( cursor >= this->mJSON.size ()) || ( this->mJSON [ cursor ] != '"' )) this->fail ( "expected member name", cursor );
+                            this->scanString ( cursor );
+                            this->expect ( cursor, ':' );
+                        }
+
+                        size_t child = this->scanValue ( cursor, depth + 1 );
+                        this->mStack.push_back ( child );
+
+                        this->skipWhitespace ( cursor );
+                        if ( cursor >= this->mJSON.size ()) this->fail ( "unexpected end of document", cursor );
+
+                        char next = this->mJSON [ cursor++ ];
+                        if ( next == close ) break;
+                        if ( next != ',' ) this->fail ( "expected ',' or closing bracket", cursor - 1 );
+                    }
+                }
+                this->finishContainer ( index, stackBase );
+                this->mTokens [ index ].mEnd = cursor;
+                return index;
+            }
+
+            case 't':
+                token.mType = TYPE_BOOL;
+                this->scanLiteral ( cursor, "true" );
+                break;
+
+            case 'f':
+                token.mType = TYPE_BOOL;
+                this->scanLiteral ( cursor, "false" );
+                break;
+
+            case 'n':
+                token.mType = TYPE_NULL;
+                this->scanLiteral ( cursor, "null" );
+                break;
+
+            default:
+                token.mType = TYPE_NUMBER;
+                this->scanNumber ( cursor );
+                break;
+        }
+
+        token.mEnd = cursor;
+        this->mTokens.push_back ( token );
+        return index;
+    }
+
+    //----------------------------------------------------------------//
+    void skipWhitespace ( size_t& cursor ) const {
+
+        const string& json = this->mJSON;
+        size_t size = json.size ();
+
+        while ( cursor < size ) {
+            char c = json [ cursor ];
+            if (( c != ' ' ) && ( c != '\t' ) && ( c != '\n' ) && ( c != '\r' )) break;
+            cursor++;
+        }
+    }
+
+public:
+
+    //----------------------------------------------------------------//
+    size_t findMember ( size_t object, const string& name ) const {
+
+        const Token& token = this->mTokens [ object ];
+        if ( token.mType != TYPE_OBJECT ) return NO_TOKEN;
+
+        // a repeated name takes the last value, as the DOM parser would.
+        size_t found = NO_TOKEN;
+        for ( size_t i = 0; i < token.mSize; ++i ) {
+            size_t value = this->mChildren [ token.mChildren + i ];
+            if ( this->isString ( value - 1, name )) {
+                found = value;
+            }
+        }
+        return found;
+    }
+
+    //----------------------------------------------------------------//
+    size_t getChild ( size_t container, size_t index ) const {
+
+        const Token& token = this->mTokens [ container ];
+        if ((( token.mType != TYPE_ARRAY ) && ( token.mType != TYPE_OBJECT )) || ( index >= token.mSize )) return NO_TOKEN;
+        return this->mChildren [ token.mChildren + index ];
+    }
+
+    //----------------------------------------------------------------//
+    string getKey ( size_t value ) const {
+
+        return this->getString ( value - 1 );
+    }
+
+    //----------------------------------------------------------------//
+    string getRaw ( size_t index ) const {
+
+        const Token& token = this->mTokens [ index ];
+        return this->mJSON.substr ( token.mBegin, token.mEnd - token.mBegin );
+    }
+
+    //----------------------------------------------------------------//
+    const char* getRawData ( size_t index ) const {
+
+        return &this->mJSON.c_str ()[ this->mTokens [ index ].mBegin ];
+    }
+
+    //----------------------------------------------------------------//
+    string getString ( size_t index ) const {
+
+        const Token& token = this->mTokens [ index ];
+        if ( !token.mEscaped ) return this->getRaw ( index );
+
+        const string& json = this->mJSON;
+
+        string out;
+        out.reserve ( token.mEnd - token.mBegin );
+
+        for ( size_t i = token.mBegin; i < token.mEnd; ++i ) {
+
+            char c = json [ i ];
+            if ( c != '\\' ) {
+                out.push_back ( c );
+                continue;
+            }
+
+            c = json [ ++i ];
+            switch ( c ) {
+                case 'b':   out.push_back ( '\b' );     break;
+                case 'f':   out.push_back ( '\f' );     break;
+                case 'n':   out.push_back ( '\n' );     break;
+                case 'r':   out.push_back ( '\r' );     break;
+                case 't':   out.push_back ( '\t' );     break;
+
+                case 'u': {
+
+                    // scanEscape has already checked the digits and the pairing.
+                    u64 codepoint;
+                    JSONTokenizer::parseHex ( &json.c_str ()[ i + 1 ], codepoint );
+                    i += 4;
+
+                    // join a UTF-16 surrogate pair.
+                    if (( codepoint >= 0xD800 ) && ( codepoint < 0xDC00 )) {
+                        u64 low;
+                        JSONTokenizer::parseHex ( &json.c_str ()[ i + 3 ], low );
+                        codepoint = 0x10000 + (( codepoint - 0xD800 ) << 10 ) + ( low - 0xDC00 );
+                        i += 6;
+                    }
+                    JSONTokenizer::appendUTF8 ( out, codepoint );
+                    break;
+                }
+
+                default:
+                    out.push_back ( c );
+                    break;
+            }
+        }
+        return out;
+    }
+
+    //----------------------------------------------------------------//
+    const Token& getToken ( size_t index ) const {
+
+        return this->mTokens [ index ];
+    }
+
+    //----------------------------------------------------------------//
+    bool isString ( size_t index, const string& str ) const {
+
+        const Token& token = this->mTokens [ index ];
+        if ( token.mType != TYPE_STRING ) return false;
+        if ( token.mEscaped ) return ( this->getString ( index ) == str );
+
+        size_t length = token.mEnd - token.mBegin;
+        return (( length == str.size ()) && ( this->mJSON.compare ( token.mBegin, length, str ) == 0 ));
+    }
+
+    //----------------------------------------------------------------//
+    JSONTokenizer () {
+    }
+
+    //----------------------------------------------------------------//
+    size_t size () const {
+
+        return this->mTokens.size ();
+    }
+
+    //----------------------------------------------------------------//
+    void tokenize ( string json ) {
+
+        this->mJSON = move ( json );
+        this->mTokens.clear ();
+        this->mChildren.clear ();
+        this->mStack.clear ();
+
+        // a rough guess; avoids most regrowth on typical documents.
+        this->mTokens.reserve ( this->mJSON.size () / 8 );
+
+        size_t cursor = 0;
+        this->scanValue ( cursor, 0 );
+        this->skipWhitespace ( cursor );
+        if ( cursor < this->mJSON.size ()) this->fail ( "trailing characters after document", cursor );
+    }
+};
+
+} // namespace Volition
+#endif
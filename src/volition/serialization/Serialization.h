@@ -24,6 +24,8 @@
 
 #include <volition/serialization/DigestSerializer.h>
 #include <volition/serialization/FromJSONSerializer.h>
+#include <volition/serialization/FromJSONStreamSerializer.h>
+#include <volition/serialization/JSONTokenizer.h>
 #include <volition/serialization/ToJSONSerializer.h>
 
 #endif
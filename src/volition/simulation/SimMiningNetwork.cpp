@@ -2,6 +2,7 @@
 // http://cryptogogue.com
 
 #include <volition/Block.h>
+#include <volition/LedgerSnapshot.h>
 #include <volition/Miner.h>
 #include <volition/MinerLocks.h>
 #include <volition/Release.h>
@@ -149,6 +150,29 @@ void SimMiningNetwork::handleRequest ( AbstractMiningMessenger* client, const Mi
             break;
         }
         
+        case MiningMessengerRequest::REQUEST_SNAPSHOT_CHUNK: {
+        
+            if ( request.mHeight >= miner->getLedger ().countBlocks ()) {
+                client->enqueueErrorResponse ( request );
+                break;
+            }
+            Ledger ledger = miner->getLedgerAtBlock ( request.mHeight + 1 );
+            client->enqueueSnapshotChunkResponse ( request, LedgerSnapshot::encodeChunk ( ledger, LedgerSnapshot::ACCOUNTS_PER_CHUNK, request.mChunkIndex ));
+            break;
+        }
+        
+        case MiningMessengerRequest::REQUEST_SNAPSHOT_MANIFEST: {
+        
+            u64 height = LedgerSnapshot::getSnapshotHeight ( miner->getLedger ().countBlocks ());
+            if ( height == 0 ) {
+                client->enqueueErrorResponse ( request );
+                break;
+            }
+            Ledger ledger = miner->getLedgerAtBlock ( height + 1 );
+            client->enqueueSnapshotManifestResponse ( request, miner->getSnapshotCache ().getManifest ( ledger ));
+            break;
+        }
+        
         default:
             assert ( false );
             break;
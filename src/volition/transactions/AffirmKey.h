@@ -47,7 +47,7 @@ public:
     //----------------------------------------------------------------//
     TransactionResult AbstractTransactionBody_apply ( TransactionContext& context ) const override {
     
-        if ( !context.mKeyEntitlements.check ( KeyEntitlements::AFFIRM_KEY )) return "Permission denied.";
+        if ( !context.mKeyEntitlements->check ( KeyEntitlements::AFFIRM_KEY )) return "Permission denied.";
     
         return context.mLedger.affirmKey (
             context.mAccountID,
@@ -57,6 +57,15 @@ public:
             this->mPolicy.get ()
         );
     }
+    
+    //----------------------------------------------------------------//
+    void AbstractTransactionBody_getAccessSet ( TransactionAccessSet& accessSet ) const override {
+    
+        // writes one of the maker's own keys.
+        if ( this->mMaker ) {
+            accessSet.mKeys.insert ( this->mMaker->getAccountName ());
+        }
+    }
 };
 
 } // namespace Transactions
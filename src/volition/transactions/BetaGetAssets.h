@@ -45,7 +45,7 @@ public:
         
         AbstractLedger& ledger = context.mLedger;
         
-        if ( !context.mKeyEntitlements.check ( KeyEntitlements::BETA_GET_ASSETS )) return "Permission denied.";
+        if ( !context.mKeyEntitlements->check ( KeyEntitlements::BETA_GET_ASSETS )) return "Permission denied.";
         
         const Schema& schema = context.mLedger.getSchema ();
         const Schema::Definitions& definitions = schema.getDefinitions ();
@@ -54,8 +54,8 @@ public:
         AccountODBM accountODBM ( ledger, context.mAccountID );
         size_t assetCount = accountODBM.mAssetCount.get ( 0 );
         
-        if ( !context.mAccountEntitlements.check ( AccountEntitlements::MAX_ASSETS, assetCount + addedAssetCount )) {
-            double max = context.mAccountEntitlements.resolvePathAs < NumericEntitlement >( AccountEntitlements::MAX_ASSETS )->getUpperLimit ().mLimit;
+        if ( !context.mAccountEntitlements->check ( AccountEntitlements::MAX_ASSETS, assetCount + addedAssetCount )) {
+            double max = context.mAccountEntitlements->resolvePathAs < NumericEntitlement >( AccountEntitlements::MAX_ASSETS )->getUpperLimit ().mLimit;
             return Format::write ( "Transaction would overflow account inventory limit of %d assets.", ( int )max );
         }
         
@@ -43,7 +43,7 @@ public:
         
         AbstractLedger& ledger = context.mLedger;
         
-        if ( !context.mKeyEntitlements.check ( KeyEntitlements::BETA_GET_DECK )) return "Permission denied.";
+        if ( !context.mKeyEntitlements->check ( KeyEntitlements::BETA_GET_DECK )) return "Permission denied.";
         
         const Schema& schema = context.mLedger.getSchema ();
         const Schema::Deck* deck = schema.getDeck ( this->mDeckName );
@@ -58,8 +58,8 @@ public:
         AccountODBM accountODBM ( ledger, context.mAccountID );
         size_t assetCount = accountODBM.mAssetCount.get ( 0 );
         
-        if ( !context.mAccountEntitlements.check ( AccountEntitlements::MAX_ASSETS, assetCount + addedAssetCount )) {
-            double max = context.mAccountEntitlements.resolvePathAs < NumericEntitlement >( AccountEntitlements::MAX_ASSETS )->getUpperLimit ().mLimit;
+        if ( !context.mAccountEntitlements->check ( AccountEntitlements::MAX_ASSETS, assetCount + addedAssetCount )) {
+            double max = context.mAccountEntitlements->resolvePathAs < NumericEntitlement >( AccountEntitlements::MAX_ASSETS )->getUpperLimit ().mLimit;
             return Format::write ( "Transaction would overflow account inventory limit of %d assets.", ( int )max );
         }
         
@@ -49,7 +49,7 @@ public:
     //----------------------------------------------------------------//
     TransactionResult AbstractTransactionBody_apply ( TransactionContext& context ) const override {
                 
-        if ( !context.mKeyEntitlements.check ( KeyEntitlements::BUY_ASSETS )) return "Permission denied.";
+        if ( !context.mKeyEntitlements->check ( KeyEntitlements::BUY_ASSETS )) return "Permission denied.";
         
         AbstractLedger& ledger = context.mLedger;
 
@@ -77,6 +77,7 @@ public:
         ledger.transferAssets ( sellerODBM, buyerODBM, AssetListAdapter ( assetIDs.data (), assetIDs.size ()), context.mTime );
 
         offerODBM.mBuyer.set ( buyerODBM.mAccountID );
+        ledger.unindexOpenOffer ( offerODBM.mOfferID );
 
         if ( context.mRelease > 0 ) {
             buyerODBM.subFunds ( this->mPrice );
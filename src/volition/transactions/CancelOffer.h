@@ -49,6 +49,13 @@ public:
             context.mTime
         );
     }
+    
+    //----------------------------------------------------------------//
+    void AbstractTransactionBody_getAccessSet ( TransactionAccessSet& accessSet ) const override {
+        UNUSED ( accessSet );
+        
+        // only the maker's own offer (and its assets) are written.
+    }
 };
 
 } // namespace Transactions
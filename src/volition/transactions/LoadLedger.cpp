@@ -34,6 +34,36 @@ TransactionResult LoadLedgerAccount::apply ( AbstractLedger& ledger ) const {
     return true;
 }
 
+//----------------------------------------------------------------//
+bool LoadLedgerAccount::init ( AbstractLedger& ledger, AccountID accountID ) {
+
+    AccountODBM accountODBM ( ledger, accountID );
+    if ( !accountODBM ) return false;
+
+    shared_ptr < const Account > account = accountODBM.mBody.get ();
+    if ( !account ) return false;
+    
+    shared_ptr < const MinerInfo > minerInfo = accountODBM.mMinerInfo.get ();
+    
+    this->mName         = accountODBM.mName.get ( "" );
+    this->mBalance      = accountODBM.mBalance.get ();
+    this->mPolicy       = account->mPolicy;
+    this->mBequest      = account->mBequest;
+    this->mKeys         = account->mKeys;
+    this->mMinerInfo    = minerInfo ? make_shared < MinerInfo >( *minerInfo ) : NULL;
+    
+    this->mInventory.clear ();
+    
+    SerializableList < SerializableSharedConstPtr < Asset >> inventory;
+    ledger.getInventory ( accountODBM.mAccountID, inventory, 0, true );
+    
+    SerializableList < SerializableSharedConstPtr < Asset >>::const_iterator assetIt = inventory.cbegin ();
+    for ( ; assetIt != inventory.cend (); ++assetIt ) {
+        this->mInventory.push_back ( **assetIt );
+    }
+    return true;
+}
+
 //================================================================//
 // virtual
 //================================================================//
@@ -69,40 +99,26 @@ void LoadLedgerAccount::AbstractSerializable_serializeTo ( AbstractSerializerTo&
 //----------------------------------------------------------------//
 void LoadLedger::init ( AbstractLedger& ledger ) {
     
-    this->mIdentity     = ledger.getIdentity ();
-    this->mSchema       = ledger.getSchema ();
+    this->initHeader ( ledger );
     
     AccountID::Index totalAccounts = ledger.getValue < AccountID::Index >( Ledger::keyFor_globalAccountCount ());
     for ( AccountID::Index i = 0; i < totalAccounts; ++i ) {
     
-        AccountODBM accountODBM ( ledger, AccountID ( i ));
-        if ( !accountODBM ) continue;
-    
-        shared_ptr < const Account > account = accountODBM.mBody.get ();
-        if ( !account ) continue;
-        
-        shared_ptr < const MinerInfo > minerInfo = accountODBM.mMinerInfo.get ();
-        
         LoadLedgerAccount loadLedgerAccount;
-        loadLedgerAccount.mName         = accountODBM.mName.get ( "" );
-        loadLedgerAccount.mBalance      = accountODBM.mBalance.get ();
-        loadLedgerAccount.mPolicy       = account->mPolicy;
-        loadLedgerAccount.mBequest      = account->mBequest;
-        loadLedgerAccount.mKeys         = account->mKeys;
-        loadLedgerAccount.mMinerInfo    = minerInfo ? make_shared < MinerInfo >( *minerInfo ) : NULL;
-        
-        SerializableList < SerializableSharedConstPtr < Asset >> inventory;
-        ledger.getInventory ( accountODBM.mAccountID, inventory, 0, true );
-        
-        SerializableList < SerializableSharedConstPtr < Asset >>::const_iterator assetIt = inventory.cbegin ();
-        for ( ; assetIt != inventory.cend (); ++assetIt ) {
-            loadLedgerAccount.mInventory.push_back ( **assetIt );
+        if ( loadLedgerAccount.init ( ledger, AccountID ( i ))) {
+            this->mAccounts.push_back ( loadLedgerAccount );
         }
-        
-        this->mAccounts.push_back ( loadLedgerAccount );
     }
 }
 
+//----------------------------------------------------------------//
+void LoadLedger::initHeader ( AbstractLedger& ledger ) {
+    
+    // consensus settings are left unset, as they always were in ledger dumps.
+    this->mIdentity     = ledger.getIdentity ();
+    this->mSchema       = ledger.getSchema ();
+}
+
 //================================================================//
 // virtual
 //================================================================//
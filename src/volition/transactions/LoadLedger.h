@@ -35,6 +35,7 @@ public:
     
     //----------------------------------------------------------------//
     TransactionResult       apply                                       ( AbstractLedger& ledger ) const;
+    bool                    init                                        ( AbstractLedger& ledger, AccountID accountID );
 };
 
 //================================================================//
@@ -60,6 +61,7 @@ public:
     
     //----------------------------------------------------------------//
     void                    init                    ( AbstractLedger& ledger );
+    void                    initHeader              ( AbstractLedger& ledger );
 };
 
 } // namespace Transactions
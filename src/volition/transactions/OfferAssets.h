@@ -51,7 +51,7 @@ public:
     //----------------------------------------------------------------//
     TransactionResult AbstractTransactionBody_apply ( TransactionContext& context ) const override {
                 
-        if ( !context.mKeyEntitlements.check ( KeyEntitlements::OFFER_ASSETS )) return "Permission denied.";
+        if ( !context.mKeyEntitlements->check ( KeyEntitlements::OFFER_ASSETS )) return "Permission denied.";
         
         return context.mLedger.offerAssets (
             context.mAccountID,
@@ -64,6 +64,13 @@ public:
             context.mTime
         );
     }
+    
+    //----------------------------------------------------------------//
+    void AbstractTransactionBody_getAccessSet ( TransactionAccessSet& accessSet ) const override {
+        UNUSED ( accessSet );
+        
+        // only the maker's own assets (and the offer) are written.
+    }
 };
 
 } // namespace Transactions
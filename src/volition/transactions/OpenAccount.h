@@ -63,7 +63,7 @@ public:
         AbstractLedger& ledger = context.mLedger;
         const Account& account = context.mAccount;
         
-        if ( !context.mKeyEntitlements.check ( KeyEntitlements::OPEN_ACCOUNT )) return "Permission denied.";
+        if ( !context.mKeyEntitlements->check ( KeyEntitlements::OPEN_ACCOUNT )) return "Permission denied.";
         
         ContractWithDigest termsOfService = ledger.getTermsOfService ();
         if ( termsOfService.mText.size ()) {
@@ -98,6 +98,17 @@ public:
         return true;
     }
     
+    //----------------------------------------------------------------//
+    void AbstractTransactionBody_getAccessSet ( TransactionAccessSet& accessSet ) const override {
+    
+        // creates the child account (named for the sponsor, as the maker names it) and funds it.
+        if ( this->mMaker ) {
+            string childName = Format::write ( ".%s.%s", this->mMaker->getAccountName ().c_str (), this->mSuffix.c_str ());
+            accessSet.mAccounts.insert ( childName );
+            accessSet.mKeys.insert ( childName );
+        }
+    }
+
     //----------------------------------------------------------------//
     u64 AbstractTransactionBody_getVOL ( const TransactionContext& context ) const override {
         UNUSED ( context );
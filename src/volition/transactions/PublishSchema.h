@@ -42,7 +42,7 @@ public:
     //----------------------------------------------------------------//
     TransactionResult AbstractTransactionBody_apply ( TransactionContext& context ) const override {
         
-        if ( !context.mKeyEntitlements.check ( KeyEntitlements::PUBLISH_SCHEMA )) return "Permission denied.";
+        if ( !context.mKeyEntitlements->check ( KeyEntitlements::PUBLISH_SCHEMA )) return "Permission denied.";
         
         Schema updateSchema = context.mLedger.getSchema ();
 
@@ -46,7 +46,7 @@ public:
     //----------------------------------------------------------------//
     TransactionResult AbstractTransactionBody_apply ( TransactionContext& context ) const override {
         
-        if ( !context.mKeyEntitlements.check ( KeyEntitlements::PUBLISH_SCHEMA_AND_RESET )) return "Permission denied.";
+        if ( !context.mKeyEntitlements->check ( KeyEntitlements::PUBLISH_SCHEMA_AND_RESET )) return "Permission denied.";
 
         LedgerResult result = context.mLedger.checkSchemaMethodsAndRewards ( this->mSchema );
         if ( !result ) return result;
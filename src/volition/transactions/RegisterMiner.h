@@ -44,13 +44,21 @@ public:
     //----------------------------------------------------------------//
     TransactionResult AbstractTransactionBody_apply ( TransactionContext& context ) const override {
     
-        if ( !context.mKeyEntitlements.check ( KeyEntitlements::REGISTER_MINER )) return "Permission denied.";
+        if ( !context.mKeyEntitlements->check ( KeyEntitlements::REGISTER_MINER )) return "Permission denied.";
         if ( !this->mMinerInfo ) return "Missing miner info.";
         if ( !this->mMinerInfo->getPublicKey ()) return "Missing miner public key.";
         if ( !this->mMinerInfo->getVisage ()) return "Missing miner visage.";
         
         return context.mLedger.registerMiner ( context.mLedger.getAccountID ( this->mAccountName ), *this->mMinerInfo );
     }
+    
+    //----------------------------------------------------------------//
+    void AbstractTransactionBody_getAccessSet ( TransactionAccessSet& accessSet ) const override {
+    
+        // registers (and writes the miner info of) the named account, which need not be the maker.
+        accessSet.mAccounts.insert ( this->mAccountName );
+        accessSet.mKeys.insert ( this->mAccountName );
+    }
 };
 
 } // namespace Transactions
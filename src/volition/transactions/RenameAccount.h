@@ -42,7 +42,7 @@ public:
     //----------------------------------------------------------------//
     TransactionResult AbstractTransactionBody_apply ( TransactionContext& context ) const override {
         
-        if ( !context.mKeyEntitlements.check ( KeyEntitlements::RENAME_ACCOUNT )) return "Permission denied.";
+        if ( !context.mKeyEntitlements->check ( KeyEntitlements::RENAME_ACCOUNT )) return "Permission denied.";
         
         if ( this->mRevealedName.size () > 0 ) {
             return context.mLedger.renameAccount ( context.mAccountID, this->mRevealedName );
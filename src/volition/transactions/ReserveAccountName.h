@@ -75,7 +75,7 @@ public:
         // The nameSecret is also generated. It is used to verify ownership of the name: if the
         // generated nameSecret is found in the collision table, the name is awarded.
 
-        if ( !context.mKeyEntitlements.check ( KeyEntitlements::RESERVE_ACCOUNT_NAME )) return "Permission denied.";
+        if ( !context.mKeyEntitlements->check ( KeyEntitlements::RESERVE_ACCOUNT_NAME )) return "Permission denied.";
 
         if (( this->mNameHash.size () > 0 ) && ( this->mNameSecret.size () > 0 )) {
             return context.mLedger.reserveAccountname ( this->mNameHash, this->mNameSecret );
@@ -44,7 +44,7 @@ public:
     //----------------------------------------------------------------//
     TransactionResult AbstractTransactionBody_apply ( TransactionContext& context ) const override {
         
-        if ( !context.mKeyEntitlements.check ( KeyEntitlements::RESTRICT_ACCOUNT )) return "Permission denied.";
+        if ( !context.mKeyEntitlements->check ( KeyEntitlements::RESTRICT_ACCOUNT )) return "Permission denied.";
         
         AbstractLedger& ledger = context.mLedger;
         Account accountUpdated = context.mAccount;
@@ -71,6 +71,15 @@ public:
         
         return true;
     }
+    
+    //----------------------------------------------------------------//
+    void AbstractTransactionBody_getAccessSet ( TransactionAccessSet& accessSet ) const override {
+    
+        // narrows the maker's own account policy.
+        if ( this->mMaker ) {
+            accessSet.mKeys.insert ( this->mMaker->getAccountName ());
+        }
+    }
 };
 
 } // namespace Transactions
@@ -44,7 +44,7 @@ public:
     //----------------------------------------------------------------//
     TransactionResult AbstractTransactionBody_apply ( TransactionContext& context ) const override {
         
-        if ( !context.mKeyEntitlements.check ( KeyEntitlements::RESTRICT_KEY )) return "Permission denied.";
+        if ( !context.mKeyEntitlements->check ( KeyEntitlements::RESTRICT_KEY )) return "Permission denied.";
         
         AbstractLedger& ledger = context.mLedger;
         KeyAndPolicy keyUpdated = context.mKeyAndPolicy;
@@ -73,6 +73,15 @@ public:
         
         return true;
     }
+    
+    //----------------------------------------------------------------//
+    void AbstractTransactionBody_getAccessSet ( TransactionAccessSet& accessSet ) const override {
+    
+        // narrows the policy of one of the maker's own keys.
+        if ( this->mMaker ) {
+            accessSet.mKeys.insert ( this->mMaker->getAccountName ());
+        }
+    }
 };
 
 } // namespace Transactions
@@ -51,7 +51,7 @@ public:
     //----------------------------------------------------------------//
     TransactionResult AbstractTransactionBody_apply ( TransactionContext& context ) const override {
         
-        if ( !context.mKeyEntitlements.check ( KeyEntitlements::RUN_SCRIPT )) return "Permission denied.";
+        if ( !context.mKeyEntitlements->check ( KeyEntitlements::RUN_SCRIPT )) return "Permission denied.";
         
         if ( !this->verifyMetrics ( context )) return "Transaction metrics are incorrect.";
         
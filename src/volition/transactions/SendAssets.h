@@ -47,7 +47,7 @@ public:
     //----------------------------------------------------------------//
     TransactionResult AbstractTransactionBody_apply ( TransactionContext& context ) const override {
                 
-        if ( !context.mKeyEntitlements.check ( KeyEntitlements::SEND_ASSETS )) return "Permission denied.";
+        if ( !context.mKeyEntitlements->check ( KeyEntitlements::SEND_ASSETS )) return "Permission denied.";
         
         AccountID receiverID = context.mLedger.getAccountID ( this->mAccountName );
         context.pushAccountLogEntry ( receiverID );
@@ -63,6 +63,12 @@ public:
         );
     }
     
+    //----------------------------------------------------------------//
+    void AbstractTransactionBody_getAccessSet ( TransactionAccessSet& accessSet ) const override {
+    
+        accessSet.mAccounts.insert ( this->mAccountName );
+    }
+    
     //----------------------------------------------------------------//
     TransactionDetailsPtr AbstractTransactionBody_getDetails ( const AbstractLedger& ledger ) const override {
         
@@ -46,7 +46,7 @@ public:
         
         AbstractLedger& ledger = context.mLedger;
         
-        if ( !context.mKeyEntitlements.check ( KeyEntitlements::SEND_VOL )) return "Permission denied.";
+        if ( !context.mKeyEntitlements->check ( KeyEntitlements::SEND_VOL )) return "Permission denied.";
         
         AccountODBM receiverODBM ( ledger, this->mAccountName );
         
@@ -61,6 +61,12 @@ public:
         return true;
     }
     
+    //----------------------------------------------------------------//
+    void AbstractTransactionBody_getAccessSet ( TransactionAccessSet& accessSet ) const override {
+    
+        accessSet.mAccounts.insert ( this->mAccountName );
+    }
+    
     //----------------------------------------------------------------//
     u64 AbstractTransactionBody_getVOL ( const TransactionContext& context ) const override {
         UNUSED ( context );
@@ -44,7 +44,7 @@ public:
     //----------------------------------------------------------------//
     TransactionResult AbstractTransactionBody_apply ( TransactionContext& context ) const override {
                 
-        if ( !context.mKeyEntitlements.check ( KeyEntitlements::SET_ENTITLEMENTS )) return "Permission denied.";
+        if ( !context.mKeyEntitlements->check ( KeyEntitlements::SET_ENTITLEMENTS )) return "Permission denied.";
         context.mLedger.setEntitlements ( this->mName, this->mEntitlements );
         return true;
     }
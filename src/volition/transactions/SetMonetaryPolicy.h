@@ -41,7 +41,7 @@ public:
     //----------------------------------------------------------------//
     TransactionResult AbstractTransactionBody_apply ( TransactionContext& context ) const override {
                 
-        if ( !context.mKeyEntitlements.check ( KeyEntitlements::SET_MONETARY_POLICY )) return "Permission denied.";
+        if ( !context.mKeyEntitlements->check ( KeyEntitlements::SET_MONETARY_POLICY )) return "Permission denied.";
         context.mLedger.setMonetaryPolicy ( this->mMonetaryPolicy );
         return true;
     }
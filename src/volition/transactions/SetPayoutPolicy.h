@@ -41,7 +41,7 @@ public:
     //----------------------------------------------------------------//
     TransactionResult AbstractTransactionBody_apply ( TransactionContext& context ) const override {
                 
-        if ( !context.mKeyEntitlements.check ( KeyEntitlements::SET_PAYOUT_POLICY )) return "Permission denied.";
+        if ( !context.mKeyEntitlements->check ( KeyEntitlements::SET_PAYOUT_POLICY )) return "Permission denied.";
         return context.mLedger.setPayoutPolicy ( this->mPayoutPolicy );
     }
 };
@@ -41,7 +41,7 @@ public:
     //----------------------------------------------------------------//
     TransactionResult AbstractTransactionBody_apply ( TransactionContext& context ) const override {
                 
-        if ( !context.mKeyEntitlements.check ( KeyEntitlements::SET_TERMS_OF_SERVICE )) return "Permission denied.";
+        if ( !context.mKeyEntitlements->check ( KeyEntitlements::SET_TERMS_OF_SERVICE )) return "Permission denied.";
         context.mLedger.setTermsOfService ( ContractWithDigest ( this->mText ));
         return true;
     }
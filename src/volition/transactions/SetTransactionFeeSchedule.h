@@ -41,7 +41,7 @@ public:
     //----------------------------------------------------------------//
     TransactionResult AbstractTransactionBody_apply ( TransactionContext& context ) const override {
                 
-        if ( !context.mKeyEntitlements.check ( KeyEntitlements::SET_TRANSACTION_FEE_SCHEDULE )) return "Permission denied.";
+        if ( !context.mKeyEntitlements->check ( KeyEntitlements::SET_TRANSACTION_FEE_SCHEDULE )) return "Permission denied.";
         context.mLedger.setTransactionFeeSchedule ( this->mFeeSchedule );
         return true;
     }
@@ -67,6 +67,13 @@ public:
         );
     }
     
+    //----------------------------------------------------------------//
+    void AbstractTransactionBody_getAccessSet ( TransactionAccessSet& accessSet ) const override {
+    
+        // the stamp's price goes to its owner, who isn't known until the body runs.
+        accessSet.mAllAccounts = true;
+    }
+    
     //----------------------------------------------------------------//
     u64 AbstractTransactionBody_getVOL ( const TransactionContext& context ) const override {
     
@@ -41,11 +41,20 @@ public:
     //----------------------------------------------------------------//
     TransactionResult AbstractTransactionBody_apply ( TransactionContext& context ) const override {
     
-        if ( !context.mKeyEntitlements.check ( KeyEntitlements::UPDATE_MINER_INFO )) return "Permission denied.";
+        if ( !context.mKeyEntitlements->check ( KeyEntitlements::UPDATE_MINER_INFO )) return "Permission denied.";
         if ( !this->mMinerInfo ) return "Missing miner info.";
         
         return context.mLedger.updateMinerInfo ( context.mAccountID, *this->mMinerInfo );
     }
+    
+    //----------------------------------------------------------------//
+    void AbstractTransactionBody_getAccessSet ( TransactionAccessSet& accessSet ) const override {
+    
+        // writes the maker's own miner info.
+        if ( this->mMaker ) {
+            accessSet.mKeys.insert ( this->mMaker->getAccountName ());
+        }
+    }
 };
 
 } // namespace Transactions
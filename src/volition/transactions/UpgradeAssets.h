@@ -42,7 +42,7 @@ public:
     //----------------------------------------------------------------//
     TransactionResult AbstractTransactionBody_apply ( TransactionContext& context ) const override {
 
-        if ( !context.mKeyEntitlements.check ( KeyEntitlements::UPGRADE_ASSETS )) return "Permission denied.";
+        if ( !context.mKeyEntitlements->check ( KeyEntitlements::UPGRADE_ASSETS )) return "Permission denied.";
                 
         return context.mLedger.upgradeAssets (
             context.mAccountID,
@@ -50,6 +50,13 @@ public:
             context.mTime
         );
     }
+
+    //----------------------------------------------------------------//
+    void AbstractTransactionBody_getAccessSet ( TransactionAccessSet& accessSet ) const override {
+        UNUSED ( accessSet );
+        
+        // only the maker's own assets are written.
+    }
 };
 
 } // namespace Transactions
@@ -21,6 +21,7 @@ class AccountDetailsHandler :
 public:
 
     SUPPORTED_HTTP_METHODS ( HTTP::GET )
+    CACHEABLE_RESPONSE
 
     //----------------------------------------------------------------//
     static void formatJSON ( const AbstractLedger& ledger, AccountODBM& accountODBM, Poco::JSON::Object& jsonOut ) {
@@ -21,6 +21,7 @@ class AssetDetailsHandler :
 public:
 
     SUPPORTED_HTTP_METHODS ( HTTP::GET )
+    CACHEABLE_RESPONSE
 
     //----------------------------------------------------------------//
     HTTPStatus AbstractMinerAPIRequestHandler_handleRequest ( HTTP::Method method, shared_ptr < Miner > miner, const Poco::JSON::Object& jsonIn, Poco::JSON::Object& jsonOut ) const override {
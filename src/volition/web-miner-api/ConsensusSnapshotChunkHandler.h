@@ -0,0 +1,50 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_WEBMINERAPI_CONSENSUSSNAPSHOTCHUNKHANDLER_H
+#define VOLITION_WEBMINERAPI_CONSENSUSSNAPSHOTCHUNKHANDLER_H
+
+#include <volition/AbstractMinerAPIRequestHandler.h>
+#include <volition/LedgerSnapshot.h>
+
+namespace Volition {
+namespace WebMinerAPI {
+
+//================================================================//
+// ConsensusSnapshotChunkHandler
+//================================================================//
+class ConsensusSnapshotChunkHandler :
+    public AbstractMinerAPIRequestHandler {
+public:
+
+    SUPPORTED_HTTP_METHODS ( HTTP::GET )
+
+    //----------------------------------------------------------------//
+    HTTPStatus AbstractMinerAPIRequestHandler_handleRequest ( HTTP::Method method, shared_ptr < Miner > miner, const Poco::JSON::Object& jsonIn, Poco::JSON::Object& jsonOut ) const override {
+        UNUSED ( method );
+        UNUSED ( jsonIn );
+
+        u64 height          = this->getMatchU64 ( "height" );
+        u64 chunkIndex      = this->getMatchU64 ( "chunkIndex" );
+
+        ScopedSharedMinerLedgerLock ledger ( miner );
+        
+        // only snapshot heights are served; anything else would let peers make us encode arbitrary history.
+        if (( height == 0 ) || ( height % LedgerSnapshot::SNAPSHOT_INTERVAL ) || ( height >= ledger.countBlocks ())) return Poco::Net::HTTPResponse::HTTP_NOT_FOUND;
+        
+        ledger.seek ( height + 1 );
+        
+        AccountID::Index totalAccounts = ledger.getValue < AccountID::Index >( Ledger::keyFor_globalAccountCount ());
+        if ( chunkIndex > (( totalAccounts + LedgerSnapshot::ACCOUNTS_PER_CHUNK - 1 ) / LedgerSnapshot::ACCOUNTS_PER_CHUNK )) return Poco::Net::HTTPResponse::HTTP_NOT_FOUND;
+        
+        jsonOut.set ( "height",     height );
+        jsonOut.set ( "chunkIndex", chunkIndex );
+        jsonOut.set ( "chunk",      LedgerSnapshot::encodeChunk ( ledger, LedgerSnapshot::ACCOUNTS_PER_CHUNK, ( size_t )chunkIndex ));
+        
+        return Poco::Net::HTTPResponse::HTTP_OK;
+    }
+};
+
+} // namespace TheWebMinerAPI
+} // namespace Volition
+#endif
@@ -0,0 +1,52 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_WEBMINERAPI_CONSENSUSSNAPSHOTHANDLER_H
+#define VOLITION_WEBMINERAPI_CONSENSUSSNAPSHOTHANDLER_H
+
+#include <volition/AbstractMinerAPIRequestHandler.h>
+#include <volition/BlockODBM.h>
+#include <volition/LedgerSnapshot.h>
+
+namespace Volition {
+namespace WebMinerAPI {
+
+//================================================================//
+// ConsensusSnapshotHandler
+//================================================================//
+class ConsensusSnapshotHandler :
+    public AbstractMinerAPIRequestHandler {
+public:
+
+    SUPPORTED_HTTP_METHODS ( HTTP::GET )
+
+    //----------------------------------------------------------------//
+    HTTPStatus AbstractMinerAPIRequestHandler_handleRequest ( HTTP::Method method, shared_ptr < Miner > miner, const Poco::JSON::Object& jsonIn, Poco::JSON::Object& jsonOut ) const override {
+        UNUSED ( method );
+        UNUSED ( jsonIn );
+
+        u64 height = 0;
+        string blockHash;
+        
+        {
+            ScopedSharedMinerLedgerLock ledger ( miner );
+            
+            height = LedgerSnapshot::getSnapshotHeight ( ledger.countBlocks ());
+            if ( height == 0 ) return Poco::Net::HTTPResponse::HTTP_NOT_FOUND;
+            
+            blockHash = BlockODBM ( ledger, height ).mHash.get ();
+        }
+        
+        // built in the background; until it's ready, the peer asks again.
+        shared_ptr < const LedgerSnapshotManifest > manifest = miner->getSnapshotCache ().getManifest ( height, blockHash );
+        if ( !manifest ) return Poco::Net::HTTPResponse::HTTP_NOT_FOUND;
+        
+        jsonOut.set ( "snapshot", ToJSONSerializer::toJSON ( *manifest ));
+        
+        return Poco::Net::HTTPResponse::HTTP_OK;
+    }
+};
+
+} // namespace TheWebMinerAPI
+} // namespace Volition
+#endif
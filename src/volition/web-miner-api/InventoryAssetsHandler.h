@@ -21,6 +21,7 @@ public:
     static const size_t ASSET_BATCH_SIZE = 256;
 
     SUPPORTED_HTTP_METHODS ( HTTP::GET )
+    CACHEABLE_RESPONSE
 
     //----------------------------------------------------------------//
     HTTPStatus AbstractMinerAPIRequestHandler_handleRequest ( HTTP::Method method, shared_ptr < Miner > miner, const Poco::JSON::Object& jsonIn, Poco::JSON::Object& jsonOut ) const override {
@@ -0,0 +1,82 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_WEBMINERAPI_INVENTORYDELTAHANDLER_H
+#define VOLITION_WEBMINERAPI_INVENTORYDELTAHANDLER_H
+
+#include <volition/AbstractMinerAPIRequestHandler.h>
+#include <volition/AccountODBM.h>
+#include <volition/InventoryDelta.h>
+
+namespace Volition {
+namespace WebMinerAPI {
+
+//================================================================//
+// InventoryDeltaHandler
+//================================================================//
+// Net inventory changes between two inventory nonces, [from, to). 'to'
+// defaults to (and is clamped at) the account's current inventory nonce.
+// Returns every added and deleted asset ID; the added assets themselves
+// are paged by 'base' over the additions, ASSET_PAGE_SIZE at a time, with
+// 'nextBase' set while there are more.
+class InventoryDeltaHandler :
+    public AbstractMinerAPIRequestHandler {
+public:
+
+    static const size_t ASSET_PAGE_SIZE = 256;
+
+    SUPPORTED_HTTP_METHODS ( HTTP::GET )
+    CACHEABLE_RESPONSE
+
+    //----------------------------------------------------------------//
+    HTTPStatus AbstractMinerAPIRequestHandler_handleRequest ( HTTP::Method method, shared_ptr < Miner > miner, const Poco::JSON::Object& jsonIn, Poco::JSON::Object& jsonOut ) const override {
+        UNUSED ( method );
+        UNUSED ( jsonIn );
+
+        ScopedSharedMinerLedgerLock ledger ( miner );
+        ledger.seek ( this->optQuery ( "at", ledger.countBlocks ()));
+
+        string accountName = this->getMatchString ( "accountName" );
+
+        AccountODBM accountODBM ( ledger, accountName );
+        if ( !accountODBM ) return Poco::Net::HTTPResponse::HTTP_NOT_FOUND;
+
+        u64 inventoryNonce  = accountODBM.mInventoryNonce.get ( 0 );
+        u64 from            = this->optQuery ( "from", 0 );
+        u64 to              = this->optQuery ( "to", inventoryNonce );
+        size_t base         = ( size_t )this->optQuery ( "base", 0 );
+
+        if ( to > inventoryNonce ) {
+            to = inventoryNonce;
+        }
+        if ( from > to ) return Poco::Net::HTTPResponse::HTTP_BAD_REQUEST;
+
+        InventoryDelta delta;
+        delta.load ( accountODBM, from, to );
+
+        SerializableList < SerializableSharedConstPtr < Asset >> assets;
+        delta.expand ( ledger, accountODBM.mAccountID, base, ASSET_PAGE_SIZE, assets );
+        jsonOut.set ( "assets", ToJSONSerializer::toJSON ( assets ));
+
+        SerializableList < string > additionsDecoded;
+        InventoryLogEntry::decode ( delta.mAdditions, additionsDecoded );
+        jsonOut.set ( "additions", ToJSONSerializer::toJSON ( additionsDecoded ));
+
+        SerializableList < string > deletionsDecoded;
+        InventoryLogEntry::decode ( delta.mDeletions, deletionsDecoded );
+        jsonOut.set ( "deletions", ToJSONSerializer::toJSON ( deletionsDecoded ));
+
+        jsonOut.set ( "from", from );
+        jsonOut.set ( "to", to );
+
+        if (( base + ASSET_PAGE_SIZE ) < delta.mAdditions.size ()) {
+            jsonOut.set ( "nextBase", base + ASSET_PAGE_SIZE );
+        }
+
+        return Poco::Net::HTTPResponse::HTTP_OK;
+    }
+};
+
+} // namespace TheWebMinerAPI
+} // namespace Volition
+#endif
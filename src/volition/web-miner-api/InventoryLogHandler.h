@@ -5,6 +5,7 @@
 #define VOLITION_WEBMINERAPI_INVENTORYLOGHANDLER_H
 
 #include <volition/Block.h>
+#include <volition/InventoryDelta.h>
 #include <volition/InventoryLogEntry.h>
 #include <volition/AbstractMinerAPIRequestHandler.h>
 #include <volition/TheTransactionBodyFactory.h>
@@ -33,33 +34,25 @@ public:
         u64 nonce           = this->getMatchU64 ( "nonce" );
         u64 count           = this->optQuery ( "count", 1 );
         
-        SerializableSet < AssetID::Index > additions;
-        SerializableSet < AssetID::Index > deletions;
-        
         AccountODBM accountODBM ( ledger, accountName );
         
-        u64 found = 0;
-        for ( ; found < count; ++found ) {
-            
-            shared_ptr < const InventoryLogEntry > logEntry = accountODBM.getInventoryLogEntryField ( nonce + found ).get ();
-            if ( !logEntry ) continue;
-            
-            logEntry->apply ( additions, deletions );
-        }
+        // checkpointed intervals inside the range are read whole instead of entry by entry.
+        InventoryDelta delta;
+        delta.load ( accountODBM, nonce, nonce + count );
         
         SerializableList < SerializableSharedConstPtr < Asset >> assets;
-        InventoryLogEntry::expand ( ledger, accountName, additions, assets );
+        InventoryLogEntry::expand ( ledger, accountName, delta.mAdditions, assets );
         jsonOut.set ( "assets", ToJSONSerializer::toJSON ( assets ));
         
         SerializableList < string > additionDecoded;
-        InventoryLogEntry::decode ( additions, additionDecoded );
+        InventoryLogEntry::decode ( delta.mAdditions, additionDecoded );
         jsonOut.set ( "additions", ToJSONSerializer::toJSON ( additionDecoded ));
         
         SerializableList < string > deletionsDecoded;
-        InventoryLogEntry::decode ( deletions, deletionsDecoded );
+        InventoryLogEntry::decode ( delta.mDeletions, deletionsDecoded );
         jsonOut.set ( "deletions", ToJSONSerializer::toJSON ( deletionsDecoded ));
         
-        jsonOut.set ( "nextNonce", nonce + found );
+        jsonOut.set ( "nextNonce", nonce + count );
         
         return Poco::Net::HTTPResponse::HTTP_OK;
     }
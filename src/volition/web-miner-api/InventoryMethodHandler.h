@@ -0,0 +1,60 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_WEBMINERAPI_INVENTORYMETHODHANDLER_H
+#define VOLITION_WEBMINERAPI_INVENTORYMETHODHANDLER_H
+
+#include <volition/AbstractMinerAPIRequestHandler.h>
+#include <volition/CraftabilityIndex.h>
+
+namespace Volition {
+namespace WebMinerAPI {
+
+//================================================================//
+// InventoryMethodHandler
+//================================================================//
+class InventoryMethodHandler :
+    public AbstractMinerAPIRequestHandler {
+public:
+
+    SUPPORTED_HTTP_METHODS ( HTTP::GET )
+    CACHEABLE_RESPONSE
+
+    //----------------------------------------------------------------//
+    HTTPStatus AbstractMinerAPIRequestHandler_handleRequest ( HTTP::Method method, shared_ptr < Miner > miner, const Poco::JSON::Object& jsonIn, Poco::JSON::Object& jsonOut ) const override {
+        UNUSED ( method );
+        UNUSED ( jsonIn );
+
+        ScopedSharedMinerLedgerLock ledger ( miner );
+        ledger.seek ( this->optQuery ( "at", ledger.countBlocks ()));
+
+        string accountName  = this->getMatchString ( "accountName" );
+        string methodName   = this->getMatchString ( "methodName" );
+
+        CraftabilityIndex::AssetsByParam assetsByParam;
+        if ( !miner->getCraftabilityIndex ().getQualifiedAssets ( ledger, accountName, methodName, assetsByParam )) return Poco::Net::HTTPResponse::HTTP_NOT_FOUND;
+
+        Poco::JSON::Object::Ptr paramsJSON = new Poco::JSON::Object ();
+
+        CraftabilityIndex::AssetsByParam::const_iterator paramIt = assetsByParam.cbegin ();
+        for ( ; paramIt != assetsByParam.cend (); ++paramIt ) {
+
+            Poco::JSON::Array::Ptr assetIDsJSON = new Poco::JSON::Array ();
+
+            CraftabilityIndex::AssetSet::const_iterator assetIt = paramIt->second.cbegin ();
+            for ( ; assetIt != paramIt->second.cend (); ++assetIt ) {
+                assetIDsJSON->add ( AssetID::encode ( *assetIt ));
+            }
+            paramsJSON->set ( paramIt->first, assetIDsJSON );
+        }
+
+        jsonOut.set ( "method", methodName );
+        jsonOut.set ( "assetArgs", paramsJSON );
+
+        return Poco::Net::HTTPResponse::HTTP_OK;
+    }
+};
+
+} // namespace TheWebMinerAPI
+} // namespace Volition
+#endif
@@ -0,0 +1,59 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_WEBMINERAPI_METRICSHANDLER_H
+#define VOLITION_WEBMINERAPI_METRICSHANDLER_H
+
+#include <volition/AbstractMinerAPIRequestHandler.h>
+#include <volition/Metrics.h>
+
+namespace Volition {
+namespace WebMinerAPI {
+
+//================================================================//
+// MetricsHandler
+//================================================================//
+// Process-wide metrics in the Prometheus text exposition format. Bypasses
+// the JSON response path (and the response cache) entirely.
+class MetricsHandler :
+    public AbstractMinerAPIRequestHandler {
+public:
+
+    SUPPORTED_HTTP_METHODS ( HTTP::GET )
+
+    //----------------------------------------------------------------//
+    HTTPStatus AbstractMinerAPIRequestHandler_handleRequest ( HTTP::Method method, shared_ptr < Miner > miner, const Poco::JSON::Object& jsonIn, Poco::JSON::Object& jsonOut ) const override {
+        UNUSED ( method );
+        UNUSED ( miner );
+        UNUSED ( jsonIn );
+        UNUSED ( jsonOut );
+
+        return Poco::Net::HTTPResponse::HTTP_METHOD_NOT_ALLOWED;
+    }
+
+    //----------------------------------------------------------------//
+    void AbstractRequestHandler_handleRequest ( const Routing::PathMatch& match, Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response ) const override {
+        UNUSED ( match );
+
+        response.add ( "Access-Control-Allow-Origin", "*" );
+
+        if ( HTTP::getMethodForString ( request.getMethod ()) != HTTP::GET ) {
+            response.setStatus ( Poco::Net::HTTPResponse::HTTP_METHOD_NOT_ALLOWED );
+            response.send ();
+            return;
+        }
+
+        string body = TheMetricsRegistry::get ().toPrometheus ();
+
+        response.setStatus ( Poco::Net::HTTPResponse::HTTP_OK );
+        response.setContentType ( "text/plain; version=0.0.4" );
+
+        ostream& out = response.send ();
+        out.write ( body.data (), ( streamsize )body.size ());
+        out.flush ();
+    }
+};
+
+} // namespace TheWebMinerAPI
+} // namespace Volition
+#endif
@@ -0,0 +1,39 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_WEBMINERAPI_NODESTEPTIMINGHANDLER_H
+#define VOLITION_WEBMINERAPI_NODESTEPTIMINGHANDLER_H
+
+#include <volition/AbstractMinerAPIRequestHandler.h>
+#include <volition/MinerStepProfiler.h>
+
+namespace Volition {
+namespace WebMinerAPI {
+
+//================================================================//
+// NodeStepTimingHandler
+//================================================================//
+// Rolling per-phase timing of the miner's step loop and the slowest recent
+// steps with their phase breakdown. Changes every step, so never cached.
+class NodeStepTimingHandler :
+    public AbstractMinerAPIRequestHandler {
+public:
+
+    SUPPORTED_HTTP_METHODS ( HTTP::GET )
+
+    //----------------------------------------------------------------//
+    HTTPStatus AbstractMinerAPIRequestHandler_handleRequest ( HTTP::Method method, shared_ptr < Miner > miner, const Poco::JSON::Object& jsonIn, Poco::JSON::Object& jsonOut ) const override {
+        UNUSED ( method );
+        UNUSED ( jsonIn );
+        
+        MinerStepReport report;
+        miner->getStepProfiler ().getReport ( report );
+        
+        jsonOut.set ( "stepTiming", ToJSONSerializer::toJSON ( report ));
+        return Poco::Net::HTTPResponse::HTTP_OK;
+    }
+};
+
+} // namespace TheWebMinerAPI
+} // namespace Volition
+#endif
@@ -66,10 +66,12 @@ public:
         SerializableVector < AssetID::Index > assetIDs;
         offerODBM.mAssetIdentifiers.get ( assetIDs );
             
+        AssetReadCache cache ( ledger );
+        
         SerializableVector < AssetID::Index >::const_iterator assetIDIt = assetIDs.cbegin ();
         for ( ; assetIDIt != assetIDs.cend (); ++assetIDIt ) {
         
-            shared_ptr < const Asset > asset = AssetODBM ( ledger, *assetIDIt ).getAsset ();
+            shared_ptr < const Asset > asset = AssetODBM ( ledger, *assetIDIt ).getAsset ( cache );
             if ( !asset ) return Poco::Net::HTTPResponse::HTTP_NOT_FOUND;
             
             assets.push_back ( asset );
@@ -0,0 +1,125 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_WEBMINERAPI_OFFERLISTHANDLER_H
+#define VOLITION_WEBMINERAPI_OFFERLISTHANDLER_H
+
+#include <volition/Block.h>
+#include <volition/AbstractMinerAPIRequestHandler.h>
+#include <volition/AssetODBM.h>
+#include <volition/OfferODBM.h>
+#include <volition/TheTransactionBodyFactory.h>
+
+namespace Volition {
+namespace WebMinerAPI {
+
+//================================================================//
+// OfferListHandler
+//================================================================//
+// Open offers containing at least one asset of the given type, from the
+// ledger's by-type offer index. Sorted by minimum price (or by expiration
+// with sort=expiration), ties broken by offer ID, then paged with base/count.
+class OfferListHandler :
+    public AbstractMinerAPIRequestHandler {
+public:
+
+    static const size_t OFFERS_PAGE_SIZE = 64;
+
+    SUPPORTED_HTTP_METHODS ( HTTP::GET )
+    CACHEABLE_RESPONSE
+
+    //----------------------------------------------------------------//
+    class OfferSortKey {
+    public:
+
+        OfferID::Index  mOfferID;
+        u64             mMinimumPrice;
+        string          mExpiration;
+    };
+
+    //----------------------------------------------------------------//
+    HTTPStatus AbstractMinerAPIRequestHandler_handleRequest ( HTTP::Method method, shared_ptr < Miner > miner, const Poco::JSON::Object& jsonIn, Poco::JSON::Object& jsonOut ) const override {
+        UNUSED ( method );
+        UNUSED ( jsonIn );
+
+        ScopedSharedMinerLedgerLock ledger ( miner );
+        ledger.seek ( this->optQuery ( "at", ledger.countBlocks ()));
+
+        string assetType = this->optQuery ( "type", "" );
+        if ( assetType.size () == 0 ) return Poco::Net::HTTPResponse::HTTP_BAD_REQUEST;
+
+        string sort = this->optQuery ( "sort", "price" );
+        if (( sort != "price" ) && ( sort != "expiration" )) return Poco::Net::HTTPResponse::HTTP_BAD_REQUEST;
+
+        size_t base = ( size_t )this->optQuery ( "base", 0 );
+        size_t count = ( size_t )this->optQuery ( "count", OFFERS_PAGE_SIZE );
+        count = count < OFFERS_PAGE_SIZE ? count : OFFERS_PAGE_SIZE;
+
+        SerializableVector < OfferID::Index > offerIDs;
+        ledger.getOpenOffers ( assetType, offerIDs );
+
+        vector < OfferSortKey > sortKeys;
+        sortKeys.reserve ( offerIDs.size ());
+
+        SerializableVector < OfferID::Index >::const_iterator offerIDIt = offerIDs.cbegin ();
+        for ( ; offerIDIt != offerIDs.cend (); ++offerIDIt ) {
+
+            OfferODBM offerODBM ( ledger, *offerIDIt );
+
+            OfferSortKey sortKey;
+            sortKey.mOfferID        = *offerIDIt;
+            sortKey.mMinimumPrice   = offerODBM.mMinimumPrice.get ();
+            sortKey.mExpiration     = offerODBM.mExpiration.get (); // ISO 8601, so it sorts as a string
+            sortKeys.push_back ( sortKey );
+        }
+
+        // only the requested page has to be in order; everything past it is left unsorted.
+        size_t top = base < sortKeys.size () ? base + count : 0;
+        top = top <= sortKeys.size () ? top : sortKeys.size ();
+
+        bool byPrice = ( sort == "price" );
+        std::partial_sort ( sortKeys.begin (), sortKeys.begin () + top, sortKeys.end (), [ byPrice ]( const OfferSortKey& a, const OfferSortKey& b ) {
+            if ( byPrice && ( a.mMinimumPrice != b.mMinimumPrice )) return a.mMinimumPrice < b.mMinimumPrice;
+            if ( !byPrice && ( a.mExpiration != b.mExpiration )) return a.mExpiration < b.mExpiration;
+            return a.mOfferID < b.mOfferID;
+        });
+
+        AssetReadCache cache ( ledger );
+        Poco::JSON::Array::Ptr offersJSON = new Poco::JSON::Array ();
+
+        for ( size_t i = base; i < top; ++i ) {
+
+            const OfferSortKey& sortKey = sortKeys [ i ];
+            OfferODBM offerODBM ( ledger, sortKey.mOfferID );
+
+            SerializableList < SerializableSharedConstPtr < Asset >> assets;
+            SerializableVector < AssetID::Index > assetIDs;
+            offerODBM.mAssetIdentifiers.get ( assetIDs );
+
+            SerializableVector < AssetID::Index >::const_iterator assetIDIt = assetIDs.cbegin ();
+            for ( ; assetIDIt != assetIDs.cend (); ++assetIDIt ) {
+                shared_ptr < const Asset > asset = AssetODBM ( ledger, *assetIDIt ).getAsset ( cache );
+                if ( asset ) {
+                    assets.push_back ( asset );
+                }
+            }
+
+            Poco::JSON::Object::Ptr offerJSON = new Poco::JSON::Object ();
+            offerJSON->set ( "offerID",         ( u64 )sortKey.mOfferID );
+            offerJSON->set ( "seller",          cache.getAccountName ( offerODBM.mSeller.get ()));
+            offerJSON->set ( "minimumPrice",    sortKey.mMinimumPrice );
+            offerJSON->set ( "expiration",      sortKey.mExpiration );
+            offerJSON->set ( "assets",          ToJSONSerializer::toJSON ( assets ));
+            offersJSON->add ( offerJSON );
+        }
+
+        jsonOut.set ( "totalOffers", sortKeys.size ());
+        jsonOut.set ( "offers", offersJSON );
+
+        return Poco::Net::HTTPResponse::HTTP_OK;
+    }
+};
+
+} // namespace TheWebMinerAPI
+} // namespace Volition
+#endif
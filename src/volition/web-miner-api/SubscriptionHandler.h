@@ -0,0 +1,78 @@
+// Copyright (c) 2017-2018 Cryptogogue, Inc. All Rights Reserved.
+// http://cryptogogue.com
+
+#ifndef VOLITION_WEBMINERAPI_SUBSCRIPTIONHANDLER_H
+#define VOLITION_WEBMINERAPI_SUBSCRIPTIONHANDLER_H
+
+#include <volition/AbstractMinerAPIRequestHandler.h>
+#include <volition/LedgerEventFeed.h>
+#include <Poco/StringTokenizer.h>
+
+namespace Volition {
+namespace WebMinerAPI {
+
+//================================================================//
+// SubscriptionHandler
+//================================================================//
+// Long poll for ledger changes touching a set of accounts or transactions.
+// Blocks until a matching event is published after 'since' or until the
+// timeout passes; the response carries 'next', to be passed as 'since' on
+// the following poll. If 'resync' is set, events were missed and the client
+// should refetch whatever it's watching. Waits on the event feed only, so
+// no ledger lock is held. Each poll holds a server thread while it waits,
+// so if too many are already waiting the poll is turned away with 503 and
+// the client should retry after a pause. Never cached.
+class SubscriptionHandler :
+    public AbstractMinerAPIRequestHandler {
+public:
+
+    SUPPORTED_HTTP_METHODS ( HTTP::GET )
+
+    static const u64 DEFAULT_TIMEOUT    = 25;   // seconds
+    static const u64 MAX_TIMEOUT        = 60;   // seconds
+
+    //----------------------------------------------------------------//
+    static void split ( string list, set < string >& tokens ) {
+
+        Poco::StringTokenizer tokenizer ( list, ",", Poco::StringTokenizer::TOK_TRIM | Poco::StringTokenizer::TOK_IGNORE_EMPTY );
+        tokens.insert ( tokenizer.begin (), tokenizer.end ());
+    }
+
+    //----------------------------------------------------------------//
+    HTTPStatus AbstractMinerAPIRequestHandler_handleRequest ( HTTP::Method method, shared_ptr < Miner > miner, const Poco::JSON::Object& jsonIn, Poco::JSON::Object& jsonOut ) const override {
+        UNUSED ( method );
+        UNUSED ( jsonIn );
+
+        const LedgerEventFeed& feed = miner->getEventFeed ();
+
+        set < string > accounts;
+        set < string > transactions;
+        SubscriptionHandler::split ( this->optQuery ( "accounts", "" ), accounts );
+        SubscriptionHandler::split ( this->optQuery ( "transactions", "" ), transactions );
+
+        u64 since       = this->optQuery ( "since", feed.getNextNonce ());
+        u64 timeout     = this->optQuery ( "timeout", DEFAULT_TIMEOUT );
+
+        if ( timeout > MAX_TIMEOUT ) {
+            timeout = MAX_TIMEOUT;
+        }
+
+        SerializableVector < LedgerEvent > events;
+        u64 next = since;
+        LedgerEventFeed::WaitResult result = feed.wait ( since, accounts, transactions, timeout * 1000, events, next );
+
+        if ( result == LedgerEventFeed::WAIT_BUSY ) {
+            return Poco::Net::HTTPResponse::HTTP_SERVICE_UNAVAILABLE;
+        }
+
+        jsonOut.set ( "events",     ToJSONSerializer::toJSON ( events ));
+        jsonOut.set ( "next",       next );
+        jsonOut.set ( "resync",     result == LedgerEventFeed::WAIT_RESYNC );
+
+        return Poco::Net::HTTPResponse::HTTP_OK;
+    }
+};
+
+} // namespace TheWebMinerAPI
+} // namespace Volition
+#endif
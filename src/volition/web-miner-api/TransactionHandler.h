@@ -21,9 +21,13 @@ class TransactionHandler :
 public:
 
     SUPPORTED_HTTP_METHODS ( HTTP::GET_PUT )
+    STREAMED_HTTP_METHODS ( HTTP::PUT )
 
     //----------------------------------------------------------------//
     HTTPStatus AbstractMinerAPIRequestHandler_handleRequest ( HTTP::Method method, shared_ptr < Miner > miner, const Poco::JSON::Object& jsonIn, Poco::JSON::Object& jsonOut ) const override {
+        UNUSED ( jsonIn );
+    
+        if ( method != HTTP::GET ) return Poco::Net::HTTPResponse::HTTP_BAD_REQUEST;
     
         ScopedExclusiveMinerLock minerLock ( miner );
         AbstractLedger& ledger = miner->getLedger ();
@@ -31,35 +35,31 @@ public:
         string accountName  = this->getMatchString ( "accountName" );
         string uuid         = this->getMatchString ( "uuid" );
     
-        TransactionQueue& transactionQueue = miner->getTransactionQueue ();
+        TransactionStatus status = miner->getTransactionQueue ().getTransactionStatus ( ledger, accountName, uuid );
+        
+        jsonOut.set ( "status", status.getStatusCodeString ());
+        jsonOut.set ( "message", status.mMessage );
+        jsonOut.set ( "uuid", status.mUUID );
+        return Poco::Net::HTTPResponse::HTTP_OK;
+    }
     
-        switch ( method ) {
+    //----------------------------------------------------------------//
+    HTTPStatus AbstractMinerAPIRequestHandler_handleStreamedRequest ( HTTP::Method method, shared_ptr < Miner > miner, const JSONTokenizer& jsonIn, Poco::JSON::Object& jsonOut ) const override {
+        UNUSED ( method );
     
-            case HTTP::GET: {
-
-                TransactionStatus status = transactionQueue.getTransactionStatus ( ledger, accountName, uuid );
-                
-                jsonOut.set ( "status", status.getStatusCodeString ());
-                jsonOut.set ( "message", status.mMessage );
-                jsonOut.set ( "uuid", status.mUUID );
-                return Poco::Net::HTTPResponse::HTTP_OK;
-            }
-            
-            case HTTP::PUT: {
-
-                SerializableUniquePtr < Transaction > transaction;
-                FromJSONSerializer::fromJSON ( transaction, jsonIn );
+        string accountName  = this->getMatchString ( "accountName" );
+        string uuid         = this->getMatchString ( "uuid" );
+    
+        // deserialize before taking the lock; the transaction body is parsed from its tokens, too.
+        SerializableUniquePtr < Transaction > transaction;
+        FromJSONStreamSerializer::fromJSON ( transaction, jsonIn );
 
-                if ( transaction && transaction->checkMaker ( accountName, uuid )) {
-                    transactionQueue.pushTransaction ( move ( transaction ));
-                    jsonOut.set ( "status", "OK" );
-                    return Poco::Net::HTTPResponse::HTTP_OK;
-                }
-                return Poco::Net::HTTPResponse::HTTP_BAD_REQUEST;
-            }
-            
-            default:
-                break;
+        if ( transaction && transaction->checkMaker ( accountName, uuid )) {
+        
+            ScopedExclusiveMinerLock minerLock ( miner );
+            miner->getTransactionQueue ().pushTransaction ( move ( transaction ));
+            jsonOut.set ( "status", "OK" );
+            return Poco::Net::HTTPResponse::HTTP_OK;
         }
         return Poco::Net::HTTPResponse::HTTP_BAD_REQUEST;
     }